@@ -44,14 +44,13 @@ static bool is_recording = false;
     }
 
 // 下行音频流回调：由 sdui_bus 路由到此处
-static void audio_play_callback(const char *base64_data)
+static void audio_play_callback(const char *base64_data, size_t data_len)
 {
-    ESP_LOGI(TAG, "Audio data received, len: %d", strlen(base64_data));
-    
+    ESP_LOGI(TAG, "Audio data received, len: %d", (int)data_len);
+
     if (!spk_handle || !base64_data)
         return;
 
-    size_t data_len = strlen(base64_data);
     // pcm_buf 属于高频实时操作缓冲，强制分配到内部 SRAM 防止 PSRAM 带宽被占用导致的 I2S 缺载失真
     unsigned char *pcm_buf = (unsigned char *)heap_caps_malloc(data_len, MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
     size_t pcm_len = 0;
@@ -119,9 +118,10 @@ static void audio_record_task(void *arg)
                 mbedtls_base64_encode(base64_buf, 1500, &base64_len, pcm_buf, mono_size);
                 base64_buf[base64_len] = '\0';
 
-                // 组装总线 payload
-                snprintf(json_buf, 2048, "{\"state\": \"stream\", \"data\": \"%s\"}", base64_buf);
-                sdui_bus_publish_up("audio/record", json_buf);
+                // 组装总线 payload（格式自控，免校验直接嵌入信封）
+                int json_len = snprintf(json_buf, 2048, "{\"state\": \"stream\", \"data\": \"%s\"}", base64_buf);
+                if (json_len > 0 && json_len < 2048)
+                    sdui_bus_publish_up_ex("audio/record", json_buf, (size_t)json_len, SDUI_BUS_UP_JSON);
             }
             else
             {
@@ -208,5 +208,5 @@ void audio_app_start(void)
     }
 
     // 订阅云端下发的音频指令
-    sdui_bus_subscribe("audio/play", audio_play_callback);
+    sdui_bus_subscribe_slice("audio/play", audio_play_callback);   // Base64 直接从下行原文解码
 }
\ No newline at end of file
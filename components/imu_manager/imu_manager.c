@@ -59,12 +59,12 @@ static void imu_polling_task(void *pvParameters)
                     ESP_LOGI(TAG, "Real Hardware Shake detected! Magnitude: %.2f m/s²", acc_magnitude);
                     
                     char json_payload[128];
-                    snprintf(json_payload, sizeof(json_payload), 
-                             "{\"type\": \"shake\", \"magnitude\": %.2f}", 
-                             acc_magnitude);
-                    
-                    // 通过消息总线上行发布，解耦 WebSocket 依赖
-                    sdui_bus_publish_up("motion", json_payload);
+                    int  json_len = snprintf(json_payload, sizeof(json_payload),
+                                             "{\"type\": \"shake\", \"magnitude\": %.2f}",
+                                             acc_magnitude);
+
+                    // 通过消息总线上行发布，解耦 WebSocket 依赖（格式自控，免校验）
+                    sdui_bus_publish_up_ex("motion", json_payload, (size_t)json_len, SDUI_BUS_UP_JSON);
                     
                     shake_cooldown = 10; // 10 次轮询冷却（约 1 秒）避免重复触发
                 }
@@ -1,27 +1,176 @@
 #ifndef SDUI_BUS_H
 #define SDUI_BUS_H
 
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 二进制下行帧头: 'S' 'B' | u8 版本 | u8 topic 长度 | topic | payload
+#define SDUI_BUS_BIN_MAGIC0   'S'
+#define SDUI_BUS_BIN_MAGIC1   'B'
+#define SDUI_BUS_BIN_VERSION  1
+
+struct cJSON;
+
 // 定义总线订阅的回调函数签名
 // 接收到的 payload 是纯文本（未深度解析的 JSON 字符串或纯字符串），由具体业务按需解析
+// payload 为总线生成的 '\0' 结尾拷贝，大载荷请改用 slice 订阅
 typedef void (*sdui_bus_cb_t)(const char *payload);
 
+/**
+ * 切片回调：payload 借用下行原文，不以 '\0' 结尾，仅在回调期间有效
+ * 对象 / 数组 / 数字等为 JSON 原文；字符串为引号内的内容（含转义时为反转义结果）；
+ * 信封没有 payload 时为 (NULL, 0)
+ */
+typedef void (*sdui_bus_slice_cb_t)(const char *payload, size_t len);
+
+// JSON 回调：payload 解析一次，同一消息的所有 json 订阅者共用，只读且仅在回调期间有效；
+// 载荷不是合法 JSON 或缺失时为 NULL
+typedef void (*sdui_bus_json_cb_t)(const struct cJSON *payload);
+
+// 二进制主题回调：data 仅在回调期间有效
+typedef void (*sdui_bus_bin_cb_t)(const uint8_t *data, size_t len);
+
 // 初始化总线
 void sdui_bus_init(void);
 
-// 订阅云端下发的特定主题 (例如 "ui/update", "audio/play")
+/**
+ * @brief 订阅主题 (例如 "ui/update", "audio/play")，订阅数不设上限、主题长度不限
+ *
+ * 主题按 '/' 分层，支持通配：'+' 匹配恰好一层（"sensor/+/temp"），
+ * '#' 放在末层匹配本层及以下任意层（"audio/cmd/#" 也匹配 "audio/cmd"）。
+ * 通配符必须独占一层。同一 (topic, cb) 重复订阅只登记一次。
+ */
 void sdui_bus_subscribe(const char *topic, sdui_bus_cb_t cb);
 
+/**
+ * @brief 退订：topic 须与订阅时的写法一致（通配订阅按原写法退订）
+ * 已在分发途中的消息仍可能回调一次
+ * @return 找到并移除时返回 true
+ */
+bool sdui_bus_unsubscribe(const char *topic, sdui_bus_cb_t cb);
+
+/** @brief 以切片方式订阅（零拷贝），主题规则同 sdui_bus_subscribe */
+void sdui_bus_subscribe_slice(const char *topic, sdui_bus_slice_cb_t cb);
+bool sdui_bus_unsubscribe_slice(const char *topic, sdui_bus_slice_cb_t cb);
+
+/** @brief 以解析好的 cJSON 节点订阅，主题规则同 sdui_bus_subscribe */
+void sdui_bus_subscribe_json(const char *topic, sdui_bus_json_cb_t cb);
+bool sdui_bus_unsubscribe_json(const char *topic, sdui_bus_json_cb_t cb);
+
 // 核心路由入口：仅供 websocket_manager 在收到下行文本时调用
+// 信封原地扫描（只校验信封本身的结构），payload 内部的语法由订阅者的解析器校验
+// 开启分发通道时只拆信封并入队，订阅者在通道任务中回调（见 sdui_bus_lane_t）
 void sdui_bus_route_down(const char *raw_json);
 
+/**
+ * @brief 订阅以二进制帧下发的主题（与同名文本订阅互不影响）
+ * 订阅后该主题会出现在 sdui_bus_get_bin_topics() 中，随心跳告知服务端
+ */
+void sdui_bus_subscribe_bin(const char *topic, sdui_bus_bin_cb_t cb);
+
+/** @brief 退订二进制主题，语义同 sdui_bus_unsubscribe */
+bool sdui_bus_unsubscribe_bin(const char *topic, sdui_bus_bin_cb_t cb);
+
+/**
+ * @brief 二进制帧路由入口：仅供 websocket_manager 在收到下行二进制帧时调用
+ * @param data 完整帧（含 SDUI_BUS_BIN_* 帧头）
+ * @param len  帧长度
+ */
+void sdui_bus_route_down_bin(const uint8_t *data, size_t len);
+
+/* ---- 分发通道（CONFIG_SDUI_BUS_LANES） ----
+ * 下行消息（文本与二进制帧）按主题归入三个优先级通道，各由一个任务按到达顺序回调订阅者，
+ * 慢的布局渲染不再阻塞音频。WebSocket 事件任务只拆信封、拷贝一次消息并入队；
+ * 切片订阅者借用的是这份拷贝，仍只在回调期间有效。
+ * 队列满时按主题规则的溢出策略处理（见 sdui_bus_overflow_t）：缺省规则下批量主题合并、
+ * 可取代的主题丢弃旧消息，其余主题阻塞投递方至多 CONFIG_SDUI_BUS_LANE_BLOCK_MS。
+ * 同一通道内保持到达顺序，不同通道之间不保证。sdui_bus_publish_local 始终同步回调。
+ * 关闭该选项时订阅者在 WebSocket 事件任务中同步回调。 */
+typedef enum {
+    SDUI_BUS_LANE_REALTIME = 0,   // 实时：缺省 audio/#
+    SDUI_BUS_LANE_INTERACTIVE,    // 交互：缺省 ui/#、state/#
+    SDUI_BUS_LANE_BACKGROUND,     // 后台：其余主题（含写 SPIFFS 的 font/#）
+    SDUI_BUS_LANE_COUNT,
+} sdui_bus_lane_t;
+
+// 通道队列满时对新消息的处理
+typedef enum {
+    SDUI_BUS_OVERFLOW_BLOCK = 0,   // 阻塞投递方直到腾出一格，超过 CONFIG_SDUI_BUS_LANE_BLOCK_MS 丢弃并记错误
+    SDUI_BUS_OVERFLOW_DROP,        // 可丢弃的流（缺省 audio/play 与未列出的主题）：挤掉最早一条同策略消息，没有则丢弃新消息
+    SDUI_BUS_OVERFLOW_COALESCE,    // 新消息完整取代旧消息（缺省 ui/layout）：替换排队中的同主题消息，没有则阻塞
+    SDUI_BUS_OVERFLOW_MERGE,       // 批量主题（缺省 ui/update、state/set、font/glyphs）：相邻两条同主题的对象 / 数组
+                                   // payload 合成一个数组 [旧, 新]（数组展开一层），订阅者须按序处理数组；无可合并时阻塞
+} sdui_bus_overflow_t;
+
+// 通道统计，计数自启动累计
+typedef struct {
+    uint16_t capacity;       // 队列深度上限
+    uint16_t depth;          // 当前排队数
+    uint16_t depth_max;      // 排队数峰值
+    uint32_t enqueued;
+    uint32_t delivered;
+    uint32_t dropped;        // DROP 策略的丢弃、阻塞超时与入队分配失败
+    uint32_t coalesced;      // 被同主题新消息取代或并入批次
+    uint32_t blocked;        // 投递方因队列满而等待的次数
+    uint32_t block_us_max;   // 投递方最长等待时间
+    uint32_t wait_us_last;   // 最近一条消息的排队时间
+    uint32_t wait_us_max;
+    uint64_t wait_us_sum;    // 除以 delivered 为平均排队时间
+} sdui_bus_lane_stats_t;
+
+/**
+ * @brief 把匹配 topic_filter（可含通配符）的主题归入指定通道，并指定队列满时的处理
+ * 后设置的规则优先，同一写法重复设置时改为新设置；仅在开启分发通道时生效。
+ * 只有新消息能完整取代旧消息的主题才应使用 DROP / COALESCE，订阅者接受数组批次的主题才应使用 MERGE。
+ */
+void sdui_bus_set_lane(const char *topic_filter, sdui_bus_lane_t lane, sdui_bus_overflow_t overflow);
+
+/**
+ * @brief 读取通道统计
+ * @return 分发通道未启用时返回 false
+ */
+bool sdui_bus_get_lane_stats(sdui_bus_lane_t lane, sdui_bus_lane_stats_t *out);
+
+/** @brief 通道名（遥测中的键名）："realtime" / "interactive" / "background" */
+const char *sdui_bus_lane_name(sdui_bus_lane_t lane);
+
+/**
+ * @brief 获取已订阅二进制帧的主题列表
+ * @param topics 输出：主题字符串指针（在该主题被全部退订前有效）
+ * @param max    topics 容量
+ * @return 实际数量
+ */
+int sdui_bus_get_bin_topics(const char **topics, int max);
+
 // 上行发布接口：各个模块调用此接口上报事件
 // 总线会自动封装为 {"topic": "...", "device_id": "...", "payload": ...} 格式并发出
+// payload 先做语法校验：合法 JSON 原样嵌入，否则作为字符串嵌入（等同 SDUI_BUS_UP_VALIDATE）
 void sdui_bus_publish_up(const char *topic, const char *payload);
 
+// sdui_bus_publish_up_ex 的 payload 处理方式
+#define SDUI_BUS_UP_JSON      0u          // payload 是调用方保证合法的 JSON，原样拷贝、不校验
+#define SDUI_BUS_UP_VALIDATE  (1u << 0)   // 先校验，不合法时作为字符串嵌入
+#define SDUI_BUS_UP_STRING    (1u << 1)   // payload 是纯文本，转义后作为 JSON 字符串嵌入
+
+/**
+ * @brief 上行发布（无分配路径）：信封直接写入发送任务自己的复用缓冲区
+ *
+ * 主题片段与 device_id 片段预先生成并缓存，payload 按 flags 原样拷贝或转义，
+ * 整个过程不建 cJSON 对象、不重新序列化；高频上报（如 audio/record）应使用 SDUI_BUS_UP_JSON。
+ * 可在任意任务中调用。
+ *
+ * @param topic   上行主题
+ * @param payload 载荷，不要求 '\0' 结尾；NULL 或空时嵌入 ""
+ * @param len     载荷长度
+ * @param flags   SDUI_BUS_UP_*
+ */
+void sdui_bus_publish_up_ex(const char *topic, const char *payload, size_t len, uint32_t flags);
+
 /**
  * @brief 设置设备唯一码（由 telemetry_manager 在初始化时调用）
  * 设置后，所有 sdui_bus_publish_up() 的上行消息将自动在信封中附加 device_id
@@ -31,6 +180,7 @@ void sdui_bus_set_device_id(const char *device_id);
 
 // 本地总线发布接口：在终端内部路由事件（不经过 WebSocket）
 // 用于 Action URI "local://" 路由。触发对应 topic 的本地订阅者
+// json 订阅者收到 payload 的解析结果，payload 不是 JSON 时为字符串节点
 void sdui_bus_publish_local(const char *topic, const char *payload);
 
 #ifdef __cplusplus
@@ -1,26 +1,488 @@
 #include "sdui_bus.h"
 #include "websocket_manager.h"
+#include "sdui_json.h"
+#include "sdui_perf.h"
 #include "cJSON.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "esp_heap_caps.h"
+#include "sdkconfig.h"
 #include <string.h>
+#include <stdlib.h>
+
+#if CONFIG_SDUI_BUS_LANES
+#include "freertos/idf_additions.h"
+#include "esp_timer.h"
+#endif
 
-#define MAX_SUBSCRIBERS 15
 static const char *TAG = "SDUI_BUS";
 
 // 设备唯一码（由 telemetry_manager 在启动时设置）
 static char s_device_id[18] = {0};
 
-// 订阅者注册表节点
+// 上行信封中的 "device_id":"...", 片段，设置设备唯一码时生成
+static char   s_device_part[sizeof(s_device_id) + 16];
+static size_t s_device_part_len = 0;
+
+/* ======================================================
+ * 主题树
+ *
+ * 主题按 '/' 切分，每个分段对应一层节点；普通分段子节点按字节序排列、二分查找，
+ * '+'（恰好一层）与 '#'（本层及以下任意层，含零层）各占一个专用子节点。
+ * 分发时沿主题逐段下行，开销取决于主题层数与通配订阅数，与订阅总数无关。
+ *
+ * 树只在持锁时访问；分发先在锁内收集匹配的回调，解锁后再逐个调用，
+ * 回调里可以再订阅 / 退订 / 发布，也不会与持有显示锁的任务互相等待。
+ * ====================================================== */
+
+// 订阅方式：决定回调收到 payload 的形式
+typedef enum {
+    BUS_CB_TEXT = 0,   // '\0' 结尾拷贝
+    BUS_CB_SLICE,      // 借用切片
+    BUS_CB_JSON,       // 解析好的 cJSON 节点
+    BUS_CB_BIN,        // 二进制帧
+} bus_cb_kind_t;
+
+typedef union {
+    sdui_bus_cb_t       text;
+    sdui_bus_slice_cb_t slice;
+    sdui_bus_json_cb_t  json;
+    sdui_bus_bin_cb_t   bin;
+} bus_fn_t;
+
+// 订阅者（同一节点上按订阅顺序排列）
+typedef struct bus_sub {
+    struct bus_sub *next;
+    bus_cb_kind_t   kind;
+    bus_fn_t        fn;
+} bus_sub_t;
+
+typedef struct bus_node {
+    struct bus_node  *parent;     // 根节点为 NULL
+    struct bus_node **kids;       // 普通分段子节点，按分段字节序排列
+    size_t            n_kids;
+    size_t            cap_kids;
+    struct bus_node  *plus;       // '+' 子节点
+    struct bus_node  *hash;       // '#' 子节点
+    bus_sub_t        *subs;
+    size_t            seg_off;    // 本层分段在 path 中的偏移
+    size_t            seg_len;
+    char              path[];     // 根到本节点的完整主题（订阅时的写法）
+} bus_node_t;
+
+// 一次分发收集到的回调；少量命中用内嵌数组，超出再上堆
+typedef struct {
+    bus_cb_kind_t kind;
+    bus_fn_t      fn;
+} bus_hit_t;
+
+typedef struct {
+    bus_hit_t *v;
+    size_t     n;
+    size_t     cap;
+    bus_hit_t  local[8];
+} bus_hits_t;
+
+static bus_node_t       *s_root = NULL;
+static SemaphoreHandle_t s_lock = NULL;
+
+static void bus_lock(void) {
+    if (!s_lock) s_lock = xSemaphoreCreateMutex();   // 启动阶段单线程，惰性创建即可
+    if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY);
+}
+
+static void bus_unlock(void) {
+    if (s_lock) xSemaphoreGive(s_lock);
+}
+
+static bus_node_t *node_new(bus_node_t *parent, const char *seg, size_t seg_len) {
+    size_t prefix = 0;
+    if (parent) prefix = parent->parent ? strlen(parent->path) + 1 : 0;   // 根的直接子节点不加 '/'
+    bus_node_t *n = calloc(1, sizeof(*n) + prefix + seg_len + 1);
+    if (!n) return NULL;
+    n->parent  = parent;
+    n->seg_off = prefix;
+    n->seg_len = seg_len;
+    if (prefix) {
+        memcpy(n->path, parent->path, prefix - 1);
+        n->path[prefix - 1] = '/';
+    }
+    memcpy(n->path + prefix, seg, seg_len);
+    n->path[prefix + seg_len] = '\0';
+    return n;
+}
+
+static void node_free(bus_node_t *n) {
+    if (!n) return;
+    for (size_t i = 0; i < n->n_kids; i++) node_free(n->kids[i]);
+    node_free(n->plus);
+    node_free(n->hash);
+    for (bus_sub_t *s = n->subs, *next; s; s = next) {
+        next = s->next;
+        free(s);
+    }
+    free(n->kids);
+    free(n);
+}
+
+static int seg_cmp(const bus_node_t *n, const char *seg, size_t len) {
+    size_t m = n->seg_len < len ? n->seg_len : len;
+    int    c = memcmp(n->path + n->seg_off, seg, m);
+    if (c) return c;
+    return n->seg_len < len ? -1 : n->seg_len > len;
+}
+
+// 二分查找普通子节点；未命中时 *pos 为插入位置
+static bus_node_t *kid_find(const bus_node_t *n, const char *seg, size_t len, size_t *pos) {
+    size_t lo = 0, hi = n->n_kids;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        int    c   = seg_cmp(n->kids[mid], seg, len);
+        if (c == 0) {
+            if (pos) *pos = mid;
+            return n->kids[mid];
+        }
+        if (c < 0) lo = mid + 1;
+        else       hi = mid;
+    }
+    if (pos) *pos = lo;
+    return NULL;
+}
+
+// 取（必要时创建）分段对应的子节点；'+' / '#' 按通配处理
+static bus_node_t *kid_get(bus_node_t *n, const char *seg, size_t len, bool create) {
+    bus_node_t **slot = NULL;
+    if (len == 1 && seg[0] == '+') slot = &n->plus;
+    else if (len == 1 && seg[0] == '#') slot = &n->hash;
+    if (slot) {
+        if (!*slot && create) *slot = node_new(n, seg, len);
+        return *slot;
+    }
+
+    size_t      pos;
+    bus_node_t *k = kid_find(n, seg, len, &pos);
+    if (k || !create) return k;
+
+    if (n->n_kids == n->cap_kids) {
+        size_t       cap  = n->cap_kids ? n->cap_kids * 2 : 4;
+        bus_node_t **kids = realloc(n->kids, cap * sizeof(*kids));
+        if (!kids) return NULL;
+        n->kids     = kids;
+        n->cap_kids = cap;
+    }
+    k = node_new(n, seg, len);
+    if (!k) return NULL;
+    memmove(&n->kids[pos + 1], &n->kids[pos], (n->n_kids - pos) * sizeof(*n->kids));
+    n->kids[pos] = k;
+    n->n_kids++;
+    return k;
+}
+
+// 沿订阅写法定位节点；create 为 false 时不存在即返回 NULL
+static bus_node_t *node_lookup(const char *topic, bool create) {
+    if (!s_root) {
+        if (!create) return NULL;
+        s_root = node_new(NULL, "", 0);
+        if (!s_root) return NULL;
+    }
+    bus_node_t *n = s_root;
+    const char *p = topic;
+    for (;;) {
+        const char *slash = strchr(p, '/');
+        size_t      len   = slash ? (size_t)(slash - p) : strlen(p);
+        n = kid_get(n, p, len, create);
+        if (!n || !slash) return n;
+        p = slash + 1;
+    }
+}
+
+// 从叶向根释放不再有订阅者、也没有子节点的节点
+static void node_prune(bus_node_t *n) {
+    while (n && n->parent && !n->subs && !n->n_kids && !n->plus && !n->hash) {
+        bus_node_t *parent = n->parent;
+        if (parent->plus == n) {
+            parent->plus = NULL;
+        } else if (parent->hash == n) {
+            parent->hash = NULL;
+        } else {
+            size_t pos;
+            if (kid_find(parent, n->path + n->seg_off, n->seg_len, &pos) == n) {
+                memmove(&parent->kids[pos], &parent->kids[pos + 1],
+                        (parent->n_kids - pos - 1) * sizeof(*parent->kids));
+                parent->n_kids--;
+            }
+        }
+        free(n->kids);
+        free(n);
+        n = parent;
+    }
+}
+
+// 订阅写法校验：'+' / '#' 必须独占一层，'#' 只能在末层
+static bool topic_valid(const char *topic) {
+    for (const char *p = topic; *p; p++) {
+        if (*p != '+' && *p != '#') continue;
+        bool whole = (p == topic || p[-1] == '/') && (p[1] == '\0' || p[1] == '/');
+        if (!whole || (*p == '#' && p[1] != '\0')) return false;
+    }
+    return true;
+}
+
+static bool fn_equal(bus_cb_kind_t kind, bus_fn_t a, bus_fn_t b) {
+    switch (kind) {
+    case BUS_CB_TEXT:  return a.text == b.text;
+    case BUS_CB_SLICE: return a.slice == b.slice;
+    case BUS_CB_JSON:  return a.json == b.json;
+    case BUS_CB_BIN:   return a.bin == b.bin;
+    }
+    return false;
+}
+
+static const char *kind_name(bus_cb_kind_t kind) {
+    static const char *const names[] = {"", "slice ", "json ", "binary "};
+    return names[kind];
+}
+
+static void bus_add(const char *topic, bus_cb_kind_t kind, bus_fn_t fn) {
+    if (!topic || !fn.text) return;
+    if (!topic_valid(topic)) {
+        ESP_LOGE(TAG, "Failed to subscribe %s: '+' / '#' must occupy a whole level ('#' last)", topic);
+        return;
+    }
+
+    bus_lock();
+    bus_node_t *n = node_lookup(topic, true);
+    bus_sub_t **tail = n ? &n->subs : NULL;
+    bool        dup  = false;
+    while (tail && *tail) {
+        if ((*tail)->kind == kind && fn_equal(kind, (*tail)->fn, fn)) dup = true;
+        tail = &(*tail)->next;
+    }
+    bus_sub_t *s = (tail && !dup) ? calloc(1, sizeof(*s)) : NULL;
+    if (s) {
+        s->kind = kind;
+        s->fn   = fn;
+        *tail   = s;
+    } else if (!dup) {
+        node_prune(n);
+    }
+    bus_unlock();
+
+    if (dup) ESP_LOGW(TAG, "Already subscribed to %s", topic);
+    else if (s) ESP_LOGI(TAG, "Subscribed to %stopic: %s", kind_name(kind), topic);
+    else ESP_LOGE(TAG, "Failed to subscribe %s: out of memory", topic);
+}
+
+static bool bus_remove(const char *topic, bus_cb_kind_t kind, bus_fn_t fn) {
+    if (!topic) return false;
+    bool found = false;
+
+    bus_lock();
+    bus_node_t *n = node_lookup(topic, false);
+    for (bus_sub_t **pp = n ? &n->subs : NULL; pp && *pp; pp = &(*pp)->next) {
+        bus_sub_t *s = *pp;
+        if (s->kind == kind && fn_equal(kind, s->fn, fn)) {
+            *pp = s->next;
+            free(s);
+            found = true;
+            break;
+        }
+    }
+    if (found) node_prune(n);
+    bus_unlock();
+
+    if (found) ESP_LOGI(TAG, "Unsubscribed from %stopic: %s", kind_name(kind), topic);
+    return found;
+}
+
+static void hits_add(bus_hits_t *h, const bus_node_t *n, bool bin) {
+    for (const bus_sub_t *s = n->subs; s; s = s->next) {
+        if ((s->kind == BUS_CB_BIN) != bin) continue;
+        if (h->n == h->cap) {
+            size_t     cap = h->cap * 2;
+            bus_hit_t *v   = h->v == h->local ? malloc(cap * sizeof(*v)) : realloc(h->v, cap * sizeof(*v));
+            if (!v) {
+                ESP_LOGE(TAG, "Dispatch list alloc failed, dropping subscriber of %s", n->path);
+                return;
+            }
+            if (h->v == h->local) memcpy(v, h->local, sizeof(h->local));
+            h->v   = v;
+            h->cap = cap;
+        }
+        h->v[h->n].kind = s->kind;
+        h->v[h->n].fn   = s->fn;
+        h->n++;
+    }
+}
+
+// p 指向待匹配分段的起点，NULL 表示主题已走完
+static void match(const bus_node_t *n, const char *p, const char *end, bool bin, bus_hits_t *h) {
+    if (!p) {
+        hits_add(h, n, bin);
+    } else {
+        const char *slash = memchr(p, '/', (size_t)(end - p));
+        const char *seg_e = slash ? slash : end;
+        const char *next  = slash ? slash + 1 : NULL;
+        const bus_node_t *k = kid_find(n, p, (size_t)(seg_e - p), NULL);
+        if (k) match(k, next, end, bin, h);
+        if (n->plus) match(n->plus, next, end, bin, h);
+    }
+    if (n->hash) hits_add(h, n->hash, bin);   // "a/#" 同时匹配 "a" 本身
+}
+
+// 收集订阅了 topic（长度 len，不要求以 0 结尾）的回调，用完须 hits_free
+static void bus_collect(const char *topic, size_t len, bool bin, bus_hits_t *h) {
+    h->v   = h->local;
+    h->n   = 0;
+    h->cap = sizeof(h->local) / sizeof(h->local[0]);
+    bus_lock();
+    if (s_root) match(s_root, topic, topic + len, bin, h);
+    bus_unlock();
+}
+
+static void hits_free(bus_hits_t *h) {
+    if (h->v != h->local) free(h->v);
+}
+
+/* ======================================================
+ * 上行信封
+ *
+ * {"topic":"...","device_id":"...","payload":...} 直接拼接到发送任务自己的缓冲区：
+ * 主题片段按主题缓存，device_id 片段在设置时生成一次，payload 原样拷贝，
+ * 只有调用方要求时才做语法校验。websocket 发送是同步的，返回后缓冲区即可复用，
+ * 每个任务一块，发送时互不等待。槽位按任务句柄绑定、任务退出后不回收，
+ * 因此每块只保留到 UP_TX_KEEP_MAX：更大的信封临时分配、发送后立即释放，
+ * 常驻占用不超过 UP_TX_TASKS × UP_TX_KEEP_MAX。
+ * ====================================================== */
+#define UP_PREFIX_MAX    32     // 缓存的主题片段条数，超出的主题每次现场生成
+#define UP_TX_TASKS      8      // 持有独立发送缓冲区的任务数，超出的任务每次临时分配
+#define UP_TX_INIT_CAP   1024
+#define UP_TX_KEEP_MAX   4096   // 常驻缓冲区上限，覆盖 audio/record 音频块与心跳
+
+typedef struct up_prefix {
+    struct up_prefix *next;
+    const char       *topic;    // 指向 text 之后的主题原文
+    size_t            len;      // text 长度
+    char              text[];   // {"topic":"<转义后的主题>",
+} up_prefix_t;
+
 typedef struct {
-    char topic[32];
-    sdui_bus_cb_t cb;
-} sdui_subscriber_t;
+    TaskHandle_t task;
+    char        *buf;
+    size_t       cap;
+} up_txbuf_t;
+
+static up_prefix_t *s_up_prefixes = NULL;   // 条目只增不删，解锁后仍可读
+static int          s_up_prefix_n = 0;
+static up_txbuf_t   s_up_tx[UP_TX_TASKS];
 
-static sdui_subscriber_t subscribers[MAX_SUBSCRIBERS];
-static uint8_t sub_count = 0;
+// 按 JSON 字符串规则转义（不含两侧引号）；dst 为 NULL 时只计算长度
+static size_t json_escape(char *dst, const char *src, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    size_t n = 0;
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)src[i];
+        char          e = 0;
+        switch (c) {
+        case '"':  e = '"';  break;
+        case '\\': e = '\\'; break;
+        case '\n': e = 'n';  break;
+        case '\r': e = 'r';  break;
+        case '\t': e = 't';  break;
+        case '\b': e = 'b';  break;
+        case '\f': e = 'f';  break;
+        }
+        if (e) {
+            if (dst) { dst[n] = '\\'; dst[n + 1] = e; }
+            n += 2;
+        } else if (c < 0x20) {
+            if (dst) {
+                memcpy(dst + n, "\\u00", 4);
+                dst[n + 4] = hex[c >> 4];
+                dst[n + 5] = hex[c & 15];
+            }
+            n += 6;
+        } else {
+            if (dst) dst[n] = (char)c;
+            n++;
+        }
+    }
+    return n;
+}
+
+// 生成 {"topic":"...", 片段，返回长度（调用方保证空间为 12 + 转义后长度）
+static size_t up_prefix_render(char *dst, const char *topic, size_t topic_len) {
+    char *p = dst;
+    memcpy(p, "{\"topic\":\"", 10);
+    p += 10;
+    p += json_escape(p, topic, topic_len);
+    memcpy(p, "\",", 2);
+    return (size_t)(p + 2 - dst);
+}
+
+// 须持锁调用；缓存已满或内存不足时返回 NULL
+static up_prefix_t *up_prefix_get(const char *topic, size_t topic_len) {
+    for (up_prefix_t *e = s_up_prefixes; e; e = e->next) {
+        if (!strcmp(e->topic, topic)) return e;
+    }
+    if (s_up_prefix_n >= UP_PREFIX_MAX) return NULL;
+
+    size_t       cap = 12 + json_escape(NULL, topic, topic_len);
+    up_prefix_t *e   = malloc(sizeof(*e) + cap + topic_len + 1);
+    if (!e) return NULL;
+    e->len   = up_prefix_render(e->text, topic, topic_len);
+    e->topic = e->text + cap;
+    memcpy((char *)e->topic, topic, topic_len + 1);
+    e->next       = s_up_prefixes;
+    s_up_prefixes = e;
+    s_up_prefix_n++;
+    return e;
+}
+
+// 须持锁调用；返回当前任务的发送缓冲区，槽位用尽时返回 NULL
+static up_txbuf_t *up_txbuf_get(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    up_txbuf_t  *free_slot = NULL;
+    for (int i = 0; i < UP_TX_TASKS; i++) {
+        if (s_up_tx[i].task == self) return &s_up_tx[i];
+        if (!s_up_tx[i].task && !free_slot) free_slot = &s_up_tx[i];
+    }
+    if (free_slot) free_slot->task = self;
+    return free_slot;
+}
+
+// 槽位只被所属任务使用，扩容无需加锁；need 不超过 UP_TX_KEEP_MAX
+static char *up_txbuf_reserve(up_txbuf_t *tb, size_t need) {
+    if (need <= tb->cap) return tb->buf;
+    size_t cap = tb->cap ? tb->cap : UP_TX_INIT_CAP;
+    while (cap < need) cap *= 2;
+    char *buf = heap_caps_realloc(tb->buf, cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) return NULL;
+    tb->buf = buf;
+    tb->cap = cap;
+    return buf;
+}
+
+static bool validate_cb(void *ctx, const sdui_json_event_t *ev) {
+    (void)ctx;
+    (void)ev;
+    return true;
+}
+
+static bool json_valid(const char *text, size_t len) {
+    return sdui_json_parse(text, len, SDUI_JSON_STR_NONE, validate_cb, NULL);
+}
+
+static void lanes_start(void);
 
 void sdui_bus_init(void) {
-    sub_count = 0;
+    bus_lock();
+    node_free(s_root);
+    s_root = NULL;
+    bus_unlock();
+    lanes_start();
     ESP_LOGI(TAG, "SDUI Bus Initialized");
 }
 
@@ -28,93 +490,884 @@ void sdui_bus_set_device_id(const char *device_id) {
     if (!device_id) return;
     strncpy(s_device_id, device_id, sizeof(s_device_id) - 1);
     s_device_id[sizeof(s_device_id) - 1] = '\0';
+    s_device_part_len = 0;
+    if (s_device_id[0]) {
+        size_t n = json_escape(NULL, s_device_id, strlen(s_device_id));
+        if (n + 16 <= sizeof(s_device_part)) {
+            char *p = s_device_part;
+            memcpy(p, "\"device_id\":\"", 13);
+            p += 13;
+            p += json_escape(p, s_device_id, strlen(s_device_id));
+            memcpy(p, "\",", 2);
+            s_device_part_len = (size_t)(p + 2 - s_device_part);
+        }
+    }
     ESP_LOGI(TAG, "Device ID registered: %s", s_device_id);
 }
 
 void sdui_bus_subscribe(const char *topic, sdui_bus_cb_t cb) {
-    if (sub_count < MAX_SUBSCRIBERS) {
-        strncpy(subscribers[sub_count].topic, topic, sizeof(subscribers[sub_count].topic) - 1);
-        subscribers[sub_count].topic[sizeof(subscribers[sub_count].topic) - 1] = '\0';
-        subscribers[sub_count].cb = cb;
-        sub_count++;
-        ESP_LOGI(TAG, "Subscribed to topic: %s", topic);
-    } else {
-        ESP_LOGE(TAG, "Failed to subscribe %s: Max subscribers reached!", topic);
+    bus_add(topic, BUS_CB_TEXT, (bus_fn_t){.text = cb});
+}
+
+void sdui_bus_subscribe_slice(const char *topic, sdui_bus_slice_cb_t cb) {
+    bus_add(topic, BUS_CB_SLICE, (bus_fn_t){.slice = cb});
+}
+
+void sdui_bus_subscribe_json(const char *topic, sdui_bus_json_cb_t cb) {
+    bus_add(topic, BUS_CB_JSON, (bus_fn_t){.json = cb});
+}
+
+void sdui_bus_subscribe_bin(const char *topic, sdui_bus_bin_cb_t cb) {
+    bus_add(topic, BUS_CB_BIN, (bus_fn_t){.bin = cb});
+}
+
+bool sdui_bus_unsubscribe(const char *topic, sdui_bus_cb_t cb) {
+    return bus_remove(topic, BUS_CB_TEXT, (bus_fn_t){.text = cb});
+}
+
+bool sdui_bus_unsubscribe_slice(const char *topic, sdui_bus_slice_cb_t cb) {
+    return bus_remove(topic, BUS_CB_SLICE, (bus_fn_t){.slice = cb});
+}
+
+bool sdui_bus_unsubscribe_json(const char *topic, sdui_bus_json_cb_t cb) {
+    return bus_remove(topic, BUS_CB_JSON, (bus_fn_t){.json = cb});
+}
+
+bool sdui_bus_unsubscribe_bin(const char *topic, sdui_bus_bin_cb_t cb) {
+    return bus_remove(topic, BUS_CB_BIN, (bus_fn_t){.bin = cb});
+}
+
+static void bin_topics_walk(const bus_node_t *n, const char **topics, int max, int *count) {
+    for (const bus_sub_t *s = n->subs; s; s = s->next) {
+        if (s->kind == BUS_CB_BIN) {
+            if (*count < max) topics[(*count)++] = n->path;
+            break;
+        }
     }
+    for (size_t i = 0; i < n->n_kids && *count < max; i++) bin_topics_walk(n->kids[i], topics, max, count);
+    if (n->plus && *count < max) bin_topics_walk(n->plus, topics, max, count);
+    if (n->hash && *count < max) bin_topics_walk(n->hash, topics, max, count);
 }
 
-void sdui_bus_route_down(const char *raw_json) {
-    // 第一层浅解析，仅拆包封套
-    cJSON *root = cJSON_Parse(raw_json);
-    if (!root) {
-        ESP_LOGW(TAG, "Failed to parse incoming SDUI payload");
+int sdui_bus_get_bin_topics(const char **topics, int max) {
+    int n = 0;
+    bus_lock();
+    if (s_root && topics && max > 0) bin_topics_walk(s_root, topics, max, &n);
+    bus_unlock();
+    return n;
+}
+
+/* ======================================================
+ * 下行信封
+ *
+ * 信封 {"topic": "...", "payload": ..., "seq": n, "ts": t} 只有一层成员，原地扫描一遍：
+ * 字符串只找闭引号，对象 / 数组只数括号深度（跳过字符串内部），不建 DOM、不反转义、
+ * 不拷贝。payload 内部的语法由订阅者自己的解析器校验。
+ *
+ * 分发时按订阅方式交付同一条消息：
+ *   slice : 指向原文的 (ptr, len)，零拷贝（字符串 payload 含转义时才反转义一份）
+ *   text  : '\0' 结尾拷贝，首个 text 订阅者出现时生成一次，所有 text 订阅者共用
+ *   json  : payload 原文解析一次，所有 json 订阅者共用同一节点
+ * 开启分发通道时以上借用的都是入队时拷贝的那一份（见下文分发通道）。
+ * ====================================================== */
+typedef struct {
+    const char *topic;       // 切片，不以 '\0' 结尾
+    size_t      topic_len;
+    bool        topic_esc;   // 含转义，需反转义后再匹配
+    const char *pl_raw;      // payload 原文 token（字符串含引号）；NULL 为无 payload
+    size_t      pl_raw_len;
+    bool        pl_esc;      // 字符串 payload 含转义
+    int64_t     seq;         // 服务端消息序号，计时记录原样回传；-1 为无
+    double      ts;          // 服务端发送时刻，0 为无
+} bus_envelope_t;
+
+// 一条待交付的消息：各形式按需生成，同一消息的订阅者共用
+typedef struct {
+    const char *data;        // 交付给 slice 订阅者的内容（借用）
+    size_t      len;
+    const char *raw;         // payload JSON 原文；NULL 表示 data 是纯文本（publish_local）
+    size_t      raw_len;
+    const char *text;        // '\0' 结尾形式；data 本身以 '\0' 结尾时直接借用
+    char       *text_own;
+    cJSON      *json;
+    bool        json_done;
+} bus_msg_t;
+
+static const char *skip_ws(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) p++;
+    return p;
+}
+
+// p 指向开引号；返回闭引号之后的位置，未闭合返回 NULL
+static const char *scan_string(const char *p, const char *end, bool *esc) {
+    for (p++; p < end; p++) {
+        if (*p == '"') return p + 1;
+        if (*p == '\\') {
+            *esc = true;
+            if (++p == end) break;
+        }
+    }
+    return NULL;
+}
+
+// 跳过一个值（不校验内部语法），返回其后的位置
+static const char *scan_value(const char *p, const char *end, bool *esc) {
+    if (*p == '"') return scan_string(p, end, esc);
+    if (*p == '{' || *p == '[') {
+        int depth = 0;
+        for (; p < end; p++) {
+            char c = *p;
+            if (c == '"') {
+                bool inner = false;
+                p = scan_string(p, end, &inner);
+                if (!p) return NULL;
+                p--;
+            } else if (c == '{' || c == '[') {
+                depth++;
+            } else if ((c == '}' || c == ']') && --depth == 0) {
+                return p + 1;
+            }
+        }
+        return NULL;
+    }
+    const char *start = p;
+    while (p < end && *p != ',' && *p != '}' && *p != ']' &&
+           *p != ' ' && *p != '\t' && *p != '\n' && *p != '\r') p++;
+    return p > start ? p : NULL;
+}
+
+static bool key_is(const char *k, size_t len, const char *name) {
+    return strlen(name) == len && memcmp(k, name, len) == 0;
+}
+
+static bool scan_number(const char *p, size_t len, double *out) {
+    char buf[32];
+    if (!len || len >= sizeof(buf)) return false;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    char *e;
+    *out = strtod(buf, &e);
+    return *e == '\0';
+}
+
+static bool envelope_scan(const char *json, size_t len, bus_envelope_t *env) {
+    const char *p = json, *end = json + len;
+    p = skip_ws(p, end);
+    if (p == end || *p != '{') return false;
+    p = skip_ws(p + 1, end);
+    if (p < end && *p == '}') return skip_ws(p + 1, end) == end;
+
+    for (;;) {
+        bool key_esc = false, val_esc = false;
+        if (p == end || *p != '"') return false;
+        const char *k  = p + 1;
+        const char *ke = scan_string(p, end, &key_esc);
+        if (!ke) return false;
+        p = skip_ws(ke, end);
+        if (p == end || *p != ':') return false;
+        p = skip_ws(p + 1, end);
+        if (p == end) return false;
+        const char *v  = p;
+        const char *ve = scan_value(v, end, &val_esc);
+        if (!ve) return false;
+
+        size_t klen = (size_t)(ke - 1 - k);
+        double num;
+        if (key_is(k, klen, "topic") && *v == '"') {
+            env->topic     = v + 1;
+            env->topic_len = (size_t)(ve - v) - 2;
+            env->topic_esc = val_esc;
+        } else if (key_is(k, klen, "payload")) {
+            env->pl_raw     = v;
+            env->pl_raw_len = (size_t)(ve - v);
+            env->pl_esc     = val_esc;
+        } else if (key_is(k, klen, "seq") && scan_number(v, (size_t)(ve - v), &num)) {
+            env->seq = (int64_t)num;
+        } else if (key_is(k, klen, "ts") && scan_number(v, (size_t)(ve - v), &num)) {
+            env->ts = num;
+        }
+
+        p = skip_ws(ve, end);
+        if (p < end && *p == ',') {
+            p = skip_ws(p + 1, end);
+            continue;
+        }
+        if (p < end && *p == '}') return skip_ws(p + 1, end) == end;
+        return false;
+    }
+}
+
+static bool unescape_cb(void *ctx, const sdui_json_event_t *ev) {
+    char **out = ctx;
+    if (ev->type != SDUI_JSON_STRING || !ev->str) return false;
+    *out = malloc(ev->len + 1);
+    if (!*out) return false;
+    memcpy(*out, ev->str, ev->len + 1);
+    return true;
+}
+
+// 反转义一个字符串 token（含引号）为堆上的 '\0' 结尾拷贝；失败返回 NULL
+static char *unescape_token(const char *tok, size_t len) {
+    char *out = NULL;
+    if (!sdui_json_parse(tok, len, 0, unescape_cb, &out)) {
+        free(out);
+        return NULL;
+    }
+    return out;
+}
+
+static const char *msg_text(bus_msg_t *m) {
+    if (m->text || !m->data) return m->text;
+    m->text_own = malloc(m->len + 1);
+    if (!m->text_own) {
+        ESP_LOGE(TAG, "payload alloc failed (%u bytes)", (unsigned)m->len);
+        return NULL;
+    }
+    memcpy(m->text_own, m->data, m->len);
+    m->text_own[m->len] = '\0';
+    m->text = m->text_own;
+    return m->text;
+}
+
+static const cJSON *msg_json(bus_msg_t *m) {
+    if (m->json_done) return m->json;
+    m->json_done = true;
+    if (m->raw) {
+        m->json = cJSON_ParseWithLength(m->raw, m->raw_len);
+    } else if (m->data) {
+        // 本地发布的 payload 可能是 JSON，也可能是纯文本
+        m->json = cJSON_ParseWithLength(m->data, m->len);
+        if (!m->json) m->json = cJSON_CreateString(msg_text(m));
+    }
+    return m->json;
+}
+
+static void bus_deliver(const bus_hits_t *h, bus_msg_t *m) {
+    for (size_t i = 0; i < h->n; i++) {
+        switch (h->v[i].kind) {
+        case BUS_CB_TEXT:  h->v[i].fn.text(msg_text(m)); break;
+        case BUS_CB_SLICE: h->v[i].fn.slice(m->data, m->len); break;
+        case BUS_CB_JSON:  h->v[i].fn.json(msg_json(m)); break;
+        case BUS_CB_BIN:   break;
+        }
+    }
+    free(m->text_own);
+    cJSON_Delete(m->json);
+}
+
+// 按订阅方式分发一条文本消息（调用任务中同步回调）
+static void bus_dispatch(const char *topic, size_t topic_len, bus_msg_t *m) {
+    bus_hits_t hits;
+    bus_collect(topic, topic_len, false, &hits);
+    bus_deliver(&hits, m);
+    if (!hits.n) ESP_LOGD(TAG, "No subscriber for %.*s", (int)topic_len, topic);
+    hits_free(&hits);
+}
+
+static void bus_dispatch_bin(const char *topic, size_t topic_len, const uint8_t *payload, size_t len) {
+    bus_hits_t hits;
+    bus_collect(topic, topic_len, true, &hits);
+    for (size_t i = 0; i < hits.n; i++) hits.v[i].fn.bin(payload, len);
+    bool routed = hits.n > 0;
+    hits_free(&hits);
+    if (!routed) ESP_LOGW(TAG, "No binary subscriber for %.*s", (int)topic_len, topic);
+}
+
+/* ======================================================
+ * 分发通道
+ *
+ * 每个通道一个有界环形队列加一个任务。WebSocket 事件任务拆完信封后把主题、payload 原文
+ * （以及反转义结果）拷进一块连续内存入队，通知通道任务；通道任务按到达顺序出队，
+ * 在自己的栈上收集订阅者并回调，计时记录随消息交给通道任务（sdui_perf_detach / adopt）。
+ *
+ * 队列满时按新消息所属规则的溢出策略处理（sdui_bus_overflow_t）：
+ *   - COALESCE：新消息完整取代旧消息（ui/layout），丢弃排队中的同主题消息；
+ *   - DROP：可丢弃的流（audio/play 与未列出的主题），挤掉通道内最早一条 DROP 消息，没有则丢弃新消息；
+ *   - MERGE：批量主题（ui/update、state/set、font/glyphs），把相邻两条同主题消息合成一个数组批次；
+ *   - 其余情况阻塞投递方直到通道任务取走一条，超时才丢弃新消息并记错误。
+ * 投递方是 WebSocket 事件任务，它阻塞时后面的音频块也读不进来，所以缺省规则让常见主题都不阻塞，
+ * 阻塞上限也远小于一个音频块的时长。只有 DROP / COALESCE 消息会被挤掉，MERGE 只合并相邻的两条；
+ * 之后的排队消息前移，新消息排在队尾，通道内仍保持到达顺序。
+ * ====================================================== */
+static const char *const s_lane_names[SDUI_BUS_LANE_COUNT] = {"realtime", "interactive", "background"};
+
+#if CONFIG_SDUI_BUS_LANES
+
+#define LANE_RULES_MAX  16
+
+#ifndef CONFIG_SDUI_BUS_LANE_BLOCK_MS
+#define CONFIG_SDUI_BUS_LANE_BLOCK_MS 5
+#endif
+
+// 排队中的消息：msg 内的指针都指向 buf
+typedef struct {
+    int64_t   t_post;      // 入队时刻 (μs)
+    int64_t   seq;         // 计时记录用的信封 seq / ts 与原始帧长度
+    double    ts;
+    uint32_t  bytes;
+    uint32_t  perf_id;
+    uint8_t   overflow;    // sdui_bus_overflow_t
+    bool      bin;         // 二进制帧：payload 在 msg.data / msg.len
+    size_t    topic_len;
+    bus_msg_t msg;
+    char      buf[];       // topic '\0' | payload 原文 '\0' | 不在原文内的 payload '\0'
+} bus_qmsg_t;
+
+typedef struct {
+    const char           *task_name;
+    uint16_t              cap;
+    uint8_t               prio;
+    int8_t                core;          // -1 为不绑核
+    bus_qmsg_t          **ring;
+    uint16_t              head;
+    uint16_t              count;
+    uint16_t              waiters;       // 因队列满而等待的投递方
+    SemaphoreHandle_t     lock;
+    SemaphoreHandle_t     space;         // 出队时通知等待的投递方
+    TaskHandle_t          task;          // NULL 表示通道未启动，消息同步分发
+    sdui_bus_lane_stats_t stats;
+} bus_lane_t;
+
+typedef struct {
+    char               *filter;
+    sdui_bus_lane_t     lane;
+    sdui_bus_overflow_t overflow;
+} lane_rule_t;
+
+static bus_lane_t s_lanes[SDUI_BUS_LANE_COUNT] = {
+    [SDUI_BUS_LANE_REALTIME]    = {"bus_rt", CONFIG_SDUI_BUS_LANE_RT_DEPTH, CONFIG_SDUI_BUS_LANE_RT_PRIO,
+                                   CONFIG_SDUI_BUS_LANE_RT_CORE},
+    [SDUI_BUS_LANE_INTERACTIVE] = {"bus_ui", CONFIG_SDUI_BUS_LANE_UI_DEPTH, CONFIG_SDUI_BUS_LANE_UI_PRIO,
+                                   CONFIG_SDUI_BUS_LANE_UI_CORE},
+    [SDUI_BUS_LANE_BACKGROUND]  = {"bus_bg", CONFIG_SDUI_BUS_LANE_BG_DEPTH, CONFIG_SDUI_BUS_LANE_BG_PRIO,
+                                   CONFIG_SDUI_BUS_LANE_BG_CORE},
+};
+
+static lane_rule_t s_lane_rules[LANE_RULES_MAX];   // 按优先级排列，持 s_lock 访问
+static int         s_lane_rule_n = 0;
+
+// filter 为订阅写法（'\0' 结尾），topic 为长度 len 的主题
+static bool filter_match(const char *f, const char *t, size_t len) {
+    const char *end = t + len;
+    for (;;) {
+        if (f[0] == '#' && f[1] == '\0') return true;
+        const char *fs  = strchr(f, '/');
+        size_t      fl  = fs ? (size_t)(fs - f) : strlen(f);
+        const char *ts  = memchr(t, '/', (size_t)(end - t));
+        size_t      tl  = (size_t)((ts ? ts : end) - t);
+        bool        any = fl == 1 && f[0] == '+';
+        if (!any && (fl != tl || memcmp(f, t, fl) != 0)) return false;
+        if (!fs) return !ts;
+        if (!ts) return strcmp(fs + 1, "#") == 0;   // "a/#" 也匹配 "a"
+        f = fs + 1;
+        t = ts + 1;
+    }
+}
+
+static void lane_rule_set(const char *filter, sdui_bus_lane_t lane, sdui_bus_overflow_t overflow) {
+    for (int i = 0; i < s_lane_rule_n; i++) {
+        if (strcmp(s_lane_rules[i].filter, filter) == 0) {
+            s_lane_rules[i].lane     = lane;
+            s_lane_rules[i].overflow = overflow;
+            return;
+        }
+    }
+    if (s_lane_rule_n == LANE_RULES_MAX) {
+        ESP_LOGE(TAG, "Lane rule table full, ignore %s", filter);
         return;
     }
+    char *copy = strdup(filter);
+    if (!copy) return;
+    memmove(&s_lane_rules[1], &s_lane_rules[0], s_lane_rule_n * sizeof(s_lane_rules[0]));   // 新规则优先
+    s_lane_rules[0] = (lane_rule_t){copy, lane, overflow};
+    s_lane_rule_n++;
+}
+
+static bus_lane_t *lane_of(const char *topic, size_t len, sdui_bus_overflow_t *overflow) {
+    sdui_bus_lane_t lane = SDUI_BUS_LANE_BACKGROUND;
+    *overflow = SDUI_BUS_OVERFLOW_BLOCK;
+    bus_lock();
+    for (int i = 0; i < s_lane_rule_n; i++) {
+        if (filter_match(s_lane_rules[i].filter, topic, len)) {
+            lane      = s_lane_rules[i].lane;
+            *overflow = s_lane_rules[i].overflow;
+            break;
+        }
+    }
+    bus_unlock();
+    return &s_lanes[lane];
+}
+
+static bool qmsg_same_topic(const bus_qmsg_t *a, const bus_qmsg_t *b) {
+    return a->bin == b->bin && a->topic_len == b->topic_len && memcmp(a->buf, b->buf, a->topic_len) == 0;
+}
+
+// 队列满时可为 q 腾出的一格：自队头起的位置，没有返回 -1
+static int lane_victim(const bus_lane_t *ln, const bus_qmsg_t *q) {
+    for (uint16_t i = 0; i < ln->count; i++) {
+        const bus_qmsg_t *o = ln->ring[(ln->head + i) % ln->cap];
+        if (q->overflow == SDUI_BUS_OVERFLOW_COALESCE && o->overflow == SDUI_BUS_OVERFLOW_COALESCE &&
+            qmsg_same_topic(o, q)) return i;
+        if (q->overflow == SDUI_BUS_OVERFLOW_DROP && o->overflow == SDUI_BUS_OVERFLOW_DROP) return i;
+    }
+    return -1;
+}
+
+// payload 原文中可并入批次的部分：对象原样，数组去掉一层方括号；其他 JSON 值返回 false
+static bool batch_items(const bus_qmsg_t *q, const char **p, size_t *n) {
+    if (q->bin || q->overflow != SDUI_BUS_OVERFLOW_MERGE || !q->msg.raw) return false;
+    const char *b = skip_ws(q->msg.raw, q->msg.raw + q->msg.raw_len);
+    const char *e = q->msg.raw + q->msg.raw_len;
+    while (e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\n' || e[-1] == '\r')) e--;
+    if (e - b < 2 || !((*b == '{' && e[-1] == '}') || (*b == '[' && e[-1] == ']'))) return false;
+    if (*b == '[') {
+        b = skip_ws(b + 1, e - 1);
+        for (e--; e > b && (e[-1] == ' ' || e[-1] == '\t' || e[-1] == '\n' || e[-1] == '\r'); e--) {}
+    }
+    *p = b;
+    *n = (size_t)(e - b);
+    return true;
+}
 
-    cJSON *topic_item = cJSON_GetObjectItem(root, "topic");
-    cJSON *payload_item = cJSON_GetObjectItem(root, "payload");
+/**
+ * 把 y 并入排队中第 k 条消息（自队头起）：两者的 payload 合成 "[旧, 新]"，第 k 条换成合并后的消息，
+ * 保留它的入队时刻与计时记录。两条不可合并或内存不足时返回 false。持通道锁调用。
+ */
+static bool lane_merge_at(bus_lane_t *ln, uint16_t k, const bus_qmsg_t *y) {
+    bus_qmsg_t **slot = &ln->ring[(ln->head + k) % ln->cap];
+    bus_qmsg_t  *x    = *slot;
+    const char  *a, *b;
+    size_t       an, bn;
+    if (!qmsg_same_topic(x, y) || !batch_items(x, &a, &an) || !batch_items(y, &b, &bn)) return false;
 
-    if (topic_item && cJSON_IsString(topic_item)) {
-        const char *topic = topic_item->valuestring;
-        char *payload_str = NULL;
+    size_t      len = 1 + an + 1 + bn + 1;
+    bus_qmsg_t *m   = heap_caps_malloc(sizeof(*m) + x->topic_len + 1 + len + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!m) return false;
+    *m = *x;
+    memcpy(m->buf, x->buf, x->topic_len + 1);
+    char *p = m->buf + x->topic_len + 1, *w = p;
+    *w++ = '[';
+    memcpy(w, a, an);
+    w += an;
+    if (an && bn) *w++ = ',';   // 空数组不留多余的逗号
+    memcpy(w, b, bn);
+    w += bn;
+    *w++ = ']';
+    *w   = '\0';
+    m->msg.raw = m->msg.data = m->msg.text = p;
+    m->msg.raw_len = m->msg.len = (size_t)(w - p);
+    heap_caps_free(x);
+    *slot = m;
+    return true;
+}
 
-        if (payload_item) {
-            // 将 payload 提取为字符串，交由下游业务自行处理
-            if (cJSON_IsString(payload_item)) {
-                payload_str = strdup(payload_item->valuestring);
-            } else {
-                payload_str = cJSON_PrintUnformatted(payload_item);
+// 合并相邻的两条消息腾出一格：先试队尾与 q，再自队头找相邻的一对。
+// 返回被并入前一条的消息（q 或已移出队列的那条），由调用方释放；没有可合并的返回 NULL
+static bus_qmsg_t *lane_merge(bus_lane_t *ln, bus_qmsg_t *q) {
+    if (lane_merge_at(ln, ln->count - 1, q)) return q;
+    for (uint16_t i = 0; i + 1 < ln->count; i++) {
+        bus_qmsg_t *y = ln->ring[(ln->head + i + 1) % ln->cap];
+        if (!lane_merge_at(ln, i, y)) continue;
+        for (uint16_t j = i + 1; j + 1 < ln->count; j++) {
+            ln->ring[(ln->head + j) % ln->cap] = ln->ring[(ln->head + j + 1) % ln->cap];
+        }
+        ln->count--;
+        return y;
+    }
+    return NULL;
+}
+
+/**
+ * 入队；队列满时按 q 的溢出策略挤掉一条、合并相邻两条、丢弃 q 或等待通道任务腾位。
+ * 返回被挤掉、被合并或未能入队的消息（由调用方在锁外释放），全部入队时返回 NULL；
+ * 返回的消息已并入相邻消息时 *merged 为 true。
+ */
+static bus_qmsg_t *lane_push(bus_lane_t *ln, bus_qmsg_t *q, bool *merged) {
+    bus_qmsg_t *victim  = NULL;
+    int64_t     t_block = 0;
+    TickType_t  budget  = pdMS_TO_TICKS(CONFIG_SDUI_BUS_LANE_BLOCK_MS);
+    xSemaphoreTake(ln->lock, portMAX_DELAY);
+    while (ln->count == ln->cap) {
+        int k = lane_victim(ln, q);
+        if (k >= 0) {
+            victim = ln->ring[(ln->head + k) % ln->cap];
+            if (q->overflow == SDUI_BUS_OVERFLOW_COALESCE) ln->stats.coalesced++;
+            else                                           ln->stats.dropped++;
+            for (uint16_t i = (uint16_t)k; i + 1 < ln->count; i++) {
+                ln->ring[(ln->head + i) % ln->cap] = ln->ring[(ln->head + i + 1) % ln->cap];
+            }
+            ln->count--;
+            break;
+        }
+        if (q->overflow == SDUI_BUS_OVERFLOW_MERGE && (victim = lane_merge(ln, q)) != NULL) {
+            ln->stats.coalesced++;
+            *merged = true;
+            if (victim == q) {
+                xSemaphoreGive(ln->lock);
+                return q;
             }
+            break;
+        }
+        if (q->overflow == SDUI_BUS_OVERFLOW_DROP || !budget) {
+            ln->stats.dropped++;
+            xSemaphoreGive(ln->lock);
+            return q;
         }
 
-        // 路由分发机制
-        for (int i = 0; i < sub_count; i++) {
-            if (strcmp(subscribers[i].topic, topic) == 0) {
-                if (subscribers[i].cb) {
-                    subscribers[i].cb(payload_str);
-                }
+        // 等待通道任务取走一条：投递方（WebSocket 事件任务）随之停止读取，形成背压，
+        // 其他通道（包括实时通道）的消息也一起等待，因此上限很短
+        if (!t_block) {
+            t_block = esp_timer_get_time();
+            ln->stats.blocked++;
+        }
+        ln->waiters++;
+        xSemaphoreGive(ln->lock);
+        TickType_t t0 = xTaskGetTickCount();
+        BaseType_t ok = xSemaphoreTake(ln->space, budget);
+        TickType_t dt = xTaskGetTickCount() - t0;
+        budget = ok == pdTRUE && dt < budget ? budget - dt : 0;
+        xSemaphoreTake(ln->lock, portMAX_DELAY);
+        ln->waiters--;
+    }
+    if (t_block) {
+        int64_t  blk = esp_timer_get_time() - t_block;
+        uint32_t us  = blk > UINT32_MAX ? UINT32_MAX : (uint32_t)blk;
+        if (us > ln->stats.block_us_max) ln->stats.block_us_max = us;
+    }
+    ln->ring[(ln->head + ln->count) % ln->cap] = q;
+    ln->count++;
+    ln->stats.enqueued++;
+    ln->stats.depth = ln->count;
+    if (ln->count > ln->stats.depth_max) ln->stats.depth_max = ln->count;
+    xSemaphoreGive(ln->lock);
+    return victim;
+}
+
+static bus_qmsg_t *lane_pop(bus_lane_t *ln) {
+    bus_qmsg_t *q = NULL;
+    xSemaphoreTake(ln->lock, portMAX_DELAY);
+    if (ln->count) {
+        q        = ln->ring[ln->head];
+        ln->head = (ln->head + 1) % ln->cap;
+        ln->count--;
+        ln->stats.depth = ln->count;
+
+        int64_t  wait = esp_timer_get_time() - q->t_post;
+        uint32_t us   = wait > UINT32_MAX ? UINT32_MAX : (uint32_t)wait;
+        ln->stats.delivered++;
+        ln->stats.wait_us_last = us;
+        ln->stats.wait_us_sum += us;
+        if (us > ln->stats.wait_us_max) ln->stats.wait_us_max = us;
+        if (ln->waiters) xSemaphoreGive(ln->space);
+    }
+    xSemaphoreGive(ln->lock);
+    return q;
+}
+
+static void lane_task(void *arg) {
+    bus_lane_t *ln = arg;
+    while (1) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        bus_qmsg_t *q;
+        while ((q = lane_pop(ln)) != NULL) {
+            sdui_perf_adopt(q->perf_id);
+            sdui_perf_routed(q->buf, q->topic_len, q->bytes, q->seq, q->ts);   // route 段含排队时间
+            if (q->bin) bus_dispatch_bin(q->buf, q->topic_len, (const uint8_t *)q->msg.data, q->msg.len);
+            else        bus_dispatch(q->buf, q->topic_len, &q->msg);
+            sdui_perf_end();
+            heap_caps_free(q);
+        }
+    }
+}
+
+// 拷贝消息并投递到主题所属通道；通道未启动时返回 false，由调用方同步分发
+static bool lane_post(const char *topic, size_t topic_len, const bus_msg_t *m, bool bin,
+                      size_t bytes, int64_t seq, double ts) {
+    sdui_bus_overflow_t overflow;
+    bus_lane_t         *ln = lane_of(topic, topic_len, &overflow);
+    // 通道任务内再投递本通道（订阅者转发下行消息）时同步回调，避免等待自己腾位
+    if (!ln->task || ln->task == xTaskGetCurrentTaskHandle()) return false;
+
+    // payload 切片落在原文内时只拷原文，否则（反转义结果、二进制 payload）另拷一份
+    bool   in_raw = m->raw && m->data >= m->raw && m->data + m->len <= m->raw + m->raw_len;
+    size_t raw_sz = m->raw ? m->raw_len + 1 : 0;
+    size_t dat_sz = (m->data && !in_raw) ? m->len + 1 : 0;
+    bus_qmsg_t *q = heap_caps_malloc(sizeof(*q) + topic_len + 1 + raw_sz + dat_sz,
+                                     MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!q) {
+        xSemaphoreTake(ln->lock, portMAX_DELAY);
+        ln->stats.dropped++;
+        xSemaphoreGive(ln->lock);
+        ESP_LOGE(TAG, "Lane %s: no memory for %.*s (%u bytes), dropped", s_lane_names[ln - s_lanes],
+                 (int)topic_len, topic, (unsigned)bytes);
+        return true;
+    }
+
+    memset(q, 0, sizeof(*q));
+    q->seq       = seq;
+    q->ts        = ts;
+    q->bytes     = (uint32_t)bytes;
+    q->overflow  = (uint8_t)overflow;
+    q->bin       = bin;
+    q->topic_len = topic_len;
+    char *p = q->buf;
+    memcpy(p, topic, topic_len);
+    p[topic_len] = '\0';
+    p += topic_len + 1;
+    if (m->raw) {
+        memcpy(p, m->raw, m->raw_len);
+        p[m->raw_len] = '\0';
+        q->msg.raw     = p;
+        q->msg.raw_len = m->raw_len;
+        if (in_raw) q->msg.data = p + (m->data - m->raw);
+        p += raw_sz;
+    }
+    if (dat_sz) {
+        memcpy(p, m->data, m->len);
+        p[m->len] = '\0';
+        q->msg.data = p;
+    }
+    q->msg.len = m->len;
+    if (q->msg.data && q->msg.data[q->msg.len] == '\0') q->msg.text = q->msg.data;   // text 订阅者直接借用
+
+    q->perf_id = sdui_perf_detach();
+    q->t_post  = esp_timer_get_time();
+    bool        merged = false;
+    bus_qmsg_t *victim = lane_push(ln, q, &merged);
+    if (victim != q) xTaskNotifyGive(ln->task);
+    if (merged) {
+        ESP_LOGD(TAG, "Lane %s full, merged %.*s into a batch", s_lane_names[ln - s_lanes], (int)topic_len, topic);
+    } else if (victim == q && overflow != SDUI_BUS_OVERFLOW_DROP) {
+        ESP_LOGE(TAG, "Lane %s blocked for %d ms, dropped %.*s (%u bytes)", s_lane_names[ln - s_lanes],
+                 CONFIG_SDUI_BUS_LANE_BLOCK_MS, (int)topic_len, topic, (unsigned)bytes);
+    } else if (victim) {
+        ESP_LOGW(TAG, "Lane %s full, %s %.*s", s_lane_names[ln - s_lanes],
+                 overflow == SDUI_BUS_OVERFLOW_COALESCE ? "superseded" : "dropped",
+                 (int)victim->topic_len, victim->buf);
+    }
+    if (victim) {
+        sdui_perf_drop(victim->perf_id);
+        heap_caps_free(victim);
+    }
+    return true;
+}
+
+static void lanes_start(void) {
+    bus_lock();
+    if (!s_lane_rule_n) {
+        // 只有被新消息完整取代的主题可丢弃或合并；font/# 要写 SPIFFS，放在后台
+        lane_rule_set("#",           SDUI_BUS_LANE_BACKGROUND,  SDUI_BUS_OVERFLOW_DROP);
+        lane_rule_set("font/glyphs", SDUI_BUS_LANE_BACKGROUND,  SDUI_BUS_OVERFLOW_MERGE);
+        lane_rule_set("state/#",     SDUI_BUS_LANE_INTERACTIVE, SDUI_BUS_OVERFLOW_BLOCK);
+        lane_rule_set("state/set",   SDUI_BUS_LANE_INTERACTIVE, SDUI_BUS_OVERFLOW_MERGE);
+        lane_rule_set("ui/#",        SDUI_BUS_LANE_INTERACTIVE, SDUI_BUS_OVERFLOW_BLOCK);
+        lane_rule_set("ui/update",   SDUI_BUS_LANE_INTERACTIVE, SDUI_BUS_OVERFLOW_MERGE);
+        lane_rule_set("ui/layout",   SDUI_BUS_LANE_INTERACTIVE, SDUI_BUS_OVERFLOW_COALESCE);
+        lane_rule_set("audio/#",     SDUI_BUS_LANE_REALTIME,    SDUI_BUS_OVERFLOW_BLOCK);
+        lane_rule_set("audio/play",  SDUI_BUS_LANE_REALTIME,    SDUI_BUS_OVERFLOW_DROP);
+    }
+    bus_unlock();
+
+    for (int i = 0; i < SDUI_BUS_LANE_COUNT; i++) {
+        bus_lane_t *ln = &s_lanes[i];
+        if (ln->task) continue;
+        ln->stats.capacity = ln->cap;
+        if (!ln->ring)  ln->ring  = heap_caps_calloc(ln->cap, sizeof(*ln->ring), MALLOC_CAP_SPIRAM);
+        if (!ln->lock)  ln->lock  = xSemaphoreCreateMutex();
+        if (!ln->space) ln->space = xSemaphoreCreateBinary();
+        if (!ln->ring || !ln->lock || !ln->space ||
+            xTaskCreatePinnedToCoreWithCaps(lane_task, ln->task_name, CONFIG_SDUI_BUS_LANE_STACK, ln, ln->prio,
+                                            &ln->task, ln->core < 0 ? tskNO_AFFINITY : ln->core,
+                                            MALLOC_CAP_SPIRAM) != pdPASS) {
+            ln->task = NULL;
+            ESP_LOGE(TAG, "Lane %s start failed, its topics are dispatched synchronously", s_lane_names[i]);
+            continue;
+        }
+        ESP_LOGI(TAG, "Lane %s: depth %u, prio %u, core %d", s_lane_names[i], ln->cap, ln->prio, ln->core);
+    }
+}
+
+void sdui_bus_set_lane(const char *topic_filter, sdui_bus_lane_t lane, sdui_bus_overflow_t overflow) {
+    if (!topic_valid(topic_filter) || lane >= SDUI_BUS_LANE_COUNT || overflow > SDUI_BUS_OVERFLOW_MERGE) {
+        ESP_LOGW(TAG, "Invalid lane rule: %s", topic_filter ? topic_filter : "(null)");
+        return;
+    }
+    bus_lock();
+    lane_rule_set(topic_filter, lane, overflow);
+    bus_unlock();
+}
+
+bool sdui_bus_get_lane_stats(sdui_bus_lane_t lane, sdui_bus_lane_stats_t *out) {
+    if (lane >= SDUI_BUS_LANE_COUNT || !out || !s_lanes[lane].task) return false;
+    bus_lane_t *ln = &s_lanes[lane];
+    xSemaphoreTake(ln->lock, portMAX_DELAY);
+    *out = ln->stats;
+    xSemaphoreGive(ln->lock);
+    return true;
+}
+
+#else
+
+static bool lane_post(const char *topic, size_t topic_len, const bus_msg_t *m, bool bin,
+                      size_t bytes, int64_t seq, double ts) {
+    (void)topic; (void)topic_len; (void)m; (void)bin; (void)bytes; (void)seq; (void)ts;
+    return false;
+}
+
+static void lanes_start(void) {}
+
+void sdui_bus_set_lane(const char *topic_filter, sdui_bus_lane_t lane, sdui_bus_overflow_t overflow) {
+    (void)topic_filter; (void)lane; (void)overflow;
+}
+
+bool sdui_bus_get_lane_stats(sdui_bus_lane_t lane, sdui_bus_lane_stats_t *out) {
+    (void)lane; (void)out;
+    return false;
+}
+
+#endif /* CONFIG_SDUI_BUS_LANES */
+
+const char *sdui_bus_lane_name(sdui_bus_lane_t lane) {
+    return lane < SDUI_BUS_LANE_COUNT ? s_lane_names[lane] : "";
+}
+
+void sdui_bus_route_down(const char *raw_json) {
+    if (!raw_json) return;
+
+    size_t         len = strlen(raw_json);
+    bus_envelope_t env = {.seq = -1};
+    if (!envelope_scan(raw_json, len, &env) || !env.topic) {
+        ESP_LOGW(TAG, "Failed to parse incoming SDUI payload");
+        return;
+    }
+
+    // 主题与字符串 payload 只在含转义时才反转义出一份拷贝
+    const char *topic     = env.topic;
+    size_t      topic_len = env.topic_len;
+    char       *topic_own = NULL;
+    if (env.topic_esc) {
+        topic_own = unescape_token(env.topic - 1, env.topic_len + 2);
+        if (!topic_own) {
+            ESP_LOGW(TAG, "Invalid topic string in SDUI payload");
+            return;
+        }
+        topic     = topic_own;
+        topic_len = strlen(topic_own);
+    }
+
+    bus_msg_t msg = {.raw = env.pl_raw, .raw_len = env.pl_raw_len};
+    char     *pl_own = NULL;
+    if (env.pl_raw && *env.pl_raw == '"') {
+        if (env.pl_esc) {
+            pl_own = unescape_token(env.pl_raw, env.pl_raw_len);
+            if (!pl_own) {
+                ESP_LOGW(TAG, "Invalid payload string for %.*s", (int)topic_len, topic);
+                free(topic_own);
+                return;
             }
+            msg.data = msg.text = pl_own;
+            msg.len  = strlen(pl_own);
+        } else {
+            msg.data = env.pl_raw + 1;
+            msg.len  = env.pl_raw_len - 2;
         }
-        
-        if (payload_str) free(payload_str);
+    } else {
+        // 对象 / 数组 / 数字 / 布尔 / null 均交付原文
+        msg.data = env.pl_raw;
+        msg.len  = env.pl_raw_len;
+    }
+
+    // 路由分发机制：投递到所属通道，通道未启用时在本任务中同步回调
+    if (!lane_post(topic, topic_len, &msg, false, len, env.seq, env.ts)) {
+        sdui_perf_routed(topic, topic_len, len, env.seq, env.ts);
+        bus_dispatch(topic, topic_len, &msg);
+    }
+
+    free(pl_own);
+    free(topic_own);
+}
+
+void sdui_bus_route_down_bin(const uint8_t *data, size_t len) {
+    // 帧头: 'S' 'B' | 版本 | topic 长度 | topic
+    if (!data || len < 4 || data[0] != SDUI_BUS_BIN_MAGIC0 || data[1] != SDUI_BUS_BIN_MAGIC1 ||
+        data[2] != SDUI_BUS_BIN_VERSION || (size_t)data[3] + 4 > len) {
+        ESP_LOGW(TAG, "Invalid binary frame (%u bytes)", (unsigned)len);
+        return;
+    }
+    const char    *topic       = (const char *)(data + 4);
+    size_t         topic_len   = data[3];
+    const uint8_t *payload     = data + 4 + topic_len;
+    size_t         payload_len = len - 4 - topic_len;
+
+    bus_msg_t msg = {.data = (const char *)payload, .len = payload_len};
+    if (!lane_post(topic, topic_len, &msg, true, len, -1, 0)) {
+        sdui_perf_routed(topic, topic_len, len, -1, 0);   // 二进制帧头不带 seq
+        bus_dispatch_bin(topic, topic_len, payload, payload_len);
     }
-    cJSON_Delete(root);
 }
 
 void sdui_bus_publish_up(const char *topic, const char *payload) {
-    cJSON *root = cJSON_CreateObject();
-    cJSON_AddStringToObject(root, "topic", topic);
-
-    // 自动在封套中附加设备唯一码（若已设置）
-    if (s_device_id[0] != '\0') {
-        cJSON_AddStringToObject(root, "device_id", s_device_id);
-    }
-    
-    // 尝试判断 payload 是否为有效 JSON 以保持结构扁平化
-    cJSON *payload_json = cJSON_Parse(payload);
-    if (payload_json) {
-        cJSON_AddItemToObject(root, "payload", payload_json);
-    } else {
-        cJSON_AddStringToObject(root, "payload", payload ? payload : "");
+    sdui_bus_publish_up_ex(topic, payload, payload ? strlen(payload) : 0, SDUI_BUS_UP_VALIDATE);
+}
+
+void sdui_bus_publish_up_ex(const char *topic, const char *payload, size_t len, uint32_t flags) {
+    if (!topic) return;
+
+    // 缺省 payload 与空串按字符串 "" 嵌入，保持信封是合法 JSON
+    bool as_string = (flags & SDUI_BUS_UP_STRING) || !payload || !len;
+    if (!payload) payload = "";
+    if (!as_string && (flags & SDUI_BUS_UP_VALIDATE)) as_string = !json_valid(payload, len);
+
+    size_t       topic_len = strlen(topic);
+    up_prefix_t *prefix;
+    up_txbuf_t  *tb;
+    bus_lock();
+    prefix = up_prefix_get(topic, topic_len);
+    tb     = up_txbuf_get();
+    bus_unlock();
+
+    size_t pre_len = prefix ? prefix->len : 12 + json_escape(NULL, topic, topic_len);
+    size_t pl_len  = as_string ? 2 + json_escape(NULL, payload, len) : len;
+    size_t need    = pre_len + s_device_part_len + 10 + pl_len + 1;
+    if (need > UP_TX_KEEP_MAX) tb = NULL;   // 超大信封不撑大常驻缓冲区
+
+    char *buf = tb ? up_txbuf_reserve(tb, need)
+                   : heap_caps_malloc(need, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) {
+        ESP_LOGE(TAG, "Uplink buffer alloc failed (%u bytes), drop %s", (unsigned)need, topic);
+        return;
     }
 
-    char *out_str = cJSON_PrintUnformatted(root);
-    if (out_str) {
-        websocket_send_json(out_str); // 调用底层 websocket_manager 发送
-        free(out_str);
+    char *p = buf;
+    if (prefix) {
+        memcpy(p, prefix->text, prefix->len);
+        p += prefix->len;
+    } else {
+        p += up_prefix_render(p, topic, topic_len);
+    }
+    memcpy(p, s_device_part, s_device_part_len);
+    p += s_device_part_len;
+    memcpy(p, "\"payload\":", 10);
+    p += 10;
+    if (as_string) {
+        *p++ = '"';
+        p += json_escape(p, payload, len);
+        *p++ = '"';
+    } else {
+        memcpy(p, payload, len);
+        p += len;
     }
-    cJSON_Delete(root);
+    *p++ = '}';
+
+    websocket_send_text(buf, (size_t)(p - buf));   // 同步发送，返回后缓冲区即可复用
+    if (!tb) heap_caps_free(buf);
 }
 
 void sdui_bus_publish_local(const char *topic, const char *payload) {
     if (!topic) return;
     ESP_LOGI(TAG, "Local publish: topic=%s", topic);
 
-    for (int i = 0; i < sub_count; i++) {
-        if (strcmp(subscribers[i].topic, topic) == 0) {
-            if (subscribers[i].cb) {
-                subscribers[i].cb(payload);
-            }
-        }
-    }
+    // 本地事件始终在调用任务中同步回调，不经分发通道
+    bus_msg_t msg = {.data = payload, .len = payload ? strlen(payload) : 0, .text = payload};
+    bus_dispatch(topic, strlen(topic), &msg);
 }
\ No newline at end of file
@@ -0,0 +1,115 @@
+/**
+ * @file sdui_json.h
+ * @brief SDUI 流式 JSON 词法解析器 (SAX)
+ *
+ * 单遍扫描输入文本，按出现顺序以事件回调报告对象/数组边界与标量值，
+ * 不构建 DOM。解析状态仅为一个深度 ≤ SDUI_JSON_MAX_DEPTH 的容器栈，
+ * 字符串反转义使用一块按需增长的 PSRAM 暂存区（大小 = 最长字符串）。
+ *
+ * 使用者：
+ *   - sdui_bus    : 拆信封，定位 payload 原文区间，无需 Parse + Print
+ *   - sdui_parser : 全量布局由事件边读边创建组件，只缓存当前路径上各节点的属性；
+ *                   增量布局与分片预处理由事件建 DOM，不经过 cJSON_Parse
+ *
+ * 另提供同构的二进制布局编码 (SBL) 解码器 sdui_json_parse_bin()，
+ * 发出与文本解析完全相同的事件序列。
+ */
+#ifndef SDUI_JSON_H
+#define SDUI_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SDUI_JSON_MAX_DEPTH  32   /* 最大容器嵌套深度 */
+#define SDUI_JSON_KEY_MAX    64   /* 键名最大长度（含结尾 '\0'，超长截断） */
+#define SDUI_JSON_STR_ALL    (-1) /* str_depth 取值：反转义所有深度的字符串 */
+#define SDUI_JSON_STR_NONE   (-2) /* str_depth 取值：只校验语法，键名与字符串都不反转义（key 为空串），不申请暂存区 */
+
+/** 事件类型 */
+typedef enum {
+    SDUI_JSON_OBJ_BEGIN = 0,
+    SDUI_JSON_OBJ_END,
+    SDUI_JSON_ARR_BEGIN,
+    SDUI_JSON_ARR_END,
+    SDUI_JSON_STRING,
+    SDUI_JSON_NUMBER,
+    SDUI_JSON_TRUE,
+    SDUI_JSON_FALSE,
+    SDUI_JSON_NULL,
+} sdui_json_type_t;
+
+/** 事件描述（仅在回调期间有效） */
+typedef struct {
+    sdui_json_type_t type;
+    int         depth;    /**< 外层容器数：根值为 0，根对象的成员为 1；BEGIN/END 取容器自身所在深度 */
+    const char *key;      /**< 所在对象中的键名（已反转义）；数组元素、根值与 END 事件为 NULL */
+    const char *str;      /**< STRING：反转义后的内容（'\0' 结尾）；超出 str_depth 时为 NULL */
+    size_t      len;      /**< STRING：str 长度 */
+    double      num;      /**< NUMBER：数值 */
+    const char *raw;      /**< token 在输入中的起始位置；END 事件指向 '}' / ']' */
+    size_t      raw_len;  /**< 标量 token 的原文长度（字符串含引号）；容器事件为 1 */
+} sdui_json_event_t;
+
+/**
+ * @brief 事件回调
+ * @return false 立即中止解析
+ */
+typedef bool (*sdui_json_cb_t)(void *ctx, const sdui_json_event_t *ev);
+
+/**
+ * @brief 流式解析一段 JSON 文本
+ *
+ * 输入须为单个完整 JSON 值（前后允许空白）。语法错误、深度超限、
+ * 内存不足或回调返回 false 时停止并返回 false，已发出的事件不会撤回。
+ *
+ * @param json      输入文本（不要求 '\0' 结尾）
+ * @param len       输入长度
+ * @param str_depth 仅 depth ≤ str_depth 的字符串值会被反转义到 ev->str，
+ *                  更深的字符串只做语法校验（省去大字段如 Base64 的拷贝）；
+ *                  SDUI_JSON_STR_ALL 表示全部，SDUI_JSON_STR_NONE 表示只做语法校验
+ * @param cb        事件回调
+ * @param ctx       透传给回调的上下文
+ * @return 完整解析成功返回 true
+ */
+bool sdui_json_parse(const char *json, size_t len, int str_depth, sdui_json_cb_t cb, void *ctx);
+
+/* ======================================================
+ * 二进制布局编码 (SBL)
+ *
+ *   payload := u8 版本 | varint 字符串数 | (varint 长度 | 字节)* | value
+ *   value   := 0x00 null | 0x01 false | 0x02 true
+ *            | 0x03 zigzag varint 整数
+ *            | 0x04 8 字节 little-endian double
+ *            | 0x05 varint 字符串表索引
+ *            | 0x06 R G B 三字节颜色（解码为 "#rrggbb" 字符串）
+ *            | 0x07 varint 成员数 | (key value)*
+ *            | 0x08 varint 元素数 | value*
+ *   key     := varint：小于内置键表长度时取内置键名，否则为字符串表索引（减去键表长度）
+ *
+ * 内置键表见 sdui_json_bin.c，与 server.py 的 SDUI_BIN_KEYS 保持一致，只能追加。
+ * ====================================================== */
+#define SDUI_BIN_VERSION  1
+
+/**
+ * @brief 解码一段 SBL 二进制布局，按与 sdui_json_parse 相同的事件序列回调
+ *
+ * STRING 事件的 str 始终有效；raw 指向二进制数据内部，不是 JSON 原文。
+ *
+ * @param data 编码数据（以版本字节开头）
+ * @param len  数据长度
+ * @param cb   事件回调
+ * @param ctx  透传给回调的上下文
+ * @return 完整解码成功返回 true
+ */
+bool sdui_json_parse_bin(const uint8_t *data, size_t len, sdui_json_cb_t cb, void *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SDUI_JSON_H */
@@ -0,0 +1,310 @@
+/**
+ * @file sdui_json.c
+ * @brief SDUI 流式 JSON 词法解析器实现
+ *
+ * 迭代实现（无递归），C 栈占用固定；容器栈为位数组式的 uint8_t 表。
+ * 字符串反转义写入 PSRAM 暂存区，只在遇到更长的字符串时增长。
+ */
+#include "sdui_json.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+static const char *TAG = "SDUI_JSON";
+
+#define SCRATCH_INIT_CAP 128
+#define NUMBER_MAX_LEN   64
+
+/* ---- 解析状态 ---- */
+typedef struct {
+    const char     *begin;
+    const char     *p;
+    const char     *end;
+    int             str_depth;
+    sdui_json_cb_t  cb;
+    void           *ctx;
+
+    char           *scratch;                          /* 字符串反转义暂存 (PSRAM) */
+    size_t          scratch_cap;
+    char            key[SDUI_JSON_KEY_MAX];           /* 当前键名 */
+    uint8_t         stack[SDUI_JSON_MAX_DEPTH];       /* 1 = 数组, 0 = 对象 */
+    int             depth;
+    bool            aborted;                          /* 回调主动中止 */
+} lexer_t;
+
+/* ======================================================
+ * 基础工具
+ * ====================================================== */
+static void skip_ws(lexer_t *lx) {
+    while (lx->p < lx->end && (*lx->p == ' ' || *lx->p == '\t' || *lx->p == '\n' || *lx->p == '\r')) lx->p++;
+}
+
+static bool emit(lexer_t *lx, sdui_json_event_t *ev) {
+    if (!lx->cb(lx->ctx, ev)) { lx->aborted = true; return false; }
+    return true;
+}
+
+static bool scratch_reserve(lexer_t *lx, size_t need) {
+    if (need <= lx->scratch_cap) return true;
+    size_t cap = lx->scratch_cap ? lx->scratch_cap : SCRATCH_INIT_CAP;
+    while (cap < need) cap *= 2;
+    char *buf = heap_caps_realloc(lx->scratch, cap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) {
+        ESP_LOGE(TAG, "scratch alloc failed (%u bytes)", (unsigned)cap);
+        return false;
+    }
+    lx->scratch     = buf;
+    lx->scratch_cap = cap;
+    return true;
+}
+
+static int hex4(const char *s) {
+    int v = 0;
+    for (int i = 0; i < 4; i++) {
+        char c = s[i];
+        v <<= 4;
+        if      (c >= '0' && c <= '9') v |= c - '0';
+        else if (c >= 'a' && c <= 'f') v |= c - 'a' + 10;
+        else if (c >= 'A' && c <= 'F') v |= c - 'A' + 10;
+        else return -1;
+    }
+    return v;
+}
+
+static size_t utf8_encode(uint32_t cp, char *out) {
+    if (cp < 0x80)    { out[0] = (char)cp; return 1; }
+    if (cp < 0x800)   { out[0] = (char)(0xC0 | (cp >> 6));  out[1] = (char)(0x80 | (cp & 0x3F)); return 2; }
+    if (cp < 0x10000) { out[0] = (char)(0xE0 | (cp >> 12)); out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+                        out[2] = (char)(0x80 | (cp & 0x3F)); return 3; }
+    out[0] = (char)(0xF0 | (cp >> 18));         out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((cp >> 6) & 0x3F)); out[3] = (char)(0x80 | (cp & 0x3F));
+    return 4;
+}
+
+/* ======================================================
+ * 字符串：lx->p 指向起始引号。
+ * copy=true 时反转义到 scratch 并 '\0' 结尾，否则仅校验。
+ * ====================================================== */
+static bool read_string(lexer_t *lx, bool copy, size_t *out_len) {
+    const char *s = ++lx->p;
+    size_t      n = 0;
+
+    /* 先找结尾引号，反转义结果不会长于原文，一次性预留 */
+    const char *q = s;
+    while (q < lx->end && *q != '"') q += (*q == '\\') ? 2 : 1;
+    if (q >= lx->end) return false;
+    if (copy && !scratch_reserve(lx, (size_t)(q - s) + 1)) return false;
+
+    while (lx->p < q) {
+        unsigned char c = (unsigned char)*lx->p++;
+        if (c < 0x20) return false;
+        if (c != '\\') {
+            if (copy) lx->scratch[n] = (char)c;
+            n++;
+            continue;
+        }
+        char e = *lx->p++;
+        char ch;
+        switch (e) {
+            case '"':  ch = '"';  break;
+            case '\\': ch = '\\'; break;
+            case '/':  ch = '/';  break;
+            case 'b':  ch = '\b'; break;
+            case 'f':  ch = '\f'; break;
+            case 'n':  ch = '\n'; break;
+            case 'r':  ch = '\r'; break;
+            case 't':  ch = '\t'; break;
+            case 'u': {
+                if (q - lx->p < 4) return false;
+                int cp = hex4(lx->p);
+                if (cp < 0) return false;
+                lx->p += 4;
+                /* UTF-16 代理对 */
+                if (cp >= 0xD800 && cp <= 0xDBFF && q - lx->p >= 6 && lx->p[0] == '\\' && lx->p[1] == 'u') {
+                    int lo = hex4(lx->p + 2);
+                    if (lo >= 0xDC00 && lo <= 0xDFFF) {
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+                        lx->p += 6;
+                    }
+                }
+                /* \uXXXX 原文 6 字节，UTF-8 至多 4 字节，不会越过预留空间 */
+                char   tmp[4];
+                size_t k = utf8_encode((uint32_t)cp, tmp);
+                if (copy) memcpy(lx->scratch + n, tmp, k);
+                n += k;
+                continue;
+            }
+            default: return false;
+        }
+        if (copy) lx->scratch[n] = ch;
+        n++;
+    }
+    lx->p = q + 1;
+    if (copy) lx->scratch[n] = '\0';
+    *out_len = n;
+    return true;
+}
+
+static bool read_key(lexer_t *lx) {
+    skip_ws(lx);
+    if (lx->p >= lx->end || *lx->p != '"') return false;
+    size_t n    = 0;
+    bool   copy = lx->str_depth != SDUI_JSON_STR_NONE;
+    if (!read_string(lx, copy, &n)) return false;
+    if (!copy) n = 0;
+    if (n >= SDUI_JSON_KEY_MAX) n = SDUI_JSON_KEY_MAX - 1;
+    if (n) memcpy(lx->key, lx->scratch, n);
+    lx->key[n] = '\0';
+    skip_ws(lx);
+    if (lx->p >= lx->end || *lx->p != ':') return false;
+    lx->p++;
+    return true;
+}
+
+static bool read_number(lexer_t *lx, double *out) {
+    const char *s = lx->p;
+    const char *p = s;
+    if (p < lx->end && *p == '-') p++;
+    if (p >= lx->end) return false;
+    if (*p == '0') p++;
+    else if (*p >= '1' && *p <= '9') while (p < lx->end && *p >= '0' && *p <= '9') p++;
+    else return false;
+    if (p < lx->end && *p == '.') {
+        p++;
+        if (p >= lx->end || *p < '0' || *p > '9') return false;
+        while (p < lx->end && *p >= '0' && *p <= '9') p++;
+    }
+    if (p < lx->end && (*p == 'e' || *p == 'E')) {
+        p++;
+        if (p < lx->end && (*p == '+' || *p == '-')) p++;
+        if (p >= lx->end || *p < '0' || *p > '9') return false;
+        while (p < lx->end && *p >= '0' && *p <= '9') p++;
+    }
+    size_t n = (size_t)(p - s);
+    if (n >= NUMBER_MAX_LEN) return false;
+    char buf[NUMBER_MAX_LEN];
+    memcpy(buf, s, n);
+    buf[n] = '\0';
+    *out  = strtod(buf, NULL);
+    lx->p = p;
+    return true;
+}
+
+static bool match_literal(lexer_t *lx, const char *lit, size_t n) {
+    if ((size_t)(lx->end - lx->p) < n || memcmp(lx->p, lit, n)) return false;
+    lx->p += n;
+    return true;
+}
+
+/* ======================================================
+ * 标量值：lx->p 指向值首字符
+ * ====================================================== */
+static bool read_scalar(lexer_t *lx, const char *key) {
+    sdui_json_event_t ev = { .depth = lx->depth, .key = key, .raw = lx->p };
+    char c = *lx->p;
+
+    if (c == '"') {
+        bool copy = lx->str_depth == SDUI_JSON_STR_ALL || lx->depth <= lx->str_depth;
+        ev.type = SDUI_JSON_STRING;
+        if (!read_string(lx, copy, &ev.len)) return false;
+        ev.str = copy ? lx->scratch : NULL;
+    } else if (c == 't') {
+        ev.type = SDUI_JSON_TRUE;
+        if (!match_literal(lx, "true", 4)) return false;
+    } else if (c == 'f') {
+        ev.type = SDUI_JSON_FALSE;
+        if (!match_literal(lx, "false", 5)) return false;
+    } else if (c == 'n') {
+        ev.type = SDUI_JSON_NULL;
+        if (!match_literal(lx, "null", 4)) return false;
+    } else {
+        ev.type = SDUI_JSON_NUMBER;
+        if (!read_number(lx, &ev.num)) return false;
+    }
+    ev.raw_len = (size_t)(lx->p - ev.raw);
+    return emit(lx, &ev);
+}
+
+/* ======================================================
+ * 主循环
+ * ====================================================== */
+static bool run(lexer_t *lx) {
+    const char *key = NULL;
+
+    for (;;) {
+        /* ---- 读取一个值 ---- */
+        skip_ws(lx);
+        if (lx->p >= lx->end) return false;
+
+        char c = *lx->p;
+        if (c == '{' || c == '[') {
+            bool arr = (c == '[');
+            if (lx->depth >= SDUI_JSON_MAX_DEPTH) {
+                ESP_LOGW(TAG, "max depth %d exceeded", SDUI_JSON_MAX_DEPTH);
+                return false;
+            }
+            sdui_json_event_t ev = {
+                .type = arr ? SDUI_JSON_ARR_BEGIN : SDUI_JSON_OBJ_BEGIN,
+                .depth = lx->depth, .key = key, .raw = lx->p, .raw_len = 1,
+            };
+            if (!emit(lx, &ev)) return false;
+            lx->stack[lx->depth++] = arr;
+            lx->p++;
+            skip_ws(lx);
+            if (lx->p < lx->end && *lx->p == (arr ? ']' : '}')) goto close;
+            if (arr) {
+                key = NULL;
+            } else {
+                if (!read_key(lx)) return false;
+                key = lx->key;
+            }
+            continue;
+        }
+        if (!read_scalar(lx, key)) return false;
+
+        /* ---- 值之后：逗号 / 容器结束 / 输入结束 ---- */
+        for (;;) {
+            skip_ws(lx);
+            if (lx->depth == 0) return lx->p == lx->end;
+            if (lx->p >= lx->end) return false;
+            if (*lx->p == ',') {
+                lx->p++;
+                if (lx->stack[lx->depth - 1]) {
+                    key = NULL;
+                } else {
+                    if (!read_key(lx)) return false;
+                    key = lx->key;
+                }
+                break;
+            }
+close:
+            if (*lx->p != (lx->stack[lx->depth - 1] ? ']' : '}')) return false;
+            {
+                bool arr = lx->stack[--lx->depth];
+                sdui_json_event_t ev = {
+                    .type = arr ? SDUI_JSON_ARR_END : SDUI_JSON_OBJ_END,
+                    .depth = lx->depth, .raw = lx->p, .raw_len = 1,
+                };
+                lx->p++;
+                if (!emit(lx, &ev)) return false;
+            }
+        }
+    }
+}
+
+bool sdui_json_parse(const char *json, size_t len, int str_depth, sdui_json_cb_t cb, void *ctx) {
+    if (!json || !cb) return false;
+
+    lexer_t lx = {
+        .begin = json, .p = json, .end = json + len,
+        .str_depth = str_depth, .cb = cb, .ctx = ctx,
+    };
+    bool ok = run(&lx);
+    if (!ok && !lx.aborted) {
+        ESP_LOGW(TAG, "syntax error at offset %u", (unsigned)(lx.p - lx.begin));
+    }
+    heap_caps_free(lx.scratch);
+    return ok;
+}
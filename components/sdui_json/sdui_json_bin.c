@@ -0,0 +1,244 @@
+/**
+ * @file sdui_json_bin.c
+ * @brief SDUI 二进制布局编码 (SBL) 解码器
+ *
+ * 与文本 JSON 同构的紧凑编码：内置键表 + varint 键标签、字符串驻留表、
+ * 颜色 3 字节打包。解码时按文本解析器相同的事件序列回调，
+ * 因而 sdui_parser 的布局构建 / reconcile 无需区分来源。
+ */
+#include "sdui_json.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+#include <stdint.h>
+
+static const char *TAG = "SDUI_JSON_BIN";
+
+/* ---- 值标签 ---- */
+enum {
+    TAG_NULL  = 0x00,
+    TAG_FALSE = 0x01,
+    TAG_TRUE  = 0x02,
+    TAG_INT   = 0x03,   /* zigzag varint */
+    TAG_F64   = 0x04,   /* 8 字节 little-endian IEEE-754 */
+    TAG_STR   = 0x05,   /* varint 字符串表索引 */
+    TAG_COLOR = 0x06,   /* R G B 三字节 → "#rrggbb" */
+    TAG_OBJ   = 0x07,   /* varint 成员数 + (键, 值)* */
+    TAG_ARR   = 0x08,   /* varint 元素数 + 值* */
+};
+
+/*
+ * 内置键表：键标签 k < KEY_COUNT 时直接取此表，否则为字符串表索引 k - KEY_COUNT。
+ * 必须与 server.py 中 SDUI_BIN_KEYS 顺序一致，只能在末尾追加。
+ */
+static const char *const s_keys[] = {
+    "type", "id", "children", "text", "w", "h", "align", "x", "y",
+    "bg_color", "bg_opa", "pad", "radius", "gap", "border_w", "border_color",
+    "text_color", "font_size", "shadow_w", "shadow_color", "opa", "hidden",
+    "flex", "justify", "align_items", "scrollable", "long_mode",
+    "value", "min", "max", "indic_color",
+    "on_click", "on_press", "on_release", "on_change",
+    "anim", "duration", "repeat", "color_a", "color_b", "min_opa", "max_opa",
+    "direction", "from", "amplitude",
+    "src", "img_w", "img_h",
+    "count", "color", "particle_size", "canvas_w", "canvas_h",
+    "reconcile", "class", "transition", "format", "src_ref",
+    "items", "row_class", "label_class", "max_items", "follow",
+};
+#define KEY_COUNT (sizeof(s_keys) / sizeof(s_keys[0]))
+
+typedef struct {
+    const uint8_t *p;
+    uint32_t       len;
+} bin_str_t;
+
+typedef struct {
+    uint32_t remaining;
+    uint8_t  is_obj;
+} bin_frame_t;
+
+typedef struct {
+    const uint8_t *p;
+    const uint8_t *end;
+    bin_str_t     *strs;
+    uint32_t       n_strs;
+    char          *scratch;
+    char           key[SDUI_JSON_KEY_MAX];
+    bin_frame_t    stack[SDUI_JSON_MAX_DEPTH];
+    int            depth;
+    sdui_json_cb_t cb;
+    void          *ctx;
+    bool           aborted;
+} bin_reader_t;
+
+static bool read_varint(bin_reader_t *br, uint64_t *out) {
+    uint64_t v = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (br->p >= br->end) return false;
+        uint8_t b = *br->p++;
+        v |= (uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) { *out = v; return true; }
+    }
+    return false;
+}
+
+static bool read_count(bin_reader_t *br, uint32_t *out) {
+    uint64_t v;
+    /* 每个元素至少 1 字节，超过剩余长度必为损坏数据 */
+    if (!read_varint(br, &v) || v > (uint64_t)(br->end - br->p)) return false;
+    *out = (uint32_t)v;
+    return true;
+}
+
+static bool emit(bin_reader_t *br, sdui_json_event_t *ev) {
+    if (!br->cb(br->ctx, ev)) { br->aborted = true; return false; }
+    return true;
+}
+
+static bool read_key(bin_reader_t *br, const char **key) {
+    uint64_t k;
+    if (!read_varint(br, &k)) return false;
+    if (k < KEY_COUNT) { *key = s_keys[k]; return true; }
+    k -= KEY_COUNT;
+    if (k >= br->n_strs) return false;
+    uint32_t n = br->strs[k].len < SDUI_JSON_KEY_MAX ? br->strs[k].len : SDUI_JSON_KEY_MAX - 1;
+    memcpy(br->key, br->strs[k].p, n);
+    br->key[n] = '\0';
+    *key = br->key;
+    return true;
+}
+
+/* 读取一个值的头部：标量直接发出事件，容器发出 BEGIN 并入栈 */
+static bool read_value(bin_reader_t *br, const char *key) {
+    static const char hex[] = "0123456789abcdef";
+    sdui_json_event_t ev = { .depth = br->depth, .key = key, .raw = (const char *)br->p };
+
+    if (br->p >= br->end) return false;
+    uint8_t tag = *br->p++;
+    switch (tag) {
+        case TAG_NULL:  ev.type = SDUI_JSON_NULL;  break;
+        case TAG_FALSE: ev.type = SDUI_JSON_FALSE; break;
+        case TAG_TRUE:  ev.type = SDUI_JSON_TRUE;  break;
+        case TAG_INT: {
+            uint64_t z;
+            if (!read_varint(br, &z)) return false;
+            ev.type = SDUI_JSON_NUMBER;
+            ev.num  = (double)(int64_t)((z >> 1) ^ (~(z & 1) + 1));
+            break;
+        }
+        case TAG_F64: {
+            if (br->end - br->p < 8) return false;
+            uint64_t u = 0;
+            for (int i = 7; i >= 0; i--) u = (u << 8) | br->p[i];
+            br->p += 8;
+            memcpy(&ev.num, &u, sizeof(ev.num));
+            ev.type = SDUI_JSON_NUMBER;
+            break;
+        }
+        case TAG_STR: {
+            uint64_t idx;
+            if (!read_varint(br, &idx) || idx >= br->n_strs) return false;
+            memcpy(br->scratch, br->strs[idx].p, br->strs[idx].len);
+            br->scratch[br->strs[idx].len] = '\0';
+            ev.type = SDUI_JSON_STRING;
+            ev.str  = br->scratch;
+            ev.len  = br->strs[idx].len;
+            break;
+        }
+        case TAG_COLOR: {
+            if (br->end - br->p < 3) return false;
+            br->scratch[0] = '#';
+            for (int i = 0; i < 3; i++) {
+                br->scratch[1 + 2 * i] = hex[br->p[i] >> 4];
+                br->scratch[2 + 2 * i] = hex[br->p[i] & 0x0F];
+            }
+            br->scratch[7] = '\0';
+            br->p  += 3;
+            ev.type = SDUI_JSON_STRING;
+            ev.str  = br->scratch;
+            ev.len  = 7;
+            break;
+        }
+        case TAG_OBJ:
+        case TAG_ARR: {
+            uint32_t n;
+            if (br->depth >= SDUI_JSON_MAX_DEPTH || !read_count(br, &n)) return false;
+            ev.type    = tag == TAG_OBJ ? SDUI_JSON_OBJ_BEGIN : SDUI_JSON_ARR_BEGIN;
+            ev.raw_len = 1;
+            if (!emit(br, &ev)) return false;
+            br->stack[br->depth].remaining = n;
+            br->stack[br->depth].is_obj    = tag == TAG_OBJ;
+            br->depth++;
+            return true;
+        }
+        default:
+            return false;
+    }
+    ev.raw_len = (size_t)((const char *)br->p - ev.raw);
+    return emit(br, &ev);
+}
+
+static bool run(bin_reader_t *br) {
+    for (;;) {
+        const char *key = NULL;
+        if (br->depth > 0) {
+            bin_frame_t *top = &br->stack[br->depth - 1];
+            if (top->remaining == 0) {
+                br->depth--;
+                sdui_json_event_t ev = {
+                    .type = top->is_obj ? SDUI_JSON_OBJ_END : SDUI_JSON_ARR_END,
+                    .depth = br->depth, .raw = (const char *)br->p, .raw_len = 1,
+                };
+                if (!emit(br, &ev)) return false;
+                if (br->depth == 0) break;
+                continue;
+            }
+            top->remaining--;
+            if (top->is_obj && !read_key(br, &key)) return false;
+        }
+        if (!read_value(br, key)) return false;
+        if (br->depth == 0) break;   /* 根为标量 */
+    }
+    return br->p == br->end;
+}
+
+bool sdui_json_parse_bin(const uint8_t *data, size_t len, sdui_json_cb_t cb, void *ctx) {
+    if (!data || !cb) return false;
+
+    bin_reader_t br = { .p = data, .end = data + len, .cb = cb, .ctx = ctx };
+    bool         ok = false;
+
+    if (len < 1 || *br.p++ != SDUI_BIN_VERSION) {
+        ESP_LOGW(TAG, "unsupported version %d", len ? data[0] : -1);
+        return false;
+    }
+
+    /* 字符串表：只记录位置，不拷贝 */
+    uint32_t n_strs, max_len = 7;   /* 至少容纳 "#rrggbb" */
+    if (!read_count(&br, &n_strs)) goto out;
+    if (n_strs) {
+        br.strs = heap_caps_malloc(n_strs * sizeof(bin_str_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!br.strs) goto out;
+    }
+    for (uint32_t i = 0; i < n_strs; i++) {
+        uint32_t n;
+        if (!read_count(&br, &n)) goto out;
+        br.strs[i].p   = br.p;
+        br.strs[i].len = n;
+        br.p += n;
+        if (n > max_len) max_len = n;
+    }
+    br.n_strs  = n_strs;
+    br.scratch = heap_caps_malloc(max_len + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!br.scratch) goto out;
+
+    ok = run(&br);
+
+out:
+    if (!ok && !br.aborted) {
+        ESP_LOGW(TAG, "malformed data at offset %u", (unsigned)(br.p - data));
+    }
+    heap_caps_free(br.scratch);
+    heap_caps_free(br.strs);
+    return ok;
+}
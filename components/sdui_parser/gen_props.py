@@ -0,0 +1,80 @@
+#!/usr/bin/env python3
+"""为 priv_include/sdui_props.h 的词表生成完美哈希（改写 sdui_props.c 中的生成段）
+
+    python3 components/sdui_parser/gen_props.py
+
+槽位 = (FNV-1a(词) * 乘数) >> (32 - SLOT_BITS)，从固定起点按奇数递增搜索第一个
+使全部词互不冲突的乘数，同一词表每次生成的结果相同。
+"""
+import os
+import re
+import sys
+
+SLOT_BITS = 9
+MUL_SEED = 0x9E3779B1
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+HEADER = os.path.join(HERE, "priv_include", "sdui_props.h")
+SOURCE = os.path.join(HERE, "sdui_props.c")
+BEGIN = "/* ---- 以下由 gen_props.py 生成，勿手改 ---- */"
+END = "/* ---- 生成结束 ---- */"
+
+
+def read_tokens():
+    """按编号顺序返回 [(name, str)]：属性键在前，取值词在后"""
+    text = open(HEADER, encoding="utf-8").read()
+    out = []
+    for macro in ("SDUI_PROP_KEYS", "SDUI_PROP_WORDS"):
+        m = re.search(r"#define %s\(T\)(.*?)\n\n" % macro, text, re.S)
+        if not m:
+            sys.exit("%s: %s not found" % (HEADER, macro))
+        out += re.findall(r'T\((\w+),\s*"([^"]+)"\)', m.group(1))
+    return out
+
+
+def fnv1a(s):
+    h = 2166136261
+    for b in s.encode("utf-8"):
+        h = ((h ^ b) * 16777619) & 0xFFFFFFFF
+    return h
+
+
+def find_mul(words):
+    hashes = [fnv1a(w) for w in words]
+    for k in range(1 << 20):
+        mul = (MUL_SEED + 2 * k) & 0xFFFFFFFF
+        slots = {((h * mul) & 0xFFFFFFFF) >> (32 - SLOT_BITS) for h in hashes}
+        if len(slots) == len(words):
+            return mul
+    sys.exit("no collision-free multiplier, raise SLOT_BITS")
+
+
+def main():
+    toks = read_tokens()
+    if len(toks) + 1 > 255:
+        sys.exit("too many tokens for uint8_t slots")
+    if len({s for _, s in toks}) != len(toks):
+        sys.exit("duplicate strings in token list")
+    mul = find_mul([s for _, s in toks])
+
+    slots = sorted((((fnv1a(s) * mul) & 0xFFFFFFFF) >> (32 - SLOT_BITS), name) for name, s in toks)
+    lines = [BEGIN,
+             "#define TOK_HASH_MUL  0x%08Xu" % mul,
+             "#define TOK_SLOT_BITS %d" % SLOT_BITS,
+             "",
+             "static const uint8_t s_tok_slots[1u << TOK_SLOT_BITS] = {"]
+    lines += ["    [%3d] = SDUI_TOK_%s," % (slot, name) for slot, name in slots]
+    lines += ["};", END]
+
+    src = open(SOURCE, encoding="utf-8").read()
+    a, b = src.find(BEGIN), src.find(END)
+    if a < 0 or b < 0:
+        sys.exit("%s: generated section markers not found" % SOURCE)
+    src = src[:a] + "\n".join(lines) + src[b + len(END):]
+    with open(SOURCE, "w", encoding="utf-8") as f:
+        f.write(src)
+    print("%s: %d tokens, %d slots, mul 0x%08X" % (SOURCE, len(toks), 1 << SLOT_BITS, mul))
+
+
+if __name__ == "__main__":
+    main()
@@ -11,16 +11,23 @@
  *   - image     : 流式图像，Base64(RGB565) 解码，存于 PSRAM，支持 spin 旋转动画
  *   - bar       : 进度指示条，支持 value/min/max/bg_color/indic_color
  *   - slider    : 滑动控制，支持 value/min/max/on_change 事件上报
- *   - particle  : 粒子特效，LVGL Canvas(PSRAM)，≤30 粒子
+ *   - particle  : 粒子特效，RGB565 Canvas(PSRAM)，定点物理 + 精灵直写，≤512 粒子
+ *   - list      : 虚拟化文本列表，条目存于 PSRAM，只为可见行创建对象，支持追加 / 裁剪
+ *
+ * text / value 可绑定状态变量（"{var}" 模板），由 state/set 驱动局部重绘（见 sdui_parser_state_set）；
+ * 也可写成速率描述 {"value", "rate", "until"}，由设备按显示刷新周期自行推进。
+ *
+ * 文本中的汉字与 emoji 字形按需向服务端请求，缓存在 PSRAM（见 sdui_parser_glyph_feed）。
  *
  * 支持动画属性 (anim 字段，服务端驱动):
  *   - blink       : 透明度闪烁
  *   - breathe     : 透明度呼吸
- *   - spin        : 图片旋转 (限≤2个并发)
+ *   - spin        : 图片旋转
  *   - slide_in    : 方向滑入入场
  *   - shake       : 水平抖动
  *   - color_pulse : 背景色双色渐变
  *   - marquee     : label 跑马灯
+ * 除 marquee 外均由动画调度器按实测帧耗时向目标帧率降级（见 sdui_parser_get_anim_stats）。
  *
  * 针对 1.75" 圆屏 (466x466) 定义了安全边距与居中约束。
  */
@@ -29,6 +36,8 @@
 
 #include "lvgl.h"
 
+struct cJSON;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -52,37 +61,324 @@ lv_obj_t *sdui_parser_init(void);
 lv_obj_t *sdui_parser_get_root(void);
 
 /**
- * @brief 根据完整 JSON 布局描述重建 UI (含 Fade 过渡动画)
+ * @brief 根据完整 JSON 布局描述重建 UI (离屏构建 + 一步切换)
  *
  * 执行步骤：
- *   1. 根视图透明度瞬间降为 0 (隐藏旧内容)
- *   2. 清除所有子节点和 anim 动画
- *   3. 递归构建新 LVGL 对象树
- *   4. 启动 200ms Fade-In 动画
+ *   1. 新建隐藏的离屏根视图，旧界面保持显示
+ *   2. 由 sdui_json 事件流式构建 LVGL 对象树：每个节点只缓存自身属性，
+ *      峰值内存 ≈ 树深度 × 单节点属性，与载荷大小无关（解析失败时保留旧 UI）
+ *   3. 切换两个根视图的可见性；根节点 "transition": "fade" 时新界面 200ms Fade-In
+ *   4. 旧根交给后台定时器按时间预算逐个删除叶子对象
+ *
+ * 根节点带 "reconcile": true 时改为增量模式（原地修改，无切换）：
+ *   - 新旧节点按 id 匹配（同父、同类型），无 id 节点按 类型+位置 匹配
+ *   - 匹配节点只重新应用签名变化的属性，无法原地修改的变化重建该节点
+ *   - 未匹配的旧节点删除，新节点创建，并按新顺序排列
+ *
+ * 同步构建：与 sdui_parser_stream 走同一路径，但解析、图片解码与构建都在本次
+ * 调用内持锁完成（增量模式跑完全部分片）。大载荷应改用 sdui_parser_stream。
  *
  * @param json_str ui/layout 主题的 payload JSON 字符串
  * @note 必须在 LVGL 加锁状态下调用 (bsp_display_lock)
  */
 void sdui_parser_render(const char *json_str);
 
+/**
+ * @brief 以 SBL 二进制编码渲染布局（语义与 sdui_parser_render 完全相同）
+ *
+ * 编码格式见 sdui_json.h；由 ui/layout 二进制帧驱动。
+ *
+ * @param data 编码数据
+ * @param len  数据长度
+ * @note 必须在 LVGL 加锁状态下调用 (bsp_display_lock)
+ */
+void sdui_parser_render_bin(const uint8_t *data, size_t len);
+
+/**
+ * @brief 设置流式构建的 LVGL 加解锁回调
+ *
+ * 设置后 sdui_parser_stream* 由调用方在锁外调用：只在创建组件前加锁，
+ * 持锁超过约 4ms 即解锁让出一个 tick，image 节点的像素解码也在锁外进行。
+ *
+ * @param lock   加锁（阻塞直到取得），如 bsp_display_lock(-1)
+ * @param unlock 解锁，如 bsp_display_unlock
+ * @note 须在 sdui_parser_init 之后、第一次 sdui_parser_stream 之前调用
+ */
+void sdui_parser_set_lock(void (*lock)(void), void (*unlock)(void));
+
+/**
+ * @brief 流式构建布局（语义同 sdui_parser_render，ui/layout 的默认入口）
+ *
+ * 全量布局边解析边在离屏根上创建组件，不建整棵 DOM，峰值内存随树深度而非载荷增长；
+ * 持锁分段按 4ms 预算切分，构建期间的 sdui_parser_update 缓存到完成后应用。
+ * 根节点带 "reconcile": true 时改为 sdui_parser_prepare_len + sdui_parser_submit。
+ *
+ * @param json 不要求 '\0' 结尾的 JSON（返回后即可释放）
+ * @param len  长度
+ * @note 设置了锁回调时在锁外调用，否则必须在 LVGL 加锁状态下调用
+ */
+void sdui_parser_stream(const char *json, size_t len);
+
+/** @brief 同 sdui_parser_stream，输入为 SBL 二进制编码 */
+void sdui_parser_stream_bin(const uint8_t *data, size_t len);
+
+/**
+ * @brief 接收一个 ui/image 图片分片（无需加锁）
+ *
+ * 载荷: {"id": "cover", "offset": 0, "total": 115200, "w": 240, "h": 240, "data": "<Base64>"}
+ *   - id     : 目标 image 组件 ID
+ *   - offset : 本分片在解码后位图中的字节偏移，须按顺序到达
+ *   - total  : 解码后总字节数，RGB565 即 w * h * 2
+ *   - w / h  : 仅 offset 为 0 的首个分片需要
+ *   - format : 可选，仅首片需要；"raw565"（默认）或 "rle565"
+ *   - ref    : 可选，仅首片需要；图片内容哈希，收齐后同时登记到图片缓存，
+ *              之后的布局可用 "src_ref" 直接引用
+ *   - data   : 本分片的 Base64（原始字节数取 3 的倍数，各分片可独立解码）；
+ *              rle565 时为完整 token 序列，offset 仍按解码后字节计
+ *
+ * 每个分片直接解码进最终的 PSRAM 缓冲，不再需要整张 Base64 的拷贝，
+ * 峰值内存约为位图本身加一个分片。
+ *
+ * @return 该图片已收齐、等待 sdui_parser_image_commit 时返回 true
+ */
+bool sdui_parser_image_feed(const char *json_str);
+
+/**
+ * @brief 把已收齐的图片替换到对应 image 组件上，并释放其旧位图
+ * @note 必须在 LVGL 加锁状态下调用；目标组件所在布局仍在分片构建时，
+ *       自动推迟到构建完成后提交
+ */
+void sdui_parser_image_commit(void);
+
+/**
+ * @brief 定义 / 重定义共享样式类 (ui/styles)
+ *
+ * payload 形如 {"bubble": {"radius": 10, "pad": 10}, "bubble_user": {"bg_color": "#2ecc71"}}。
+ * 每个类对应一个常驻 PSRAM 的 lv_style_t，节点以 "class": "bubble bubble_user"
+ * 引用（lv_obj_add_style，不复制样式），节点上的同名本地属性优先于类。
+ * 重定义已有类时原地替换属性，所有引用对象自动刷新。
+ *
+ * 可用属性: bg_color / bg_opa / pad / radius / gap / border_w /
+ *           border_color / text_color / font_size / shadow_w / shadow_color / opa
+ *
+ * @param json_str ui/styles 主题的 payload JSON 字符串
+ * @note 必须在 LVGL 加锁状态下调用；应先于引用它的布局下发
+ */
+void sdui_parser_set_styles(const char *json_str);
+
+/** 预处理完成、等待分片构建的布局任务（不透明句柄） */
+typedef struct sdui_layout_job sdui_layout_job_t;
+
+/**
+ * @brief 在 LVGL 锁外预处理布局：解析、展平节点表、解码全部图片
+ *
+ * 不调用任何 LVGL 接口，可在 WebSocket 事件任务中直接执行，
+ * 耗时最长的步骤（Base64 解码、大载荷解析）因此不再阻塞触摸与动画。
+ *
+ * @param json_str ui/layout 主题的 payload JSON 字符串（返回后即可释放）
+ * @return 任务句柄，交给 sdui_parser_submit；语法错误或内存不足返回 NULL（保留旧 UI）
+ */
+sdui_layout_job_t *sdui_parser_prepare(const char *json_str);
+
+/** @brief 同 sdui_parser_prepare，输入为不要求 '\0' 结尾的切片（如总线 slice 订阅的 payload） */
+sdui_layout_job_t *sdui_parser_prepare_len(const char *json, size_t len);
+
+/** @brief 同 sdui_parser_prepare，输入为 SBL 二进制编码 */
+sdui_layout_job_t *sdui_parser_prepare_bin(const uint8_t *data, size_t len);
+
+/**
+ * @brief 同 sdui_parser_prepare，输入为已解析好的 cJSON 树（所有权转移，失败时也会释放）
+ *
+ * 主机基准 sdui_bench --legacy 以 cJSON_ParseWithLength 解析后经此入口构建，
+ * 作为 sdui_json 事件解析的对照；prepare_us 不含 cJSON 解析本身。
+ */
+sdui_layout_job_t *sdui_parser_prepare_dom(struct cJSON *root);
+
+/**
+ * @brief 提交预处理好的布局，由 LVGL 定时器分片构建
+ *
+ * 全量模式下每片只在离屏根上创建约 4ms 预算内的节点，片间释放 LVGL 锁，
+ * 旧界面在构建期间保持显示与可交互，完成后一步切换。增量模式在下一片内完成对比。
+ * 新任务提交时取代尚未完成的旧任务；构建期间的 sdui_parser_update 缓存到完成后应用。
+ *
+ * @param job 由 sdui_parser_prepare* 返回，所有权转移给解析引擎
+ * @note 必须在 LVGL 加锁状态下调用（仅登记任务，立即返回）
+ */
+void sdui_parser_submit(sdui_layout_job_t *job);
+
+/** @brief 释放未提交的任务（无需加锁） */
+void sdui_parser_discard(sdui_layout_job_t *job);
+
+/** @brief 是否有布局正在构建（分片任务或流式构建，须在 LVGL 锁内调用） */
+bool sdui_parser_is_building(void);
+
+/** 最近一次渲染（同步或分片）的统计 */
+typedef struct {
+    uint32_t created;     /**< 新建节点数 */
+    uint32_t patched;     /**< 原地修改节点数 */
+    uint32_t deleted;     /**< 删除节点数：增量模式为对比删除的旧节点（含子树），全量模式为被替换旧树的节点数 */
+    uint32_t bytes;       /**< 载荷字节数 */
+    uint32_t slices;      /**< 持锁构建片数（同步渲染与未设锁回调的流式构建为 1） */
+    int64_t  time_us;     /**< 总耗时：解析开始到构建完成 (μs) */
+    int64_t  prepare_us;  /**< 锁外预处理耗时 (μs)，流式构建为 0（解析与构建交错） */
+    int64_t  max_lock_us; /**< 单次持有 LVGL 锁的最长时间 (μs) */
+    int32_t  heap_bytes;  /**< 构建阶段净消耗的内部+PSRAM 堆 (B)，不含被替换的旧树 */
+    bool     reconciled;  /**< 是否为增量模式 */
+    bool     binary;      /**< 是否为二进制编码 */
+} sdui_render_stats_t;
+
+/**
+ * @brief 获取最近一次渲染统计
+ * @param out 输出
+ */
+void sdui_parser_get_render_stats(sdui_render_stats_t *out);
+
+/** 图片缓存统计（累计值） */
+typedef struct {
+    uint32_t hits;        /**< src_ref 命中次数 */
+    uint32_t misses;      /**< src_ref 未命中次数（已上报 ui/image_miss 或随 src 补齐） */
+    uint32_t evictions;   /**< 因超出预算被淘汰的条目数 */
+    uint32_t entries;     /**< 当前条目数 */
+    uint32_t bytes;       /**< 当前占用 PSRAM 字节数（含正在显示的位图） */
+    uint32_t budget;      /**< 字节预算 */
+} sdui_image_cache_stats_t;
+
+/**
+ * @brief 获取图片缓存统计（线程安全，无需加锁）
+ *
+ * image 节点带 "src_ref": "<内容哈希>" 时，解码后的位图以该哈希为键常驻 PSRAM，
+ * 组件删除后保留，供之后的布局只发 src_ref 复用，超出预算按 LRU 淘汰。
+ * 只有 src_ref 而缓存未命中时，设备上行 ui/image_miss {"ref", "id"}，
+ * 服务端以带 ref 的 ui/image 补发。
+ *
+ * @param out 输出
+ */
+void sdui_parser_get_image_cache_stats(sdui_image_cache_stats_t *out);
+
+/** 动画调度统计（最近一个 500ms 窗口；dropped / skipped 为累计值） */
+typedef struct {
+    uint16_t active;       /**< 运行中的受调度动画数 */
+    uint16_t paused;       /**< 其中组件隐藏或在屏幕外、暂停写入的动画数 */
+    uint8_t  level;        /**< 降级等级 0–3，0 为全速 */
+    uint16_t fps;          /**< 实际绘制帧率 */
+    uint16_t target_fps;   /**< 目标帧率 (CONFIG_SDUI_ANIM_TARGET_FPS) */
+    uint32_t frame_us;     /**< 平均帧耗时 (μs)：布局 + 渲染 + 刷屏 */
+    uint32_t frame_max_us; /**< 最长帧耗时 (μs) */
+    uint32_t dropped;      /**< 超出帧预算的帧数 */
+    uint32_t skipped;      /**< 降级时跳过的动画写入次数 */
+} sdui_anim_stats_t;
+
+/**
+ * @brief 获取动画调度统计（无需加锁）
+ *
+ * 动画不限数量与类型；帧耗时超出 1000 / target_fps 毫秒时逐级放慢动画定时器、
+ * 让高开销动画（旋转、大面积组件）跳帧写入，隐藏或移出屏幕的组件上的动画只计时不重绘。
+ *
+ * @param out 输出
+ */
+void sdui_parser_get_anim_stats(sdui_anim_stats_t *out);
+
+/**
+ * @brief 接收一条 font/glyphs 字形批次（无需加锁）
+ *
+ * 文本按 font_size 选用 Montserrat，非 ASCII 码点（汉字、emoji）不在其中，
+ * 由流式字形字体向服务端按需请求：一帧内未命中的码点合并为一条上行
+ * font/glyph_miss {"size": 16, "cps": [20320, 22909]}，服务端回送
+ * {"size": 16, "glyphs": [{"cp", "adv", "w", "h", "x", "y", "bmp"}]}
+ * （bmp 为 Base64 的 4 bpp 位图），字形常驻 PSRAM 缓存。
+ * 在收到之前这些字符显示为占位框。也接受多个批次组成的数组（总线通道满时的合并形式）。
+ *
+ * @return 有新字形、需要 sdui_parser_glyph_commit 刷新文本时返回 true
+ */
+bool sdui_parser_glyph_feed(const char *json_str);
+
+/**
+ * @brief 用新到的字形重新排版界面上的文本（label 与 list 条目）
+ * @note 必须在 LVGL 加锁状态下调用
+ */
+void sdui_parser_glyph_commit(void);
+
+/**
+ * @brief 启用字形持久化：从 path（SPIFFS 上的文件）预载，之后定期写回最近使用的字形
+ *
+ * 重启后常用字直接命中，无需往返。调用前须已挂载文件系统。
+ */
+void sdui_parser_glyph_persist(const char *path);
+
+/** 字形缓存统计（累计值） */
+typedef struct {
+    uint32_t hits;        /**< 命中缓存的字形查询（排版与绘制各计一次） */
+    uint32_t misses;      /**< 首次遇到、已排队请求的码点数 */
+    uint32_t requests;    /**< 上行 font/glyph_miss 消息数 */
+    uint32_t received;    /**< 收到的字形数 */
+    uint32_t evictions;   /**< 因超出预算被淘汰的字形数 */
+    uint32_t glyphs;      /**< 当前缓存的字形数 */
+    uint32_t bytes;       /**< 当前占用 PSRAM 字节数 */
+    uint32_t budget;      /**< 字节预算 */
+} sdui_glyph_cache_stats_t;
+
+/** @brief 获取字形缓存统计（线程安全，无需加锁） */
+void sdui_parser_get_glyph_cache_stats(sdui_glyph_cache_stats_t *out);
+
 /**
  * @brief 根据 ID 查找已渲染的 LVGL 对象
+ *
+ * ID 注册表为 PSRAM 中的开放寻址哈希表，O(1) 查找，数量无上限。
+ * 重复 ID 以最后创建的组件为准。
+ *
  * @param id 组件 ID 字符串
  * @return 匹配的 lv_obj_t*，未找到返回 NULL
  */
 lv_obj_t *sdui_parser_find_by_id(const char *id);
 
+/**
+ * @brief 反查组件 ID（读取对象 user_data 中的元数据，O(1)）
+ * @param obj 由 sdui_parser 创建的 LVGL 对象
+ * @return ID 字符串（生命周期与对象相同），未设置 ID 返回 NULL
+ */
+const char *sdui_parser_get_id(lv_obj_t *obj);
+
 /**
  * @brief 按 ID 增量更新组件属性
  *
  * 支持字段: text / hidden / bg_color / opa / value (bar/slider) /
- *           indic_color (bar) / anim (触发动画)
+ *           indic_color (bar) / class (替换样式类) / anim (触发动画) /
+ *           items / append / trim / scroll_to (list：替换 / 追加 / 丢弃最早 n 条 / 滚动)
+ *
+ * 载荷可为单个 {"id": ...} 对象，也可为对象数组或 {"ops": [...]}：
+ * 批量形式一次解析、在同一次持锁内全部应用，重绘合并为一次刷新。
+ * 数组中的 {"ops": [...]} 元素按序展开（总线通道满时把相邻的几条合并成数组）。
+ *
+ * 布局分片构建期间调用时，更新被缓存并在构建完成后按序应用。
  *
  * @param json_str ui/update 主题的 payload JSON 字符串
  * @note 必须在 LVGL 加锁状态下调用
  */
 void sdui_parser_update(const char *json_str);
 
+/**
+ * @brief 设置状态变量 (state/set)
+ *
+ * 布局节点的 text（label / button）与 value（bar / slider）可写成引用变量的模板，
+ * 如 "text": "{rounds} 轮"、"value": "{progress}"；ui/update 改写这两个字段时同样可用。
+ * payload 形如 {"rounds": 3, "progress": 42, "status": "思考中"}，null 清空变量；
+ * 变量值为 {"value": 35, "rate": 1, "until": 240} 速率描述时由设备自行推进，
+ * 服务端只在速率变化（暂停、跳转）时下发校正。
+ * 只有引用了变化变量的组件重新渲染；同一帧内的多次 state/set 合并，
+ * 每个组件在下一次刷新前最多更新一次。变量跨布局保留，后建的组件按当前值显示。
+ * 也接受这种对象组成的数组（总线通道满时的合并形式），按序应用。
+ *
+ * @param json_str state/set 主题的 payload JSON 字符串
+ * @note 必须在 LVGL 加锁状态下调用；布局分片构建期间无需缓存，直接生效
+ */
+void sdui_parser_state_set(const char *json_str);
+
+/**
+ * @brief 立即重绘 state/set 改动的绑定组件，不等下一帧的合并定时器
+ * @note 必须在 LVGL 加锁状态下调用；主机基准用它把重绘计入单条消息的耗时
+ */
+void sdui_parser_state_flush(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,61 @@
+/**
+ * @file sdui_anim.h
+ * @brief SDUI 动画调度：按实测帧耗时向目标帧率自适应降级
+ *
+ * anim 字段驱动的动画都经 sdui_anim_start 启动，值由调度器转交 apply 回调，
+ * 不再按类型限制并发数量。帧耗时取显示器 LV_EVENT_REFR_START → REFR_READY
+ * （布局 + 渲染 + 等待 SPI 刷屏，只统计真正绘制了区域的帧），每 500ms 与目标帧率
+ * 的帧预算比较一次，逐级降级 / 恢复：
+ *   L0  动画定时器按 LV_DEF_REFR_PERIOD 运行
+ *   L1  动画定时器周期放宽到一个帧预算
+ *   L2  周期 1.5 个帧预算，高开销动画隔帧写入
+ *   L3  周期 2 个帧预算，高开销每 4 帧、中开销隔帧写入
+ * 隐藏或完全移出屏幕的组件上的动画照常计时但不写样式，不产生重绘。
+ * 动画的起止值总会写入，跳帧不会让组件停在中间状态。
+ *
+ * 全部接口在 LVGL 任务中调用（sdui_anim_get_stats 除外）。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#include "sdui_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 开销等级：组件面积超过四分之一屏时自动升一级 */
+typedef enum {
+    SDUI_ANIM_COST_LOW = 0,   /* 只改颜色 */
+    SDUI_ANIM_COST_MID,       /* 透明度 / 位移：整块重绘或图层混合 */
+    SDUI_ANIM_COST_HIGH,      /* 图片旋转：逐像素变换 */
+} sdui_anim_cost_t;
+
+/** 把动画当前值写到组件上 */
+typedef void (*sdui_anim_apply_cb_t)(lv_obj_t *obj, int32_t v, void *ctx);
+
+/** @brief 挂载帧耗时统计与调度定时器（须在显示启动后、LVGL 锁内调用） */
+void sdui_anim_init(void);
+
+/**
+ * @brief 启动一个受调度的动画
+ *
+ * @param a     已设置 duration / repeat / playback / path 的描述；var、values、
+ *              exec 与 deleted 回调由本函数设置
+ * @param obj   目标组件，lv_anim_delete(obj, NULL) 可停止
+ * @param from  起始值
+ * @param to    结束值
+ * @param ctx   apply 的附加参数；非 NULL 时在动画结束或删除时 free()
+ * @return 内存不足时返回 false（ctx 已释放）
+ */
+bool sdui_anim_start(lv_anim_t *a, lv_obj_t *obj, int32_t from, int32_t to,
+                     sdui_anim_cost_t cost, sdui_anim_apply_cb_t apply, void *ctx);
+
+/** @brief 读取统计（近似快照，无需加锁） */
+void sdui_anim_get_stats(sdui_anim_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file sdui_glyph.h
+ * @brief SDUI 按需下发的字形字体（CJK / emoji）
+ *
+ * 每个 Montserrat 字号包一层 LVGL 字体：ASCII 与 LVGL 符号仍由 Montserrat 绘制，
+ * 其余码点查 PSRAM 字形缓存。未命中的码点在本帧内汇总，由 LVGL 定时器
+ * 合并成一条上行 font/glyph_miss {"size", "cps": [...]}；服务端以 font/glyphs
+ * 回送 4 bpp 位图，登记后刷新界面上的文本。新文本首次显示只需一次往返，
+ * 之后全部命中缓存。
+ *
+ * 缓存按字节预算 LRU 淘汰；可选把最近使用的字形写入 SPIFFS，重启后预载。
+ * 查询在 LVGL 任务中，登记在总线任务中，内部以互斥量保护。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lvgl.h"
+#include "sdui_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SDUI_GLYPH_CACHE_BUDGET
+#define SDUI_GLYPH_CACHE_BUDGET  (256 * 1024)   /* 缓存字节预算，16 px 汉字约 1500 个 */
+#endif
+#define SDUI_GLYPH_BOX_MAX       64             /* 单个字形位图边长上限 */
+
+/**
+ * @brief 初始化缓存与请求定时器（须在 LVGL 锁内调用），重复调用无副作用
+ */
+void sdui_glyph_init(size_t budget);
+
+/**
+ * @brief 为一个 Montserrat 字号创建流式字体（须在 sdui_glyph_init 之后）
+ * @param base 底层字体：提供行高、基线，并绘制 ASCII 与符号
+ * @param px   向服务端请求字形时使用的像素字号
+ * @return 新字体；内存不足时返回 base
+ */
+const lv_font_t *sdui_glyph_font_create(const lv_font_t *base, uint8_t px);
+
+/**
+ * @brief 登记一条 font/glyphs 消息中的字形（无需加锁）
+ *
+ * payload: {"size": 16, "glyphs": [{"cp", "adv", "w", "h", "x", "y", "bmp"}]}
+ *   x / y 为位图左下角相对原点与基线的偏移（LVGL ofs_x / ofs_y，y 向上），
+ *   bmp 为 Base64 的 4 bpp 位图，逐行存储、每行 (w + 1) / 2 字节、高半字节在左。
+ *   服务端无法绘制的码点以 w = h = 0 回送，之后不再请求。
+ *
+ * @return 至少登记了一个字形时返回 true，此时应在锁内刷新文本
+ */
+bool sdui_glyph_feed(const char *json_str);
+
+/**
+ * @brief 启用持久化：从 path 预载字形，之后登记新字形时定期写回
+ *
+ * 写回在 sdui_glyph_feed 的调用者任务中进行，两次写回至少间隔一分钟，
+ * 只保存 LRU 表头（最近使用）的一部分字形。
+ */
+void sdui_glyph_persist(const char *path);
+
+/** @brief 读取统计 */
+void sdui_glyph_get_stats(sdui_glyph_cache_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,48 @@
+/**
+ * @file sdui_ids.h
+ * @brief SDUI 组件 ID 注册表：id → 对象
+ *
+ * 开放寻址哈希 (FNV-1a + 线性探测)，槽位数组位于 PSRAM，负载 > 3/4 时翻倍扩容，
+ * 删除用回移 (backward-shift) 而不留墓碑，因此查找耗时与注册的 ID 数无关。
+ * 槽位只保存 id 指针，字符串由调用方持有，注册期间必须保持有效。
+ *
+ * 不依赖 LVGL，值为不透明指针；只在 LVGL 任务中调用，不加锁。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SDUI_IDS_INIT_CAP  64   /* 初始槽位数，必须为 2 的幂 */
+
+/** @brief FNV-1a 字符串哈希（注册表与属性签名共用） */
+uint32_t sdui_ids_hash(const char *s);
+
+/** @brief 分配初始槽位并清空，重复调用只清空 */
+void sdui_ids_init(void);
+
+/**
+ * @brief 注册 id → obj；id 已存在时改绑到 obj（以最后注册者为准）
+ * @return 扩容失败时返回 false，该 id 未登记
+ */
+bool sdui_ids_put(const char *id, void *obj);
+
+/** @brief 按 id 查找，未命中返回 NULL */
+void *sdui_ids_get(const char *id);
+
+/** @brief 仅当 id 仍绑定在 obj 上时移除（重复 ID 被改绑后，旧对象删除不影响新绑定） */
+void sdui_ids_remove(const char *id, const void *obj);
+
+/** @brief 清空所有槽位，保留容量 */
+void sdui_ids_clear(void);
+
+/** @brief 已注册的 ID 数 */
+int sdui_ids_count(void);
+
+#ifdef __cplusplus
+}
+#endif
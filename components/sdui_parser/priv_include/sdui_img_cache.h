@@ -0,0 +1,66 @@
+/**
+ * @file sdui_img_cache.h
+ * @brief SDUI 按内容寻址的图片缓存
+ *
+ * 已解码的 RGB565 位图以服务端给出的内容哈希 (src_ref) 为键常驻 PSRAM，
+ * 多个 image 组件共享同一缓冲（引用计数）。组件删除只归还引用，
+ * 位图留在缓存中供后续布局复用；总量超过预算时按 LRU 淘汰无引用的条目，
+ * 仍被组件显示的条目不会被淘汰。
+ *
+ * 所有接口线程安全：锁外的布局预处理与分片上传、锁内的组件删除可并发调用。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdui_parser.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef SDUI_IMG_CACHE_BUDGET
+#define SDUI_IMG_CACHE_BUDGET  (2 * 1024 * 1024)   /* 缓存字节预算，约 4 张全屏位图 */
+#endif
+#define SDUI_IMG_REF_MAX       32                  /* src_ref 最大长度（不含 '\0'） */
+
+/** 缓存条目（只读访问 buf / size / w / h） */
+typedef struct sdui_img_entry {
+    char                   ref[SDUI_IMG_REF_MAX + 1];
+    uint8_t               *buf;      /* PSRAM 位图，归缓存所有 */
+    uint32_t               size;
+    uint16_t               w, h;
+    uint16_t               refs;     /* 持有该条目的组件数 */
+    struct sdui_img_entry *prev;     /* LRU 链表：表头最近使用 */
+    struct sdui_img_entry *next;
+} sdui_img_entry_t;
+
+/** @brief 初始化（创建互斥量），重复调用无副作用 */
+void sdui_img_cache_init(size_t budget);
+
+/**
+ * @brief 按 ref 查找，命中时引用 +1 并移到 LRU 表头
+ * @return 命中的条目；未命中返回 NULL（计入 misses）
+ */
+sdui_img_entry_t *sdui_img_cache_acquire(const char *ref);
+
+/**
+ * @brief 把刚解码的位图登记到缓存，并持有一次引用
+ *
+ * 同 ref 已存在时释放 buf，返回已有条目。之后按预算淘汰无引用的旧条目。
+ *
+ * @param buf 位图（PSRAM），成功后所有权转移给缓存
+ * @return 条目；ref 非法或内存不足返回 NULL，buf 仍归调用方
+ */
+sdui_img_entry_t *sdui_img_cache_insert(const char *ref, uint8_t *buf, uint32_t size, uint16_t w, uint16_t h);
+
+/** @brief 归还一次引用（组件删除或换图时） */
+void sdui_img_cache_release(sdui_img_entry_t *e);
+
+/** @brief 读取统计 */
+void sdui_img_cache_get_stats(sdui_image_cache_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
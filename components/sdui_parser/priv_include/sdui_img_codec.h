@@ -0,0 +1,46 @@
+/**
+ * @file sdui_img_codec.h
+ * @brief SDUI 图片压缩格式解码
+ *
+ * rle565：以 RGB565 像素（2 字节，设备字节序）为单位的 PackBits 式游程编码
+ *   token := 0x00–0x7F 字面量：随后 (op + 1) 个像素原样拷贝
+ *          | 0x80–0xFF 重复：随后 1 个像素，重复 (op - 0x7F) 次
+ * 单个 token 最多 128 像素。图标、纯色封面等 UI 素材通常可压缩 5–10 倍，
+ * 解码只有 memcpy 与填充，直接写入最终的 PSRAM 位图。
+ *
+ * 编码器见 server.py encode_rle565()。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SDUI_IMG_RAW565 = 0,    /* 未压缩 RGB565 */
+    SDUI_IMG_RLE565,        /* rle565 游程编码 */
+    SDUI_IMG_UNKNOWN,
+} sdui_img_format_t;
+
+/**
+ * @brief 解析 "format" 属性
+ * @param s 属性值，NULL 或 "raw" 为未压缩
+ */
+sdui_img_format_t sdui_img_format_parse(const char *s);
+
+/**
+ * @brief 解码一段由完整 token 组成的 rle565 数据
+ * @param src 编码数据
+ * @param len 编码数据长度
+ * @param dst 输出缓冲（偶数地址偏移）
+ * @param cap 输出缓冲剩余字节数
+ * @return 写入的字节数；数据截断、token 不完整或超出 cap 时返回 -1
+ */
+int32_t sdui_img_rle565_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+#ifdef __cplusplus
+}
+#endif
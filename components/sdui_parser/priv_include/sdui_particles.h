@@ -0,0 +1,55 @@
+/**
+ * @file sdui_particles.h
+ * @brief SDUI 定点粒子引擎（不依赖 LVGL）
+ *
+ * 状态为 Q16.16 定点、SoA 布局（x / y / vx / vy / alpha 各自连续），
+ * 每帧一次顺序遍历即可完成物理更新。绘制不经过 LVGL 绘图管线：
+ * 创建时把圆点预光栅化为一张抗锯齿 alpha 精灵，逐粒子直接混合进
+ * RGB565 画布缓冲；下一帧只清除上一帧画过的精灵方块，
+ * 并返回两帧的包围盒供调用方做局部失效。
+ *
+ * 画布背景约定为黑色 (0x0000)，与 particle 组件的 RGB565 画布一致。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SDUI_PARTICLES_MAX    512   /* 单个粒子组件的粒子数上限 */
+#define SDUI_PARTICLE_R_MAX   8     /* 精灵半径上限 (像素) */
+
+typedef struct sdui_particles sdui_particles_t;
+
+/** 画布坐标系内的矩形（闭区间），x1 > x2 表示空 */
+typedef struct {
+    int16_t x1, y1, x2, y2;
+} sdui_particles_rect_t;
+
+/**
+ * @brief 创建粒子系统
+ * @param count    粒子数（截断到 SDUI_PARTICLES_MAX）
+ * @param buf      RGB565 画布缓冲（w * h * 2 字节，调用方所有）
+ * @param w / h    画布尺寸
+ * @param color    粒子颜色 (RGB565)
+ * @param radius   粒子半径（截断到 1..SDUI_PARTICLE_R_MAX）
+ * @return 句柄，内存不足返回 NULL
+ */
+sdui_particles_t *sdui_particles_create(int count, uint16_t *buf, int w, int h, uint16_t color, int radius);
+
+/** @brief 释放粒子系统（不释放画布缓冲） */
+void sdui_particles_destroy(sdui_particles_t *ps);
+
+/**
+ * @brief 推进一帧：清除上一帧的精灵、更新物理、绘制新一帧
+ * @param dirty 输出本帧需要刷新的区域（上一帧与本帧的包围盒并集）
+ * @return 有像素变化时返回 true
+ */
+bool sdui_particles_step(sdui_particles_t *ps, sdui_particles_rect_t *dirty);
+
+#ifdef __cplusplus
+}
+#endif
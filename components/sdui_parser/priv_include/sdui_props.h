@@ -0,0 +1,88 @@
+/**
+ * @file sdui_props.h
+ * @brief SDUI 属性键 / 取值词表：编译期完美哈希，把字符串一次性映射为记号
+ *
+ * 节点属性键与枚举型取值（align、flex、long_mode、type、anim.type 等）统一编号为
+ * sdui_tok_t。查找为 FNV-1a 乘法移位定位到 512 个槽位中的唯一候选，再做一次 strcmp
+ * 确认，与词表大小无关；未收录的字符串返回 SDUI_TOK_UNKNOWN。
+ *
+ * 词表增删后须运行 gen_props.py 重新生成 sdui_props.c 中的乘数与槽位表
+ * （词表顺序即记号编号，属性键在前，取值词在后）。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 节点属性键（含 ui/update 列表操作与 anim 对象内的键） */
+#define SDUI_PROP_KEYS(T)                                                                  \
+    T(TYPE, "type") T(ID, "id") T(CHILDREN, "children") T(RECONCILE, "reconcile")          \
+    T(TRANSITION, "transition") T(CLASS, "class")                                          \
+    T(W, "w") T(H, "h") T(ALIGN, "align") T(X, "x") T(Y, "y")                              \
+    T(BG_COLOR, "bg_color") T(BG_OPA, "bg_opa") T(PAD, "pad") T(RADIUS, "radius")          \
+    T(GAP, "gap") T(BORDER_W, "border_w") T(BORDER_COLOR, "border_color")                  \
+    T(TEXT_COLOR, "text_color") T(FONT_SIZE, "font_size") T(SHADOW_W, "shadow_w")          \
+    T(SHADOW_COLOR, "shadow_color") T(OPA, "opa") T(HIDDEN, "hidden")                      \
+    T(FLEX, "flex") T(JUSTIFY, "justify") T(ALIGN_ITEMS, "align_items")                    \
+    T(SCROLLABLE, "scrollable") T(TEXT, "text") T(LONG_MODE, "long_mode")                  \
+    T(VALUE, "value") T(MIN, "min") T(MAX, "max") T(INDIC_COLOR, "indic_color")            \
+    T(ON_CLICK, "on_click") T(ON_PRESS, "on_press") T(ON_RELEASE, "on_release")            \
+    T(ON_CHANGE, "on_change") T(ANIM, "anim")                                              \
+    T(SRC, "src") T(SRC_REF, "src_ref") T(IMG_W, "img_w") T(IMG_H, "img_h")                \
+    T(FORMAT, "format") T(CANVAS_W, "canvas_w") T(CANVAS_H, "canvas_h")                    \
+    T(COUNT, "count") T(COLOR, "color") T(PARTICLE_SIZE, "particle_size")                  \
+    T(DURATION, "duration") T(ROW_CLASS, "row_class") T(LABEL_CLASS, "label_class")        \
+    T(MAX_ITEMS, "max_items") T(FOLLOW, "follow") T(ITEMS, "items")                        \
+    T(APPEND, "append") T(TRIM, "trim") T(SCROLL_TO, "scroll_to")                          \
+    T(REPEAT, "repeat") T(MIN_OPA, "min_opa") T(MAX_OPA, "max_opa")                        \
+    T(DIRECTION, "direction") T(FROM, "from") T(AMPLITUDE, "amplitude")                    \
+    T(COLOR_A, "color_a") T(COLOR_B, "color_b")
+
+/* 枚举型属性的取值 */
+#define SDUI_PROP_WORDS(T)                                                                 \
+    T(CENTER, "center") T(TOP_MID, "top_mid") T(TOP_LEFT, "top_left")                      \
+    T(TOP_RIGHT, "top_right") T(BOTTOM_MID, "bottom_mid") T(BOTTOM_LEFT, "bottom_left")    \
+    T(BOTTOM_RIGHT, "bottom_right") T(LEFT_MID, "left_mid") T(RIGHT_MID, "right_mid")      \
+    T(ROW, "row") T(COLUMN, "column") T(ROW_WRAP, "row_wrap") T(COLUMN_WRAP, "column_wrap") \
+    T(START, "start") T(END, "end") T(SPACE_EVENLY, "space_evenly")                        \
+    T(SPACE_AROUND, "space_around") T(SPACE_BETWEEN, "space_between")                      \
+    T(WRAP, "wrap") T(SCROLL, "scroll") T(DOT, "dot") T(MARQUEE, "marquee")                \
+    T(CONTAINER, "container") T(LABEL, "label") T(BUTTON, "button") T(IMAGE, "image")      \
+    T(BAR, "bar") T(SLIDER, "slider") T(PARTICLE, "particle") T(LIST, "list")              \
+    T(FULL, "full") T(CONTENT, "content")                                                  \
+    T(NONE, "none") T(BLINK, "blink") T(BREATHE, "breathe") T(SPIN, "spin")                \
+    T(SLIDE_IN, "slide_in") T(SHAKE, "shake") T(COLOR_PULSE, "color_pulse")                \
+    T(FADE, "fade") T(CCW, "ccw") T(LEFT, "left") T(RIGHT, "right") T(TOP, "top")
+
+#define SDUI_TOK_ENUM_(name, str) SDUI_TOK_##name,
+
+typedef enum {
+    SDUI_TOK_UNKNOWN = 0,
+    SDUI_PROP_KEYS(SDUI_TOK_ENUM_)
+    SDUI_TOK_NUM_KEYS,                                  /* 属性键个数上界，node_props 按此定长 */
+    SDUI_TOK_WORDS_ = SDUI_TOK_NUM_KEYS - 1,            /* 取值词紧随属性键编号 */
+    SDUI_PROP_WORDS(SDUI_TOK_ENUM_)
+    SDUI_TOK_NUM,
+} sdui_tok_t;
+
+/** 记号 → 原字符串（SDUI_TOK_UNKNOWN 为空串） */
+extern const char *const sdui_tok_names[SDUI_TOK_NUM];
+
+/** @brief 字符串 → 记号；s 为 NULL 或未收录时返回 SDUI_TOK_UNKNOWN */
+sdui_tok_t sdui_tok_lookup(const char *s);
+
+/** @brief 是否为节点属性键（可作为 node_props 下标） */
+static inline bool sdui_tok_is_key(sdui_tok_t t) {
+    return t > SDUI_TOK_UNKNOWN && t < SDUI_TOK_NUM_KEYS;
+}
+
+/** @brief 自检：每个词都能查回自身（槽位表与词表不同步时返回 false） */
+bool sdui_tok_selftest(void);
+
+#ifdef __cplusplus
+}
+#endif
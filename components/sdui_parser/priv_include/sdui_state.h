@@ -0,0 +1,90 @@
+/**
+ * @file sdui_state.h
+ * @brief SDUI 状态变量与属性绑定（state/set）
+ *
+ * 布局节点的 text（label / button）与 value（bar / slider）可以写成模板：
+ * "text": "{rounds} 轮"、"value": "{progress}"，花括号内为变量名。组件创建或该属性
+ * 被改写时登记绑定并按当前变量值渲染；state/set 只修改变量，设备只重新渲染引用了
+ * 变化变量的绑定。同一帧内到达的多次修改先合并，由 LVGL 定时器在下一次刷新前
+ * 统一应用，每个绑定最多渲染一次。
+ *
+ * 变量名由字母、数字与 '_' '.' '-' 组成，不构成变量引用的花括号按原文显示，
+ * 未设置的变量渲染为空串。绑定随组件删除自动解除，同一属性被普通值改写时解除。
+ *
+ * 速率描述 {"value": 35, "rate": 0.5, "until": 100} 让值在设备端按时间推进：
+ * 可作为 state/set 的变量值，也可直接写在 text / value 属性上。推进定时器按
+ * LV_DEF_REFR_PERIOD 计算当前值，只在格式化结果变化时重绘，到达 until 后停止；
+ * 服务端只在速率变化（暂停、跳转）时下发新的描述作为校正。
+ *
+ * 全部接口在 LVGL 任务中调用。
+ */
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "lvgl.h"
+#include "cJSON.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SDUI_STATE_NAME_MAX    32    /* 变量名长度上限（含结尾 0） */
+#define SDUI_STATE_VALUE_MAX   128   /* 变量值长度上限（含结尾 0），超出截断 */
+#define SDUI_STATE_VARS_MAX    128   /* 变量个数上限（含只被引用、尚未设置的变量） */
+#define SDUI_STATE_BIND_REFS   4     /* 单个模板订阅的变量引用数，超出的引用照常渲染但不触发更新 */
+
+/** 可绑定的属性 */
+typedef enum {
+    SDUI_BIND_TEXT = 0,   /* label 文本（button 为其内部 label） */
+    SDUI_BIND_VALUE,      /* bar / slider 数值，渲染结果按十进制数解析 */
+} sdui_bind_prop_t;
+
+/** @brief 创建合并刷新定时器（须在 LVGL 锁内调用），重复调用无副作用 */
+void sdui_state_init(void);
+
+/** @brief 字符串是否含有变量引用 {name} */
+bool sdui_state_is_template(const char *s);
+
+/**
+ * @brief 把模板绑定到对象属性并立即按当前变量值渲染
+ *
+ * 取代该对象同一属性上已有的绑定。内存不足时只渲染一次、不登记。
+ */
+void sdui_state_bind(lv_obj_t *obj, sdui_bind_prop_t prop, const char *tmpl);
+
+/**
+ * @brief 把速率描述绑定到对象属性：立即显示当前值，之后按显示刷新周期推进
+ *
+ * 描述字段：
+ *   - value    : 起始值（必需），即收到时刻的值
+ *   - rate     : 每秒增量，可为负；缺省 0（静止）
+ *   - until    : 终点，到达后停止推进；缺省不封顶
+ *   - duration : 代替 rate：在该毫秒数内线性到达 until
+ *   - format   : "time" 时按秒数显示为 m:ss（超过 1 小时为 h:mm:ss），缺省为整数
+ *
+ * @return 描述无效（缺少数字 value）时返回 false，属性不变
+ */
+bool sdui_state_bind_rate(lv_obj_t *obj, sdui_bind_prop_t prop, const cJSON *desc);
+
+/** @brief 解除对象某属性上的绑定（没有绑定时为空操作） */
+void sdui_state_unbind(lv_obj_t *obj, sdui_bind_prop_t prop);
+
+/**
+ * @brief 应用一条 state/set：{"rounds": 3, "status": "思考中", "progress": 42}
+ *
+ * 字符串原样保存，数字按十进制、布尔按 true / false 转为文本，null 清空变量，
+ * 对象为速率描述（见 sdui_state_bind_rate），之后变量自行推进；值未变化的变量不触发渲染。
+ *
+ * 载荷也可以是这种对象组成的数组，按序应用。
+ *
+ * @return 值发生变化的变量数；载荷不是 JSON 对象或数组时返回 -1
+ */
+int sdui_state_set(const char *json_str);
+
+/** @brief 立即渲染尚未应用的变量修改（通常由合并定时器在下一帧调用） */
+void sdui_state_flush(void);
+
+#ifdef __cplusplus
+}
+#endif
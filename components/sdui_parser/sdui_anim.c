@@ -0,0 +1,208 @@
+/**
+ * @file sdui_anim.c
+ * @brief SDUI 动画调度实现
+ *
+ * 每个动画一条记录（双向链表），随 lv_anim 的 deleted_cb 释放，
+ * 组件删除或 anim:none 时由 lv_anim_delete(obj, NULL) 统一回收。
+ */
+#include "sdui_anim.h"
+#include "sdkconfig.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "SDUI_ANIM";
+
+#ifndef CONFIG_SDUI_ANIM_TARGET_FPS
+#define CONFIG_SDUI_ANIM_TARGET_FPS 30
+#endif
+
+#define ANIM_WINDOW_MS    500   /* 统计 / 调度窗口 */
+#define ANIM_LEVEL_MAX    3
+#define ANIM_CALM_WINDOWS 4     /* 连续空闲窗口数达到后才恢复一级 */
+
+typedef struct anim_rec {
+    lv_obj_t            *obj;
+    sdui_anim_apply_cb_t apply;
+    void                *ctx;
+    struct anim_rec     *prev, *next;
+    int32_t              from, to;
+    uint32_t             tick;
+    uint8_t              cost_base;
+    uint8_t              cost;      /* cost_base 按面积修正 */
+    bool                 visible;
+} anim_rec_t;
+
+/* 各等级下每种开销的写入间隔（帧） */
+static const uint8_t s_stride[ANIM_LEVEL_MAX + 1][3] = {
+    {1, 1, 1},
+    {1, 1, 1},
+    {1, 1, 2},
+    {1, 2, 4},
+};
+
+static anim_rec_t        *s_recs     = NULL;
+static uint8_t            s_level    = 0;
+static uint8_t            s_calm     = 0;
+static uint32_t           s_budget_us;
+static sdui_anim_stats_t  s_stats;
+
+/* 帧统计窗口（LVGL 任务内读写） */
+static int64_t  s_refr_t0;
+static bool     s_rendered;
+static uint32_t s_win_frames, s_win_max_us, s_win_start;
+static uint64_t s_win_sum_us;
+
+/* ======================================================
+ * 动画回调
+ * ====================================================== */
+static void anim_exec_cb(lv_anim_t *a, int32_t v) {
+    anim_rec_t *r = lv_anim_get_user_data(a);
+    if (!r) return;
+    if (v != r->from && v != r->to) {
+        if (!r->visible) return;   /* 不可见：只计时 */
+        uint8_t stride = s_stride[s_level][r->cost];
+        if (stride > 1 && (++r->tick % stride) != 0) {
+            s_stats.skipped++;
+            return;
+        }
+    }
+    r->apply(r->obj, v, r->ctx);
+}
+
+static void anim_deleted_cb(lv_anim_t *a) {
+    anim_rec_t *r = lv_anim_get_user_data(a);
+    if (!r) return;
+    if (r->prev) r->prev->next = r->next; else s_recs = r->next;
+    if (r->next) r->next->prev = r->prev;
+    free(r->ctx);
+    free(r);
+}
+
+/* ======================================================
+ * 帧耗时（显示器事件）
+ * ====================================================== */
+static void disp_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_REFR_START) {
+        s_refr_t0  = esp_timer_get_time();
+        s_rendered = false;
+    } else if (code == LV_EVENT_RENDER_START) {
+        s_rendered = true;
+    } else if (code == LV_EVENT_REFR_READY && s_rendered) {
+        uint32_t us = (uint32_t)(esp_timer_get_time() - s_refr_t0);
+        s_win_frames++;
+        s_win_sum_us += us;
+        if (us > s_win_max_us) s_win_max_us = us;
+        if (us > s_budget_us) s_stats.dropped++;
+    }
+}
+
+/* ======================================================
+ * 调度：可见性、开销修正与降级等级
+ * ====================================================== */
+static void sched_timer_cb(lv_timer_t *t) {
+    (void)t;
+    const int32_t big = SDUI_SCREEN_W * SDUI_SCREEN_H / 4;
+    uint16_t active = 0, paused = 0;
+    for (anim_rec_t *r = s_recs; r; r = r->next) {
+        r->visible = lv_obj_is_visible(r->obj);
+        r->cost    = r->cost_base;
+        if (r->cost < SDUI_ANIM_COST_HIGH && lv_obj_get_width(r->obj) * lv_obj_get_height(r->obj) > big) r->cost++;
+        active++;
+        if (!r->visible) paused++;
+    }
+
+    uint32_t elapsed = lv_tick_elaps(s_win_start);
+    uint32_t avg     = s_win_frames ? (uint32_t)(s_win_sum_us / s_win_frames) : 0;
+    uint8_t  level   = s_level;
+    if (active == paused) {
+        level  = 0;                 /* 没有可见动画：无需降级 */
+        s_calm = 0;
+    } else if (s_win_frames && avg > s_budget_us) {
+        if (level < ANIM_LEVEL_MAX) level++;
+        s_calm = 0;
+    } else if (!s_win_frames || avg < s_budget_us / 2) {
+        if (level && ++s_calm >= ANIM_CALM_WINDOWS) {
+            level--;
+            s_calm = 0;
+        }
+    } else {
+        s_calm = 0;
+    }
+    if (level != s_level) {
+        static const uint8_t period_x2[ANIM_LEVEL_MAX + 1] = {0, 2, 3, 4};   /* 帧预算的倍数 × 2 */
+        uint32_t period = level ? s_budget_us * period_x2[level] / 2000 : LV_DEF_REFR_PERIOD;
+        lv_timer_set_period(lv_anim_get_timer(), period);
+        ESP_LOGI(TAG, "level %u -> %u (frame avg %u us / budget %u us, %u anims), anim period %u ms",
+                 s_level, level, (unsigned)avg, (unsigned)s_budget_us, active, (unsigned)period);
+        s_level = level;
+    }
+
+    s_stats.active       = active;
+    s_stats.paused       = paused;
+    s_stats.level        = s_level;
+    s_stats.fps          = elapsed ? (uint16_t)(s_win_frames * 1000 / elapsed) : 0;
+    s_stats.frame_us     = avg;
+    s_stats.frame_max_us = s_win_max_us;
+
+    s_win_frames = 0;
+    s_win_sum_us = 0;
+    s_win_max_us = 0;
+    s_win_start  = lv_tick_get();
+}
+
+/* ======================================================
+ * 公共接口
+ * ====================================================== */
+void sdui_anim_init(void) {
+    static bool inited = false;
+    if (inited) return;
+    lv_display_t *disp = lv_display_get_default();
+    if (!disp) {
+        ESP_LOGW(TAG, "no display, frame timing disabled");
+        return;
+    }
+    inited             = true;
+    s_budget_us        = 1000000 / CONFIG_SDUI_ANIM_TARGET_FPS;
+    s_stats.target_fps = CONFIG_SDUI_ANIM_TARGET_FPS;
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_REFR_READY, NULL);
+    s_win_start = lv_tick_get();
+    lv_timer_create(sched_timer_cb, ANIM_WINDOW_MS, NULL);
+    ESP_LOGI(TAG, "anim scheduler: target %d fps (%u us/frame)", CONFIG_SDUI_ANIM_TARGET_FPS, (unsigned)s_budget_us);
+}
+
+bool sdui_anim_start(lv_anim_t *a, lv_obj_t *obj, int32_t from, int32_t to,
+                     sdui_anim_cost_t cost, sdui_anim_apply_cb_t apply, void *ctx) {
+    anim_rec_t *r = calloc(1, sizeof(anim_rec_t));
+    if (!r) {
+        free(ctx);
+        return false;
+    }
+    r->obj       = obj;
+    r->apply     = apply;
+    r->ctx       = ctx;
+    r->from      = from;
+    r->to        = to;
+    r->cost_base = (uint8_t)cost;
+    r->cost      = (uint8_t)cost;
+    r->visible   = true;   /* 下一个调度窗口前按可见处理 */
+    r->next      = s_recs;
+    if (s_recs) s_recs->prev = r;
+    s_recs = r;
+
+    lv_anim_set_var(a, obj);
+    lv_anim_set_values(a, from, to);
+    lv_anim_set_custom_exec_cb(a, anim_exec_cb);
+    lv_anim_set_user_data(a, r);
+    lv_anim_set_deleted_cb(a, anim_deleted_cb);
+    lv_anim_start(a);
+    return true;
+}
+
+void sdui_anim_get_stats(sdui_anim_stats_t *out) {
+    if (out) *out = s_stats;
+}
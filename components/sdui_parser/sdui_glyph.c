@@ -0,0 +1,506 @@
+/**
+ * @file sdui_glyph.c
+ * @brief SDUI 按需下发的字形字体实现
+ *
+ * 缓存为链式哈希（码点 + 字号为键）加 LRU 双向链表。除了位图，
+ * 还登记"底层字体自带"与"已请求"两种状态，每帧重复查询同一码点
+ * 只做一次哈希查找，不会重复请求。
+ */
+#include "sdui_glyph.h"
+#include "sdui_bus.h"
+#include "cJSON.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "mbedtls/base64.h"
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+static const char *TAG = "SDUI_GLYPH";
+
+#define GLYPH_HASH_SIZE        1024                  /* 哈希桶数，2 的幂 */
+#define GLYPH_BATCH_MAX        96                    /* 单次上行请求的码点数上限 */
+#define GLYPH_FLUSH_MS         20                    /* 未命中汇总窗口 */
+#define GLYPH_RETRY_US         (3 * 1000000LL)       /* 请求无应答时重发 */
+#define GLYPH_SAVE_INTERVAL_US (60 * 1000000LL)      /* 两次写回 SPIFFS 的最小间隔 */
+#define GLYPH_PERSIST_MAX      (64 * 1024)           /* 持久化文件字节上限 */
+#define GLYPH_FILE_MAGIC       0x314C4753u           /* "SGL1" */
+#define GLYPH_REC_HDR          9                     /* key(4) adv w h x y */
+
+#define GLYPH_KEY(px, cp)  (((uint32_t)(px) << 21) | ((uint32_t)(cp) & 0x1FFFFF))
+#define GLYPH_KEY_PX(k)    ((unsigned)((k) >> 21))
+#define GLYPH_KEY_CP(k)    ((k) & 0x1FFFFF)
+#define A4_ROW(w)          (((uint32_t)(w) + 1) / 2)
+
+typedef enum {
+    GLYPH_READY = 0,    /* 位图可用 */
+    GLYPH_PENDING,      /* 已排队，等待下一次上行 */
+    GLYPH_INFLIGHT,     /* 已请求，等待 font/glyphs */
+    GLYPH_BASE,         /* 底层字体自带，不请求 */
+} glyph_state_t;
+
+typedef struct glyph {
+    uint32_t      key;
+    struct glyph *hnext;         /* 哈希桶链 */
+    struct glyph *prev, *next;   /* LRU：表头最近使用 */
+    int64_t       asked_us;      /* INFLIGHT 时的请求时刻 */
+    uint16_t      size;          /* 计入预算的字节数 */
+    uint8_t       state;
+    uint8_t       adv_w, box_w, box_h;
+    int8_t        ofs_x, ofs_y;
+    uint8_t       bmp[];         /* 4 bpp，每行 A4_ROW(box_w) 字节 */
+} glyph_t;
+
+/** 流式字体：lv_font_t 必须在首位，font.dsc 指回自身 */
+typedef struct {
+    lv_font_t        font;
+    const lv_font_t *base;
+    uint8_t          px;
+} glyph_font_t;
+
+static SemaphoreHandle_t s_lock    = NULL;
+static glyph_t         **s_buckets = NULL;
+static glyph_t          *s_head    = NULL;
+static glyph_t          *s_tail    = NULL;
+static size_t            s_budget  = SDUI_GLYPH_CACHE_BUDGET;
+static sdui_glyph_cache_stats_t s_stats;
+
+static uint32_t    s_pending[GLYPH_BATCH_MAX];   /* 待请求的键 */
+static size_t      s_pending_n = 0;
+static lv_timer_t *s_flush_timer = NULL;
+
+static char    s_persist_path[64];
+static bool    s_dirty    = false;
+static int64_t s_saved_us = 0;
+
+#define CACHE_LOCK()   xSemaphoreTake(s_lock, portMAX_DELAY)
+#define CACHE_UNLOCK() xSemaphoreGive(s_lock)
+
+/* ---- 哈希与 LRU（持锁） ---- */
+static inline uint32_t bucket_of(uint32_t key) {
+    return (key * 2654435761u) >> 22;   /* 高 10 位 → GLYPH_HASH_SIZE */
+}
+
+static glyph_t *find(uint32_t key) {
+    for (glyph_t *g = s_buckets[bucket_of(key)]; g; g = g->hnext)
+        if (g->key == key) return g;
+    return NULL;
+}
+
+static void lru_unlink(glyph_t *g) {
+    if (g->prev) g->prev->next = g->next; else s_head = g->next;
+    if (g->next) g->next->prev = g->prev; else s_tail = g->prev;
+    g->prev = g->next = NULL;
+}
+
+static void lru_push_front(glyph_t *g) {
+    g->prev = NULL;
+    g->next = s_head;
+    if (s_head) s_head->prev = g; else s_tail = g;
+    s_head = g;
+}
+
+static void glyph_link(glyph_t *g) {
+    uint32_t b = bucket_of(g->key);
+    g->hnext     = s_buckets[b];
+    s_buckets[b] = g;
+    lru_push_front(g);
+    s_stats.bytes += g->size;
+    if (g->state == GLYPH_READY) s_stats.glyphs++;
+}
+
+static void glyph_unlink_free(glyph_t *g) {
+    glyph_t **pp = &s_buckets[bucket_of(g->key)];
+    while (*pp != g) pp = &(*pp)->hnext;
+    *pp = g->hnext;
+    lru_unlink(g);
+    s_stats.bytes -= g->size;
+    if (g->state == GLYPH_READY) s_stats.glyphs--;
+    heap_caps_free(g);
+}
+
+/** 超出预算时从表尾淘汰；排队与请求中的条目保留 */
+static void trim(void) {
+    glyph_t *g = s_tail;
+    while (g && s_stats.bytes > s_budget) {
+        glyph_t *prev = g->prev;
+        if (g->state == GLYPH_READY || g->state == GLYPH_BASE) {
+            if (g->state == GLYPH_READY) s_stats.evictions++;
+            glyph_unlink_free(g);
+        }
+        g = prev;
+    }
+}
+
+static glyph_t *glyph_new(uint32_t key, glyph_state_t state, uint32_t bmp_bytes) {
+    glyph_t *g = heap_caps_calloc(1, sizeof(glyph_t) + bmp_bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!g) return NULL;
+    g->key   = key;
+    g->state = state;
+    g->size  = (uint16_t)(sizeof(glyph_t) + bmp_bytes);
+    return g;
+}
+
+/** 新条目登记为 state 并链入；PENDING 还要进入待请求队列（队列满时不登记，下一帧再试） */
+static bool add_marker(uint32_t key, glyph_state_t state) {
+    if (state == GLYPH_PENDING && s_pending_n == GLYPH_BATCH_MAX) return false;
+    glyph_t *g = glyph_new(key, state, 0);
+    if (!g) return false;
+    glyph_link(g);
+    trim();
+    if (state == GLYPH_PENDING) s_pending[s_pending_n++] = key;
+    return true;
+}
+
+/* ======================================================
+ * LVGL 字体回调（LVGL 任务）
+ * ====================================================== */
+static bool glyph_get_dsc(const lv_font_t *font, lv_font_glyph_dsc_t *dsc, uint32_t letter, uint32_t letter_next) {
+    /* ASCII 与 LVGL 符号（私用区）直接交给 fallback（Montserrat） */
+    if (letter < 0x80 || (letter >= 0xE000 && letter <= 0xF8FF)) return false;
+
+    const glyph_font_t *gf  = font->dsc;
+    uint32_t            key = GLYPH_KEY(gf->px, letter);
+    bool found = false, probe = false, queued = false;
+
+    CACHE_LOCK();
+    glyph_t *g = find(key);
+    if (!g) {
+        probe = true;
+    } else if (g->state == GLYPH_READY) {
+        dsc->adv_w          = g->adv_w;
+        dsc->box_w          = g->box_w;
+        dsc->box_h          = g->box_h;
+        dsc->ofs_x          = g->ofs_x;
+        dsc->ofs_y          = g->ofs_y;
+        dsc->format         = g->box_w ? LV_FONT_GLYPH_FORMAT_A4 : LV_FONT_GLYPH_FORMAT_NONE;
+        dsc->is_placeholder = 0;
+        dsc->gid.index      = key;
+        lru_unlink(g);
+        lru_push_front(g);
+        s_stats.hits++;
+        found = true;
+    } else if (g->state == GLYPH_INFLIGHT && esp_timer_get_time() - g->asked_us > GLYPH_RETRY_US &&
+               s_pending_n < GLYPH_BATCH_MAX) {
+        g->state = GLYPH_PENDING;
+        s_pending[s_pending_n++] = key;
+        queued = true;
+    }
+    CACHE_UNLOCK();
+
+    if (probe) {
+        /* 首次遇到：底层字体有的（如 °）记为 BASE，其余排队请求 */
+        bool in_base = gf->base->get_glyph_dsc(gf->base, dsc, letter, letter_next);
+        CACHE_LOCK();
+        if (!find(key)) {
+            if (in_base) {
+                add_marker(key, GLYPH_BASE);
+            } else if (add_marker(key, GLYPH_PENDING)) {
+                s_stats.misses++;
+                queued = true;
+            }
+        }
+        CACHE_UNLOCK();
+    }
+    if (queued) lv_timer_resume(s_flush_timer);
+    return found;   /* 未命中时 LVGL 继续查 fallback，最终画占位 */
+}
+
+/** 4 bpp → LVGL 需要的 A8 */
+static const void *glyph_get_bitmap(lv_font_glyph_dsc_t *dsc, lv_draw_buf_t *draw_buf) {
+    if (!draw_buf) return NULL;
+    const void *ret = NULL;
+    CACHE_LOCK();
+    glyph_t *g = find(dsc->gid.index);
+    if (g && g->state == GLYPH_READY && g->box_w == dsc->box_w && g->box_h == dsc->box_h) {
+        uint32_t       stride = draw_buf->header.stride;
+        uint32_t       row_b  = A4_ROW(g->box_w);
+        const uint8_t *src    = g->bmp;
+        uint8_t       *dst    = draw_buf->data;
+        for (uint32_t y = 0; y < g->box_h; y++, src += row_b, dst += stride) {
+            for (uint32_t x = 0; x < g->box_w; x++) {
+                uint8_t v = src[x >> 1];
+                v         = (x & 1) ? (v & 0x0F) : (v >> 4);
+                dst[x]    = v * 17;
+            }
+        }
+        ret = draw_buf;
+    }
+    CACHE_UNLOCK();
+    return ret;
+}
+
+/** 把本帧汇总的未命中码点按字号分组上行，每组一条 font/glyph_miss */
+static void glyph_flush_cb(lv_timer_t *t) {
+    static char pl[GLYPH_BATCH_MAX * 8 + 32];
+    uint32_t    keys[GLYPH_BATCH_MAX];
+    size_t      n   = 0;
+    int64_t     now = esp_timer_get_time();
+
+    CACHE_LOCK();
+    for (size_t i = 0; i < s_pending_n; i++) {
+        glyph_t *g = find(s_pending[i]);
+        if (!g || g->state != GLYPH_PENDING) continue;   /* 期间已收到 */
+        g->state    = GLYPH_INFLIGHT;
+        g->asked_us = now;
+        keys[n++]   = g->key;
+    }
+    s_pending_n = 0;
+    CACHE_UNLOCK();
+    lv_timer_pause(t);
+
+    uint32_t sent = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (!keys[i]) continue;
+        unsigned px  = GLYPH_KEY_PX(keys[i]);
+        int      len = snprintf(pl, sizeof(pl), "{\"size\":%u,\"cps\":[", px);
+        for (size_t j = i; j < n; j++) {
+            if (!keys[j] || GLYPH_KEY_PX(keys[j]) != px) continue;
+            len += snprintf(pl + len, sizeof(pl) - len, "%" PRIu32 ",", GLYPH_KEY_CP(keys[j]));
+            keys[j] = 0;
+        }
+        snprintf(pl + len - 1, sizeof(pl) - len + 1, "]}");
+        sdui_bus_publish_up("font/glyph_miss", pl);
+        sent++;
+    }
+    if (sent) {
+        CACHE_LOCK();
+        s_stats.requests += sent;
+        CACHE_UNLOCK();
+        ESP_LOGD(TAG, "requested %u glyphs in %" PRIu32 " batches", (unsigned)n, sent);
+    }
+}
+
+/* ======================================================
+ * 持久化（SPIFFS）
+ *   "SGL1" | count(4) | count × { key(4) adv w h x y | bmp }
+ * ====================================================== */
+static void glyph_load(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        ESP_LOGI(TAG, "no glyph file at %s", path);
+        return;
+    }
+    uint32_t hdr[2] = {0};
+    uint32_t loaded = 0;
+    if (fread(hdr, sizeof(hdr), 1, f) != 1 || hdr[0] != GLYPH_FILE_MAGIC) {
+        ESP_LOGW(TAG, "%s: bad header, ignored", path);
+        goto out;
+    }
+    for (uint32_t i = 0; i < hdr[1]; i++) {
+        uint8_t  rec[GLYPH_REC_HDR];
+        uint32_t key;
+        if (fread(rec, sizeof(rec), 1, f) != 1) break;
+        memcpy(&key, rec, 4);
+        uint8_t w = rec[5], h = rec[6];
+        if (w > SDUI_GLYPH_BOX_MAX || h > SDUI_GLYPH_BOX_MAX) break;
+        uint32_t bytes = A4_ROW(w) * h;
+        glyph_t *g     = glyph_new(key, GLYPH_READY, bytes);
+        if (!g) break;
+        if (bytes && fread(g->bmp, bytes, 1, f) != 1) {   /* 写回中断留下的残尾 */
+            heap_caps_free(g);
+            break;
+        }
+        g->adv_w = rec[4];
+        g->box_w = w;
+        g->box_h = h;
+        g->ofs_x = (int8_t)rec[7];
+        g->ofs_y = (int8_t)rec[8];
+        CACHE_LOCK();
+        if (find(key)) {
+            heap_caps_free(g);
+        } else {
+            glyph_link(g);
+            trim();
+            loaded++;
+        }
+        CACHE_UNLOCK();
+    }
+    ESP_LOGI(TAG, "preloaded %" PRIu32 " glyphs from %s", loaded, path);
+out:
+    fclose(f);
+}
+
+/** 有新字形且距上次写回超过间隔时，把 LRU 表头的字形快照写入文件 */
+static void glyph_save_maybe(void) {
+    if (!s_persist_path[0]) return;
+    int64_t now = esp_timer_get_time();
+    if (s_saved_us && now - s_saved_us < GLYPH_SAVE_INTERVAL_US) return;
+
+    uint8_t *buf = heap_caps_malloc(GLYPH_PERSIST_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) return;
+    size_t   len   = 8;
+    uint32_t count = 0;
+    bool     dirty;
+    /* 快照在锁内，文件写入在锁外，不阻塞渲染 */
+    CACHE_LOCK();
+    dirty = s_dirty;
+    for (glyph_t *g = s_head; dirty && g; g = g->next) {
+        if (g->state != GLYPH_READY) continue;
+        uint32_t bytes = A4_ROW(g->box_w) * g->box_h;
+        if (len + GLYPH_REC_HDR + bytes > GLYPH_PERSIST_MAX) break;
+        uint8_t *r = buf + len;
+        memcpy(r, &g->key, 4);
+        r[4] = g->adv_w;
+        r[5] = g->box_w;
+        r[6] = g->box_h;
+        r[7] = (uint8_t)g->ofs_x;
+        r[8] = (uint8_t)g->ofs_y;
+        memcpy(r + GLYPH_REC_HDR, g->bmp, bytes);
+        len += GLYPH_REC_HDR + bytes;
+        count++;
+    }
+    s_dirty = false;
+    CACHE_UNLOCK();
+
+    if (dirty) {
+        uint32_t hdr[2] = {GLYPH_FILE_MAGIC, count};
+        memcpy(buf, hdr, sizeof(hdr));
+        FILE *f = fopen(s_persist_path, "wb");
+        if (f && fwrite(buf, len, 1, f) == 1) {
+            ESP_LOGI(TAG, "saved %" PRIu32 " glyphs (%u B) to %s", count, (unsigned)len, s_persist_path);
+        } else {
+            ESP_LOGW(TAG, "write %s failed", s_persist_path);
+        }
+        if (f) fclose(f);
+        s_saved_us = now;
+    }
+    heap_caps_free(buf);
+}
+
+/* ======================================================
+ * 公共接口
+ * ====================================================== */
+void sdui_glyph_init(size_t budget) {
+    if (s_lock) return;
+    s_buckets = heap_caps_calloc(GLYPH_HASH_SIZE, sizeof(glyph_t *), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!s_buckets) {
+        ESP_LOGE(TAG, "glyph table alloc failed, CJK text disabled");
+        return;
+    }
+    if (budget) s_budget = budget;
+    s_stats.budget = (uint32_t)s_budget;
+    s_flush_timer  = lv_timer_create(glyph_flush_cb, GLYPH_FLUSH_MS, NULL);
+    lv_timer_pause(s_flush_timer);
+    s_lock = xSemaphoreCreateMutex();
+    ESP_LOGI(TAG, "glyph cache budget %u KB", (unsigned)(s_budget / 1024));
+}
+
+const lv_font_t *sdui_glyph_font_create(const lv_font_t *base, uint8_t px) {
+    if (!s_lock || !base) return base;
+    /* 每次取字形都会访问，放内部 RAM */
+    glyph_font_t *gf = heap_caps_calloc(1, sizeof(glyph_font_t), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+    if (!gf) return base;
+    gf->base                     = base;
+    gf->px                       = px;
+    gf->font.get_glyph_dsc       = glyph_get_dsc;
+    gf->font.get_glyph_bitmap    = glyph_get_bitmap;
+    gf->font.line_height         = base->line_height;
+    gf->font.base_line           = base->base_line;
+    gf->font.underline_position  = base->underline_position;
+    gf->font.underline_thickness = base->underline_thickness;
+    gf->font.dsc                 = gf;
+    gf->font.fallback            = base;
+    return &gf->font;
+}
+
+/** 解析一个字形；位图大小与 w / h 不符时丢弃 */
+static glyph_t *glyph_parse(uint8_t px, cJSON *it) {
+    cJSON *cp  = cJSON_GetObjectItem(it, "cp");
+    cJSON *adv = cJSON_GetObjectItem(it, "adv");
+    cJSON *w   = cJSON_GetObjectItem(it, "w");
+    cJSON *h   = cJSON_GetObjectItem(it, "h");
+    cJSON *x   = cJSON_GetObjectItem(it, "x");
+    cJSON *y   = cJSON_GetObjectItem(it, "y");
+    cJSON *bmp = cJSON_GetObjectItem(it, "bmp");
+    if (!cJSON_IsNumber(cp) || cp->valuedouble < 0x80 || cp->valuedouble > 0x10FFFF) return NULL;
+    int bw = cJSON_IsNumber(w) ? w->valueint : 0;
+    int bh = cJSON_IsNumber(h) ? h->valueint : 0;
+    if (bw < 0 || bh < 0 || bw > SDUI_GLYPH_BOX_MAX || bh > SDUI_GLYPH_BOX_MAX) {
+        ESP_LOGW(TAG, "U+%04X: box %dx%d too large", cp->valueint, bw, bh);
+        return NULL;
+    }
+    if (!bw || !bh) bw = bh = 0;
+
+    uint32_t bytes = A4_ROW(bw) * bh;
+    glyph_t *g     = glyph_new(GLYPH_KEY(px, cp->valueint), GLYPH_READY, bytes);
+    if (!g) return NULL;
+    if (bytes) {
+        size_t n = 0;
+        if (!cJSON_IsString(bmp) ||
+            mbedtls_base64_decode(g->bmp, bytes, &n, (const unsigned char *)bmp->valuestring,
+                                  strlen(bmp->valuestring)) != 0 || n != bytes) {
+            ESP_LOGW(TAG, "U+%04X: bitmap size mismatch", cp->valueint);
+            heap_caps_free(g);
+            return NULL;
+        }
+    }
+    g->adv_w = (uint8_t)LV_CLAMP(0, cJSON_IsNumber(adv) ? adv->valueint : bw, 255);
+    g->box_w = (uint8_t)bw;
+    g->box_h = (uint8_t)bh;
+    g->ofs_x = (int8_t)LV_CLAMP(-128, cJSON_IsNumber(x) ? x->valueint : 0, 127);
+    g->ofs_y = (int8_t)LV_CLAMP(-128, cJSON_IsNumber(y) ? y->valueint : 0, 127);
+    return g;
+}
+
+/** 登记一个 {"size", "glyphs"} 批次，返回新增字形数 */
+static uint32_t feed_batch(const cJSON *root) {
+    uint32_t added  = 0;
+    cJSON   *size   = cJSON_GetObjectItem(root, "size");
+    cJSON   *glyphs = cJSON_GetObjectItem(root, "glyphs");
+    if (!cJSON_IsNumber(size) || size->valueint <= 0 || size->valueint > 255 || !cJSON_IsArray(glyphs)) {
+        ESP_LOGW(TAG, "glyphs: need size/glyphs");
+        return 0;
+    }
+    cJSON *it;
+    cJSON_ArrayForEach(it, glyphs) {
+        glyph_t *g = glyph_parse((uint8_t)size->valueint, it);   /* 分配与解码在锁外 */
+        if (!g) continue;
+        CACHE_LOCK();
+        glyph_t *old = find(g->key);
+        if (old) glyph_unlink_free(old);   /* 排队 / 请求中的标记，或重复下发 */
+        glyph_link(g);
+        trim();
+        s_stats.received++;
+        s_dirty = true;
+        CACHE_UNLOCK();
+        added++;
+    }
+    ESP_LOGD(TAG, "received %" PRIu32 " glyphs (%d px)", added, size->valueint);
+    return added;
+}
+
+bool sdui_glyph_feed(const char *json_str) {
+    if (!s_lock || !json_str) return false;
+    cJSON *root = cJSON_Parse(json_str);
+    if (!root) { ESP_LOGW(TAG, "glyphs: JSON parse failed"); return false; }
+
+    /* 总线通道满时相邻的几个批次合成一个数组 */
+    uint32_t added = 0;
+    if (cJSON_IsArray(root)) {
+        cJSON *b;
+        cJSON_ArrayForEach(b, root) added += feed_batch(b);
+    } else {
+        added = feed_batch(root);
+    }
+    cJSON_Delete(root);
+    if (added) glyph_save_maybe();
+    return added > 0;
+}
+
+void sdui_glyph_persist(const char *path) {
+    if (!s_lock || !path || strlen(path) >= sizeof(s_persist_path)) return;
+    strcpy(s_persist_path, path);
+    glyph_load(path);
+}
+
+void sdui_glyph_get_stats(sdui_glyph_cache_stats_t *out) {
+    if (!out) return;
+    if (!s_lock) { memset(out, 0, sizeof(*out)); return; }
+    CACHE_LOCK();
+    *out = s_stats;
+    CACHE_UNLOCK();
+}
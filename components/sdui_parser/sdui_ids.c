@@ -0,0 +1,115 @@
+/**
+ * @file sdui_ids.c
+ * @brief SDUI 组件 ID 注册表实现
+ *
+ * 槽位内联保存 id 哈希，探测时先比较哈希，命中后才比较字符串。
+ */
+#include "sdui_ids.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+
+static const char *TAG = "SDUI_IDS";
+
+typedef struct {
+    uint32_t    hash;
+    const char *id;    /* NULL 表示空槽；字符串由调用方持有 */
+    void       *obj;
+} id_slot_t;
+
+static id_slot_t *s_slots = NULL;
+static uint32_t   s_cap   = 0;
+static int        s_count = 0;
+
+uint32_t sdui_ids_hash(const char *s) {
+    uint32_t h = 2166136261u;
+    while (*s) { h ^= (uint8_t)*s++; h *= 16777619u; }
+    return h;
+}
+
+static id_slot_t *slots_alloc(uint32_t cap) {
+    id_slot_t *slots = heap_caps_calloc(cap, sizeof(id_slot_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!slots) ESP_LOGE(TAG, "PSRAM alloc failed (%u slots)", (unsigned)cap);
+    return slots;
+}
+
+/** 查找 id 所在槽位；未命中时返回应插入的空槽 */
+static id_slot_t *slot_find(id_slot_t *slots, uint32_t cap, uint32_t hash, const char *id) {
+    uint32_t mask = cap - 1;
+    for (uint32_t i = hash & mask; ; i = (i + 1) & mask) {
+        id_slot_t *sl = &slots[i];
+        if (!sl->id) return sl;
+        if (sl->hash == hash && !strcmp(sl->id, id)) return sl;
+    }
+}
+
+static bool table_grow(void) {
+    uint32_t   new_cap = s_cap ? s_cap * 2 : SDUI_IDS_INIT_CAP;
+    id_slot_t *slots   = slots_alloc(new_cap);
+    if (!slots) return false;
+    for (uint32_t i = 0; i < s_cap; i++) {
+        id_slot_t *old = &s_slots[i];
+        if (old->id) *slot_find(slots, new_cap, old->hash, old->id) = *old;
+    }
+    heap_caps_free(s_slots);
+    s_slots = slots;
+    s_cap   = new_cap;
+    return true;
+}
+
+/** 删除槽位并回移后续探测链 (backward-shift)，无需墓碑 */
+static void slot_remove(id_slot_t *sl) {
+    uint32_t mask = s_cap - 1;
+    uint32_t i    = (uint32_t)(sl - s_slots);
+    for (uint32_t j = (i + 1) & mask; s_slots[j].id; j = (j + 1) & mask) {
+        uint32_t home = s_slots[j].hash & mask;
+        /* home 不在 (i, j] 循环区间内时，j 处元素可以回填到 i */
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            s_slots[i] = s_slots[j];
+            i = j;
+        }
+    }
+    memset(&s_slots[i], 0, sizeof(id_slot_t));
+    s_count--;
+}
+
+void sdui_ids_init(void) {
+    if (!s_slots) table_grow();
+    sdui_ids_clear();
+}
+
+bool sdui_ids_put(const char *id, void *obj) {
+    if ((uint32_t)(s_count + 1) * 4 > s_cap * 3 && !table_grow()) return false;
+    uint32_t   hash = sdui_ids_hash(id);
+    id_slot_t *sl   = slot_find(s_slots, s_cap, hash, id);
+    if (sl->id) {
+        ESP_LOGW(TAG, "Duplicate id '%s', rebinding to newest widget", id);
+    } else {
+        s_count++;
+    }
+    sl->hash = hash;
+    sl->id   = id;
+    sl->obj  = obj;
+    return true;
+}
+
+void *sdui_ids_get(const char *id) {
+    if (!id || !s_slots) return NULL;
+    id_slot_t *sl = slot_find(s_slots, s_cap, sdui_ids_hash(id), id);
+    return sl->id ? sl->obj : NULL;
+}
+
+void sdui_ids_remove(const char *id, const void *obj) {
+    if (!id || !s_slots) return;
+    id_slot_t *sl = slot_find(s_slots, s_cap, sdui_ids_hash(id), id);
+    if (sl->id && sl->obj == obj) slot_remove(sl);
+}
+
+void sdui_ids_clear(void) {
+    if (s_slots) memset(s_slots, 0, s_cap * sizeof(id_slot_t));
+    s_count = 0;
+}
+
+int sdui_ids_count(void) {
+    return s_count;
+}
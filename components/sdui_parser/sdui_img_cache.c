@@ -0,0 +1,141 @@
+/**
+ * @file sdui_img_cache.c
+ * @brief SDUI 按内容寻址的图片缓存实现
+ *
+ * 条目数通常只有几十个，查找直接遍历 LRU 双向链表；
+ * 淘汰从表尾开始，跳过仍有引用的条目。
+ */
+#include "sdui_img_cache.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+#include <inttypes.h>
+
+static const char *TAG = "SDUI_IMG_CACHE";
+
+static SemaphoreHandle_t  s_lock   = NULL;
+static sdui_img_entry_t  *s_head   = NULL;   /* 最近使用 */
+static sdui_img_entry_t  *s_tail   = NULL;   /* 最久未用 */
+static size_t             s_budget = SDUI_IMG_CACHE_BUDGET;
+static sdui_image_cache_stats_t s_stats;
+
+#define CACHE_LOCK()   xSemaphoreTake(s_lock, portMAX_DELAY)
+#define CACHE_UNLOCK() xSemaphoreGive(s_lock)
+
+/* ---- 链表操作（持锁） ---- */
+static void lru_unlink(sdui_img_entry_t *e) {
+    if (e->prev) e->prev->next = e->next; else s_head = e->next;
+    if (e->next) e->next->prev = e->prev; else s_tail = e->prev;
+    e->prev = e->next = NULL;
+}
+
+static void lru_push_front(sdui_img_entry_t *e) {
+    e->prev = NULL;
+    e->next = s_head;
+    if (s_head) s_head->prev = e; else s_tail = e;
+    s_head = e;
+}
+
+static sdui_img_entry_t *lru_find(const char *ref) {
+    for (sdui_img_entry_t *e = s_head; e; e = e->next)
+        if (!strcmp(e->ref, ref)) return e;
+    return NULL;
+}
+
+/** 超出预算时从表尾淘汰无引用条目 */
+static void trim(void) {
+    sdui_img_entry_t *e = s_tail;
+    while (e && s_stats.bytes > s_budget) {
+        sdui_img_entry_t *prev = e->prev;
+        if (e->refs == 0) {
+            lru_unlink(e);
+            s_stats.bytes -= e->size;
+            s_stats.entries--;
+            s_stats.evictions++;
+            ESP_LOGD(TAG, "evict %s (%" PRIu32 " B)", e->ref, e->size);
+            heap_caps_free(e->buf);
+            heap_caps_free(e);
+        }
+        e = prev;
+    }
+}
+
+/* ======================================================
+ * 公共接口
+ * ====================================================== */
+void sdui_img_cache_init(size_t budget) {
+    if (s_lock) return;
+    s_lock = xSemaphoreCreateMutex();
+    if (budget) s_budget = budget;
+    s_stats.budget = (uint32_t)s_budget;
+    ESP_LOGI(TAG, "image cache budget %u KB", (unsigned)(s_budget / 1024));
+}
+
+sdui_img_entry_t *sdui_img_cache_acquire(const char *ref) {
+    if (!s_lock || !ref) return NULL;
+    CACHE_LOCK();
+    sdui_img_entry_t *e = lru_find(ref);
+    if (e) {
+        e->refs++;
+        lru_unlink(e);
+        lru_push_front(e);
+        s_stats.hits++;
+    } else {
+        s_stats.misses++;
+    }
+    CACHE_UNLOCK();
+    return e;
+}
+
+sdui_img_entry_t *sdui_img_cache_insert(const char *ref, uint8_t *buf, uint32_t size, uint16_t w, uint16_t h) {
+    if (!s_lock || !ref || !buf || !ref[0] || strlen(ref) > SDUI_IMG_REF_MAX) return NULL;
+
+    /* 分配放在锁外，尽量缩短持锁时间 */
+    sdui_img_entry_t *n = heap_caps_calloc(1, sizeof(sdui_img_entry_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!n) return NULL;
+    strcpy(n->ref, ref);
+    n->buf  = buf;
+    n->size = size;
+    n->w    = w;
+    n->h    = h;
+    n->refs = 1;
+
+    CACHE_LOCK();
+    sdui_img_entry_t *e = lru_find(ref);
+    if (e) {
+        /* 并发解码了同一张图：保留已有条目 */
+        e->refs++;
+        lru_unlink(e);
+        lru_push_front(e);
+    } else {
+        lru_push_front(n);
+        s_stats.bytes += size;
+        s_stats.entries++;
+        trim();
+    }
+    CACHE_UNLOCK();
+
+    if (e) {
+        heap_caps_free(buf);
+        heap_caps_free(n);
+        return e;
+    }
+    return n;
+}
+
+void sdui_img_cache_release(sdui_img_entry_t *e) {
+    if (!s_lock || !e) return;
+    CACHE_LOCK();
+    if (e->refs > 0 && --e->refs == 0) trim();   /* 被引用期间可能超出预算 */
+    CACHE_UNLOCK();
+}
+
+void sdui_img_cache_get_stats(sdui_image_cache_stats_t *out) {
+    if (!out) return;
+    if (!s_lock) { memset(out, 0, sizeof(*out)); return; }
+    CACHE_LOCK();
+    *out = s_stats;
+    CACHE_UNLOCK();
+}
@@ -0,0 +1,44 @@
+/**
+ * @file sdui_img_codec.c
+ * @brief SDUI 图片压缩格式解码实现
+ */
+#include "sdui_img_codec.h"
+#include <string.h>
+
+sdui_img_format_t sdui_img_format_parse(const char *s) {
+    if (!s || !strcmp(s, "raw")) return SDUI_IMG_RAW565;
+    if (!strcmp(s, "rle565"))    return SDUI_IMG_RLE565;
+    return SDUI_IMG_UNKNOWN;
+}
+
+int32_t sdui_img_rle565_decode(const uint8_t *src, size_t len, uint8_t *dst, size_t cap) {
+    const uint8_t *p   = src;
+    const uint8_t *end = src + len;
+    uint8_t       *o   = dst;
+    uint8_t       *oe  = dst + cap;
+
+    while (p < end) {
+        uint8_t op = *p++;
+        if (op < 0x80) {
+            /* 字面量 */
+            size_t n = ((size_t)op + 1) * 2;
+            if ((size_t)(end - p) < n || (size_t)(oe - o) < n) return -1;
+            memcpy(o, p, n);
+            p += n;
+            o += n;
+        } else {
+            /* 重复：按 4 字节（两像素）填充，奇数个像素补一个 */
+            size_t n = ((size_t)op - 0x7F) * 2;
+            if (end - p < 2 || (size_t)(oe - o) < n) return -1;
+            uint8_t  pix[4] = { p[0], p[1], p[0], p[1] };
+            uint32_t v;
+            memcpy(&v, pix, 4);
+            p += 2;
+            size_t i = 0;
+            for (; i + 4 <= n; i += 4) memcpy(o + i, &v, 4);
+            if (i < n) memcpy(o + i, pix, 2);
+            o += n;
+        }
+    }
+    return (int32_t)(o - dst);
+}
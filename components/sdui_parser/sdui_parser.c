@@ -3,22 +3,40 @@
  * @brief SDUI 容器化布局解析引擎实现 (增强版)
  *
  * 将 Server 下发的 JSON UI 树递归解析为 LVGL 对象。
- * 支持组件类型: container, label, button, image, bar, slider, particle
+ * 支持组件类型: container, label, button, image, bar, slider, particle, list
  * 支持布局: flex-box (row/column), 对齐方式, 尺寸百分比/像素
  * 支持事件: on_click, on_press, on_release, on_change → Action URI
- * 支持动画: anim 字段 (blink/breathe/spin/slide_in/shake/color_pulse/marquee)
+ * 支持动画: anim 字段 (blink/breathe/spin/slide_in/shake/color_pulse/marquee/none)
  * 支持特效: 页面切换 Fade 过渡, 粒子系统 (PSRAM Canvas)
+ * 支持增量: 根节点 "reconcile": true 时按 id/位置 对比新旧树，仅修改差异属性
+ * 支持绑定: text / value 写成 "{var}" 模板时绑定状态变量，state/set 只重绘引用它的组件
+ * 全量布局由 sdui_json 事件流式构建（峰值内存随树深度而非载荷增长），按时间预算分段持锁；
+ * 增量布局建成 DOM 后在锁外准备，锁内按时间预算分片构建
  */
 #include "sdui_parser.h"
 #include "sdui_bus.h"
+#include "sdui_json.h"
+#include "sdui_img_codec.h"
+#include "sdui_img_cache.h"
+#include "sdui_ids.h"
+#include "sdui_glyph.h"
+#include "sdui_anim.h"
+#include "sdui_perf.h"
+#include "sdui_particles.h"
+#include "sdui_props.h"
+#include "sdui_state.h"
 #include "audio_manager.h"
 #include "cJSON.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "mbedtls/base64.h"
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <inttypes.h>
 #include <math.h>
 
 static const char *TAG = "SDUI_PARSER";
@@ -26,18 +44,38 @@ static const char *TAG = "SDUI_PARSER";
 /* ---- 根视图 ---- */
 static lv_obj_t *s_root_view = NULL;
 
-/* ---- ID 注册表 ---- */
-#define MAX_ID_ENTRIES 64
+/** 组件类型 */
+typedef enum {
+    WT_UNKNOWN = 0,
+    WT_CONTAINER,
+    WT_LABEL,
+    WT_BUTTON,
+    WT_IMAGE,
+    WT_BAR,
+    WT_SLIDER,
+    WT_PARTICLE,
+    WT_LIST,
+} widget_type_t;
+
+/** 单个属性签名：键哈希 + 值哈希，val 为 0 表示已被 ui/update 改写（脏） */
 typedef struct {
-    char id[32];
-    lv_obj_t *obj;
-} id_entry_t;
-static id_entry_t s_id_table[MAX_ID_ENTRIES];
-static int        s_id_count = 0;
+    uint32_t key;
+    uint32_t val;
+} prop_sig_t;
 
-/* ---- 旋转动画计数（防止同时旋转超过 MAX_SPIN_ANIM 个） ---- */
-#define MAX_SPIN_ANIM 2
-static int s_spin_count = 0;
+/** 组件元数据，挂载到 lv_obj user_data：O(1) 反查 ID，并保存 reconcile 所需的属性签名 */
+typedef struct {
+    uint8_t     type;        /* widget_type_t */
+    uint8_t     matched;     /* reconcile 匹配标记 */
+    uint16_t    prop_count;
+    prop_sig_t *props;       /* PSRAM */
+    char        id[];        /* 无 id 时为空串 */
+} widget_meta_t;
+
+/* ---- 渲染统计 ---- */
+static sdui_render_stats_t s_stats;
+static size_t              s_heap_base;   /* 构建前空闲堆，用于统计节点堆开销 */
+static uint32_t            s_view_nodes;  /* 当前界面上的 SDUI 节点数，全量替换时计为 deleted */
 
 /* -------- 数据结构 -------- */
 
@@ -48,10 +86,11 @@ typedef struct {
     char on_release[64];
 } action_data_t;
 
-/** image 组件：持有解码后的图像缓冲 */
+/** image 组件：持有解码后的图像缓冲，或共享一个缓存条目 */
 typedef struct {
-    lv_image_dsc_t dsc;
-    uint8_t       *data_buf; /* heap_caps_malloc(PSRAM) */
+    lv_image_dsc_t    dsc;
+    uint8_t          *data_buf; /* heap_caps_malloc(PSRAM)，来自缓存时为 NULL */
+    sdui_img_entry_t *entry;    /* 图片缓存条目（持有一次引用），私有位图为 NULL */
 } image_data_t;
 
 /** slider on_change 用户数据 */
@@ -60,39 +99,37 @@ typedef struct {
     char id[32];
 } slider_data_t;
 
-/** color_pulse 动画目标颜色对 */
+/** color_pulse 动画目标颜色对（由动画调度器随动画释放） */
 typedef struct {
-    lv_obj_t  *obj;
     lv_color_t color_a;
     lv_color_t color_b;
 } color_anim_data_t;
 
-/** 粒子系统数据 */
-#define MAX_PARTICLES 30
+/** 粒子系统数据（物理与绘制见 sdui_particles.c） */
 typedef struct {
-    float   x, y;
-    float   vx, vy;
-    uint8_t alpha;
-    bool    active;
-} particle_t;
+    lv_obj_t         *canvas;
+    sdui_particles_t *ps;
+    uint8_t          *canvas_buf;
+    lv_timer_t       *timer;
+} particle_data_t;
 
+/**
+ * 节点属性表：节点成员只遍历一次，键经 sdui_props 完美哈希映射为记号后
+ * 按下标存放，之后各处直接取值，不再逐键线性查找。
+ * 同名键以第一个为准（与 cJSON_GetObjectItem 一致）。
+ */
 typedef struct {
-    lv_obj_t     *canvas;
-    particle_t    p[MAX_PARTICLES];
-    int           count;
-    lv_color_t    color;
-    int           size;
-    uint8_t      *canvas_buf;
-    lv_timer_t   *timer;
-    int           canvas_w;
-    int           canvas_h;
-} particle_data_t;
+    cJSON *v[SDUI_TOK_NUM_KEYS];
+} node_props_t;
+
+#define NP(p, key) ((p)->v[SDUI_TOK_##key])
 
 /* --------- 前向声明 --------- */
-static void      parse_node(cJSON *node, lv_obj_t *parent);
-static void      apply_common_style(cJSON *node, lv_obj_t *obj);
+static lv_obj_t *parse_node(cJSON *node, lv_obj_t *parent);
+static void      apply_common_style(const node_props_t *p, lv_obj_t *obj);
 static void      apply_anim(cJSON *anim_node, lv_obj_t *obj);
-static void      register_id(const char *id, lv_obj_t *obj);
+static void      attach_meta(lv_obj_t *obj, widget_type_t type, cJSON *node, const node_props_t *p);
+static const char *widget_id_of(lv_obj_t *obj);
 static void      action_event_cb(lv_event_t *e);
 static void      dispatch_action(const char *uri, const char *widget_id);
 
@@ -106,38 +143,54 @@ static lv_color_t parse_color(const char *hex_str) {
     return lv_color_hex((uint32_t)strtol(hex_str + 1, NULL, 16));
 }
 
-static lv_align_t parse_align(const char *s) {
-    if (!s) return LV_ALIGN_DEFAULT;
-    if (!strcmp(s, "center"))       return LV_ALIGN_CENTER;
-    if (!strcmp(s, "top_mid"))      return LV_ALIGN_TOP_MID;
-    if (!strcmp(s, "top_left"))     return LV_ALIGN_TOP_LEFT;
-    if (!strcmp(s, "top_right"))    return LV_ALIGN_TOP_RIGHT;
-    if (!strcmp(s, "bottom_mid"))   return LV_ALIGN_BOTTOM_MID;
-    if (!strcmp(s, "bottom_left"))  return LV_ALIGN_BOTTOM_LEFT;
-    if (!strcmp(s, "bottom_right")) return LV_ALIGN_BOTTOM_RIGHT;
-    if (!strcmp(s, "left_mid"))     return LV_ALIGN_LEFT_MID;
-    if (!strcmp(s, "right_mid"))    return LV_ALIGN_RIGHT_MID;
-    return LV_ALIGN_DEFAULT;
-}
-
-static lv_flex_flow_t parse_flex_flow(const char *s) {
-    if (!s) return LV_FLEX_FLOW_COLUMN;
-    if (!strcmp(s, "row"))         return LV_FLEX_FLOW_ROW;
-    if (!strcmp(s, "column"))      return LV_FLEX_FLOW_COLUMN;
-    if (!strcmp(s, "row_wrap"))    return LV_FLEX_FLOW_ROW_WRAP;
-    if (!strcmp(s, "column_wrap")) return LV_FLEX_FLOW_COLUMN_WRAP;
-    return LV_FLEX_FLOW_COLUMN;
-}
-
-static lv_flex_align_t parse_flex_align(const char *s) {
-    if (!s) return LV_FLEX_ALIGN_START;
-    if (!strcmp(s, "start"))         return LV_FLEX_ALIGN_START;
-    if (!strcmp(s, "end"))           return LV_FLEX_ALIGN_END;
-    if (!strcmp(s, "center"))        return LV_FLEX_ALIGN_CENTER;
-    if (!strcmp(s, "space_evenly"))  return LV_FLEX_ALIGN_SPACE_EVENLY;
-    if (!strcmp(s, "space_around"))  return LV_FLEX_ALIGN_SPACE_AROUND;
-    if (!strcmp(s, "space_between")) return LV_FLEX_ALIGN_SPACE_BETWEEN;
-    return LV_FLEX_ALIGN_START;
+/** 扫描节点成员建立属性表（未收录的键忽略） */
+static void node_props_scan(node_props_t *p, const cJSON *node) {
+    memset(p, 0, sizeof(*p));
+    cJSON *it = NULL;
+    cJSON_ArrayForEach(it, node) {
+        sdui_tok_t t = sdui_tok_lookup(it->string);
+        if (sdui_tok_is_key(t) && !p->v[t]) p->v[t] = it;
+    }
+}
+
+/** 字符串取值 → 记号；非字符串或未收录为 SDUI_TOK_UNKNOWN */
+static sdui_tok_t value_tok(const cJSON *item) {
+    return cJSON_IsString(item) ? sdui_tok_lookup(item->valuestring) : SDUI_TOK_UNKNOWN;
+}
+
+static lv_align_t parse_align(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_CENTER:       return LV_ALIGN_CENTER;
+        case SDUI_TOK_TOP_MID:      return LV_ALIGN_TOP_MID;
+        case SDUI_TOK_TOP_LEFT:     return LV_ALIGN_TOP_LEFT;
+        case SDUI_TOK_TOP_RIGHT:    return LV_ALIGN_TOP_RIGHT;
+        case SDUI_TOK_BOTTOM_MID:   return LV_ALIGN_BOTTOM_MID;
+        case SDUI_TOK_BOTTOM_LEFT:  return LV_ALIGN_BOTTOM_LEFT;
+        case SDUI_TOK_BOTTOM_RIGHT: return LV_ALIGN_BOTTOM_RIGHT;
+        case SDUI_TOK_LEFT_MID:     return LV_ALIGN_LEFT_MID;
+        case SDUI_TOK_RIGHT_MID:    return LV_ALIGN_RIGHT_MID;
+        default:                    return LV_ALIGN_DEFAULT;
+    }
+}
+
+static lv_flex_flow_t parse_flex_flow(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_ROW:         return LV_FLEX_FLOW_ROW;
+        case SDUI_TOK_ROW_WRAP:    return LV_FLEX_FLOW_ROW_WRAP;
+        case SDUI_TOK_COLUMN_WRAP: return LV_FLEX_FLOW_COLUMN_WRAP;
+        default:                   return LV_FLEX_FLOW_COLUMN;
+    }
+}
+
+static lv_flex_align_t parse_flex_align(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_END:           return LV_FLEX_ALIGN_END;
+        case SDUI_TOK_CENTER:        return LV_FLEX_ALIGN_CENTER;
+        case SDUI_TOK_SPACE_EVENLY:  return LV_FLEX_ALIGN_SPACE_EVENLY;
+        case SDUI_TOK_SPACE_AROUND:  return LV_FLEX_ALIGN_SPACE_AROUND;
+        case SDUI_TOK_SPACE_BETWEEN: return LV_FLEX_ALIGN_SPACE_BETWEEN;
+        default:                     return LV_FLEX_ALIGN_START;
+    }
 }
 
 static lv_coord_t parse_size_value(cJSON *item) {
@@ -145,93 +198,199 @@ static lv_coord_t parse_size_value(cJSON *item) {
     if (cJSON_IsNumber(item)) return (lv_coord_t)item->valueint;
     if (cJSON_IsString(item)) {
         const char *s = item->valuestring;
-        if (!strcmp(s, "full"))    return lv_pct(100);
-        if (!strcmp(s, "content")) return LV_SIZE_CONTENT;
         int len = strlen(s);
         if (len > 1 && s[len - 1] == '%') return lv_pct(atoi(s));
+        switch (sdui_tok_lookup(s)) {
+            case SDUI_TOK_FULL:    return lv_pct(100);
+            case SDUI_TOK_CONTENT: return LV_SIZE_CONTENT;
+            default:               break;
+        }
         return (lv_coord_t)atoi(s);
     }
     return LV_SIZE_CONTENT;
 }
 
+/* font_size 档位：Montserrat 绘制 ASCII，其余字形按需下发（sdui_glyph），由 init 创建 */
+static const struct {
+    int              px;
+    const lv_font_t *base;
+} s_font_sizes[] = {
+    {26, &lv_font_montserrat_26},
+    {24, &lv_font_montserrat_24},
+    {20, &lv_font_montserrat_20},
+    {16, &lv_font_montserrat_16},
+    {14, &lv_font_montserrat_14},
+};
+#define FONT_SIZE_COUNT (sizeof(s_font_sizes) / sizeof(s_font_sizes[0]))
+static const lv_font_t *s_fonts[FONT_SIZE_COUNT];
+
+static const lv_font_t *pick_font(int sz) {
+    size_t i = 0;
+    while (i < FONT_SIZE_COUNT - 1 && sz < s_font_sizes[i].px) i++;
+    return s_fonts[i] ? s_fonts[i] : s_font_sizes[i].base;
+}
+
+/* ======================================================
+ * 共享样式类 (ui/styles)
+ *   每个类是一个 lv_style_t，单独分配在 PSRAM 中、地址终生不变，
+ *   节点通过 "class" 属性 lv_obj_add_style 引用，不再为每个对象
+ *   生成一份本地样式。重定义同名类时原地重置并通知引用对象刷新。
+ * ====================================================== */
+#define STYLE_CLASS_NAME_MAX 24
+
+typedef struct {
+    char       name[STYLE_CLASS_NAME_MAX];
+    lv_style_t style;
+} style_class_t;
+
+static style_class_t **s_classes     = NULL;
+static uint16_t        s_class_count = 0;
+static uint16_t        s_class_cap   = 0;
+
+static style_class_t *find_class(const char *name, size_t len) {
+    for (uint16_t i = 0; i < s_class_count; i++) {
+        if (strlen(s_classes[i]->name) == len && !memcmp(s_classes[i]->name, name, len)) return s_classes[i];
+    }
+    return NULL;
+}
+
+static style_class_t *add_class(const char *name) {
+    if (s_class_count == s_class_cap) {
+        uint16_t cap = s_class_cap ? s_class_cap * 2 : 8;
+        style_class_t **grown = heap_caps_realloc(s_classes, cap * sizeof(style_class_t *),
+                                                  MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!grown) return NULL;
+        s_classes   = grown;
+        s_class_cap = cap;
+    }
+    style_class_t *cls = heap_caps_calloc(1, sizeof(style_class_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!cls) return NULL;
+    strncpy(cls->name, name, STYLE_CLASS_NAME_MAX - 1);
+    lv_style_init(&cls->style);
+    s_classes[s_class_count++] = cls;
+    return cls;
+}
+
+/** 样式类属性：通用样式中可放入 lv_style_t 的部分（尺寸由各组件本地设置，不入类） */
+static void fill_class_style(lv_style_t *st, cJSON *props) {
+    node_props_t p;
+    node_props_scan(&p, props);
+    cJSON *it;
+    if ((it = NP(&p, BG_COLOR)) && cJSON_IsString(it)) {
+        lv_style_set_bg_color(st, parse_color(it->valuestring));
+        lv_style_set_bg_opa(st, LV_OPA_COVER);
+    }
+    if ((it = NP(&p, BG_OPA)) && cJSON_IsNumber(it))       lv_style_set_bg_opa(st, (lv_opa_t)it->valueint);
+    if ((it = NP(&p, PAD)) && cJSON_IsNumber(it))          lv_style_set_pad_all(st, (lv_coord_t)it->valueint);
+    if ((it = NP(&p, RADIUS)) && cJSON_IsNumber(it))       lv_style_set_radius(st, (lv_coord_t)it->valueint);
+    if ((it = NP(&p, GAP)) && cJSON_IsNumber(it)) {
+        lv_style_set_pad_row(st,    (lv_coord_t)it->valueint);
+        lv_style_set_pad_column(st, (lv_coord_t)it->valueint);
+    }
+    if ((it = NP(&p, BORDER_W)) && cJSON_IsNumber(it))     lv_style_set_border_width(st, (lv_coord_t)it->valueint);
+    if ((it = NP(&p, BORDER_COLOR)) && cJSON_IsString(it)) lv_style_set_border_color(st, parse_color(it->valuestring));
+    if ((it = NP(&p, TEXT_COLOR)) && cJSON_IsString(it))   lv_style_set_text_color(st, parse_color(it->valuestring));
+    if ((it = NP(&p, FONT_SIZE)) && cJSON_IsNumber(it))    lv_style_set_text_font(st, pick_font(it->valueint));
+    if ((it = NP(&p, SHADOW_W)) && cJSON_IsNumber(it))     lv_style_set_shadow_width(st, (lv_coord_t)it->valueint);
+    if ((it = NP(&p, SHADOW_COLOR)) && cJSON_IsString(it)) lv_style_set_shadow_color(st, parse_color(it->valuestring));
+    if ((it = NP(&p, OPA)) && cJSON_IsNumber(it))          lv_style_set_opa(st, (lv_opa_t)it->valueint);
+}
+
+/** 移除对象上引用的全部样式类（本地样式不受影响） */
+static void remove_classes(lv_obj_t *obj) {
+    for (uint16_t i = 0; i < s_class_count; i++) lv_obj_remove_style(obj, &s_classes[i]->style, 0);
+}
+
+/** "a b c" → 依次 lv_obj_add_style，后者优先；本地样式始终优先于类 */
+static void apply_class_list(const char *p, lv_obj_t *obj) {
+    while (*p) {
+        while (*p == ' ') p++;
+        const char *e = p;
+        while (*e && *e != ' ') e++;
+        if (e > p) {
+            style_class_t *c = find_class(p, (size_t)(e - p));
+            if (c) lv_obj_add_style(obj, &c->style, 0);
+            else   ESP_LOGW(TAG, "Unknown style class: %.*s", (int)(e - p), p);
+        }
+        p = e;
+    }
+}
+
+static void apply_classes(const cJSON *cls, lv_obj_t *obj) {
+    if (cls && cJSON_IsString(cls)) apply_class_list(cls->valuestring, obj);
+}
+
 /* ======================================================
  * 公共样式应用
  * ====================================================== */
-static void apply_common_style(cJSON *node, lv_obj_t *obj) {
-    cJSON *w = cJSON_GetObjectItem(node, "w");
-    cJSON *h = cJSON_GetObjectItem(node, "h");
+static void apply_common_style(const node_props_t *p, lv_obj_t *obj) {
+    cJSON *w = NP(p, W);
+    cJSON *h = NP(p, H);
     if (w) lv_obj_set_width(obj,  parse_size_value(w));
     if (h) lv_obj_set_height(obj, parse_size_value(h));
 
-    cJSON *align = cJSON_GetObjectItem(node, "align");
+    cJSON *align = NP(p, ALIGN);
     if (align && cJSON_IsString(align)) {
         int xo = 0, yo = 0;
-        cJSON *xi = cJSON_GetObjectItem(node, "x");
-        cJSON *yi = cJSON_GetObjectItem(node, "y");
+        cJSON *xi = NP(p, X);
+        cJSON *yi = NP(p, Y);
         if (xi) xo = xi->valueint;
         if (yi) yo = yi->valueint;
-        lv_obj_align(obj, parse_align(align->valuestring), xo, yo);
+        lv_obj_align(obj, parse_align(value_tok(align)), xo, yo);
     }
 
-    cJSON *bg_color = cJSON_GetObjectItem(node, "bg_color");
+    cJSON *bg_color = NP(p, BG_COLOR);
     if (bg_color && cJSON_IsString(bg_color)) {
         lv_obj_set_style_bg_color(obj, parse_color(bg_color->valuestring), 0);
         lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
     }
-    cJSON *bg_opa = cJSON_GetObjectItem(node, "bg_opa");
+    cJSON *bg_opa = NP(p, BG_OPA);
     if (bg_opa && cJSON_IsNumber(bg_opa))
         lv_obj_set_style_bg_opa(obj, (lv_opa_t)bg_opa->valueint, 0);
 
-    cJSON *pad = cJSON_GetObjectItem(node, "pad");
+    cJSON *pad = NP(p, PAD);
     if (pad && cJSON_IsNumber(pad))
         lv_obj_set_style_pad_all(obj, (lv_coord_t)pad->valueint, 0);
 
-    cJSON *radius = cJSON_GetObjectItem(node, "radius");
+    cJSON *radius = NP(p, RADIUS);
     if (radius && cJSON_IsNumber(radius))
         lv_obj_set_style_radius(obj, (lv_coord_t)radius->valueint, 0);
 
-    cJSON *gap = cJSON_GetObjectItem(node, "gap");
+    cJSON *gap = NP(p, GAP);
     if (gap && cJSON_IsNumber(gap)) {
         lv_obj_set_style_pad_row(obj,    (lv_coord_t)gap->valueint, 0);
         lv_obj_set_style_pad_column(obj, (lv_coord_t)gap->valueint, 0);
     }
 
-    cJSON *bw = cJSON_GetObjectItem(node, "border_w");
+    cJSON *bw = NP(p, BORDER_W);
     if (bw && cJSON_IsNumber(bw))
         lv_obj_set_style_border_width(obj, (lv_coord_t)bw->valueint, 0);
-    cJSON *bc = cJSON_GetObjectItem(node, "border_color");
+    cJSON *bc = NP(p, BORDER_COLOR);
     if (bc && cJSON_IsString(bc))
         lv_obj_set_style_border_color(obj, parse_color(bc->valuestring), 0);
 
-    cJSON *tc = cJSON_GetObjectItem(node, "text_color");
+    cJSON *tc = NP(p, TEXT_COLOR);
     if (tc && cJSON_IsString(tc))
         lv_obj_set_style_text_color(obj, parse_color(tc->valuestring), 0);
 
-    cJSON *fs = cJSON_GetObjectItem(node, "font_size");
-    if (fs && cJSON_IsNumber(fs)) {
-        int sz = fs->valueint;
-        const lv_font_t *font = &lv_font_montserrat_14;
-        if (sz >= 26)      font = &lv_font_montserrat_26;
-        else if (sz >= 24) font = &lv_font_montserrat_24;
-        else if (sz >= 20) font = &lv_font_montserrat_20;
-        else if (sz >= 16) font = &lv_font_montserrat_16;
-        lv_obj_set_style_text_font(obj, font, 0);
-    }
+    cJSON *fs = NP(p, FONT_SIZE);
+    if (fs && cJSON_IsNumber(fs))
+        lv_obj_set_style_text_font(obj, pick_font(fs->valueint), 0);
 
     /* 阴影 */
-    cJSON *sw = cJSON_GetObjectItem(node, "shadow_w");
+    cJSON *sw = NP(p, SHADOW_W);
     if (sw && cJSON_IsNumber(sw))
         lv_obj_set_style_shadow_width(obj, sw->valueint, 0);
-    cJSON *sc = cJSON_GetObjectItem(node, "shadow_color");
+    cJSON *sc = NP(p, SHADOW_COLOR);
     if (sc && cJSON_IsString(sc))
         lv_obj_set_style_shadow_color(obj, parse_color(sc->valuestring), 0);
 
     /* 整体不透明度 */
-    cJSON *opa = cJSON_GetObjectItem(node, "opa");
+    cJSON *opa = NP(p, OPA);
     if (opa && cJSON_IsNumber(opa))
         lv_obj_set_style_opa(obj, (lv_opa_t)opa->valueint, 0);
 
-    cJSON *hidden = cJSON_GetObjectItem(node, "hidden");
+    cJSON *hidden = NP(p, HIDDEN);
     if (hidden && cJSON_IsTrue(hidden))
         lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
 }
@@ -242,16 +401,14 @@ static void apply_common_style(cJSON *node, lv_obj_t *obj) {
 static void action_event_cb(lv_event_t *e) {
     action_data_t *ad = (action_data_t *)lv_event_get_user_data(e);
     if (!ad) return;
-    lv_event_code_t code   = lv_event_get_code(e);
-    lv_obj_t       *target = lv_event_get_target(e);
-    const char     *wid    = "unknown";
-    for (int i = 0; i < s_id_count; i++) {
-        if (s_id_table[i].obj == target) { wid = s_id_table[i].id; break; }
-    }
-    if (code == LV_EVENT_CLICKED  && ad->on_click[0])   dispatch_action(ad->on_click,   wid);
-    if (code == LV_EVENT_PRESSED  && ad->on_press[0])   dispatch_action(ad->on_press,   wid);
-    if ((code == LV_EVENT_RELEASED || code == LV_EVENT_PRESS_LOST) && ad->on_release[0])
-        dispatch_action(ad->on_release, wid);
+    /* 以 LV_EVENT_ALL 注册，PRESSING 等高频事件在此直接返回，不做 ID 反查 */
+    lv_event_code_t code = lv_event_get_code(e);
+    const char     *uri  = NULL;
+    if      (code == LV_EVENT_CLICKED)  uri = ad->on_click;
+    else if (code == LV_EVENT_PRESSED)  uri = ad->on_press;
+    else if (code == LV_EVENT_RELEASED || code == LV_EVENT_PRESS_LOST) uri = ad->on_release;
+    if (!uri || !uri[0]) return;
+    dispatch_action(uri, widget_id_of(lv_event_get_target(e)));
 }
 
 static void dispatch_action(const char *uri, const char *wid) {
@@ -263,10 +420,10 @@ static void dispatch_action(const char *uri, const char *wid) {
     else                                         sdui_bus_publish_up("ui/click", pl);
 }
 
-static void bind_actions(cJSON *node, lv_obj_t *obj) {
-    cJSON *oc = cJSON_GetObjectItem(node, "on_click");
-    cJSON *op = cJSON_GetObjectItem(node, "on_press");
-    cJSON *or = cJSON_GetObjectItem(node, "on_release");
+static void bind_actions(const node_props_t *p, lv_obj_t *obj) {
+    cJSON *oc = NP(p, ON_CLICK);
+    cJSON *op = NP(p, ON_PRESS);
+    cJSON *or = NP(p, ON_RELEASE);
     if (!oc && !op && !or) return;
     action_data_t *ad = calloc(1, sizeof(action_data_t));
     if (!ad) return;
@@ -278,16 +435,125 @@ static void bind_actions(cJSON *node, lv_obj_t *obj) {
 
 /* ======================================================
  * ID 注册表
+ *   正向：id → lv_obj_t*，见 sdui_ids.h，槽位引用 widget_meta_t 中的 id 字符串
+ *   反向：lv_obj user_data → widget_meta_t，直接取出 ID
+ *   每个节点都挂载 widget_meta_t（无 id 时不入表），对象删除时 (LV_EVENT_DELETE)
+ *   自动移出注册表并释放，重复 ID 以最后注册者为准
+ * ====================================================== */
+static void meta_delete_cb(lv_event_t *e) {
+    widget_meta_t *meta = lv_event_get_user_data(e);
+    lv_obj_t      *obj  = lv_event_get_current_target(e);
+    if (!meta) return;
+    if (meta->id[0]) sdui_ids_remove(meta->id, obj);
+    lv_obj_set_user_data(obj, NULL);
+    heap_caps_free(meta->props);
+    heap_caps_free(meta);
+}
+
+static void register_id(widget_meta_t *meta, lv_obj_t *obj) {
+    sdui_ids_put(meta->id, obj);
+}
+
+static const char *widget_id_of(lv_obj_t *obj) {
+    widget_meta_t *meta = obj ? lv_obj_get_user_data(obj) : NULL;
+    return (meta && meta->id[0]) ? meta->id : "unknown";
+}
+
+/* ======================================================
+ * 属性签名（reconcile 比较用）
  * ====================================================== */
-static void register_id(const char *id, lv_obj_t *obj) {
-    if (s_id_count >= MAX_ID_ENTRIES) return;
-    strncpy(s_id_table[s_id_count].id, id, 31);
-    s_id_table[s_id_count].obj = obj;
-    s_id_count++;
+static uint32_t fnv_mix(uint32_t h, const void *data, size_t len) {
+    const uint8_t *p = data;
+    while (len--) { h ^= *p++; h *= 16777619u; }
+    return h;
+}
+
+/** 递归计算 JSON 值哈希，不产生任何分配 */
+static uint32_t json_hash(const cJSON *item, uint32_t h) {
+    uint8_t t = (uint8_t)(item->type & 0xFF);
+    h = fnv_mix(h, &t, 1);
+    if (cJSON_IsNumber(item)) {
+        h = fnv_mix(h, &item->valuedouble, sizeof(item->valuedouble));
+    } else if (cJSON_IsString(item)) {
+        h = fnv_mix(h, item->valuestring, strlen(item->valuestring));
+    } else if (cJSON_IsArray(item) || cJSON_IsObject(item)) {
+        const cJSON *c = NULL;
+        cJSON_ArrayForEach(c, item) {
+            if (c->string) h = fnv_mix(h, c->string, strlen(c->string) + 1);
+            h = json_hash(c, h);
+        }
+    }
+    return h;
+}
+
+/** 节点自身属性（不含 type/id/children/reconcile）才参与比较 */
+static bool is_sig_tok(sdui_tok_t t) {
+    return t != SDUI_TOK_TYPE && t != SDUI_TOK_ID && t != SDUI_TOK_CHILDREN && t != SDUI_TOK_RECONCILE;
 }
+
+/** 成员是否参与比较：排除项已在属性表中，按指针比较即可，无需再查键 */
+static bool is_sig_item(const node_props_t *p, const cJSON *it) {
+    return it->string && it != NP(p, TYPE) && it != NP(p, ID) && it != NP(p, CHILDREN) && it != NP(p, RECONCILE);
+}
+
+/** 生成节点属性签名数组 (PSRAM)，返回个数 */
+static uint16_t build_prop_sigs(cJSON *node, const node_props_t *p, prop_sig_t **out) {
+    uint16_t n = 0;
+    cJSON   *it = NULL;
+    *out = NULL;
+    cJSON_ArrayForEach(it, node) if (is_sig_item(p, it)) n++;
+    if (!n) return 0;
+    prop_sig_t *sigs = heap_caps_malloc(n * sizeof(prop_sig_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!sigs) return 0;
+    uint16_t i = 0;
+    cJSON_ArrayForEach(it, node) {
+        if (!is_sig_item(p, it)) continue;
+        sigs[i].key = sdui_ids_hash(it->string);
+        sigs[i].val = json_hash(it, 2166136261u) | 1u;   /* 保留 0 作为脏标记 */
+        i++;
+    }
+    *out = sigs;
+    return n;
+}
+
+static prop_sig_t *meta_find_sig(widget_meta_t *meta, uint32_t key) {
+    for (uint16_t i = 0; i < meta->prop_count; i++)
+        if (meta->props[i].key == key) return &meta->props[i];
+    return NULL;
+}
+
+/** ui/update 改写某属性后标记为脏，下次 reconcile 时按布局值重新应用 */
+static void meta_mark_dirty(widget_meta_t *meta, const char *key) {
+    uint32_t    kh  = sdui_ids_hash(key);
+    prop_sig_t *sig = meta_find_sig(meta, kh);
+    if (sig) { sig->val = 0; return; }
+    prop_sig_t *grown = heap_caps_realloc(meta->props, (meta->prop_count + 1) * sizeof(prop_sig_t),
+                                          MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!grown) return;
+    grown[meta->prop_count].key = kh;
+    grown[meta->prop_count].val = 0;
+    meta->props = grown;
+    meta->prop_count++;
+}
+
+static void attach_meta(lv_obj_t *obj, widget_type_t type, cJSON *node, const node_props_t *p) {
+    cJSON      *id_item = NP(p, ID);
+    const char *id      = (id_item && cJSON_IsString(id_item)) ? id_item->valuestring : "";
+    size_t      len     = strlen(id);
+
+    widget_meta_t *meta = heap_caps_calloc(1, sizeof(widget_meta_t) + len + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!meta) return;
+    meta->type = (uint8_t)type;
+    memcpy(meta->id, id, len + 1);
+    meta->prop_count = build_prop_sigs(node, p, &meta->props);
+    lv_obj_set_user_data(obj, meta);
+    lv_obj_add_event_cb(obj, meta_delete_cb, LV_EVENT_DELETE, meta);
+    if (len) register_id(meta, obj);
+}
+
 static void clear_id_table(void) {
-    s_id_count = 0;
-    memset(s_id_table, 0, sizeof(s_id_table));
+    /* 元数据随对象 LV_EVENT_DELETE 释放，这里只清空槽位 */
+    sdui_ids_clear();
 }
 
 /* ======================================================
@@ -296,48 +562,69 @@ static void clear_id_table(void) {
 static void free_action_data_cb(lv_event_t *e) {
     free(lv_event_get_user_data(e));
 }
+static void image_data_free(image_data_t *d) {
+    if (!d) return;
+    if (d->entry) sdui_img_cache_release(d->entry);
+    else          heap_caps_free(d->data_buf);
+    free(d);
+}
 static void free_image_data_cb(lv_event_t *e) {
-    image_data_t *d = lv_event_get_user_data(e);
-    if (d) { heap_caps_free(d->data_buf); free(d); }
+    image_data_free(lv_event_get_user_data(e));
 }
 static void free_slider_data_cb(lv_event_t *e) {
     free(lv_event_get_user_data(e));
 }
-static void free_color_anim_cb(lv_event_t *e) {
-    free(lv_event_get_user_data(e));
-}
-static void spin_delete_cb(lv_event_t *e) {
-    (void)e;
-    if (s_spin_count > 0) s_spin_count--;
-}
 static void free_particle_data_cb(lv_event_t *e) {
     particle_data_t *pd = lv_event_get_user_data(e);
     if (!pd) return;
     if (pd->timer) { lv_timer_delete(pd->timer); pd->timer = NULL; }
+    sdui_particles_destroy(pd->ps);
     if (pd->canvas_buf) heap_caps_free(pd->canvas_buf);
     free(pd);
 }
 
 /* ======================================================
- * 动画 exec_cb 函数
+ * 动画取值写入（apply 回调，经 sdui_anim 调度）
  * ====================================================== */
 static void anim_opa_exec_cb(void *var, int32_t v) {
     lv_obj_set_style_opa((lv_obj_t *)var, (lv_opa_t)v, 0);
 }
-static void anim_translate_x_exec_cb(void *var, int32_t v) {
-    lv_obj_set_style_translate_x((lv_obj_t *)var, v, 0);
+static void anim_apply_opa(lv_obj_t *obj, int32_t v, void *ctx) {
+    lv_obj_set_style_opa(obj, (lv_opa_t)v, 0);
+}
+static void anim_apply_translate_x(lv_obj_t *obj, int32_t v, void *ctx) {
+    lv_obj_set_style_translate_x(obj, v, 0);
 }
-static void anim_translate_y_exec_cb(void *var, int32_t v) {
-    lv_obj_set_style_translate_y((lv_obj_t *)var, v, 0);
+static void anim_apply_translate_y(lv_obj_t *obj, int32_t v, void *ctx) {
+    lv_obj_set_style_translate_y(obj, v, 0);
 }
-static void anim_rotation_exec_cb(void *var, int32_t v) {
-    lv_image_set_rotation((lv_obj_t *)var, (int16_t)v);
+static void anim_apply_rotation(lv_obj_t *obj, int32_t v, void *ctx) {
+    lv_image_set_rotation(obj, (int16_t)v);
 }
-static void anim_color_exec_cb(void *var, int32_t v) {
-    color_anim_data_t *cad = (color_anim_data_t *)var;
+static void anim_apply_color(lv_obj_t *obj, int32_t v, void *ctx) {
+    color_anim_data_t *cad = ctx;
     lv_color_t c = lv_color_mix(cad->color_b, cad->color_a, (uint8_t)v);
-    lv_obj_set_style_bg_color(cad->obj, c, 0);
-    lv_obj_set_style_bg_opa(cad->obj, LV_OPA_COVER, 0);
+    lv_obj_set_style_bg_color(obj, c, 0);
+    lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, 0);
+}
+
+/** 查找对象上某事件回调绑定的 user_data */
+static lv_event_dsc_t *find_event_dsc(lv_obj_t *obj, lv_event_cb_t cb) {
+    uint32_t n = lv_obj_get_event_count(obj);
+    for (uint32_t i = 0; i < n; i++) {
+        lv_event_dsc_t *dsc = lv_obj_get_event_dsc(obj, i);
+        if (lv_event_dsc_get_cb(dsc) == cb) return dsc;
+    }
+    return NULL;
+}
+
+/** 停止对象上的全部动画并复位动画写入的样式 (anim:none / reconcile 使用) */
+static void stop_anims(lv_obj_t *obj) {
+    lv_anim_delete(obj, NULL);   /* 调度记录与 color_pulse 颜色对随之释放 */
+    if (lv_obj_has_class(obj, &lv_image_class)) lv_image_set_rotation(obj, 0);
+    lv_obj_set_style_translate_x(obj, 0, 0);
+    lv_obj_set_style_translate_y(obj, 0, 0);
+    lv_obj_set_style_opa(obj, LV_OPA_COVER, 0);
 }
 
 /* ======================================================
@@ -345,130 +632,111 @@ static void anim_color_exec_cb(void *var, int32_t v) {
  * ====================================================== */
 static void apply_anim(cJSON *an, lv_obj_t *obj) {
     if (!an || !obj) return;
-    cJSON *ti = cJSON_GetObjectItem(an, "type");
+    node_props_t ap;
+    node_props_scan(&ap, an);
+    cJSON *ti = NP(&ap, TYPE);
     if (!ti || !cJSON_IsString(ti)) return;
-    const char *atype = ti->valuestring;
+    sdui_tok_t atype = sdui_tok_lookup(ti->valuestring);
 
-    cJSON *di = cJSON_GetObjectItem(an, "duration");
+    cJSON *di = NP(&ap, DURATION);
     int32_t dur = (di && cJSON_IsNumber(di)) ? di->valueint : 1000;
 
-    cJSON *ri = cJSON_GetObjectItem(an, "repeat");
+    cJSON *ri = NP(&ap, REPEAT);
     int32_t  rep_raw = (ri && cJSON_IsNumber(ri)) ? ri->valueint : -1;
     uint32_t repeat  = (rep_raw < 0) ? LV_ANIM_REPEAT_INFINITE : (uint32_t)rep_raw;
 
     lv_anim_t a;
     lv_anim_init(&a);
 
+    /* ---------- none：停止该组件上的动画 ---------- */
+    if (atype == SDUI_TOK_NONE) {
+        stop_anims(obj);
+    }
+
     /* ---------- blink ---------- */
-    if (!strcmp(atype, "blink")) {
-        lv_anim_set_var(&a, obj);
-        lv_anim_set_exec_cb(&a, anim_opa_exec_cb);
-        lv_anim_set_values(&a, LV_OPA_COVER, LV_OPA_TRANSP);
+    else if (atype == SDUI_TOK_BLINK) {
         lv_anim_set_duration(&a, dur);
         lv_anim_set_playback_duration(&a, dur);
         lv_anim_set_repeat_count(&a, repeat);
         lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
-        lv_anim_start(&a);
+        sdui_anim_start(&a, obj, LV_OPA_COVER, LV_OPA_TRANSP, SDUI_ANIM_COST_MID, anim_apply_opa, NULL);
     }
 
     /* ---------- breathe ---------- */
-    else if (!strcmp(atype, "breathe")) {
-        cJSON *mni = cJSON_GetObjectItem(an, "min_opa");
-        cJSON *mxi = cJSON_GetObjectItem(an, "max_opa");
+    else if (atype == SDUI_TOK_BREATHE) {
+        cJSON *mni = NP(&ap, MIN_OPA);
+        cJSON *mxi = NP(&ap, MAX_OPA);
         int32_t mn = (mni && cJSON_IsNumber(mni)) ? mni->valueint : 80;
         int32_t mx = (mxi && cJSON_IsNumber(mxi)) ? mxi->valueint : 255;
-        lv_anim_set_var(&a, obj);
-        lv_anim_set_exec_cb(&a, anim_opa_exec_cb);
-        lv_anim_set_values(&a, mn, mx);
         lv_anim_set_duration(&a, dur);
         lv_anim_set_playback_duration(&a, dur);
         lv_anim_set_repeat_count(&a, (repeat == 0) ? LV_ANIM_REPEAT_INFINITE : repeat);
         lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
-        lv_anim_start(&a);
+        sdui_anim_start(&a, obj, mn, mx, SDUI_ANIM_COST_MID, anim_apply_opa, NULL);
     }
 
     /* ---------- spin (image only) ---------- */
-    else if (!strcmp(atype, "spin")) {
+    else if (atype == SDUI_TOK_SPIN) {
         if (!lv_obj_has_class(obj, &lv_image_class)) {
             ESP_LOGW(TAG, "anim:spin only for image widget, skipped");
             return;
         }
-        if (s_spin_count >= MAX_SPIN_ANIM) {
-            ESP_LOGW(TAG, "anim:spin limit reached (%d), degraded", MAX_SPIN_ANIM);
-            return;
-        }
-        cJSON *dri = cJSON_GetObjectItem(an, "direction");
-        bool ccw = (dri && cJSON_IsString(dri) && !strcmp(dri->valuestring, "ccw"));
-        lv_anim_set_var(&a, obj);
-        lv_anim_set_exec_cb(&a, anim_rotation_exec_cb);
-        lv_anim_set_values(&a, ccw ? 3600 : 0, ccw ? 0 : 3600);
+        cJSON *dri = NP(&ap, DIRECTION);
+        bool ccw = value_tok(dri) == SDUI_TOK_CCW;
         lv_anim_set_duration(&a, dur);
         lv_anim_set_repeat_count(&a, (repeat == 0) ? LV_ANIM_REPEAT_INFINITE : repeat);
         lv_anim_set_path_cb(&a, lv_anim_path_linear);
-        lv_anim_start(&a);
-        s_spin_count++;
-        lv_obj_add_event_cb(obj, spin_delete_cb, LV_EVENT_DELETE, NULL);
+        sdui_anim_start(&a, obj, ccw ? 3600 : 0, ccw ? 0 : 3600, SDUI_ANIM_COST_HIGH, anim_apply_rotation, NULL);
     }
 
     /* ---------- slide_in ---------- */
-    else if (!strcmp(atype, "slide_in")) {
-        cJSON *fromi = cJSON_GetObjectItem(an, "from");
-        const char *from = (fromi && cJSON_IsString(fromi)) ? fromi->valuestring : "left";
-        bool is_x = (!strcmp(from, "left") || !strcmp(from, "right"));
-        bool negative = (!strcmp(from, "left")  || !strcmp(from, "top"));
+    else if (atype == SDUI_TOK_SLIDE_IN) {
+        cJSON *fromi = NP(&ap, FROM);
+        sdui_tok_t from = (fromi && cJSON_IsString(fromi)) ? sdui_tok_lookup(fromi->valuestring) : SDUI_TOK_LEFT;
+        bool is_x = (from == SDUI_TOK_LEFT || from == SDUI_TOK_RIGHT);
+        bool negative = (from == SDUI_TOK_LEFT || from == SDUI_TOK_TOP);
         int32_t offset = negative ? -SDUI_SCREEN_W : SDUI_SCREEN_W;
-        lv_anim_set_var(&a, obj);
-        lv_anim_set_exec_cb(&a, is_x ? anim_translate_x_exec_cb : anim_translate_y_exec_cb);
-        lv_anim_set_values(&a, offset, 0);
         lv_anim_set_duration(&a, dur);
         lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
-        lv_anim_start(&a);
+        sdui_anim_start(&a, obj, offset, 0, SDUI_ANIM_COST_MID,
+                        is_x ? anim_apply_translate_x : anim_apply_translate_y, NULL);
     }
 
     /* ---------- shake ---------- */
-    else if (!strcmp(atype, "shake")) {
-        cJSON *ampi = cJSON_GetObjectItem(an, "amplitude");
+    else if (atype == SDUI_TOK_SHAKE) {
+        cJSON *ampi = NP(&ap, AMPLITUDE);
         int32_t amp = (ampi && cJSON_IsNumber(ampi)) ? ampi->valueint : 8;
-        lv_anim_set_var(&a, obj);
-        lv_anim_set_exec_cb(&a, anim_translate_x_exec_cb);
-        lv_anim_set_values(&a, -amp, amp);
         lv_anim_set_duration(&a, dur / 4);
         lv_anim_set_playback_duration(&a, dur / 4);
         lv_anim_set_repeat_count(&a, 2);
         lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
-        lv_anim_start(&a);
+        sdui_anim_start(&a, obj, -amp, amp, SDUI_ANIM_COST_MID, anim_apply_translate_x, NULL);
     }
 
     /* ---------- color_pulse ---------- */
-    else if (!strcmp(atype, "color_pulse")) {
-        cJSON *cai = cJSON_GetObjectItem(an, "color_a");
-        cJSON *cbi = cJSON_GetObjectItem(an, "color_b");
+    else if (atype == SDUI_TOK_COLOR_PULSE) {
+        cJSON *cai = NP(&ap, COLOR_A);
+        cJSON *cbi = NP(&ap, COLOR_B);
         color_anim_data_t *cad = calloc(1, sizeof(color_anim_data_t));
         if (!cad) return;
-        cad->obj     = obj;
         cad->color_a = parse_color(cai && cJSON_IsString(cai) ? cai->valuestring : "#1a1a2e");
         cad->color_b = parse_color(cbi && cJSON_IsString(cbi) ? cbi->valuestring : "#e94560");
-        lv_anim_set_var(&a, cad);
-        lv_anim_set_exec_cb(&a, anim_color_exec_cb);
-        lv_anim_set_values(&a, 0, 255);
         lv_anim_set_duration(&a, dur);
         lv_anim_set_playback_duration(&a, dur);
         lv_anim_set_repeat_count(&a, (repeat == 0) ? LV_ANIM_REPEAT_INFINITE : repeat);
         lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out);
-        lv_anim_start(&a);
-        /* color_anim_data 由 obj 删除时回调释放 */
-        lv_obj_add_event_cb(obj, free_color_anim_cb, LV_EVENT_DELETE, cad);
+        sdui_anim_start(&a, obj, 0, 255, SDUI_ANIM_COST_LOW, anim_apply_color, cad);   /* cad 随动画释放 */
     }
 
     /* ---------- marquee (label only) ---------- */
-    else if (!strcmp(atype, "marquee")) {
+    else if (atype == SDUI_TOK_MARQUEE) {
         if (lv_obj_has_class(obj, &lv_label_class)) {
             lv_label_set_long_mode(obj, LV_LABEL_LONG_SCROLL_CIRCULAR);
         }
     }
 
     else {
-        ESP_LOGW(TAG, "Unknown anim type: %s", atype);
+        ESP_LOGW(TAG, "Unknown anim type: %s", ti->valuestring);
     }
 }
 
@@ -477,82 +745,45 @@ static void apply_anim(cJSON *an, lv_obj_t *obj) {
  * ====================================================== */
 static void particle_timer_cb(lv_timer_t *timer) {
     particle_data_t *pd = (particle_data_t *)lv_timer_get_user_data(timer);
-    if (!pd || !pd->canvas) return;
+    if (!pd || !pd->canvas || !pd->ps) return;
 
     /* 熔断机制：如果在录音期间则跳过一切消耗 SPI 总线写 PSRAM 和屏幕缓冲的回调 */
     if (audio_manager_is_recording()) {
         return;
     }
 
-    int cw = pd->canvas_w;
-    int ch = pd->canvas_h;
-    int cx = cw / 2;
-    int cy = ch / 2;
-
-    /* 清除画布 */
-    lv_canvas_fill_bg(pd->canvas, lv_color_black(), LV_OPA_TRANSP);
-
-    lv_layer_t layer;
-    lv_canvas_init_layer(pd->canvas, &layer);
-
-    lv_draw_rect_dsc_t dsc;
-    lv_draw_rect_dsc_init(&dsc);
-    dsc.bg_color  = pd->color;
-    dsc.radius    = pd->size;
-    dsc.border_width = 0;
-
-    for (int i = 0; i < pd->count; i++) {
-        particle_t *p = &pd->p[i];
-        if (!p->active) {
-            /* 重置粒子到中心，随机初速度 */
-            p->x  = (float)(rand() % 20 - 10);
-            p->y  = (float)(rand() % 20 - 10);
-            p->vx = ((rand() % 200) - 100) / 80.0f;
-            p->vy = ((rand() % 200) - 100) / 80.0f - 1.5f;
-            p->alpha  = 255;
-            p->active = true;
-        }
-        p->x  += p->vx;
-        p->y  += p->vy;
-        p->vy += 0.06f; /* 重力 */
-        p->alpha = (p->alpha > 8) ? (p->alpha - 8) : 0;
-        if (p->alpha == 0) { p->active = false; continue; }
-
-        int px = cx + (int)p->x - pd->size;
-        int py = cy + (int)p->y - pd->size;
-        if (px >= 0 && py >= 0 && px < cw && py < ch) {
-            lv_area_t area = {px, py, px + pd->size * 2, py + pd->size * 2};
-            dsc.bg_opa = p->alpha;
-            lv_draw_rect(&layer, &dsc, &area);
-        }
-    }
-    lv_canvas_finish_layer(pd->canvas, &layer);
+    /* 直接写画布缓冲，只失效上一帧与本帧粒子覆盖的区域 */
+    sdui_particles_rect_t dirty;
+    if (!sdui_particles_step(pd->ps, &dirty)) return;
+
+    lv_area_t coords;
+    lv_obj_get_coords(pd->canvas, &coords);
+    lv_area_t area = {
+        coords.x1 + dirty.x1, coords.y1 + dirty.y1,
+        coords.x1 + dirty.x2, coords.y1 + dirty.y2,
+    };
+    lv_obj_invalidate_area(pd->canvas, &area);
 }
 
 /* ======================================================
  * 创建 container 组件
  * ====================================================== */
-static lv_obj_t *create_container(cJSON *node, lv_obj_t *parent) {
-    lv_obj_t *cont = lv_obj_create(parent);
-    lv_obj_remove_style_all(cont);
-    lv_obj_set_style_bg_opa(cont, LV_OPA_TRANSP, 0);
-
-    cJSON *flex = cJSON_GetObjectItem(node, "flex");
+static void apply_container_props(const node_props_t *p, lv_obj_t *cont) {
+    cJSON *flex = NP(p, FLEX);
     if (flex && cJSON_IsString(flex)) {
         lv_obj_set_layout(cont, LV_LAYOUT_FLEX);
-        lv_obj_set_flex_flow(cont, parse_flex_flow(flex->valuestring));
+        lv_obj_set_flex_flow(cont, parse_flex_flow(value_tok(flex)));
     }
-    cJSON *just = cJSON_GetObjectItem(node, "justify");
-    cJSON *ali  = cJSON_GetObjectItem(node, "align_items");
+    cJSON *just = NP(p, JUSTIFY);
+    cJSON *ali  = NP(p, ALIGN_ITEMS);
     if (just || ali) {
-        lv_flex_align_t ma = just && cJSON_IsString(just) ? parse_flex_align(just->valuestring) : LV_FLEX_ALIGN_START;
-        lv_flex_align_t ca = ali  && cJSON_IsString(ali)  ? parse_flex_align(ali->valuestring)  : LV_FLEX_ALIGN_START;
+        lv_flex_align_t ma = parse_flex_align(value_tok(just));
+        lv_flex_align_t ca = parse_flex_align(value_tok(ali));
         lv_obj_set_flex_align(cont, ma, ca, ca);
     }
-    lv_obj_set_size(cont, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
 
     /* scrollable 属性 */
-    cJSON *sc = cJSON_GetObjectItem(node, "scrollable");
+    cJSON *sc = NP(p, SCROLLABLE);
     if (sc && cJSON_IsTrue(sc)) {
         lv_obj_add_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
         lv_obj_set_scroll_dir(cont, LV_DIR_VER);
@@ -560,52 +791,71 @@ static lv_obj_t *create_container(cJSON *node, lv_obj_t *parent) {
     } else {
         lv_obj_clear_flag(cont, LV_OBJ_FLAG_SCROLLABLE);
     }
+}
+
+static lv_obj_t *create_container(const node_props_t *p, lv_obj_t *parent) {
+    lv_obj_t *cont = lv_obj_create(parent);
+    lv_obj_remove_style_all(cont);   /* 无样式即透明背景；不设本地 bg_opa，以免遮盖样式类 */
+    lv_obj_set_size(cont, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
+    apply_container_props(p, cont);
     return cont;
 }
 
 /* ======================================================
  * 创建 label 组件
  * ====================================================== */
-static lv_obj_t *create_label(cJSON *node, lv_obj_t *parent) {
-    lv_obj_t *label = lv_label_create(parent);
-    cJSON *text = cJSON_GetObjectItem(node, "text");
-    lv_label_set_text(label, (text && cJSON_IsString(text)) ? text->valuestring : "");
+/** long_mode: wrap / scroll / dot / marquee，其余取值不改变 */
+static void set_long_mode(lv_obj_t *label, const cJSON *lm) {
+    switch (value_tok(lm)) {
+        case SDUI_TOK_WRAP:    lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);            break;
+        case SDUI_TOK_SCROLL:  lv_label_set_long_mode(label, LV_LABEL_LONG_SCROLL);          break;
+        case SDUI_TOK_DOT:     lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);             break;
+        case SDUI_TOK_MARQUEE: lv_label_set_long_mode(label, LV_LABEL_LONG_SCROLL_CIRCULAR); break;
+        default:               break;
+    }
+}
 
-    cJSON *lm = cJSON_GetObjectItem(node, "long_mode");
-    if (lm && cJSON_IsString(lm)) {
-        if      (!strcmp(lm->valuestring, "wrap"))   lv_label_set_long_mode(label, LV_LABEL_LONG_WRAP);
-        else if (!strcmp(lm->valuestring, "scroll")) lv_label_set_long_mode(label, LV_LABEL_LONG_SCROLL);
-        else if (!strcmp(lm->valuestring, "dot"))    lv_label_set_long_mode(label, LV_LABEL_LONG_DOT);
-        else if (!strcmp(lm->valuestring, "marquee")) lv_label_set_long_mode(label, LV_LABEL_LONG_SCROLL_CIRCULAR);
+/**
+ * 设置文本：含 {var} 的模板绑定到状态变量，速率描述对象在设备端推进，
+ * 普通字符串解除已有绑定
+ */
+static void set_label_text(lv_obj_t *label, const cJSON *text) {
+    if (cJSON_IsObject(text) && sdui_state_bind_rate(label, SDUI_BIND_TEXT, text)) return;
+    const char *s = (text && cJSON_IsString(text)) ? text->valuestring : "";
+    if (sdui_state_is_template(s)) {
+        sdui_state_bind(label, SDUI_BIND_TEXT, s);
+        return;
     }
+    sdui_state_unbind(label, SDUI_BIND_TEXT);
+    lv_label_set_text(label, s);
+}
+
+static lv_obj_t *create_label(const node_props_t *p, lv_obj_t *parent) {
+    lv_obj_t *label = lv_label_create(parent);
+    set_label_text(label, NP(p, TEXT));
+
+    set_long_mode(label, NP(p, LONG_MODE));
     return label;
 }
 
 /* ======================================================
  * 创建 button 组件
  * ====================================================== */
-static lv_obj_t *create_button(cJSON *node, lv_obj_t *parent) {
+static lv_obj_t *create_button(const node_props_t *p, lv_obj_t *parent) {
     lv_obj_t *btn = lv_btn_create(parent);
     lv_obj_set_size(btn, LV_SIZE_CONTENT, LV_SIZE_CONTENT);
 
-    cJSON *text = cJSON_GetObjectItem(node, "text");
-    if (text && cJSON_IsString(text)) {
+    cJSON *text = NP(p, TEXT);
+    if (text && (cJSON_IsString(text) || cJSON_IsObject(text))) {
         lv_obj_t *lbl = lv_label_create(btn);
-        lv_label_set_text(lbl, text->valuestring);
+        set_label_text(lbl, text);
         lv_obj_center(lbl);
-        cJSON *tc = cJSON_GetObjectItem(node, "text_color");
+        cJSON *tc = NP(p, TEXT_COLOR);
         if (tc && cJSON_IsString(tc))
             lv_obj_set_style_text_color(lbl, parse_color(tc->valuestring), 0);
-        cJSON *fs = cJSON_GetObjectItem(node, "font_size");
-        if (fs && cJSON_IsNumber(fs)) {
-            int sz = fs->valueint;
-            const lv_font_t *font = &lv_font_montserrat_14;
-            if (sz >= 26)      font = &lv_font_montserrat_26;
-            else if (sz >= 24) font = &lv_font_montserrat_24;
-            else if (sz >= 20) font = &lv_font_montserrat_20;
-            else if (sz >= 16) font = &lv_font_montserrat_16;
-            lv_obj_set_style_text_font(lbl, font, 0);
-        }
+        cJSON *fs = NP(p, FONT_SIZE);
+        if (fs && cJSON_IsNumber(fs))
+            lv_obj_set_style_text_font(lbl, pick_font(fs->valueint), 0);
     }
     return btn;
 }
@@ -613,49 +863,144 @@ static lv_obj_t *create_button(cJSON *node, lv_obj_t *parent) {
 /* ======================================================
  * 创建 image 组件（Base64 → RGB565 raw）
  * ====================================================== */
-static lv_obj_t *create_image(cJSON *node, lv_obj_t *parent) {
-    lv_obj_t *img = lv_image_create(parent);
 
-    cJSON *src_item = cJSON_GetObjectItem(node, "src");
-    cJSON *iw_item  = cJSON_GetObjectItem(node, "img_w");
-    cJSON *ih_item  = cJSON_GetObjectItem(node, "img_h");
-
-    if (src_item && cJSON_IsString(src_item) && iw_item && ih_item) {
-        const char *b64    = src_item->valuestring;
-        size_t      b64len = strlen(b64);
-        size_t      out_len = 0;
-
-        /* 计算解码后的字节数 */
-        mbedtls_base64_decode(NULL, 0, &out_len, (const unsigned char *)b64, b64len);
-        if (out_len > 0) {
-            uint8_t *buf = (uint8_t *)heap_caps_malloc(out_len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
-            if (!buf) {
-                ESP_LOGW(TAG, "image: PSRAM alloc failed (%d bytes)", out_len);
-            } else {
-                size_t actual = 0;
-                int ret = mbedtls_base64_decode(buf, out_len, &actual,
-                                                (const unsigned char *)b64, b64len);
-                if (ret == 0) {
-                    image_data_t *idata = calloc(1, sizeof(image_data_t));
-                    if (idata) {
-                        idata->data_buf              = buf;
-                        idata->dsc.data              = buf;
-                        idata->dsc.data_size         = actual;
-                        idata->dsc.header.cf         = LV_COLOR_FORMAT_RGB565;
-                        idata->dsc.header.w          = iw_item->valueint;
-                        idata->dsc.header.h          = ih_item->valueint;
-                        idata->dsc.header.stride     = iw_item->valueint * 2;
-                        lv_image_set_src(img, &idata->dsc);
-                        lv_obj_add_event_cb(img, free_image_data_cb, LV_EVENT_DELETE, idata);
-                    } else {
-                        heap_caps_free(buf);
-                    }
-                } else {
-                    ESP_LOGW(TAG, "image: base64 decode failed (%d)", ret);
-                    heap_caps_free(buf);
-                }
-            }
+/** 包装一块 RGB565 位图；entry 非空时位图归缓存所有 */
+static image_data_t *image_data_new(uint8_t *buf, uint32_t size, int w, int h, sdui_img_entry_t *entry) {
+    image_data_t *idata = calloc(1, sizeof(image_data_t));
+    if (!idata) return NULL;
+    idata->data_buf          = entry ? NULL : buf;
+    idata->entry             = entry;
+    idata->dsc.data          = buf;
+    idata->dsc.data_size     = size;
+    idata->dsc.header.cf     = LV_COLOR_FORMAT_RGB565;
+    idata->dsc.header.w      = w;
+    idata->dsc.header.h      = h;
+    idata->dsc.header.stride = w * 2;
+    return idata;
+}
+
+static image_data_t *image_data_from_entry(sdui_img_entry_t *e) {
+    image_data_t *idata = image_data_new(e->buf, e->size, e->w, e->h, e);
+    if (!idata) sdui_img_cache_release(e);
+    return idata;
+}
+
+/** src_ref 未命中且没有随附 src：上报给服务端补发 */
+static void report_image_miss(const char *ref, const cJSON *id) {
+    if (!cJSON_IsString(id)) {
+        ESP_LOGW(TAG, "image: src_ref %s missed, no id to fill", ref);
+        return;
+    }
+    /* ref / id 均来自下发的布局，经 cJSON 转义后再上报 */
+    cJSON *pl = cJSON_CreateObject();
+    if (!pl) return;
+    cJSON_AddStringToObject(pl, "ref", ref);
+    cJSON_AddStringToObject(pl, "id", id->valuestring);
+    char *json = cJSON_PrintUnformatted(pl);
+    cJSON_Delete(pl);
+    if (json) {
+        sdui_bus_publish_up("ui/image_miss", json);
+        cJSON_free(json);
+    }
+}
+
+/** 解码 image 节点的 src（按 format 解压，按 src_ref 查缓存）；不调用 LVGL，可在锁外执行 */
+static image_data_t *decode_image(const node_props_t *p) {
+    cJSON *src_item = NP(p, SRC);
+    cJSON *iw_item  = NP(p, IMG_W);
+    cJSON *ih_item  = NP(p, IMG_H);
+    cJSON *ref_item = NP(p, SRC_REF);
+    const char *ref = cJSON_IsString(ref_item) && ref_item->valuestring[0] ? ref_item->valuestring : NULL;
+
+    /* 缓存命中时即使随附了 src 也不再解码 */
+    if (ref) {
+        sdui_img_entry_t *e = sdui_img_cache_acquire(ref);
+        if (e) return image_data_from_entry(e);
+        if (!cJSON_IsString(src_item)) {
+            report_image_miss(ref, NP(p, ID));
+            return NULL;
+        }
+    }
+    if (!src_item || !cJSON_IsString(src_item) || !cJSON_IsNumber(iw_item) || !cJSON_IsNumber(ih_item)) return NULL;
+    if (iw_item->valueint <= 0 || ih_item->valueint <= 0) {
+        ESP_LOGW(TAG, "image: invalid size %dx%d", iw_item->valueint, ih_item->valueint);
+        return NULL;
+    }
+    size_t bmp = (size_t)iw_item->valueint * ih_item->valueint * 2;
+
+    cJSON            *fmt_item = NP(p, FORMAT);
+    sdui_img_format_t fmt      = sdui_img_format_parse(cJSON_IsString(fmt_item) ? fmt_item->valuestring : NULL);
+    if (fmt == SDUI_IMG_UNKNOWN) {
+        ESP_LOGW(TAG, "image: unsupported format '%s'", fmt_item->valuestring);
+        return NULL;
+    }
+
+    const char *b64     = src_item->valuestring;
+    size_t      b64len  = strlen(b64);
+    size_t      out_len = 0;
+
+    /* 计算解码后的字节数 */
+    mbedtls_base64_decode(NULL, 0, &out_len, (const unsigned char *)b64, b64len);
+    if (out_len == 0) return NULL;
+
+    uint8_t *buf = (uint8_t *)heap_caps_malloc(out_len, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!buf) {
+        ESP_LOGW(TAG, "image: PSRAM alloc failed (%u bytes)", (unsigned)out_len);
+        return NULL;
+    }
+    size_t actual = 0;
+    int    ret    = mbedtls_base64_decode(buf, out_len, &actual, (const unsigned char *)b64, b64len);
+    if (ret != 0) {
+        ESP_LOGW(TAG, "image: base64 decode failed (%d)", ret);
+        heap_caps_free(buf);
+        return NULL;
+    }
+
+    /* 压缩格式：再解压到最终位图，压缩数据随即释放 */
+    if (fmt == SDUI_IMG_RLE565) {
+        uint8_t *pix = heap_caps_malloc(bmp, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        int32_t  n   = pix ? sdui_img_rle565_decode(buf, actual, pix, bmp) : -1;
+        heap_caps_free(buf);
+        if (n < 0) {
+            ESP_LOGW(TAG, "image: rle565 decode failed (%u -> %u bytes)", (unsigned)actual, (unsigned)bmp);
+            heap_caps_free(pix);
+            return NULL;
         }
+        if ((size_t)n < bmp) memset(pix + n, 0, bmp - (size_t)n);
+        buf    = pix;
+        actual = bmp;
+    } else if (actual < bmp) {
+        /* raw565 短于 w*h*2 时 LVGL 会越界读取像素 */
+        ESP_LOGW(TAG, "image: raw565 %u bytes, %dx%d needs %u", (unsigned)actual,
+                 iw_item->valueint, ih_item->valueint, (unsigned)bmp);
+        heap_caps_free(buf);
+        return NULL;
+    }
+
+    if (ref) {
+        sdui_img_entry_t *e = sdui_img_cache_insert(ref, buf, (uint32_t)actual, iw_item->valueint, ih_item->valueint);
+        if (e) return image_data_from_entry(e);
+        ESP_LOGW(TAG, "image: src_ref %s not cached", ref);
+    }
+    image_data_t *idata = image_data_new(buf, (uint32_t)actual, iw_item->valueint, ih_item->valueint, NULL);
+    if (!idata) heap_caps_free(buf);
+    return idata;
+}
+
+/** 预扫描阶段按节点解码（属性表不随 prep_collect 递归累积栈占用） */
+static __attribute__((noinline)) image_data_t *decode_image_node(cJSON *node) {
+    node_props_t p;
+    node_props_scan(&p, node);
+    return decode_image(&p);
+}
+
+/** @param idata 分片构建时锁外已解码的像素（转交所有权），NULL 时现场解码 */
+static lv_obj_t *create_image(const node_props_t *p, lv_obj_t *parent, image_data_t *idata) {
+    lv_obj_t *img = lv_image_create(parent);
+    if (!idata) idata = decode_image(p);
+    if (idata) {
+        lv_image_set_src(img, &idata->dsc);
+        lv_obj_add_event_cb(img, free_image_data_cb, LV_EVENT_DELETE, idata);
     }
 
     /* pivot 居中（旋转原点） */
@@ -666,26 +1011,40 @@ static lv_obj_t *create_image(cJSON *node, lv_obj_t *parent) {
 /* ======================================================
  * 创建 bar 组件
  * ====================================================== */
-static lv_obj_t *create_bar(cJSON *node, lv_obj_t *parent) {
+/** 设置 bar / slider 数值：数字直接设置，"{var}" 模板绑定到状态变量，速率描述在设备端推进 */
+static void set_range_value(lv_obj_t *obj, const cJSON *val, lv_anim_enable_t anim) {
+    if (cJSON_IsObject(val)) {
+        sdui_state_bind_rate(obj, SDUI_BIND_VALUE, val);
+        return;
+    }
+    if (val && cJSON_IsString(val) && sdui_state_is_template(val->valuestring)) {
+        sdui_state_bind(obj, SDUI_BIND_VALUE, val->valuestring);
+        return;
+    }
+    if (!val || !cJSON_IsNumber(val)) return;
+    sdui_state_unbind(obj, SDUI_BIND_VALUE);
+    if (lv_obj_has_class(obj, &lv_slider_class)) lv_slider_set_value(obj, val->valueint, anim);
+    else                                          lv_bar_set_value(obj, val->valueint, anim);
+}
+
+static lv_obj_t *create_bar(const node_props_t *p, lv_obj_t *parent) {
     lv_obj_t *bar = lv_bar_create(parent);
     lv_obj_set_size(bar, 200, 20);  /* 默认尺寸，可被 common_style 覆盖 */
 
-    cJSON *mn = cJSON_GetObjectItem(node, "min");
-    cJSON *mx = cJSON_GetObjectItem(node, "max");
+    cJSON *mn = NP(p, MIN);
+    cJSON *mx = NP(p, MAX);
     int32_t min_v = (mn && cJSON_IsNumber(mn)) ? mn->valueint : 0;
     int32_t max_v = (mx && cJSON_IsNumber(mx)) ? mx->valueint : 100;
     lv_bar_set_range(bar, min_v, max_v);
 
-    cJSON *val = cJSON_GetObjectItem(node, "value");
-    if (val && cJSON_IsNumber(val))
-        lv_bar_set_value(bar, val->valueint, LV_ANIM_ON);
+    set_range_value(bar, NP(p, VALUE), LV_ANIM_ON);
 
-    cJSON *bgc = cJSON_GetObjectItem(node, "bg_color");
+    cJSON *bgc = NP(p, BG_COLOR);
     if (bgc && cJSON_IsString(bgc)) {
         lv_obj_set_style_bg_color(bar, parse_color(bgc->valuestring), 0);
         lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, 0);
     }
-    cJSON *ic = cJSON_GetObjectItem(node, "indic_color");
+    cJSON *ic = NP(p, INDIC_COLOR);
     if (ic && cJSON_IsString(ic)) {
         lv_obj_set_style_bg_color(bar, parse_color(ic->valuestring), LV_PART_INDICATOR);
         lv_obj_set_style_bg_opa(bar, LV_OPA_COVER, LV_PART_INDICATOR);
@@ -708,26 +1067,24 @@ static void slider_changed_cb(lv_event_t *e) {
     else                                                    sdui_bus_publish_up("ui/action",          pl);
 }
 
-static lv_obj_t *create_slider(cJSON *node, lv_obj_t *parent) {
+static lv_obj_t *create_slider(const node_props_t *p, lv_obj_t *parent) {
     lv_obj_t *slider = lv_slider_create(parent);
     lv_obj_set_width(slider, 200);
 
-    cJSON *mn  = cJSON_GetObjectItem(node, "min");
-    cJSON *mx  = cJSON_GetObjectItem(node, "max");
-    cJSON *val = cJSON_GetObjectItem(node, "value");
+    cJSON *mn  = NP(p, MIN);
+    cJSON *mx  = NP(p, MAX);
     lv_slider_set_range(slider,
         (mn && cJSON_IsNumber(mn)) ? mn->valueint : 0,
         (mx && cJSON_IsNumber(mx)) ? mx->valueint : 100);
-    if (val && cJSON_IsNumber(val))
-        lv_slider_set_value(slider, val->valueint, LV_ANIM_OFF);
+    set_range_value(slider, NP(p, VALUE), LV_ANIM_OFF);
 
-    cJSON *oc = cJSON_GetObjectItem(node, "on_change");
+    cJSON *oc = NP(p, ON_CHANGE);
     if (oc && cJSON_IsString(oc)) {
         slider_data_t *sd = calloc(1, sizeof(slider_data_t));
         if (sd) {
             strncpy(sd->on_change, oc->valuestring, 63);
             /* 从注册表中找当前 id */
-            cJSON *id_item = cJSON_GetObjectItem(node, "id");
+            cJSON *id_item = NP(p, ID);
             if (id_item && cJSON_IsString(id_item))
                 strncpy(sd->id, id_item->valuestring, 31);
             lv_obj_add_event_cb(slider, slider_changed_cb, LV_EVENT_RELEASED, sd);
@@ -740,9 +1097,9 @@ static lv_obj_t *create_slider(cJSON *node, lv_obj_t *parent) {
 /* ======================================================
  * 创建 particle 组件
  * ====================================================== */
-static lv_obj_t *create_particle(cJSON *node, lv_obj_t *parent) {
-    cJSON *cw_item = cJSON_GetObjectItem(node, "canvas_w");
-    cJSON *ch_item = cJSON_GetObjectItem(node, "canvas_h");
+static lv_obj_t *create_particle(const node_props_t *p, lv_obj_t *parent) {
+    cJSON *cw_item = NP(p, CANVAS_W);
+    cJSON *ch_item = NP(p, CANVAS_H);
     int cw = (cw_item && cJSON_IsNumber(cw_item)) ? cw_item->valueint : 200;
     int ch = (ch_item && cJSON_IsNumber(ch_item)) ? ch_item->valueint : 200;
     /* 限制最大尺寸：200×200×2B = 80KB PSRAM */
@@ -752,7 +1109,7 @@ static lv_obj_t *create_particle(cJSON *node, lv_obj_t *parent) {
     size_t buf_sz = cw * ch * 2; /* RGB565 */
     uint8_t *buf  = (uint8_t *)heap_caps_malloc(buf_sz, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
     if (!buf) {
-        ESP_LOGW(TAG, "particle: PSRAM alloc failed (%d bytes)", buf_sz);
+        ESP_LOGW(TAG, "particle: PSRAM alloc failed (%u bytes)", (unsigned)buf_sz);
         return lv_obj_create(parent); /* 返回空占位 */
     }
     memset(buf, 0, buf_sz);
@@ -766,18 +1123,18 @@ static lv_obj_t *create_particle(cJSON *node, lv_obj_t *parent) {
 
     pd->canvas     = canvas;
     pd->canvas_buf = buf;
-    pd->canvas_w   = cw;
-    pd->canvas_h   = ch;
-
-    cJSON *cnt_i  = cJSON_GetObjectItem(node, "count");
-    cJSON *col_i  = cJSON_GetObjectItem(node, "color");
-    cJSON *sz_i   = cJSON_GetObjectItem(node, "particle_size");
-    cJSON *dur_i  = cJSON_GetObjectItem(node, "duration");
-    pd->count  = (cnt_i && cJSON_IsNumber(cnt_i)) ? LV_MIN(cnt_i->valueint, MAX_PARTICLES) : 20;
-    pd->color  = parse_color((col_i && cJSON_IsString(col_i)) ? col_i->valuestring : "#ffffff");
-    pd->size   = (sz_i && cJSON_IsNumber(sz_i)) ? sz_i->valueint : 3;
+
+    cJSON *cnt_i  = NP(p, COUNT);
+    cJSON *col_i  = NP(p, COLOR);
+    cJSON *sz_i   = NP(p, PARTICLE_SIZE);
+    cJSON *dur_i  = NP(p, DURATION);
+    int count  = (cnt_i && cJSON_IsNumber(cnt_i)) ? cnt_i->valueint : 20;   /* ≤ SDUI_PARTICLES_MAX */
+    lv_color_t color = parse_color((col_i && cJSON_IsString(col_i)) ? col_i->valuestring : "#ffffff");
+    int size   = (sz_i && cJSON_IsNumber(sz_i)) ? sz_i->valueint : 3;
     int period = (dur_i && cJSON_IsNumber(dur_i)) ? dur_i->valueint : 33; /* ~30fps */
 
+    pd->ps = sdui_particles_create(count, (uint16_t *)buf, cw, ch, lv_color_to_u16(color), size);
+    if (!pd->ps) ESP_LOGW(TAG, "particle: state alloc failed (%d)", count);
     pd->timer  = lv_timer_create(particle_timer_cb, period, pd);
 
     lv_obj_add_event_cb(canvas, free_particle_data_cb, LV_EVENT_DELETE, pd);
@@ -785,237 +1142,2201 @@ static lv_obj_t *create_particle(cJSON *node, lv_obj_t *parent) {
 }
 
 /* ======================================================
- * 递归解析节点
+ * 创建 list 组件（虚拟化列表）
+ *   条目只保存文本与样式类组合，存于 PSRAM 数组；只有视口内及上下
+ *   各 LIST_MARGIN_ROWS 行存在 LVGL 行对象，滚动时复用行对象重新绑定。
+ *   行高按行类内边距 + 文本换行高度测量，内容总高度经
+ *   LV_EVENT_GET_SELF_SIZE 交给 LVGL 计算滚动范围。
+ *   条目可由 ui/update 追加 / 裁剪，无需全量渲染。
  * ====================================================== */
-static void parse_node(cJSON *node, lv_obj_t *parent) {
-    if (!node || !parent) return;
-    cJSON *type = cJSON_GetObjectItem(node, "type");
-    if (!type || !cJSON_IsString(type)) {
-        ESP_LOGW(TAG, "Node missing 'type', skipped");
-        return;
-    }
-    const char *ts  = type->valuestring;
-    lv_obj_t   *obj = NULL;
-
-    if      (!strcmp(ts, "container")) obj = create_container(node, parent);
-    else if (!strcmp(ts, "label"))     obj = create_label(node, parent);
-    else if (!strcmp(ts, "button"))    obj = create_button(node, parent);
-    else if (!strcmp(ts, "image"))     obj = create_image(node, parent);
-    else if (!strcmp(ts, "bar"))       obj = create_bar(node, parent);
-    else if (!strcmp(ts, "slider"))    obj = create_slider(node, parent);
-    else if (!strcmp(ts, "particle"))  obj = create_particle(node, parent);
-    else {
-        ESP_LOGW(TAG, "Unknown widget type: %s", ts);
-        return;
-    }
-    if (!obj) return;
+#define LIST_POOL_MAX      24    /* 行对象上限（视口 + 余量） */
+#define LIST_MARGIN_ROWS   2
+#define LIST_VARIANTS_MAX  8     /* 单个列表内不同的条目样式类组合 */
+#define LIST_ITEMS_DEFAULT 500   /* max_items 缺省值：超出时丢弃最早的条目 */
+#define LIST_ITEMS_LIMIT   4096
 
-    /* 注册 ID */
-    cJSON *id = cJSON_GetObjectItem(node, "id");
-    if (id && cJSON_IsString(id)) register_id(id->valuestring, obj);
+typedef struct {
+    char    *text;       /* PSRAM */
+    int32_t  y;          /* 内容坐标 */
+    int32_t  h;
+    uint8_t  variant;
+} list_item_t;
 
-    /* 应用通用样式 */
-    apply_common_style(node, obj);
+typedef struct {
+    lv_obj_t *row;
+    lv_obj_t *label;
+    int32_t   idx;       /* 绑定的条目，-1 表示空闲 */
+    uint8_t   variant;   /* 已应用的样式类组合 */
+} list_row_t;
 
-    /* 绑定 Action URI */
-    bind_actions(node, obj);
+typedef struct {
+    lv_obj_t    *obj;
+    list_item_t *items;        /* PSRAM */
+    uint32_t     count, cap, max_items;
+    int32_t      total_h;
+    int32_t      measured_w;   /* 测量时的内容宽度，0 表示尚未布局 */
+    bool         follow;       /* 停在底部时追加条目后跟随到底部（聊天记录） */
+    bool         torn;         /* 行对象正被逐个删除（回收旧根），不再绑定 */
+    char        *variants[LIST_VARIANTS_MAX];   /* [0] 为 row_class；其余为 row_class + 条目 class */
+    uint8_t      variant_count;
+    char        *label_class;
+    list_row_t   rows[LIST_POOL_MAX];
+    uint8_t      row_count;
+} list_data_t;
+
+static char *psram_strdup(const char *s) {
+    size_t n = strlen(s) + 1;
+    char  *d = heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (d) memcpy(d, s, n);
+    return d;
+}
 
-    /* 注册删除回调 */
-    lv_obj_add_event_cb(obj, free_action_data_cb, LV_EVENT_DELETE, NULL);
+/** 条目 class → 样式类组合下标；组合用满时退回默认行样式 */
+static uint8_t list_variant(list_data_t *ld, const char *cls) {
+    if (!cls || !cls[0]) return 0;
+    char buf[96];
+    snprintf(buf, sizeof(buf), "%s %s", ld->variants[0], cls);
+    for (uint8_t i = 1; i < ld->variant_count; i++)
+        if (!strcmp(ld->variants[i], buf)) return i;
+    if (ld->variant_count == LIST_VARIANTS_MAX) {
+        ESP_LOGW(TAG, "list: too many item classes, '%s' ignored", cls);
+        return 0;
+    }
+    char *v = psram_strdup(buf);
+    if (!v) return 0;
+    ld->variants[ld->variant_count] = v;
+    return ld->variant_count++;
+}
 
-    /* 应用动画 */
-    cJSON *anim = cJSON_GetObjectItem(node, "anim");
-    if (anim && cJSON_IsObject(anim)) apply_anim(anim, obj);
+static list_row_t *list_row_new(list_data_t *ld) {
+    if (ld->row_count == LIST_POOL_MAX) return NULL;
+    list_row_t *r = &ld->rows[ld->row_count];
+    r->row = lv_obj_create(ld->obj);
+    lv_obj_remove_style_all(r->row);
+    lv_obj_clear_flag(r->row, LV_OBJ_FLAG_SCROLLABLE | LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_add_flag(r->row, LV_OBJ_FLAG_HIDDEN | LV_OBJ_FLAG_EVENT_BUBBLE);
+    apply_class_list(ld->variants[0], r->row);
+    lv_obj_set_width(r->row, lv_pct(100));
+
+    r->label = lv_label_create(r->row);
+    lv_label_set_long_mode(r->label, LV_LABEL_LONG_WRAP);
+    lv_obj_set_width(r->label, lv_pct(100));
+    if (ld->label_class) apply_class_list(ld->label_class, r->label);
+
+    r->idx     = -1;
+    r->variant = 0;
+    ld->row_count++;
+    return r;
+}
 
-    /* 递归子节点 */
-    cJSON *children = cJSON_GetObjectItem(node, "children");
-    if (children && cJSON_IsArray(children)) {
-        cJSON *child = NULL;
-        cJSON_ArrayForEach(child, children) {
-            parse_node(child, obj);
-        }
+/** 从 from 起重新测量行高与位置（行类与标签类取自行对象 0，条目 class 不应改变内边距与字体） */
+static void list_measure(list_data_t *ld, uint32_t from) {
+    if (ld->torn) return;
+    int32_t cw = lv_obj_get_content_width(ld->obj);
+    ld->measured_w = cw;
+    if (cw <= 0 || !ld->row_count) return;
+
+    lv_obj_t *row = ld->rows[0].row, *lbl = ld->rows[0].label;
+    int32_t bw   = lv_obj_get_style_border_width(row, 0);
+    int32_t hpad = lv_obj_get_style_pad_left(row, 0) + lv_obj_get_style_pad_right(row, 0) + 2 * bw;
+    int32_t vpad = lv_obj_get_style_pad_top(row, 0) + lv_obj_get_style_pad_bottom(row, 0) + 2 * bw;
+    int32_t gap  = lv_obj_get_style_pad_row(ld->obj, 0);
+    int32_t tw   = LV_MAX(cw - hpad, 1);
+    const lv_font_t *font = lv_obj_get_style_text_font(lbl, 0);
+    int32_t letter = lv_obj_get_style_text_letter_space(lbl, 0);
+    int32_t line   = lv_obj_get_style_text_line_space(lbl, 0);
+
+    int32_t y = from ? ld->items[from - 1].y + ld->items[from - 1].h + gap : 0;
+    for (uint32_t i = from; i < ld->count; i++) {
+        lv_point_t sz;
+        lv_text_get_size(&sz, ld->items[i].text, font, letter, line, tw, LV_TEXT_FLAG_NONE);
+        ld->items[i].y = y;
+        ld->items[i].h = sz.y + vpad;
+        y += ld->items[i].h + gap;
     }
+    ld->total_h = ld->count ? y - gap : 0;
 }
 
-/* ======================================================
- * 过渡动画辅助：根视图 Fade-In
- * ====================================================== */
-static void root_fade_in(void) {
-    lv_anim_t a;
-    lv_anim_init(&a);
-    lv_anim_set_var(&a, s_root_view);
-    lv_anim_set_exec_cb(&a, anim_opa_exec_cb);
-    lv_anim_set_values(&a, LV_OPA_TRANSP, LV_OPA_COVER);
-    lv_anim_set_duration(&a, 200);
-    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
-    lv_anim_start(&a);
+/** 第一个底边低于 y 的条目（二分） */
+static uint32_t list_find(const list_data_t *ld, int32_t y) {
+    uint32_t lo = 0, hi = ld->count;
+    while (lo < hi) {
+        uint32_t mid = (lo + hi) / 2;
+        if (ld->items[mid].y + ld->items[mid].h <= y) lo = mid + 1;
+        else                                          hi = mid;
+    }
+    return lo;
 }
 
-/* ======================================================
- * 公共 API
- * ====================================================== */
-lv_obj_t *sdui_parser_init(void) {
-    lv_obj_t *scr = lv_scr_act();
+/** 按当前滚动位置把行对象绑定到可见条目 */
+static void list_bind(list_data_t *ld) {
+    if (ld->measured_w <= 0 || ld->torn) return;
+    int32_t top = lv_obj_get_scroll_y(ld->obj);
+    int32_t bot = top + lv_obj_get_content_height(ld->obj);
+
+    uint32_t first = list_find(ld, top);
+    uint32_t last  = first;
+    while (last < ld->count && ld->items[last].y < bot) last++;
+    first = first > LIST_MARGIN_ROWS ? first - LIST_MARGIN_ROWS : 0;
+    last  = LV_MIN(last + LIST_MARGIN_ROWS, ld->count);
+    if (last - first > LIST_POOL_MAX) last = first + LIST_POOL_MAX;
+
+    /* 1. 释放范围外的行 */
+    for (uint8_t r = 0; r < ld->row_count; r++) {
+        list_row_t *row = &ld->rows[r];
+        if (row->idx >= 0 && ((uint32_t)row->idx < first || (uint32_t)row->idx >= last)) {
+            row->idx = -1;
+            lv_obj_add_flag(row->row, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+    /* 2. 为未绑定的条目分配空闲行 */
+    for (uint32_t i = first; i < last; i++) {
+        bool bound = false;
+        for (uint8_t r = 0; r < ld->row_count && !bound; r++) bound = ld->rows[r].idx == (int32_t)i;
+        if (bound) continue;
+
+        list_row_t *row = NULL;
+        for (uint8_t r = 0; r < ld->row_count && !row; r++)
+            if (ld->rows[r].idx < 0) row = &ld->rows[r];
+        if (!row && !(row = list_row_new(ld))) break;
+
+        const list_item_t *it = &ld->items[i];
+        if (row->variant != it->variant) {
+            remove_classes(row->row);
+            apply_class_list(ld->variants[it->variant], row->row);
+            row->variant = it->variant;
+        }
+        lv_label_set_text(row->label, it->text);
+        lv_obj_set_pos(row->row, 0, it->y);
+        lv_obj_set_height(row->row, it->h);
+        lv_obj_clear_flag(row->row, LV_OBJ_FLAG_HIDDEN);
+        row->idx = (int32_t)i;
+    }
+}
 
-    /* 禁用活动屏幕本身的 scrollable 和 scrollbar，
-     * 防止其在内容稍有溢出时于右下角渲染灰色滚动条方块 */
-    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_scrollbar_mode(scr, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+/** 条目下标整体变化（裁剪 / 替换）后解除全部绑定 */
+static void list_unbind_all(list_data_t *ld) {
+    for (uint8_t r = 0; r < ld->row_count; r++) {
+        ld->rows[r].idx = -1;
+        lv_obj_add_flag(ld->rows[r].row, LV_OBJ_FLAG_HIDDEN);
+    }
+}
 
-    s_root_view   = lv_obj_create(scr);
-    lv_obj_remove_style_all(s_root_view);
-    lv_obj_set_size(s_root_view,
-                    SDUI_SCREEN_W - 2 * SDUI_SAFE_PADDING,
-                    SDUI_SCREEN_H - 2 * SDUI_SAFE_PADDING);
-    lv_obj_center(s_root_view);
-    lv_obj_set_style_bg_opa(s_root_view, LV_OPA_TRANSP, 0);
-    lv_obj_clear_flag(s_root_view, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_set_scrollbar_mode(s_root_view, LV_SCROLLBAR_MODE_OFF);
-    lv_obj_set_layout(s_root_view, LV_LAYOUT_FLEX);
-    lv_obj_set_flex_flow(s_root_view, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(s_root_view, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    clear_id_table();
-    ESP_LOGI(TAG, "Parser init. Root: %dx%d, safe_pad=%d",
-             SDUI_SCREEN_W - 2*SDUI_SAFE_PADDING,
-             SDUI_SCREEN_H - 2*SDUI_SAFE_PADDING,
-             SDUI_SAFE_PADDING);
-    return s_root_view;
+static void list_free_items(list_data_t *ld, uint32_t from, uint32_t to) {
+    for (uint32_t i = from; i < to; i++) heap_caps_free(ld->items[i].text);
 }
 
-lv_obj_t *sdui_parser_get_root(void) { return s_root_view; }
+/** 丢弃最早的 n 个条目，视口内容保持不动 */
+static void list_trim(list_data_t *ld, uint32_t n) {
+    if (n > ld->count) n = ld->count;
+    if (!n) return;
+    int32_t shift = n < ld->count ? ld->items[n].y : ld->total_h;
+    list_free_items(ld, 0, n);
+    memmove(ld->items, ld->items + n, (ld->count - n) * sizeof(list_item_t));
+    ld->count -= n;
+    for (uint32_t i = 0; i < ld->count; i++) ld->items[i].y -= shift;
+    ld->total_h = ld->count ? ld->total_h - shift : 0;
+    list_unbind_all(ld);
+    lv_obj_refresh_self_size(ld->obj);
+    lv_obj_scroll_by_bounded(ld->obj, 0, shift, LV_ANIM_OFF);
+}
 
-void sdui_parser_render(const char *json_str) {
-    if (!json_str || !s_root_view) return;
-    ESP_LOGI(TAG, "Render layout (%d bytes)", strlen(json_str));
+/** 追加条目：[{"text": "...", "class": "..."}] 或字符串数组 */
+static void list_append(list_data_t *ld, cJSON *arr) {
+    uint32_t add = (uint32_t)cJSON_GetArraySize(arr);
+    if (!add) return;
+    bool at_end = ld->follow && lv_obj_get_scroll_bottom(ld->obj) <= 0;
+    if (ld->count + add > ld->max_items) {
+        uint32_t over = ld->count + add - ld->max_items;
+        if (over >= ld->count) {
+            /* 新条目本身超出上限：只保留最后 max_items 个 */
+            list_trim(ld, ld->count);
+        } else {
+            list_trim(ld, over);
+        }
+    }
+    if (ld->count + add > ld->cap) {
+        uint32_t cap = LV_MAX(ld->cap ? ld->cap * 2 : 16, ld->count + add);
+        list_item_t *grown = heap_caps_realloc(ld->items, cap * sizeof(list_item_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!grown) { ESP_LOGW(TAG, "list: item alloc failed (%" PRIu32 ")", cap); return; }
+        ld->items = grown;
+        ld->cap   = cap;
+    }
 
-    cJSON *root = cJSON_Parse(json_str);
-    if (!root) { ESP_LOGE(TAG, "JSON parse failed"); return; }
+    uint32_t from = ld->count;
+    uint32_t skip = add > ld->max_items ? add - ld->max_items : 0;
+    cJSON   *it     = NULL;
+    cJSON_ArrayForEach(it, arr) {
+        if (skip) { skip--; continue; }
+        cJSON      *text = cJSON_IsObject(it) ? cJSON_GetObjectItemCaseSensitive(it, "text") : it;
+        cJSON      *cls  = cJSON_IsObject(it) ? cJSON_GetObjectItemCaseSensitive(it, "class") : NULL;
+        list_item_t *li  = &ld->items[ld->count];
+        li->text = psram_strdup(cJSON_IsString(text) ? text->valuestring : "");
+        if (!li->text) break;
+        li->variant = list_variant(ld, cJSON_IsString(cls) ? cls->valuestring : NULL);
+        li->y = li->h = 0;
+        ld->count++;
+    }
+    list_measure(ld, from);
+    lv_obj_refresh_self_size(ld->obj);
+    if (at_end) lv_obj_scroll_to_y(ld->obj, ld->total_h, LV_ANIM_ON);
+    list_bind(ld);
+}
 
-    /* --- 过渡动画：先瞬间隐藏，渲染完毕后 Fade-In --- */
-    lv_obj_set_style_opa(s_root_view, LV_OPA_TRANSP, 0);
+static void list_set_items(list_data_t *ld, cJSON *arr) {
+    list_free_items(ld, 0, ld->count);
+    ld->count   = 0;
+    ld->total_h = 0;
+    list_unbind_all(ld);
+    lv_obj_scroll_to_y(ld->obj, 0, LV_ANIM_OFF);
+    if (arr && cJSON_IsArray(arr)) list_append(ld, arr);
+    lv_obj_refresh_self_size(ld->obj);
+    list_bind(ld);
+}
 
-    /* 清除旧 UI 树 */
-    lv_obj_clean(s_root_view);
-    clear_id_table();
-    s_spin_count = 0;
+static void list_data_free(list_data_t *ld) {
+    list_free_items(ld, 0, ld->count);
+    heap_caps_free(ld->items);
+    for (uint8_t i = 0; i < ld->variant_count; i++) heap_caps_free(ld->variants[i]);
+    heap_caps_free(ld->label_class);
+    heap_caps_free(ld);
+}
 
-    /* 重置根视图 Flex */
-    lv_obj_set_layout(s_root_view, LV_LAYOUT_FLEX);
-    lv_obj_set_flex_flow(s_root_view, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_flex_align(s_root_view, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
-    lv_obj_set_style_bg_opa(s_root_view, LV_OPA_TRANSP, 0);
-
-    /* 解析 JSON 树 */
-    if (cJSON_IsArray(root)) {
-        cJSON *item = NULL;
-        cJSON_ArrayForEach(item, root) parse_node(item, s_root_view);
-    } else if (cJSON_IsObject(root)) {
-        cJSON *children = cJSON_GetObjectItem(root, "children");
-        if (children && cJSON_IsArray(children)) {
-            apply_common_style(root, s_root_view);
-            cJSON *flex = cJSON_GetObjectItem(root, "flex");
-            if (flex && cJSON_IsString(flex)) {
-                lv_obj_set_layout(s_root_view, LV_LAYOUT_FLEX);
-                lv_obj_set_flex_flow(s_root_view, parse_flex_flow(flex->valuestring));
-            }
-            cJSON *just = cJSON_GetObjectItem(root, "justify");
-            cJSON *ali  = cJSON_GetObjectItem(root, "align_items");
-            if (just || ali) {
-                lv_flex_align_t ma = just && cJSON_IsString(just) ? parse_flex_align(just->valuestring) : LV_FLEX_ALIGN_CENTER;
-                lv_flex_align_t ca = ali  && cJSON_IsString(ali)  ? parse_flex_align(ali->valuestring)  : LV_FLEX_ALIGN_CENTER;
-                lv_obj_set_flex_align(s_root_view, ma, ca, ca);
-            }
-            cJSON *child = NULL;
-            cJSON_ArrayForEach(child, children) parse_node(child, s_root_view);
-        } else {
-            parse_node(root, s_root_view);
+static void list_event_cb(lv_event_t *e) {
+    list_data_t    *ld   = lv_event_get_user_data(e);
+    lv_event_code_t code = lv_event_get_code(e);
+    if (code == LV_EVENT_GET_SELF_SIZE) {
+        lv_point_t *p = lv_event_get_param(e);
+        p->y = LV_MAX(p->y, ld->total_h);
+    } else if (code == LV_EVENT_SCROLL) {
+        list_bind(ld);
+    } else if (code == LV_EVENT_SIZE_CHANGED) {
+        if (lv_obj_get_content_width(ld->obj) != ld->measured_w) {
+            bool first = ld->measured_w <= 0;
+            list_measure(ld, 0);
+            list_unbind_all(ld);
+            lv_obj_refresh_self_size(ld->obj);
+            if (first && ld->follow) lv_obj_scroll_to_y(ld->obj, ld->total_h, LV_ANIM_OFF);
         }
+        list_bind(ld);
+    } else if (code == LV_EVENT_CHILD_DELETED) {
+        /* 行对象只随列表一起删除（回收定时器逐个删叶子），之后不得再访问 */
+        ld->torn      = true;
+        ld->row_count = 0;
+    } else if (code == LV_EVENT_DELETE) {
+        list_data_free(ld);
     }
+}
 
-    cJSON_Delete(root);
+static void list_set_max(list_data_t *ld, cJSON *mx) {
+    ld->max_items = cJSON_IsNumber(mx) && mx->valueint > 0 ? (uint32_t)LV_MIN(mx->valueint, LIST_ITEMS_LIMIT)
+                                                         : LIST_ITEMS_DEFAULT;
+    if (ld->count > ld->max_items) {
+        list_trim(ld, ld->count - ld->max_items);
+        list_bind(ld);
+    }
+}
 
-    /* 渲染完毕后 Fade-In */
-    root_fade_in();
-    ESP_LOGI(TAG, "Render done. IDs: %d", s_id_count);
+static list_data_t *list_data_of(lv_obj_t *obj) {
+    lv_event_dsc_t *dsc = find_event_dsc(obj, list_event_cb);
+    return dsc ? lv_event_dsc_get_user_data(dsc) : NULL;
 }
 
-lv_obj_t *sdui_parser_find_by_id(const char *id) {
-    if (!id) return NULL;
-    for (int i = 0; i < s_id_count; i++) {
-        if (!strcmp(s_id_table[i].id, id)) return s_id_table[i].obj;
+/**
+ * ui/update 中的列表操作：
+ *   "append": [...]  追加条目（超出 max_items 时丢弃最早的）
+ *   "trim": n        丢弃最早的 n 个条目
+ *   "scroll_to": "end" | "start" | 条目下标
+ */
+static void list_update(lv_obj_t *obj, const node_props_t *p) {
+    list_data_t *ld = list_data_of(obj);
+    if (!ld) return;
+    cJSON *it;
+    if ((it = NP(p, ITEMS)) && cJSON_IsArray(it)) list_set_items(ld, it);
+    if ((it = NP(p, TRIM)) && cJSON_IsNumber(it) && it->valueint > 0) {
+        list_trim(ld, (uint32_t)it->valueint);
+        list_bind(ld);
+    }
+    if ((it = NP(p, APPEND)) && cJSON_IsArray(it)) list_append(ld, it);
+    if ((it = NP(p, SCROLL_TO))) {
+        int32_t y = -1;
+        if (value_tok(it) == SDUI_TOK_END)   y = ld->total_h;
+        if (value_tok(it) == SDUI_TOK_START) y = 0;
+        if (cJSON_IsNumber(it) && it->valueint >= 0 && (uint32_t)it->valueint < ld->count) y = ld->items[it->valueint].y;
+        if (y >= 0) lv_obj_scroll_to_y(obj, y, LV_ANIM_ON);
     }
-    return NULL;
 }
 
-void sdui_parser_update(const char *json_str) {
-    if (!json_str) return;
-    cJSON *root = cJSON_Parse(json_str);
-    if (!root) { ESP_LOGW(TAG, "update: JSON parse failed"); return; }
+static lv_obj_t *create_list(const node_props_t *p, lv_obj_t *parent) {
+    lv_obj_t *list = lv_obj_create(parent);
+    lv_obj_remove_style_all(list);
+    lv_obj_set_size(list, lv_pct(100), 200);
+    lv_obj_add_flag(list, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scroll_dir(list, LV_DIR_VER);
+    lv_obj_set_scrollbar_mode(list, LV_SCROLLBAR_MODE_ACTIVE);
+
+    list_data_t *ld = heap_caps_calloc(1, sizeof(list_data_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ld) return list;
+    cJSON *rc = NP(p, ROW_CLASS);
+    cJSON *lc = NP(p, LABEL_CLASS);
+    cJSON *mx = NP(p, MAX_ITEMS);
+    cJSON *fl = NP(p, FOLLOW);
+    ld->obj           = list;
+    ld->variants[0]   = psram_strdup(cJSON_IsString(rc) ? rc->valuestring : "");
+    ld->variant_count = 1;
+    ld->label_class   = cJSON_IsString(lc) ? psram_strdup(lc->valuestring) : NULL;
+    ld->follow        = cJSON_IsTrue(fl);
+    list_set_max(ld, mx);
+    if (!ld->variants[0]) { list_data_free(ld); return list; }
+    lv_obj_add_event_cb(list, list_event_cb, LV_EVENT_ALL, ld);
+
+    /* 行对象 0 兼作测量样板；宽度确定（LV_EVENT_SIZE_CHANGED）后才测量 */
+    list_row_new(ld);
+    cJSON *items = NP(p, ITEMS);
+    if (items && cJSON_IsArray(items)) list_append(ld, items);
+    return list;
+}
 
-    cJSON *id_item = cJSON_GetObjectItem(root, "id");
-    if (!id_item || !cJSON_IsString(id_item)) {
-        ESP_LOGW(TAG, "update: missing 'id'");
-        cJSON_Delete(root);
-        return;
+/* ======================================================
+ * 递归解析节点
+ * ====================================================== */
+static widget_type_t parse_widget_type(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_CONTAINER: return WT_CONTAINER;
+        case SDUI_TOK_LABEL:     return WT_LABEL;
+        case SDUI_TOK_BUTTON:    return WT_BUTTON;
+        case SDUI_TOK_IMAGE:     return WT_IMAGE;
+        case SDUI_TOK_BAR:       return WT_BAR;
+        case SDUI_TOK_SLIDER:    return WT_SLIDER;
+        case SDUI_TOK_PARTICLE:  return WT_PARTICLE;
+        case SDUI_TOK_LIST:      return WT_LIST;
+        default:                 return WT_UNKNOWN;
+    }
+}
+
+static widget_type_t node_type(cJSON *node) {
+    return parse_widget_type(value_tok(cJSON_GetObjectItemCaseSensitive(node, "type")));
+}
+
+/** 创建组件本体并应用通用样式（事件、动画、元数据由 finish_widget 完成） */
+static lv_obj_t *create_widget(const node_props_t *p, lv_obj_t *parent, image_data_t *img, widget_type_t *out_type) {
+    cJSON *type = NP(p, TYPE);
+    if (!type || !cJSON_IsString(type)) {
+        ESP_LOGW(TAG, "Node missing 'type', skipped");
+        image_data_free(img);
+        return NULL;
+    }
+    widget_type_t wt  = parse_widget_type(sdui_tok_lookup(type->valuestring));
+    lv_obj_t     *obj = NULL;
+
+    switch (wt) {
+        case WT_CONTAINER: obj = create_container(p, parent);     break;
+        case WT_LABEL:     obj = create_label(p, parent);         break;
+        case WT_BUTTON:    obj = create_button(p, parent);        break;
+        case WT_IMAGE:     obj = create_image(p, parent, img); break;
+        case WT_BAR:       obj = create_bar(p, parent);           break;
+        case WT_SLIDER:    obj = create_slider(p, parent);        break;
+        case WT_PARTICLE:  obj = create_particle(p, parent);      break;
+        case WT_LIST:      obj = create_list(p, parent);          break;
+        default:
+            ESP_LOGW(TAG, "Unknown widget type: %s", type->valuestring);
+            return NULL;
+    }
+    if (!obj) return NULL;
+    s_stats.created++;
+
+    /* 共享样式类 + 通用样式（本地样式覆盖类） */
+    apply_classes(NP(p, CLASS), obj);
+    apply_common_style(p, obj);
+    *out_type = wt;
+    return obj;
+}
+
+static void finish_widget(cJSON *node, const node_props_t *p, lv_obj_t *obj, widget_type_t wt) {
+    /* 绑定 Action URI */
+    bind_actions(p, obj);
+
+    /* 注册删除回调 */
+    lv_obj_add_event_cb(obj, free_action_data_cb, LV_EVENT_DELETE, NULL);
+
+    /* 应用动画 */
+    cJSON *anim = NP(p, ANIM);
+    if (anim && cJSON_IsObject(anim)) apply_anim(anim, obj);
+
+    /* 挂载元数据并注册 ID */
+    attach_meta(obj, wt, node, p);
+}
+
+/**
+ * 扫描属性表并创建单个节点。属性表只存在于本函数栈帧，
+ * 禁止内联以免随 parse_node 递归逐层累积栈占用。
+ * img 为锁外预解码的像素（仅 image 节点，转交所有权），NULL 时现场解码。
+ */
+static __attribute__((noinline)) lv_obj_t *build_node(cJSON *node, lv_obj_t *parent, image_data_t *img, cJSON **children) {
+    node_props_t p;
+    node_props_scan(&p, node);
+    widget_type_t wt  = WT_UNKNOWN;
+    lv_obj_t     *obj = create_widget(&p, parent, img, &wt);
+    if (obj) finish_widget(node, &p, obj, wt);
+    if (children) *children = NP(&p, CHILDREN);
+    return obj;
+}
+
+static void parse_children(cJSON *children, lv_obj_t *parent) {
+    if (!children || !cJSON_IsArray(children)) return;
+    cJSON *child = NULL;
+    cJSON_ArrayForEach(child, children) {
+        parse_node(child, parent);
+    }
+}
+
+static lv_obj_t *parse_node(cJSON *node, lv_obj_t *parent) {
+    if (!node || !parent) return NULL;
+    cJSON    *children = NULL;
+    lv_obj_t *obj      = build_node(node, parent, NULL, &children);
+    if (!obj) return NULL;
+
+    /* 递归子节点 */
+    parse_children(children, obj);
+    return obj;
+}
+
+/* ======================================================
+ * Reconcile：按 id（或 类型+位置）匹配新旧节点，仅修改差异属性
+ * ====================================================== */
+
+/** 可原地修改的属性；其余属性变化时整节点重建 */
+static bool prop_patchable(widget_type_t t, sdui_tok_t k) {
+    switch (k) {
+        case SDUI_TOK_W:          case SDUI_TOK_H:            case SDUI_TOK_ALIGN:      case SDUI_TOK_X:
+        case SDUI_TOK_Y:          case SDUI_TOK_BG_COLOR:     case SDUI_TOK_BG_OPA:     case SDUI_TOK_PAD:
+        case SDUI_TOK_RADIUS:     case SDUI_TOK_GAP:          case SDUI_TOK_BORDER_W:   case SDUI_TOK_BORDER_COLOR:
+        case SDUI_TOK_TEXT_COLOR: case SDUI_TOK_FONT_SIZE:    case SDUI_TOK_SHADOW_W:   case SDUI_TOK_SHADOW_COLOR:
+        case SDUI_TOK_OPA:        case SDUI_TOK_HIDDEN:       case SDUI_TOK_ANIM:       case SDUI_TOK_CLASS:
+            return true;
+        default:
+            break;
+    }
+    switch (t) {
+        case WT_LABEL:  return k == SDUI_TOK_TEXT || k == SDUI_TOK_LONG_MODE;
+        case WT_BUTTON: return k == SDUI_TOK_TEXT;
+        case WT_BAR:    return k == SDUI_TOK_VALUE || k == SDUI_TOK_MIN || k == SDUI_TOK_MAX ||
+                               k == SDUI_TOK_INDIC_COLOR;
+        case WT_SLIDER: return k == SDUI_TOK_VALUE || k == SDUI_TOK_MIN || k == SDUI_TOK_MAX;
+        case WT_LIST:   return k == SDUI_TOK_ITEMS || k == SDUI_TOK_MAX_ITEMS;
+        default:        return false;
+    }
+}
+
+/** 被移除后可原地复位的属性 */
+static bool prop_resettable(sdui_tok_t k) {
+    return k == SDUI_TOK_HIDDEN || k == SDUI_TOK_OPA || k == SDUI_TOK_ANIM || k == SDUI_TOK_TEXT ||
+           k == SDUI_TOK_CLASS;
+}
+
+/** 新节点中存在且尚未进入差异表的属性补入差异表 */
+static void diff_pull(node_props_t *diff, const node_props_t *np, sdui_tok_t k) {
+    if (!diff->v[k]) diff->v[k] = np->v[k];
+}
+
+/** 某属性变化时需要一并重新应用的伴随属性（按依赖顺序，一次补齐） */
+static void diff_add_companions(node_props_t *diff, const node_props_t *np, bool anim_removed) {
+    /* 停止动画会复位透明度与背景色 */
+    if (NP(diff, ANIM) || anim_removed) {
+        diff_pull(diff, np, SDUI_TOK_OPA);
+        diff_pull(diff, np, SDUI_TOK_BG_COLOR);
+        diff_pull(diff, np, SDUI_TOK_BG_OPA);
+    }
+    if (NP(diff, ALIGN) || NP(diff, X) || NP(diff, Y)) {
+        diff_pull(diff, np, SDUI_TOK_ALIGN);
+        diff_pull(diff, np, SDUI_TOK_X);
+        diff_pull(diff, np, SDUI_TOK_Y);
+    }
+    if (NP(diff, BG_COLOR)) diff_pull(diff, np, SDUI_TOK_BG_OPA);
+    if (NP(diff, MIN) || NP(diff, MAX)) {
+        diff_pull(diff, np, SDUI_TOK_MIN);
+        diff_pull(diff, np, SDUI_TOK_MAX);
+        diff_pull(diff, np, SDUI_TOK_VALUE);
+    }
+}
+
+/** 把差异属性应用到已有对象 */
+static void patch_props(const node_props_t *d, widget_type_t t, lv_obj_t *obj) {
+    cJSON *anim = NP(d, ANIM);
+    if (anim) stop_anims(obj);
+
+    if (NP(d, CLASS)) {
+        remove_classes(obj);
+        apply_classes(NP(d, CLASS), obj);
+    }
+
+    apply_common_style(d, obj);
+
+    cJSON *hidden = NP(d, HIDDEN);
+    if (hidden && !cJSON_IsTrue(hidden)) lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+
+    cJSON *text = NP(d, TEXT);
+    if (text) {
+        if (t == WT_LABEL) {
+            set_label_text(obj, text);
+        } else if (t == WT_BUTTON) {
+            if (lv_obj_get_child_count(obj) == 0) lv_obj_center(lv_label_create(obj));
+            set_label_text(lv_obj_get_child(obj, 0), text);
+        }
+    }
+    if (t == WT_BUTTON && lv_obj_get_child_count(obj) > 0) {
+        lv_obj_t *lbl = lv_obj_get_child(obj, 0);
+        cJSON    *tc  = NP(d, TEXT_COLOR);
+        cJSON    *fs  = NP(d, FONT_SIZE);
+        if (tc && cJSON_IsString(tc)) lv_obj_set_style_text_color(lbl, parse_color(tc->valuestring), 0);
+        if (fs && cJSON_IsNumber(fs)) lv_obj_set_style_text_font(lbl, pick_font(fs->valueint), 0);
+    }
+
+    cJSON *lm = NP(d, LONG_MODE);
+    if (lm && t == WT_LABEL) set_long_mode(obj, lm);
+
+    if (t == WT_BAR || t == WT_SLIDER) {
+        cJSON *mn  = NP(d, MIN);
+        cJSON *mx  = NP(d, MAX);
+        if (mn || mx) {
+            int32_t min_v = (mn && cJSON_IsNumber(mn)) ? mn->valueint : 0;
+            int32_t max_v = (mx && cJSON_IsNumber(mx)) ? mx->valueint : 100;
+            if (t == WT_BAR) lv_bar_set_range(obj, min_v, max_v);
+            else             lv_slider_set_range(obj, min_v, max_v);
+        }
+        set_range_value(obj, NP(d, VALUE), LV_ANIM_ON);
+    }
+    cJSON *ic = NP(d, INDIC_COLOR);
+    if (ic && cJSON_IsString(ic) && t == WT_BAR) {
+        lv_obj_set_style_bg_color(obj, parse_color(ic->valuestring), LV_PART_INDICATOR);
+        lv_obj_set_style_bg_opa(obj, LV_OPA_COVER, LV_PART_INDICATOR);
+    }
+
+    list_data_t *ld = t == WT_LIST ? list_data_of(obj) : NULL;
+    if (ld) {
+        cJSON *mx    = NP(d, MAX_ITEMS);
+        cJSON *items = NP(d, ITEMS);
+        if (mx) list_set_max(ld, mx);
+        if (items) {
+            list_set_items(ld, items);
+        } else if (NP(d, GAP) || NP(d, PAD)) {
+            list_measure(ld, 0);   /* 行距或内容宽度变化 */
+            list_unbind_all(ld);
+            list_bind(ld);
+        }
+    }
+
+    if (anim && cJSON_IsObject(anim)) apply_anim(anim, obj);
+}
+
+static bool sigs_have(const prop_sig_t *sigs, uint16_t n, uint32_t key) {
+    for (uint16_t i = 0; i < n; i++) if (sigs[i].key == key) return true;
+    return false;
+}
+
+/** 布局中被移除的属性：可复位的原地复位，返回 false 表示需要重建 */
+static bool reset_removed_props(widget_meta_t *meta, const prop_sig_t *sigs, uint16_t n, lv_obj_t *obj) {
+    for (uint16_t i = 0; i < meta->prop_count; i++) {
+        uint32_t k = meta->props[i].key;
+        if (sigs_have(sigs, n, k)) continue;
+        if      (k == sdui_ids_hash("hidden")) lv_obj_clear_flag(obj, LV_OBJ_FLAG_HIDDEN);
+        else if (k == sdui_ids_hash("opa"))    lv_obj_set_style_opa(obj, LV_OPA_COVER, 0);
+        else if (k == sdui_ids_hash("anim"))   stop_anims(obj);
+        else if (k == sdui_ids_hash("class"))  remove_classes(obj);
+        else if (k == sdui_ids_hash("text")) {
+            if (meta->type == WT_LABEL) set_label_text(obj, NULL);
+            else if (lv_obj_get_child_count(obj) > 0) set_label_text(lv_obj_get_child(obj, 0), NULL);
+        }
+        else return false;
+    }
+    return true;
+}
+
+/**
+ * 比较新节点与已有对象的属性签名并原地修改。
+ * 差异以属性表表示（不分配）。
+ * @return true 已原地处理；false 存在无法原地修改的差异，需要重建
+ */
+static bool patch_node(cJSON *node, lv_obj_t *obj) {
+    widget_meta_t *meta = lv_obj_get_user_data(obj);
+    node_props_t   np, diff;
+    node_props_scan(&np, node);
+    memset(&diff, 0, sizeof(diff));
+    prop_sig_t    *sigs    = NULL;
+    uint16_t       n       = build_prop_sigs(node, &np, &sigs);
+    bool           ok      = sigs || !n;
+    bool           changed = false;
+
+    /* 先检查移除项能否复位，避免修改到一半再重建 */
+    for (uint16_t i = 0; ok && i < meta->prop_count; i++) {
+        uint32_t k = meta->props[i].key;
+        if (!sigs_have(sigs, n, k) && k != sdui_ids_hash("hidden") && k != sdui_ids_hash("opa") &&
+            k != sdui_ids_hash("anim") && k != sdui_ids_hash("text") && k != sdui_ids_hash("class"))
+            ok = false;
+    }
+
+    /* 变化或新增的属性 */
+    cJSON   *it = NULL;
+    uint16_t j  = 0;
+    if (ok) {
+        cJSON_ArrayForEach(it, node) {
+            if (!is_sig_item(&np, it)) continue;
+            prop_sig_t *old = meta_find_sig(meta, sigs[j].key);
+            if (!old || old->val != sigs[j].val) {
+                sdui_tok_t k = sdui_tok_lookup(it->string);
+                if (!prop_patchable((widget_type_t)meta->type, k)) { ok = false; break; }
+                if (!diff.v[k]) diff.v[k] = it;
+                changed = true;
+            }
+            j++;
+        }
+    }
+
+    if (ok) {
+        for (uint16_t i = 0; i < meta->prop_count && !changed; i++)
+            changed = !sigs_have(sigs, n, meta->props[i].key);
+
+        reset_removed_props(meta, sigs, n, obj);
+
+        /* 动画被移除：stop_anims 复位了透明度与背景色，需按布局值重新应用 */
+        bool anim_removed = meta_find_sig(meta, sdui_ids_hash("anim")) && !sigs_have(sigs, n, sdui_ids_hash("anim"));
+        diff_add_companions(&diff, &np, anim_removed);
+
+        if (changed) {
+            patch_props(&diff, (widget_type_t)meta->type, obj);
+            s_stats.patched++;
+        }
+        heap_caps_free(meta->props);
+        meta->props      = sigs;
+        meta->prop_count = n;
+        sigs = NULL;
+    }
+    heap_caps_free(sigs);
+    return ok;
+}
+
+/** 旧节点子对象：有元数据的才是 SDUI 节点（按钮内部 label 等不参与匹配） */
+static widget_meta_t *node_meta(lv_obj_t *obj) {
+    return obj ? (widget_meta_t *)lv_obj_get_user_data(obj) : NULL;
+}
+
+/** 子树中的 SDUI 节点数（带元数据的对象） */
+static uint32_t count_nodes(lv_obj_t *obj) {
+    uint32_t n = node_meta(obj) ? 1 : 0;
+    uint32_t k = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < k; i++) n += count_nodes(lv_obj_get_child(obj, i));
+    return n;
+}
+
+/**
+ * 删除 reconcile 判定的旧节点。deleted 在判定时按子树节点数记入，
+ * 回收定时器在后台删除的旧根不计入当次渲染。
+ */
+static void delete_node(lv_obj_t *obj) {
+    s_stats.deleted += count_nodes(obj);
+    lv_obj_delete(obj);
+}
+
+/**
+ * 对比一层子节点的前三步：匹配新旧节点并删除未匹配的旧节点。
+ * match 与 children 等长，匹配到的旧对象带 matched 标记直到被逐个处理。
+ * @return parent 下不参与匹配的子对象数（新节点排在它们之后）
+ */
+static uint32_t reconcile_match(cJSON *children, lv_obj_t *parent, bool is_root, lv_obj_t **match) {
+    int n = (children && cJSON_IsArray(children)) ? cJSON_GetArraySize(children) : 0;
+
+    /* 1. 按 id 匹配（须同父、同类型） */
+    cJSON *child = NULL;
+    int    i     = 0;
+    cJSON_ArrayForEach(child, children) {
+        cJSON *id = cJSON_GetObjectItemCaseSensitive(child, "id");
+        if (id && cJSON_IsString(id) && id->valuestring[0]) {
+            lv_obj_t      *obj  = sdui_parser_find_by_id(id->valuestring);
+            widget_meta_t *meta = node_meta(obj);
+            if (meta && !meta->matched && lv_obj_get_parent(obj) == parent && meta->type == node_type(child)) {
+                match[i]      = obj;
+                meta->matched = 1;
+            }
+        }
+        i++;
+    }
+
+    /* 2. 无 id 节点按 类型+位置 匹配 */
+    uint32_t old_cnt = lv_obj_get_child_count(parent);
+    int      pos     = 0;
+    for (uint32_t k = 0; k < old_cnt && pos < n; k++) {
+        lv_obj_t      *obj  = lv_obj_get_child(parent, k);
+        widget_meta_t *meta = node_meta(obj);
+        if (!meta) continue;
+        cJSON *nc = cJSON_GetArrayItem(children, pos);
+        cJSON *id = cJSON_GetObjectItemCaseSensitive(nc, "id");
+        bool   nc_has_id = id && cJSON_IsString(id) && id->valuestring[0];
+        if (!match[pos] && !meta->matched && !meta->id[0] && !nc_has_id && meta->type == node_type(nc)) {
+            match[pos]    = obj;
+            meta->matched = 1;
+        }
+        pos++;
+    }
+
+    /* 3. 删除未匹配的旧节点（根视图下的非 SDUI 对象如 Loading 页一并删除） */
+    for (int32_t k = (int32_t)lv_obj_get_child_count(parent) - 1; k >= 0; k--) {
+        lv_obj_t      *obj  = lv_obj_get_child(parent, k);
+        widget_meta_t *meta = node_meta(obj);
+        if (meta ? !meta->matched : is_root) delete_node(obj);
+    }
+
+    uint32_t base = 0;
+    for (uint32_t k = 0; k < lv_obj_get_child_count(parent); k++)
+        if (!node_meta(lv_obj_get_child(parent, k))) base++;
+    return base;
+}
+
+/* ======================================================
+ * 过渡动画辅助：根视图 Fade-In
+ * ====================================================== */
+static void root_fade_in(void) {
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, s_root_view);
+    lv_anim_set_exec_cb(&a, anim_opa_exec_cb);
+    lv_anim_set_values(&a, LV_OPA_TRANSP, LV_OPA_COVER);
+    lv_anim_set_duration(&a, 200);
+    lv_anim_set_path_cb(&a, lv_anim_path_ease_out);
+    lv_anim_start(&a);
+}
+
+/* ======================================================
+ * 根视图双缓冲
+ *   全量构建在隐藏的离屏根 (stage) 上进行，旧界面保持显示且可交互；
+ *   完成后一步切换可见性。旧根移入隐藏的回收站，由定时器每次删除
+ *   预算时间内的若干叶子对象，避免一次性删除整棵树造成卡顿。
+ * ====================================================== */
+#define REAP_SLICE_BUDGET_US  2000   /* 每次回收的持锁预算 */
+#define REAP_TIMER_PERIOD_MS  10
+
+static lv_obj_t   *s_build_root = NULL;   /* 构建目标：全量构建时为 stage，否则即 s_root_view */
+static lv_obj_t   *s_graveyard  = NULL;   /* 待删除旧根的隐藏父对象 */
+static lv_timer_t *s_reap_timer = NULL;
+
+/** 创建一个空的根视图（圆屏安全区、Flex 列布局、不可滚动） */
+static lv_obj_t *root_view_create(lv_obj_t *scr) {
+    lv_obj_t *root = lv_obj_create(scr);
+    lv_obj_remove_style_all(root);
+    lv_obj_set_size(root,
+                    SDUI_SCREEN_W - 2 * SDUI_SAFE_PADDING,
+                    SDUI_SCREEN_H - 2 * SDUI_SAFE_PADDING);
+    lv_obj_center(root);
+    lv_obj_set_style_bg_opa(root, LV_OPA_TRANSP, 0);
+    lv_obj_clear_flag(root, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(root, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_layout(root, LV_LAYOUT_FLEX);
+    lv_obj_set_flex_flow(root, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(root, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    return root;
+}
+
+static void reap_timer_cb(lv_timer_t *t) {
+    (void)t;
+    int64_t t0 = esp_timer_get_time();
+    while (lv_obj_get_child_count(s_graveyard) > 0) {
+        /* 每次删除一个叶子，单步开销与子树大小无关 */
+        lv_obj_t *leaf = s_graveyard;
+        while (lv_obj_get_child_count(leaf) > 0) leaf = lv_obj_get_child(leaf, -1);
+        lv_obj_delete(leaf);
+        if (esp_timer_get_time() - t0 >= REAP_SLICE_BUDGET_US) return;
+    }
+    lv_timer_pause(s_reap_timer);
+}
+
+static void retire_root(lv_obj_t *root) {
+    lv_obj_add_flag(root, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_set_parent(root, s_graveyard);
+    if (!s_reap_timer) s_reap_timer = lv_timer_create(reap_timer_cb, REAP_TIMER_PERIOD_MS, NULL);
+    lv_timer_resume(s_reap_timer);
+}
+
+/** 把现有对象树中的 ID 重新登记（离屏构建被放弃后恢复注册表） */
+static void reindex_tree(lv_obj_t *obj) {
+    widget_meta_t *meta = lv_obj_get_user_data(obj);
+    if (meta && meta->id[0]) register_id(meta, obj);
+    uint32_t n = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < n; i++) reindex_tree(lv_obj_get_child(obj, i));
+}
+
+/** 放弃未完成的离屏构建，旧界面继续生效 */
+static void stage_abort(void) {
+    if (s_build_root == s_root_view) return;
+    retire_root(s_build_root);
+    s_build_root = s_root_view;
+    clear_id_table();
+    reindex_tree(s_root_view);
+}
+
+/** 开始离屏构建：新建隐藏的 stage，ID 注册表改为登记新树 */
+static void stage_begin(void) {
+    stage_abort();
+    clear_id_table();
+    s_build_root = root_view_create(lv_obj_get_parent(s_root_view));
+    lv_obj_add_flag(s_build_root, LV_OBJ_FLAG_HIDDEN);
+}
+
+/** 可见性一步切换；fade 为 true 时新根 200ms Fade-In */
+static void stage_commit(bool fade) {
+    lv_obj_t *old = s_root_view;
+    s_root_view = s_build_root;
+    lv_obj_clear_flag(s_root_view, LV_OBJ_FLAG_HIDDEN);
+    retire_root(old);
+    if (fade) root_fade_in();
+}
+
+/** 根节点 "transition": "fade" 时切换带淡入，默认直接切换 */
+static bool root_wants_fade(cJSON *root) {
+    cJSON *tr = root ? cJSON_GetObjectItemCaseSensitive(root, "transition") : NULL;
+    return value_tok(tr) == SDUI_TOK_FADE;
+}
+
+/** 根节点自身属性（flex/justify/align_items 及通用样式） */
+static uint32_t s_root_sig = 0;
+
+static void apply_root_props(const node_props_t *root) {
+    /* 重置根视图 Flex */
+    lv_obj_set_layout(s_build_root, LV_LAYOUT_FLEX);
+    lv_obj_set_flex_flow(s_build_root, LV_FLEX_FLOW_COLUMN);
+    lv_obj_set_flex_align(s_build_root, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER, LV_FLEX_ALIGN_CENTER);
+    lv_obj_set_style_bg_opa(s_build_root, LV_OPA_TRANSP, 0);
+    if (!root) return;
+
+    apply_common_style(root, s_build_root);
+    cJSON *flex = NP(root, FLEX);
+    if (flex && cJSON_IsString(flex)) {
+        lv_obj_set_layout(s_build_root, LV_LAYOUT_FLEX);
+        lv_obj_set_flex_flow(s_build_root, parse_flex_flow(value_tok(flex)));
+    }
+    cJSON *just = NP(root, JUSTIFY);
+    cJSON *ali  = NP(root, ALIGN_ITEMS);
+    if (just || ali) {
+        lv_flex_align_t ma = just && cJSON_IsString(just) ? parse_flex_align(value_tok(just)) : LV_FLEX_ALIGN_CENTER;
+        lv_flex_align_t ca = ali  && cJSON_IsString(ali)  ? parse_flex_align(value_tok(ali))  : LV_FLEX_ALIGN_CENTER;
+        lv_obj_set_flex_align(s_build_root, ma, ca, ca);
+    }
+}
+
+static uint32_t root_props_hash(cJSON *root, const node_props_t *p) {
+    uint32_t h  = 2166136261u;
+    cJSON   *it = NULL;
+    cJSON_ArrayForEach(it, root) {
+        if (!is_sig_item(p, it)) continue;
+        h = fnv_mix(h, it->string, strlen(it->string) + 1);
+        h = json_hash(it, h);
+    }
+    return h;
+}
+
+/* 布局来源：JSON 文本或 SBL 二进制，均产生 sdui_json 事件 */
+typedef bool (*layout_parse_fn_t)(const void *data, size_t len, int str_depth, sdui_json_cb_t cb, void *ctx);
+
+static bool layout_parse_text(const void *data, size_t len, int str_depth, sdui_json_cb_t cb, void *ctx) {
+    return sdui_json_parse(data, len, str_depth, cb, ctx);
+}
+
+static bool layout_parse_bin(const void *data, size_t len, int str_depth, sdui_json_cb_t cb, void *ctx) {
+    (void)str_depth;
+    return sdui_json_parse_bin(data, len, cb, ctx);
+}
+
+/* 由事件构建 cJSON DOM：增量模式与 sdui_parser_prepare* 在锁外准备、锁内按节点表逐片创建，
+ * 整棵树须保留到构建完成（全量布局的 sdui_parser_stream 不经过这里） */
+typedef struct {
+    cJSON *stack[SDUI_JSON_MAX_DEPTH];
+    int    depth;
+    cJSON *root;
+} dom_ctx_t;
+
+static cJSON *json_scalar(const sdui_json_event_t *ev) {
+    switch (ev->type) {
+        case SDUI_JSON_STRING: return cJSON_CreateString(ev->str);
+        case SDUI_JSON_NUMBER: return cJSON_CreateNumber(ev->num);
+        case SDUI_JSON_TRUE:   return cJSON_CreateTrue();
+        case SDUI_JSON_FALSE:  return cJSON_CreateFalse();
+        default:               return cJSON_CreateNull();
+    }
+}
+
+static bool dom_cb(void *ctx, const sdui_json_event_t *ev) {
+    dom_ctx_t *dc = ctx;
+    cJSON     *item;
+    switch (ev->type) {
+        case SDUI_JSON_OBJ_END:
+        case SDUI_JSON_ARR_END:   dc->depth--; return true;
+        case SDUI_JSON_OBJ_BEGIN: item = cJSON_CreateObject(); break;
+        case SDUI_JSON_ARR_BEGIN: item = cJSON_CreateArray();  break;
+        default:                  item = json_scalar(ev);      break;
+    }
+    if (!item) return false;
+    if (dc->depth == 0) {
+        dc->root = item;
+    } else {
+        cJSON *parent = dc->stack[dc->depth - 1];
+        if (cJSON_IsArray(parent)) cJSON_AddItemToArray(parent, item);
+        else                       cJSON_AddItemToObject(parent, ev->key, item);
+    }
+    if (ev->type == SDUI_JSON_OBJ_BEGIN || ev->type == SDUI_JSON_ARR_BEGIN) dc->stack[dc->depth++] = item;
+    return true;
+}
+
+/** 解析为 cJSON DOM；失败返回 NULL。不调用 LVGL，可在锁外执行 */
+static cJSON *build_dom(layout_parse_fn_t parse, const void *data, size_t len) {
+    dom_ctx_t *dc = heap_caps_calloc(1, sizeof(dom_ctx_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!dc) { ESP_LOGE(TAG, "dom ctx alloc failed"); return NULL; }
+    bool   ok   = parse(data, len, SDUI_JSON_STR_ALL, dom_cb, dc);
+    cJSON *root = dc->root;
+    heap_caps_free(dc);
+    if (!ok) {
+        ESP_LOGE(TAG, "Layout DOM build failed");
+        cJSON_Delete(root);
+        return NULL;
+    }
+    return root;
+}
+
+/* ======================================================
+ * 分片构建 (sdui_parser_prepare / sdui_parser_submit)
+ *   锁外：解析为 DOM、前序展平为节点表、解码全部图片像素。
+ *   锁内：LVGL 定时器每次只创建预算时间内的若干节点，期间根视图
+ *   保持透明，全部完成后再 Fade-In。增量模式按同样预算逐个子节点对比，
+ *   以显式栈代替递归，片间停在当前子节点上。
+ *   构建期间到达的 ui/update 缓存，完成后按序应用。
+ * ====================================================== */
+#define BUILD_SLICE_BUDGET_US  4000   /* 每片持锁预算 */
+#define BUILD_TIMER_PERIOD_MS  1
+
+typedef struct {
+    cJSON   *node;
+    int32_t  parent;   /* 父节点在节点表中的下标，-1 为根视图 */
+    int32_t  img;      /* 预解码像素在 imgs 中的下标，-1 为无 */
+    uint32_t end;      /* 子树结束下标（不含），即下一个兄弟节点 */
+} prep_node_t;
+
+/* 增量模式的一层子节点：reconcile_match 完成后逐个修改 / 创建 */
+typedef struct {
+    lv_obj_t  *parent;
+    lv_obj_t **match;    /* 与新子节点等长，匹配到的旧对象 */
+    cJSON     *child;    /* 下一个待处理的新子节点 */
+    int32_t    i;        /* child 在数组中的位置 */
+    uint32_t   idx;      /* child 在节点表中的下标 */
+    uint32_t   base;     /* parent 下不参与匹配的子对象数 */
+    uint32_t   placed;
+} rec_frame_t;
+
+struct sdui_layout_job {
+    cJSON        *root;         /* 布局 DOM */
+    cJSON        *props_root;   /* 根容器属性（无则 NULL） */
+    bool          reconcile;
+    bool          binary;
+    bool          started;      /* 已清屏并开始创建 */
+    uint32_t      bytes;
+    int64_t       t_start;      /* prepare 开始时刻 */
+    int64_t       prepare_us;
+    uint32_t      perf_id;      /* 渲染计时记录（sdui_perf），0 为不计时 */
+
+    prep_node_t  *nodes;        /* 前序：父节点总在子节点之前 */
+    lv_obj_t    **objs;         /* 已创建的对象，创建失败为 NULL */
+    uint32_t      node_count;
+    uint32_t      node_cap;
+    uint32_t      next;
+
+    image_data_t **imgs;       /* 已解码像素，被 create_image 取走后为 NULL */
+    uint32_t      img_count;
+    uint32_t      img_cap;
+
+    cJSON        *wrap;         /* 增量模式单节点根的包装数组（引用 root） */
+    rec_frame_t  *rec;          /* 增量模式显式栈，栈顶为当前一层 */
+    uint32_t      rec_depth;
+    uint32_t      rec_cap;
+};
+
+static sdui_layout_job_t *s_job         = NULL;   /* 正在构建的任务 */
+static lv_timer_t        *s_build_timer = NULL;
+static char             **s_deferred       = NULL;   /* 构建期间到达的 ui/update（PSRAM，按需翻倍） */
+static uint32_t           s_deferred_count = 0;
+static uint32_t           s_deferred_cap   = 0;
+static bool               s_streaming      = false;   /* 流式构建进行中，片间不持锁 */
+
+/** 有布局正在构建（分片任务或流式构建），期间的 ui/update 与图片提交推迟 */
+static bool building(void) {
+    return s_job || s_streaming;
+}
+
+static void update_apply(const char *json_str);
+static void image_commit_ready(void);
+
+static bool job_grow(void **arr, uint32_t *cap, size_t elem) {
+    uint32_t n    = *cap ? *cap * 2 : 32;
+    void    *grown = heap_caps_realloc(*arr, n * elem, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!grown) return false;
+    *arr = grown;
+    *cap = n;
+    return true;
+}
+
+static bool prep_collect(sdui_layout_job_t *job, cJSON *node, int32_t parent);
+
+static bool prep_collect_list(sdui_layout_job_t *job, cJSON *children, int32_t parent) {
+    cJSON *child = NULL;
+    cJSON_ArrayForEach(child, children) {
+        if (cJSON_IsObject(child) && !prep_collect(job, child, parent)) return false;
+    }
+    return true;
+}
+
+static bool prep_collect(sdui_layout_job_t *job, cJSON *node, int32_t parent) {
+    if (job->node_count == job->node_cap &&
+        !job_grow((void **)&job->nodes, &job->node_cap, sizeof(prep_node_t))) return false;
+    int32_t self = (int32_t)job->node_count++;
+    job->nodes[self].node   = node;
+    job->nodes[self].parent = parent;
+    job->nodes[self].img    = -1;
+
+    if (node_type(node) == WT_IMAGE) {
+        image_data_t *img = decode_image_node(node);
+        if (img) {
+            if (job->img_count == job->img_cap &&
+                !job_grow((void **)&job->imgs, &job->img_cap, sizeof(image_data_t *))) {
+                image_data_free(img);
+                return false;
+            }
+            job->nodes[self].img        = (int32_t)job->img_count;
+            job->imgs[job->img_count++] = img;
+        }
+    }
+
+    cJSON *children = cJSON_GetObjectItemCaseSensitive(node, "children");
+    if (children && cJSON_IsArray(children) && !prep_collect_list(job, children, self)) return false;
+    job->nodes[self].end = job->node_count;
+    return true;
+}
+
+static void job_free(sdui_layout_job_t *job) {
+    if (!job) return;
+    sdui_perf_drop(job->perf_id);   /* 未上屏即被取代或失败 */
+    for (uint32_t i = 0; i < job->img_count; i++) image_data_free(job->imgs[i]);
+    heap_caps_free(job->imgs);
+    for (uint32_t d = 0; d < job->rec_depth; d++) free(job->rec[d].match);
+    heap_caps_free(job->rec);
+    cJSON_Delete(job->wrap);
+    heap_caps_free(job->objs);
+    heap_caps_free(job->nodes);
+    cJSON_Delete(job->root);
+    heap_caps_free(job);
+}
+
+static sdui_layout_job_t *job_new(int64_t t0, size_t len, bool binary, uint32_t perf_id) {
+    sdui_layout_job_t *job = heap_caps_calloc(1, sizeof(sdui_layout_job_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!job) {
+        ESP_LOGE(TAG, "layout job alloc failed");
+        sdui_perf_drop(perf_id);
+        return NULL;
+    }
+    job->t_start = t0;
+    job->binary  = binary;
+    job->bytes   = (uint32_t)len;
+    job->perf_id = perf_id;
+    return job;
+}
+
+/** 由 job->root 展平节点表并解码图片；失败时释放 job 并返回 NULL */
+static sdui_layout_job_t *job_prepare(sdui_layout_job_t *job) {
+    /* 根节点形态：数组 / 带 children 的根容器 / 单个节点 */
+    bool ok;
+    if (cJSON_IsArray(job->root)) {
+        ok = prep_collect_list(job, job->root, -1);
+    } else {
+        job->reconcile = cJSON_IsTrue(cJSON_GetObjectItemCaseSensitive(job->root, "reconcile"));
+        cJSON *ch = cJSON_GetObjectItemCaseSensitive(job->root, "children");
+        if (ch && cJSON_IsArray(ch)) {
+            job->props_root = job->root;
+            ok = prep_collect_list(job, ch, -1);
+        } else {
+            ok = prep_collect(job, job->root, -1);
+        }
+    }
+    if (ok && job->node_count) {
+        job->objs = heap_caps_calloc(job->node_count, sizeof(lv_obj_t *), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        ok = job->objs != NULL;
+    }
+    if (!ok) {
+        ESP_LOGE(TAG, "layout job: out of memory (%" PRIu32 " nodes)", job->node_count);
+        job_free(job);
+        return NULL;
+    }
+    job->prepare_us = esp_timer_get_time() - job->t_start;
+    sdui_perf_mark(job->perf_id, SDUI_PERF_PREPARED);
+    return job;
+}
+
+static sdui_layout_job_t *prepare_layout(layout_parse_fn_t parse, const void *data, size_t len, bool binary,
+                                         int64_t t0, uint32_t perf_id) {
+    sdui_layout_job_t *job = job_new(t0, len, binary, perf_id);
+    if (!job) return NULL;
+    job->root = build_dom(parse, data, len);
+    sdui_perf_mark(job->perf_id, SDUI_PERF_PARSED);
+    if (!job->root) {
+        ESP_LOGE(TAG, "Layout decode failed (%s)", binary ? "binary" : "json");
+        job_free(job);
+        return NULL;
+    }
+    return job_prepare(job);
+}
+
+/** 全量模式首片：新建离屏根并设置根容器属性 */
+static void job_begin(sdui_layout_job_t *job) {
+    stage_begin();
+    node_props_t rp;
+    if (job->props_root) node_props_scan(&rp, job->props_root);
+    apply_root_props(job->props_root ? &rp : NULL);
+    s_root_sig  = job->props_root ? root_props_hash(job->props_root, &rp) : 0;
+    s_heap_base = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    job->started = true;
+}
+
+/** 取走节点的预解码像素（转交所有权） */
+static image_data_t *job_take_image(sdui_layout_job_t *job, uint32_t idx) {
+    if (idx >= job->node_count || job->nodes[idx].img < 0) return NULL;
+    image_data_t *img = job->imgs[job->nodes[idx].img];
+    job->imgs[job->nodes[idx].img] = NULL;
+    return img;
+}
+
+static void job_build_one(sdui_layout_job_t *job) {
+    prep_node_t  *pn     = &job->nodes[job->next];
+    lv_obj_t     *parent = pn->parent < 0 ? s_build_root : job->objs[pn->parent];
+    image_data_t *img    = job_take_image(job, job->next);
+    lv_obj_t     *obj    = NULL;
+    if (parent) obj = build_node(pn->node, parent, img, NULL);
+    else        image_data_free(img);   /* 失败节点的子树随之跳过 */
+    job->objs[job->next++] = obj;
+}
+
+/** 增量模式：为 parent 的新子节点压入一层（idx 为首个子节点在节点表中的下标） */
+static void rec_push(sdui_layout_job_t *job, cJSON *children, lv_obj_t *parent, bool is_root, uint32_t idx) {
+    int n = (children && cJSON_IsArray(children)) ? cJSON_GetArraySize(children) : 0;
+    if (job->rec_depth == job->rec_cap &&
+        !job_grow((void **)&job->rec, &job->rec_cap, sizeof(rec_frame_t))) {
+        ESP_LOGE(TAG, "reconcile: out of memory, subtree skipped");
+        return;
+    }
+    lv_obj_t **match = n ? calloc(n, sizeof(lv_obj_t *)) : NULL;
+    if (n && !match) return;
+
+    rec_frame_t *f = &job->rec[job->rec_depth++];
+    memset(f, 0, sizeof(*f));
+    f->parent = parent;
+    f->match  = match;
+    f->child  = n ? children->child : NULL;
+    f->idx    = idx;
+    f->base   = reconcile_match(children, parent, is_root, match);
+}
+
+/** 增量模式首片：对比根容器属性并压入根视图这一层 */
+static void rec_begin(sdui_layout_job_t *job) {
+    /* 根节点形态：数组 / 带 children 的根容器 / 单个节点（包装为单元素数组） */
+    cJSON *children = job->root;
+    if (job->props_root) {
+        children = cJSON_GetObjectItemCaseSensitive(job->root, "children");
+    } else if (!cJSON_IsArray(job->root)) {
+        job->wrap = cJSON_CreateArray();
+        cJSON_AddItemReferenceToArray(job->wrap, job->root);
+        children = job->wrap;
+    }
+    node_props_t rp;
+    if (job->props_root) node_props_scan(&rp, job->props_root);
+    uint32_t root_sig = job->props_root ? root_props_hash(job->props_root, &rp) : 0;
+    if (root_sig != s_root_sig) apply_root_props(job->props_root ? &rp : NULL);
+    s_root_sig  = root_sig;
+    s_heap_base = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    job->started = true;
+    rec_push(job, children, s_root_view, true, 0);
+}
+
+/** 增量模式：处理栈顶一层的下一个新子节点（修改或创建），有子节点时压入下一层 */
+static void rec_step(sdui_layout_job_t *job) {
+    rec_frame_t *f = &job->rec[job->rec_depth - 1];
+    if (!f->child) {
+        free(f->match);
+        job->rec_depth--;
+        return;
+    }
+    cJSON    *child  = f->child;
+    lv_obj_t *parent = f->parent;
+    lv_obj_t *obj    = f->match[f->i];
+    uint32_t  idx    = f->idx;
+    cJSON    *kids   = NULL;
+
+    if (obj) {
+        node_meta(obj)->matched = 0;
+        if (patch_node(child, obj)) {
+            kids = cJSON_GetObjectItemCaseSensitive(child, "children");
+        } else {
+            delete_node(obj);
+            obj = build_node(child, parent, job_take_image(job, idx), &kids);
+        }
+    } else {
+        obj = build_node(child, parent, job_take_image(job, idx), &kids);
+    }
+    if (obj) lv_obj_move_to_index(obj, (int32_t)(f->base + f->placed++));
+
+    /* 节点表只收录对象（见 prep_collect_list） */
+    if (cJSON_IsObject(child)) f->idx = job->nodes[idx].end;
+    f->child = child->next;
+    f->i++;
+    if (obj && kids) rec_push(job, kids, obj, false, idx + 1);   /* 可能搬移 job->rec，f 此后失效 */
+}
+
+/** 被取代的增量任务：清除尚未处理的匹配标记 */
+static void rec_abort(sdui_layout_job_t *job) {
+    for (uint32_t d = 0; d < job->rec_depth; d++) {
+        rec_frame_t *f = &job->rec[d];
+        for (cJSON *c = f->child; c; c = c->next, f->i++)
+            if (f->match[f->i]) node_meta(f->match[f->i])->matched = 0;
+    }
+}
+
+/** 构建完成：全量模式切换到新根，记录统计与日志 */
+static void render_done(bool reconcile, bool fade, bool binary, uint32_t bytes, int64_t t_start, int64_t prepare_us) {
+    if (!reconcile) {
+        s_stats.deleted = s_view_nodes;   /* 被替换的整棵旧树，由回收定时器在后台删除 */
+        stage_commit(fade);
+    }
+    s_view_nodes += s_stats.created - s_stats.deleted;
+
+    s_stats.reconciled = reconcile;
+    s_stats.binary     = binary;
+    s_stats.bytes      = bytes;
+    s_stats.prepare_us = prepare_us;
+    s_stats.time_us    = esp_timer_get_time() - t_start;
+    s_stats.heap_bytes = (int32_t)((int64_t)s_heap_base - (int64_t)heap_caps_get_free_size(MALLOC_CAP_8BIT));
+    ESP_LOGI(TAG, "Render done (%s, %s %" PRIu32 " B): created=%" PRIu32 " patched=%" PRIu32 " deleted=%" PRIu32
+             " in %" PRId64 " us (prepare %" PRId64 " us off-lock, %" PRIu32 " slices, max lock %" PRId64 " us). IDs: %d",
+             reconcile ? "reconcile" : "full", binary ? "binary" : "json", bytes,
+             s_stats.created, s_stats.patched, s_stats.deleted, s_stats.time_us, s_stats.prepare_us,
+             s_stats.slices, s_stats.max_lock_us, sdui_ids_count());
+    ESP_LOGI(TAG, "Render heap: %+" PRId32 " B (%" PRId32 " B/created node), classes: %u",
+             s_stats.heap_bytes, s_stats.created ? s_stats.heap_bytes / (int32_t)s_stats.created : 0,
+             s_class_count);
+}
+
+/** 依次应用构建期间缓存的 ui/update，再提交目标组件在构建期间尚未创建的图片上传 */
+static void apply_deferred(void) {
+    for (uint32_t i = 0; i < s_deferred_count; i++) {
+        update_apply(s_deferred[i]);
+        heap_caps_free(s_deferred[i]);
+    }
+    s_deferred_count = 0;
+    image_commit_ready();
+}
+
+static void job_finish(sdui_layout_job_t *job) {
+    render_done(job->reconcile, root_wants_fade(job->props_root), job->binary, job->bytes, job->t_start,
+                job->prepare_us);
+    sdui_perf_mark(job->perf_id, SDUI_PERF_BUILT);   /* 之后由刷新事件记到上屏 */
+    job->perf_id = 0;
+
+    s_job = NULL;
+    job_free(job);
+    lv_timer_pause(s_build_timer);
+    apply_deferred();
+}
+
+static void build_timer_cb(lv_timer_t *t) {
+    (void)t;
+    sdui_layout_job_t *job = s_job;
+    if (!job) { lv_timer_pause(s_build_timer); return; }
+
+    int64_t t0 = esp_timer_get_time();
+    bool    done;
+    if (job->reconcile) {
+        if (!job->started) rec_begin(job);
+        while (job->rec_depth) {
+            rec_step(job);
+            if (esp_timer_get_time() - t0 >= BUILD_SLICE_BUDGET_US) break;
+        }
+        done = job->rec_depth == 0;
+    } else {
+        if (!job->started) job_begin(job);
+        while (job->next < job->node_count) {
+            job_build_one(job);
+            if (esp_timer_get_time() - t0 >= BUILD_SLICE_BUDGET_US) break;
+        }
+        done = job->next == job->node_count;
+    }
+
+    int64_t held = esp_timer_get_time() - t0;
+    s_stats.slices++;
+    if (held > s_stats.max_lock_us) s_stats.max_lock_us = held;
+    if (done) job_finish(job);
+}
+
+/** 放弃正在进行的任务（被新布局取代） */
+static void job_cancel(void) {
+    if (!s_job) return;
+    ESP_LOGW(TAG, "Layout build superseded at %" PRIu32 "/%" PRIu32 " nodes", s_job->next, s_job->node_count);
+    if (s_job->reconcile) rec_abort(s_job);
+    job_free(s_job);
+    s_job = NULL;
+    stage_abort();
+    if (s_build_timer) lv_timer_pause(s_build_timer);
+}
+
+/* ======================================================
+ * 分片图片上传 (ui/image)
+ *   每个分片 {id, offset, total, data[, w, h]} 在锁外直接 Base64 解码进
+ *   最终的 PSRAM 像素缓冲，峰值内存 ≈ 位图本身 + 一个分片；收齐后在锁内
+ *   替换到同 id 的 image 组件上。
+ *   槽位状态由唯一一方推进：接收任务 FREE→RECEIVING→READY，
+ *   LVGL 锁内 READY→FREE，因此锁外接收与锁内提交无需额外互斥。
+ * ====================================================== */
+#define IMAGE_UPLOAD_SLOTS  4
+#define IMAGE_UPLOAD_MAX    (SDUI_SCREEN_W * SDUI_SCREEN_H * 2)   /* RGB565 全屏 */
+
+enum { UPLOAD_FREE = 0, UPLOAD_RECEIVING, UPLOAD_READY };
+
+typedef struct {
+    uint8_t   state;        /* __atomic 访问 */
+    char      id[32];
+    uint8_t  *buf;          /* PSRAM，提交后归组件所有 */
+    uint32_t  total;        /* 解码后字节数 = w * h * 2 */
+    uint32_t  received;     /* 已连续写入的字节数 */
+    uint16_t  w, h;
+    uint8_t   format;       /* sdui_img_format_t */
+    char      ref[SDUI_IMG_REF_MAX + 1];   /* 内容哈希，非空时收齐后登记到图片缓存 */
+    uint32_t  seq;          /* 开始顺序，同 id 多次上传时后者生效 */
+    int64_t   t_start;
+} image_upload_t;
+
+static image_upload_t s_uploads[IMAGE_UPLOAD_SLOTS];
+static uint32_t       s_upload_seq = 0;
+
+static uint8_t upload_state(image_upload_t *u) { return __atomic_load_n(&u->state, __ATOMIC_ACQUIRE); }
+static void    upload_set_state(image_upload_t *u, uint8_t st) { __atomic_store_n(&u->state, st, __ATOMIC_RELEASE); }
+
+static void upload_reset(image_upload_t *u) {
+    heap_caps_free(u->buf);
+    u->buf = NULL;
+    upload_set_state(u, UPLOAD_FREE);
+}
+
+/** offset 为 0 的分片开始一次上传；同 id 未完成的上传被取代，无空槽时淘汰最早的接收中槽位 */
+static image_upload_t *upload_begin(const char *id, uint32_t total, int w, int h, sdui_img_format_t fmt, const char *ref) {
+    image_upload_t *slot = NULL, *oldest = NULL;
+    for (int i = 0; i < IMAGE_UPLOAD_SLOTS; i++) {
+        image_upload_t *u  = &s_uploads[i];
+        uint8_t         st = upload_state(u);
+        if (st == UPLOAD_RECEIVING && !strcmp(u->id, id)) { upload_reset(u); st = UPLOAD_FREE; }
+        if (st == UPLOAD_FREE && !slot) slot = u;
+        if (st == UPLOAD_RECEIVING && (!oldest || u->seq < oldest->seq)) oldest = u;
+    }
+    if (!slot && oldest) {
+        ESP_LOGW(TAG, "image upload '%s' evicted (%" PRIu32 "/%" PRIu32 " B)", oldest->id, oldest->received, oldest->total);
+        upload_reset(oldest);
+        slot = oldest;
+    }
+    if (!slot) {
+        ESP_LOGW(TAG, "image upload '%s': no free slot", id);
+        return NULL;
+    }
+    slot->buf = heap_caps_malloc(total, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!slot->buf) {
+        ESP_LOGW(TAG, "image upload '%s': PSRAM alloc failed (%" PRIu32 " B)", id, total);
+        return NULL;
+    }
+    strncpy(slot->id, id, sizeof(slot->id) - 1);
+    slot->id[sizeof(slot->id) - 1] = '\0';
+    slot->total    = total;
+    slot->received = 0;
+    slot->w        = (uint16_t)w;
+    slot->h        = (uint16_t)h;
+    slot->format   = (uint8_t)fmt;
+    strncpy(slot->ref, ref ? ref : "", sizeof(slot->ref) - 1);
+    slot->ref[sizeof(slot->ref) - 1] = '\0';
+    slot->seq      = ++s_upload_seq;
+    slot->t_start  = esp_timer_get_time();
+    upload_set_state(slot, UPLOAD_RECEIVING);
+    return slot;
+}
+
+static image_upload_t *upload_find(const char *id) {
+    for (int i = 0; i < IMAGE_UPLOAD_SLOTS; i++)
+        if (upload_state(&s_uploads[i]) == UPLOAD_RECEIVING && !strcmp(s_uploads[i].id, id)) return &s_uploads[i];
+    return NULL;
+}
+
+/** 把位图换到组件上：新图生效后再释放旧缓冲 */
+static void image_swap(lv_obj_t *img, image_upload_t *u) {
+    sdui_img_entry_t *entry = u->ref[0] ? sdui_img_cache_insert(u->ref, u->buf, u->total, u->w, u->h) : NULL;
+    image_data_t     *idata = entry ? image_data_from_entry(entry)
+                                    : image_data_new(u->buf, u->total, u->w, u->h, NULL);
+    if (entry) u->buf = NULL;   /* 位图已归缓存 */
+    if (!idata) { upload_reset(u); return; }
+
+    lv_event_dsc_t *old = find_event_dsc(img, free_image_data_cb);
+    lv_image_set_src(img, &idata->dsc);
+    lv_image_set_pivot(img, u->w / 2, u->h / 2);
+    if (old) {
+        image_data_t *od = lv_event_dsc_get_user_data(old);
+        lv_obj_remove_event_dsc(img, old);
+        image_data_free(od);
+    }
+    lv_obj_add_event_cb(img, free_image_data_cb, LV_EVENT_DELETE, idata);
+
+    ESP_LOGI(TAG, "Image '%s' %ux%u (%" PRIu32 " B) applied, %" PRId64 " us since first chunk",
+             u->id, u->w, u->h, u->total, esp_timer_get_time() - u->t_start);
+    u->buf = NULL;
+    upload_set_state(u, UPLOAD_FREE);
+}
+
+/** 锁内：按开始顺序提交已收齐的上传；目标尚在构建中的保留到构建完成 */
+static void image_commit_ready(void) {
+    for (;;) {
+        image_upload_t *next = NULL;
+        for (int i = 0; i < IMAGE_UPLOAD_SLOTS; i++) {
+            image_upload_t *u = &s_uploads[i];
+            if (upload_state(u) != UPLOAD_READY) continue;
+            if (building() && !sdui_parser_find_by_id(u->id)) continue;
+            if (!next || u->seq < next->seq) next = u;
+        }
+        if (!next) return;
+
+        lv_obj_t *obj = sdui_parser_find_by_id(next->id);
+        if (!obj || !lv_obj_has_class(obj, &lv_image_class)) {
+            ESP_LOGW(TAG, "image upload: '%s' is not an image widget, dropped", next->id);
+            upload_reset(next);
+            continue;
+        }
+        image_swap(obj, next);
+    }
+}
+
+/* ======================================================
+ * 公共 API
+ * ====================================================== */
+lv_obj_t *sdui_parser_init(void) {
+    lv_obj_t *scr = lv_scr_act();
+
+    /* 禁用活动屏幕本身的 scrollable 和 scrollbar，
+     * 防止其在内容稍有溢出时于右下角渲染灰色滚动条方块 */
+    lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_scrollbar_mode(scr, LV_SCROLLBAR_MODE_OFF);
+    lv_obj_set_style_bg_color(scr, lv_color_black(), 0);
+    lv_obj_set_style_bg_opa(scr, LV_OPA_COVER, 0);
+
+    s_root_view  = root_view_create(scr);
+    s_build_root = s_root_view;
+
+    /* 被替换下来的旧根挂在这里分片删除 */
+    s_graveyard = lv_obj_create(scr);
+    lv_obj_remove_style_all(s_graveyard);
+    lv_obj_add_flag(s_graveyard, LV_OBJ_FLAG_HIDDEN);
+    sdui_img_cache_init(SDUI_IMG_CACHE_BUDGET);
+    sdui_glyph_init(SDUI_GLYPH_CACHE_BUDGET);
+    sdui_anim_init();
+    sdui_state_init();
+    for (size_t i = 0; i < FONT_SIZE_COUNT; i++)
+        if (!s_fonts[i]) s_fonts[i] = sdui_glyph_font_create(s_font_sizes[i].base, (uint8_t)s_font_sizes[i].px);
+    sdui_ids_init();
+    if (!sdui_tok_selftest()) ESP_LOGE(TAG, "Property token table out of sync, re-run gen_props.py");
+    ESP_LOGI(TAG, "Parser init. Root: %dx%d, safe_pad=%d",
+             SDUI_SCREEN_W - 2*SDUI_SAFE_PADDING,
+             SDUI_SCREEN_H - 2*SDUI_SAFE_PADDING,
+             SDUI_SAFE_PADDING);
+    return s_root_view;
+}
+
+lv_obj_t *sdui_parser_get_root(void) { return s_root_view; }
+
+/* ======================================================
+ * 流式构建 (sdui_parser_stream)：由 sdui_json 事件驱动，边读边创建组件
+ *   每个节点只缓存自身的标量属性（小 cJSON 对象，到达时即登记到属性表），
+ *   遇到 "children" 时先创建本体，子节点随后逐个创建并释放其属性；节点结束时补齐
+ *   事件、动画与元数据。峰值内存 ≈ 树深度 × 单节点属性，与载荷大小无关。
+ *   "children" 出现在 "type" 之前的节点退化为缓存整棵子树后 parse_node。
+ *   设置了锁回调时只在创建组件前持锁，持锁超过 BUILD_SLICE_BUDGET_US 即让出一次；
+ *   image 节点的像素在锁外解码。根节点带 "reconcile": true 时改走分片构建任务。
+ * ====================================================== */
+typedef enum {
+    SF_NODE = 0,    /* 组件节点（或根容器） */
+    SF_CHILDREN,    /* 正在创建其子节点的 children 数组 */
+    SF_VALUE,       /* 节点属性中的嵌套对象/数组（如 anim），照常构建为 cJSON */
+    SF_SKIP,        /* 无意义的结构，忽略 */
+} stream_kind_t;
+
+typedef struct {
+    uint8_t    kind;
+    uint8_t    wt;        /* SF_NODE：已创建时的组件类型 */
+    bool       is_root;   /* SF_NODE：根对象 */
+    bool       late;      /* SF_NODE：创建本体之后仍有属性到达 */
+    cJSON     *props;     /* SF_NODE：节点属性；SF_VALUE：正在构建的值（归属上层） */
+    lv_obj_t  *parent;    /* SF_NODE：父对象；SF_CHILDREN：子节点的父对象；NULL 为离屏根 */
+    lv_obj_t  *obj;       /* SF_NODE：已创建的本体（根容器为 s_build_root） */
+    node_props_t p;       /* SF_NODE：props 的属性表 */
+} stream_frame_t;
+
+typedef struct {
+    stream_frame_t stack[SDUI_JSON_MAX_DEPTH];
+    int            depth;
+    uint32_t       root_sig;
+    uint32_t       perf_id;
+    bool           fade;       /* 根容器 "transition": "fade" */
+    bool           reconcile;  /* 根节点 "reconcile": true，中止后改走分片构建 */
+    bool           started;    /* 已取消旧任务并新建离屏根 */
+    bool           yield;      /* 调用方未持锁，按预算分段持锁 */
+    bool           locked;
+    int64_t        t_lock;     /* 本段持锁开始时刻 */
+} stream_ctx_t;
+
+static void (*s_lock_fn)(void)   = NULL;
+static void (*s_unlock_fn)(void) = NULL;
+/** 结束本段持锁 */
+static void stream_unlock(stream_ctx_t *sc) {
+    if (!sc->yield || !sc->locked) return;
+    int64_t held = esp_timer_get_time() - sc->t_lock;
+    s_stats.slices++;
+    if (held > s_stats.max_lock_us) s_stats.max_lock_us = held;
+    sc->locked = false;
+    s_unlock_fn();
+}
+
+/**
+ * 创建组件前调用：确保持锁，首次调用时取代旧任务并新建离屏根。
+ * 本段已超预算时先让出一个 tick，LVGL 任务借此刷新与处理输入。
+ */
+static void stream_lock(stream_ctx_t *sc) {
+    if (sc->yield && sc->locked && esp_timer_get_time() - sc->t_lock >= BUILD_SLICE_BUDGET_US) {
+        stream_unlock(sc);
+        vTaskDelay(1);
+    }
+    if (sc->yield && !sc->locked) {
+        s_lock_fn();
+        sc->locked = true;
+        sc->t_lock = esp_timer_get_time();
+    }
+    if (sc->started) return;
+    sdui_perf_mark(sc->perf_id, SDUI_PERF_LOCKED);
+    job_cancel();
+    memset(&s_stats, 0, sizeof(s_stats));
+    stage_begin();
+    s_heap_base = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    s_streaming = true;
+    sc->started = true;
+}
+
+/** image 节点在锁外解码像素（不调用 LVGL），其余类型返回 NULL */
+static image_data_t *stream_image(stream_ctx_t *sc, stream_frame_t *f) {
+    if (parse_widget_type(value_tok(NP(&f->p, TYPE))) != WT_IMAGE) return NULL;
+    stream_unlock(sc);
+    return decode_image(&f->p);
+}
+
+/** 创建本体之后到达时需要重新应用的属性（id / 事件 / 动画本就在节点结束时处理，未收录的键无效果） */
+static bool stream_late_tok(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_ID:       case SDUI_TOK_ANIM:       case SDUI_TOK_ON_CLICK:
+        case SDUI_TOK_ON_PRESS: case SDUI_TOK_ON_RELEASE: case SDUI_TOK_ON_CHANGE:
+            return false;
+        default:
+            return sdui_tok_is_key(t);
+    }
+}
+
+static void stream_add(stream_frame_t *f, const char *key, cJSON *item) {
+    if (f->kind == SF_NODE) {
+        sdui_tok_t t = sdui_tok_lookup(key);
+        if (f->obj && stream_late_tok(t)) f->late = true;
+        cJSON_AddItemToObject(f->props, key, item);
+        if (sdui_tok_is_key(t) && !f->p.v[t]) f->p.v[t] = item;
+    } else if (cJSON_IsArray(f->props)) {
+        cJSON_AddItemToArray(f->props, item);
+    } else {
+        cJSON_AddItemToObject(f->props, key, item);
+    }
+}
+
+/** 节点进入 "children"：创建本体。返回 false 时按普通属性缓存 children */
+static bool stream_open_children(stream_ctx_t *sc, stream_frame_t *f) {
+    if (f->obj) return true;
+    if (f->is_root) {
+        stream_lock(sc);
+        apply_root_props(&f->p);
+        f->obj = s_build_root;
+        return true;
+    }
+    cJSON *type = NP(&f->p, TYPE);
+    if (!type || !cJSON_IsString(type)) return false;
+    image_data_t *img = stream_image(sc, f);
+    stream_lock(sc);
+    widget_type_t wt = WT_UNKNOWN;
+    f->obj = create_widget(&f->p, f->parent ? f->parent : s_build_root, img, &wt);
+    f->wt  = (uint8_t)wt;
+    return f->obj != NULL;
+}
+
+static void stream_close_node(stream_ctx_t *sc, stream_frame_t *f) {
+    if (f->is_root && f->obj) {
+        /* 根容器 */
+        stream_lock(sc);
+        if (f->late) apply_root_props(&f->p);
+        sc->root_sig = root_props_hash(f->props, &f->p);
+        sc->fade     = root_wants_fade(f->props);
+    } else if (f->obj) {
+        /* 出现在 children 之后的属性：整体重新应用一次（少见路径） */
+        stream_lock(sc);
+        if (f->late) {
+            cJSON *anim = NP(&f->p, ANIM);
+            NP(&f->p, ANIM) = NULL;   /* 动画由 finish_widget 启动 */
+            patch_props(&f->p, (widget_type_t)f->wt, f->obj);
+            if (f->wt == WT_CONTAINER) apply_container_props(&f->p, f->obj);
+            NP(&f->p, ANIM) = anim;
+        }
+        finish_widget(f->props, &f->p, f->obj, (widget_type_t)f->wt);
+    } else {
+        /* 无子节点（或退化）的节点一次性构建，属性表已随属性到达建好 */
+        image_data_t *img = stream_image(sc, f);
+        stream_lock(sc);
+        widget_type_t wt  = WT_UNKNOWN;
+        lv_obj_t     *obj = create_widget(&f->p, f->parent ? f->parent : s_build_root, img, &wt);
+        if (obj) {
+            finish_widget(f->props, &f->p, obj, wt);
+            parse_children(NP(&f->p, CHILDREN), obj);
+        }
+    }
+    cJSON_Delete(f->props);
+    f->props = NULL;
+}
+
+static bool stream_cb(void *ctx, const sdui_json_event_t *ev) {
+    stream_ctx_t   *sc  = ctx;
+    stream_frame_t *top = sc->depth ? &sc->stack[sc->depth - 1] : NULL;
+
+    switch (ev->type) {
+        case SDUI_JSON_OBJ_BEGIN:
+        case SDUI_JSON_ARR_BEGIN: {
+            bool            arr = ev->type == SDUI_JSON_ARR_BEGIN;
+            stream_frame_t *f   = &sc->stack[sc->depth++];
+            memset(f, 0, sizeof(*f));
+            if (!top) {
+                /* 根：数组直接作为根视图的子节点列表，对象可能是根容器或单个节点 */
+                f->kind    = arr ? SF_CHILDREN : SF_NODE;
+                f->is_root = !arr;
+                if (!arr) f->props = cJSON_CreateObject();
+            } else if (top->kind == SF_CHILDREN) {
+                f->kind   = arr ? SF_SKIP : SF_NODE;
+                f->parent = top->parent;
+                if (!arr) f->props = cJSON_CreateObject();
+            } else if (top->kind == SF_NODE && arr && !strcmp(ev->key, "children") &&
+                       stream_open_children(sc, top)) {
+                f->kind   = SF_CHILDREN;
+                f->parent = top->obj;
+            } else if (top->kind == SF_NODE || top->kind == SF_VALUE) {
+                f->kind  = SF_VALUE;
+                f->props = arr ? cJSON_CreateArray() : cJSON_CreateObject();
+                if (f->props) stream_add(top, ev->key, f->props);
+            } else {
+                f->kind = SF_SKIP;
+            }
+            return (f->kind != SF_NODE && f->kind != SF_VALUE) || f->props;
+        }
+        case SDUI_JSON_OBJ_END:
+        case SDUI_JSON_ARR_END:
+            sc->depth--;
+            if (top->kind == SF_NODE) stream_close_node(sc, top);
+            return true;
+        default: {
+            /* 根标量、children 中的标量：忽略 */
+            if (!top || (top->kind != SF_NODE && top->kind != SF_VALUE)) return true;
+            if (top->is_root && ev->type == SDUI_JSON_TRUE && !strcmp(ev->key, "reconcile")) {
+                sc->reconcile = true;   /* 增量模式需要随机访问新树，停止流式构建 */
+                return false;
+            }
+            cJSON *item = json_scalar(ev);
+            if (!item) return false;
+            stream_add(top, ev->key, item);
+            return true;
+        }
+    }
+}
+
+/**
+ * 全量模式：在离屏根上流式构建，完成后切换。
+ * yield 为 true 且设置了锁回调时调用方不持锁，否则调用方全程持锁。
+ */
+static void stream_layout(layout_parse_fn_t parse, const void *data, size_t len, bool binary, bool yield) {
+    int64_t       t0      = esp_timer_get_time();
+    uint32_t      perf_id = sdui_perf_claim();
+    stream_ctx_t *sc      = heap_caps_calloc(1, sizeof(stream_ctx_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!sc) {
+        ESP_LOGE(TAG, "stream ctx alloc failed");
+        sdui_perf_drop(perf_id);
+        return;
+    }
+    sc->perf_id = perf_id;
+    sc->yield   = yield && s_lock_fn && s_unlock_fn;
+
+    bool ok = parse(data, len, SDUI_JSON_STR_ALL, stream_cb, sc);
+    while (sc->depth > 0) {
+        stream_frame_t *f = &sc->stack[--sc->depth];
+        if (f->kind == SF_NODE) cJSON_Delete(f->props);
+    }
+    bool reconcile = sc->reconcile;
+
+    if (reconcile || !ok) {
+        bool hooked = sc->yield;
+        if (sc->started) {
+            stream_lock(sc);
+            stage_abort();   /* 旧界面继续生效 */
+            s_streaming = false;
+            stream_unlock(sc);
+        }
+        heap_caps_free(sc);
+        if (!reconcile) {
+            ESP_LOGE(TAG, "Layout decode failed (%s), keeping the current UI", binary ? "binary" : "json");
+            sdui_perf_drop(perf_id);
+            return;
+        }
+        sdui_layout_job_t *job = prepare_layout(parse, data, len, binary, t0, perf_id);
+        if (!job) return;
+        if (!hooked) {
+            sdui_parser_submit(job);   /* 调用方持锁 */
+            return;
+        }
+        s_lock_fn();
+        sdui_parser_submit(job);
+        s_unlock_fn();
+        return;
+    }
+
+    stream_lock(sc);   /* 空布局也要切换到空白的新根 */
+    if (sc->yield) {
+        int64_t held = esp_timer_get_time() - sc->t_lock;
+        s_stats.slices++;
+        if (held > s_stats.max_lock_us) s_stats.max_lock_us = held;
+    } else {
+        s_stats.slices      = 1;
+        s_stats.max_lock_us = esp_timer_get_time() - t0;
+    }
+    s_root_sig = sc->root_sig;
+    render_done(false, sc->fade, binary, (uint32_t)len, t0, 0);
+    sdui_perf_mark(perf_id, SDUI_PERF_BUILT);   /* 之后由刷新事件记到上屏 */
+    s_streaming = false;
+    apply_deferred();
+    if (sc->yield) s_unlock_fn();
+    heap_caps_free(sc);
+}
+
+void sdui_parser_set_lock(void (*lock)(void), void (*unlock)(void)) {
+    s_lock_fn   = lock;
+    s_unlock_fn = unlock;
+}
+
+void sdui_parser_stream(const char *json, size_t len) {
+    if (!json || !s_root_view) return;
+    stream_layout(layout_parse_text, json, len, false, true);
+}
+
+void sdui_parser_stream_bin(const uint8_t *data, size_t len) {
+    if (!data || !s_root_view) return;
+    stream_layout(layout_parse_bin, data, len, true, true);
+}
+
+/** 同步构建：在本次持锁调用内流式构建；增量模式跑完全部分片 */
+static void render_layout(layout_parse_fn_t parse, const void *data, size_t len, bool binary) {
+    stream_layout(parse, data, len, binary, false);
+    while (s_job) build_timer_cb(s_build_timer);
+}
+
+void sdui_parser_render(const char *json_str) {
+    if (!json_str || !s_root_view) return;
+    size_t len = strlen(json_str);
+    ESP_LOGI(TAG, "Render layout (%u bytes)", (unsigned)len);
+    render_layout(layout_parse_text, json_str, len, false);
+}
+
+void sdui_parser_render_bin(const uint8_t *data, size_t len) {
+    if (!data || !s_root_view) return;
+    ESP_LOGI(TAG, "Render binary layout (%u bytes)", (unsigned)len);
+    render_layout(layout_parse_bin, data, len, true);
+}
+
+sdui_layout_job_t *sdui_parser_prepare(const char *json_str) {
+    if (!json_str) return NULL;
+    return prepare_layout(layout_parse_text, json_str, strlen(json_str), false, esp_timer_get_time(), sdui_perf_claim());
+}
+
+sdui_layout_job_t *sdui_parser_prepare_len(const char *json, size_t len) {
+    if (!json) return NULL;
+    return prepare_layout(layout_parse_text, json, len, false, esp_timer_get_time(), sdui_perf_claim());
+}
+
+sdui_layout_job_t *sdui_parser_prepare_bin(const uint8_t *data, size_t len) {
+    if (!data) return NULL;
+    return prepare_layout(layout_parse_bin, data, len, true, esp_timer_get_time(), sdui_perf_claim());
+}
+
+sdui_layout_job_t *sdui_parser_prepare_dom(cJSON *root) {
+    if (!root) return NULL;
+    sdui_layout_job_t *job = job_new(esp_timer_get_time(), 0, false, sdui_perf_claim());
+    if (!job) { cJSON_Delete(root); return NULL; }
+    job->root = root;
+    sdui_perf_mark(job->perf_id, SDUI_PERF_PARSED);
+    return job_prepare(job);
+}
+
+void sdui_parser_submit(sdui_layout_job_t *job) {
+    if (!job) return;
+    if (!s_root_view) { job_free(job); return; }
+    sdui_perf_mark(job->perf_id, SDUI_PERF_LOCKED);
+    job_cancel();
+
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_heap_base = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    s_job       = job;
+    ESP_LOGI(TAG, "Layout job: %" PRIu32 " nodes, %" PRIu32 " images, prepared in %" PRId64 " us",
+             job->node_count, job->img_count, job->prepare_us);
+
+    if (!s_build_timer) s_build_timer = lv_timer_create(build_timer_cb, BUILD_TIMER_PERIOD_MS, NULL);
+    lv_timer_resume(s_build_timer);
+    lv_timer_ready(s_build_timer);
+}
+
+void sdui_parser_discard(sdui_layout_job_t *job) {
+    job_free(job);
+}
+
+bool sdui_parser_is_building(void) {
+    return building();
+}
+
+bool sdui_parser_image_feed(const char *json_str) {
+    if (!json_str) return false;
+    cJSON *root = cJSON_Parse(json_str);
+    if (!root) { ESP_LOGW(TAG, "image: JSON parse failed"); return false; }
+
+    bool   ready  = false;
+    cJSON *id     = cJSON_GetObjectItemCaseSensitive(root, "id");
+    cJSON *offset = cJSON_GetObjectItemCaseSensitive(root, "offset");
+    cJSON *total  = cJSON_GetObjectItemCaseSensitive(root, "total");
+    cJSON *data   = cJSON_GetObjectItemCaseSensitive(root, "data");
+    if (!id || !cJSON_IsString(id) || !cJSON_IsNumber(offset) || !cJSON_IsNumber(total) ||
+        !data || !cJSON_IsString(data)) {
+        ESP_LOGW(TAG, "image: need id/offset/total/data");
+        goto out;
+    }
+
+    image_upload_t *u = NULL;
+    if (offset->valuedouble == 0) {
+        cJSON            *w   = cJSON_GetObjectItemCaseSensitive(root, "w");
+        cJSON            *h   = cJSON_GetObjectItemCaseSensitive(root, "h");
+        cJSON            *fi  = cJSON_GetObjectItemCaseSensitive(root, "format");
+        sdui_img_format_t fmt = sdui_img_format_parse(cJSON_IsString(fi) ? fi->valuestring : NULL);
+        if (fmt == SDUI_IMG_UNKNOWN) {
+            ESP_LOGW(TAG, "image '%s': unsupported format '%s'", id->valuestring, fi->valuestring);
+            goto out;
+        }
+        if (!cJSON_IsNumber(w) || !cJSON_IsNumber(h) || w->valueint <= 0 || h->valueint <= 0 ||
+            total->valuedouble != (double)w->valueint * h->valueint * 2 || total->valuedouble > IMAGE_UPLOAD_MAX) {
+            ESP_LOGW(TAG, "image '%s': first chunk needs w/h with total = w*h*2 (<= %d)", id->valuestring, IMAGE_UPLOAD_MAX);
+            goto out;
+        }
+        cJSON *ref = cJSON_GetObjectItemCaseSensitive(root, "ref");
+        u = upload_begin(id->valuestring, (uint32_t)total->valuedouble, w->valueint, h->valueint, fmt,
+                         cJSON_IsString(ref) ? ref->valuestring : NULL);
+    } else {
+        u = upload_find(id->valuestring);
+        if (u && (offset->valuedouble != u->received || total->valuedouble != u->total)) {
+            /* TCP 保序，错位只可能来自服务端重传或丢弃，整张重来 */
+            ESP_LOGW(TAG, "image '%s': chunk at %.0f, expected %" PRIu32 ", upload reset",
+                     id->valuestring, offset->valuedouble, u->received);
+            upload_reset(u);
+            u = NULL;
+        }
+    }
+    if (!u) goto out;
+
+    size_t                b64len = strlen(data->valuestring);
+    const unsigned char  *b64    = (const unsigned char *)data->valuestring;
+    size_t                n      = 0;
+    int                   ret;
+    if (u->format == SDUI_IMG_RAW565) {
+        /* 直接解码到最终缓冲的对应位置 */
+        ret = mbedtls_base64_decode(u->buf + u->received, u->total - u->received, &n, b64, b64len);
+    } else {
+        /* 压缩分片（由完整 token 组成）：Base64 解到临时区，再解压到最终缓冲 */
+        size_t   zcap = b64len / 4 * 3 + 3;
+        uint8_t *z    = heap_caps_malloc(zcap, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        size_t   zlen = 0;
+        ret = z ? mbedtls_base64_decode(z, zcap, &zlen, b64, b64len) : -1;
+        if (ret == 0) {
+            int32_t k = sdui_img_rle565_decode(z, zlen, u->buf + u->received, u->total - u->received);
+            if (k < 0) ret = -2;
+            else       n = (size_t)k;
+        }
+        heap_caps_free(z);
+    }
+    if (ret != 0) {
+        ESP_LOGW(TAG, "image '%s': chunk decode failed (%d), upload reset", u->id, ret);
+        upload_reset(u);
+        goto out;
+    }
+    u->received += (uint32_t)n;
+    if (u->received == u->total) {
+        upload_set_state(u, UPLOAD_READY);
+        ready = true;
+    }
+out:
+    cJSON_Delete(root);
+    return ready;
+}
+
+void sdui_parser_image_commit(void) {
+    image_commit_ready();
+}
+
+/** 标签按原文重新排版；列表重新测量行高并重新绑定行（不再进入行对象） */
+static void glyph_refresh_tree(lv_obj_t *obj) {
+    list_data_t *ld = list_data_of(obj);
+    if (ld) {
+        list_measure(ld, 0);
+        list_unbind_all(ld);
+        lv_obj_refresh_self_size(ld->obj);
+        list_bind(ld);
+        return;
+    }
+    if (lv_obj_has_class(obj, &lv_label_class)) lv_label_set_text(obj, NULL);
+    uint32_t n = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < n; i++) glyph_refresh_tree(lv_obj_get_child(obj, i));
+}
+
+bool sdui_parser_glyph_feed(const char *json_str) {
+    return sdui_glyph_feed(json_str);
+}
+
+void sdui_parser_glyph_commit(void) {
+    if (!s_root_view) return;
+    int64_t t0 = esp_timer_get_time();
+    glyph_refresh_tree(s_root_view);
+    if (s_build_root != s_root_view) glyph_refresh_tree(s_build_root);   /* 正在分片构建的新根 */
+    ESP_LOGD(TAG, "glyph refresh in %" PRId64 " us", esp_timer_get_time() - t0);
+}
+
+void sdui_parser_glyph_persist(const char *path) {
+    sdui_glyph_persist(path);
+}
+
+void sdui_parser_get_glyph_cache_stats(sdui_glyph_cache_stats_t *out) {
+    sdui_glyph_get_stats(out);
+}
+
+void sdui_parser_get_anim_stats(sdui_anim_stats_t *out) {
+    sdui_anim_get_stats(out);
+}
+
+void sdui_parser_set_styles(const char *json_str) {
+    if (!json_str) return;
+    cJSON *root = cJSON_Parse(json_str);
+    if (!root || !cJSON_IsObject(root)) {
+        ESP_LOGW(TAG, "styles: JSON parse failed");
+        cJSON_Delete(root);
+        return;
+    }
+
+    int    n   = 0;
+    cJSON *def = NULL;
+    cJSON_ArrayForEach(def, root) {
+        if (!cJSON_IsObject(def) || !def->string[0]) continue;
+        style_class_t *cls = find_class(def->string, strlen(def->string));
+        if (cls) {
+            /* 原地重定义：引用该类的对象随之刷新 */
+            lv_style_reset(&cls->style);
+            fill_class_style(&cls->style, def);
+            lv_obj_report_style_change(&cls->style);
+        } else {
+            cls = add_class(def->string);
+            if (!cls) { ESP_LOGE(TAG, "styles: alloc failed"); break; }
+            fill_class_style(&cls->style, def);
+        }
+        n++;
+    }
+    ESP_LOGI(TAG, "Styles: %d defined, %u classes total", n, s_class_count);
+    cJSON_Delete(root);
+}
+
+void sdui_parser_get_render_stats(sdui_render_stats_t *out) {
+    if (out) *out = s_stats;
+}
+
+void sdui_parser_get_image_cache_stats(sdui_image_cache_stats_t *out) {
+    sdui_img_cache_get_stats(out);
+}
+
+lv_obj_t *sdui_parser_find_by_id(const char *id) {
+    return sdui_ids_get(id);
+}
+
+const char *sdui_parser_get_id(lv_obj_t *obj) {
+    widget_meta_t *meta = obj ? lv_obj_get_user_data(obj) : NULL;
+    return (meta && meta->id[0]) ? meta->id : NULL;
+}
+
+void sdui_parser_update(const char *json_str) {
+    if (!json_str) return;
+    if (!building()) {
+        uint32_t perf_id = sdui_perf_claim();
+        sdui_perf_mark(perf_id, SDUI_PERF_LOCKED);
+        update_apply(json_str);
+        sdui_perf_mark(perf_id, SDUI_PERF_BUILT);
+        return;
+    }
+
+    /* 布局尚在构建，目标可能还未创建：缓存到完成后应用。队列不设上限，
+     * 内存不足时立即应用（已创建的目标照常更新），不静默丢弃 */
+    size_t n   = strlen(json_str) + 1;
+    char  *dup = NULL;
+    if (s_deferred_count < s_deferred_cap ||
+        job_grow((void **)&s_deferred, &s_deferred_cap, sizeof(char *))) {
+        dup = heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    }
+    if (!dup) {
+        ESP_LOGE(TAG, "update: out of memory deferring %u B, applying before the build completes", (unsigned)n);
+        update_apply(json_str);
+        return;
+    }
+    memcpy(dup, json_str, n);
+    s_deferred[s_deferred_count++] = dup;
+}
+
+void sdui_parser_state_set(const char *json_str) {
+    int n = sdui_state_set(json_str);
+    if (n >= 0) ESP_LOGD(TAG, "State: %d variables changed", n);
+}
+
+void sdui_parser_state_flush(void) {
+    sdui_state_flush();
+}
+
+/** 应用单个 {"id": ...} 更新；目标不存在或缺少 id 时返回 false */
+static bool update_one(cJSON *root, bool verbose) {
+    node_props_t p;
+    node_props_scan(&p, root);
+    cJSON *id_item = NP(&p, ID);
+    if (!id_item || !cJSON_IsString(id_item)) {
+        ESP_LOGW(TAG, "update: missing 'id'");
+        return false;
     }
     lv_obj_t *target = sdui_parser_find_by_id(id_item->valuestring);
     if (!target) {
         ESP_LOGW(TAG, "update: widget '%s' not found", id_item->valuestring);
-        cJSON_Delete(root);
-        return;
+        return false;
+    }
+
+    /* 被 update 改写的属性标记为脏，下次 reconcile 时恢复为布局值 */
+    widget_meta_t *meta    = lv_obj_get_user_data(target);
+    bool           is_list = meta && meta->type == WT_LIST;
+    cJSON         *key     = NULL;
+    if (meta) cJSON_ArrayForEach(key, root) {
+        const char *k = key->string;
+        sdui_tok_t  t = sdui_tok_lookup(k);
+        if (is_list && (t == SDUI_TOK_APPEND || t == SDUI_TOK_TRIM)) k = "items";   /* 条目已偏离布局 */
+        else if (t == SDUI_TOK_SCROLL_TO) continue;
+        if (is_sig_tok(t)) meta_mark_dirty(meta, k);
     }
 
     /* text */
-    cJSON *text = cJSON_GetObjectItem(root, "text");
-    if (text && cJSON_IsString(text)) {
+    cJSON *text = NP(&p, TEXT);
+    if (text && (cJSON_IsString(text) || cJSON_IsObject(text)) && !is_list) {
         lv_obj_t *lobj = target;
         if (lv_obj_get_child_count(target) > 0)
             lobj = lv_obj_get_child(target, 0);
-        lv_label_set_text(lobj, text->valuestring);
+        set_label_text(lobj, text);
     }
 
     /* hidden */
-    cJSON *hidden = cJSON_GetObjectItem(root, "hidden");
+    cJSON *hidden = NP(&p, HIDDEN);
     if (hidden) {
         if (cJSON_IsTrue(hidden)) lv_obj_add_flag(target, LV_OBJ_FLAG_HIDDEN);
         else                      lv_obj_clear_flag(target, LV_OBJ_FLAG_HIDDEN);
     }
 
     /* bg_color */
-    cJSON *bgc = cJSON_GetObjectItem(root, "bg_color");
+    cJSON *bgc = NP(&p, BG_COLOR);
     if (bgc && cJSON_IsString(bgc)) {
         lv_obj_set_style_bg_color(target, parse_color(bgc->valuestring), 0);
         lv_obj_set_style_bg_opa(target, LV_OPA_COVER, 0);
     }
 
     /* value（bar / slider 专用） */
-    cJSON *val = cJSON_GetObjectItem(root, "value");
-    if (val && cJSON_IsNumber(val)) {
-        if (lv_obj_has_class(target, &lv_bar_class)) {
-            lv_bar_set_value(target, val->valueint, LV_ANIM_ON);
-        } else if (lv_obj_has_class(target, &lv_slider_class)) {
-            lv_slider_set_value(target, val->valueint, LV_ANIM_ON);
-        }
-    }
+    cJSON *val = NP(&p, VALUE);
+    if (val && (lv_obj_has_class(target, &lv_bar_class) || lv_obj_has_class(target, &lv_slider_class)))
+        set_range_value(target, val, LV_ANIM_ON);
 
     /* indic_color (bar) */
-    cJSON *ic = cJSON_GetObjectItem(root, "indic_color");
+    cJSON *ic = NP(&p, INDIC_COLOR);
     if (ic && cJSON_IsString(ic) && lv_obj_has_class(target, &lv_bar_class)) {
         lv_obj_set_style_bg_color(target, parse_color(ic->valuestring), LV_PART_INDICATOR);
         lv_obj_set_style_bg_opa(target, LV_OPA_COVER, LV_PART_INDICATOR);
     }
 
     /* opa */
-    cJSON *opa = cJSON_GetObjectItem(root, "opa");
+    cJSON *opa = NP(&p, OPA);
     if (opa && cJSON_IsNumber(opa))
         lv_obj_set_style_opa(target, (lv_opa_t)opa->valueint, 0);
 
+    /* class：替换引用的样式类 */
+    if (NP(&p, CLASS)) {
+        remove_classes(target);
+        apply_classes(NP(&p, CLASS), target);
+    }
+
+    /* list：items / append / trim / scroll_to */
+    if (is_list) list_update(target, &p);
+
     /* 触发动画 */
-    cJSON *anim = cJSON_GetObjectItem(root, "anim");
+    cJSON *anim = NP(&p, ANIM);
     if (anim && cJSON_IsObject(anim)) apply_anim(anim, target);
 
-    ESP_LOGI(TAG, "Updated '%s'", id_item->valuestring);
+    if (verbose) ESP_LOGI(TAG, "Updated '%s'", id_item->valuestring);
+    else         ESP_LOGD(TAG, "Updated '%s'", id_item->valuestring);
+    return true;
+}
+
+/**
+ * ui/update 载荷：单个对象，或对象数组 / {"ops": [...]} 批量形式。
+ * 批量形式只解析一次，全部在同一次持锁内应用，失效区域由 LVGL 合并到下一次刷新。
+ * 总线通道满时会把相邻的几条合成一个数组，其中的 {"ops": [...]} 元素按序展开。
+ */
+static void update_apply(const char *json_str) {
+    int64_t t0   = esp_timer_get_time();
+    cJSON  *root = cJSON_Parse(json_str);
+    if (!root) { ESP_LOGW(TAG, "update: JSON parse failed"); return; }
+
+    cJSON *ops = cJSON_IsArray(root) ? root : cJSON_GetObjectItemCaseSensitive(root, "ops");
+    if (ops && cJSON_IsArray(ops)) {
+        int    total = 0, applied = 0;
+        cJSON *op    = NULL;
+        cJSON_ArrayForEach(op, ops) {
+            cJSON *sub = cJSON_IsObject(op) ? cJSON_GetObjectItemCaseSensitive(op, "ops") : NULL;
+            if (cJSON_IsArray(sub)) {
+                cJSON *it = NULL;
+                cJSON_ArrayForEach(it, sub) {
+                    total++;
+                    if (cJSON_IsObject(it) && update_one(it, false)) applied++;
+                }
+                continue;
+            }
+            total++;
+            if (cJSON_IsObject(op) && update_one(op, false)) applied++;
+        }
+        ESP_LOGI(TAG, "Batch update: %d/%d applied in %" PRId64 " us",
+                 applied, total, esp_timer_get_time() - t0);
+    } else {
+        update_one(root, true);
+    }
     cJSON_Delete(root);
 }
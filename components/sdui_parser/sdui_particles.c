@@ -0,0 +1,188 @@
+/**
+ * @file sdui_particles.c
+ * @brief SDUI 定点粒子引擎实现
+ *
+ * 物理参数与旧版浮点实现一致（按帧步进）：
+ *   出生于中心 ±10px，vx ∈ [-1.25, 1.25)，vy ∈ [-2.75, -0.25)，
+ *   重力 0.06 px/帧²，alpha 每帧 -8，归零后下一帧重生。
+ *
+ * 清除与精灵混合走 sdui_pixel 内核（按行调用，PIE 可用时自动加速）。
+ */
+#include "sdui_particles.h"
+#include "sdui_pixel.h"
+#include "esp_heap_caps.h"
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#define Q16(v)          ((int32_t)((v) * 65536))
+#define GRAVITY_Q16     Q16(0.06)
+#define FADE_PER_FRAME  8
+#define SPAWN_JITTER    10          /* 出生点偏移 ±px */
+#define NOT_DRAWN       INT16_MIN
+
+struct sdui_particles {
+    /* ---- SoA 状态 ---- */
+    int32_t  *x, *y;       /* 相对画布中心，Q16 */
+    int32_t  *vx, *vy;     /* Q16 px/帧 */
+    uint8_t  *alpha;       /* 0 = 待重生 */
+    int16_t  *drawn_x;     /* 上一帧精灵左上角，NOT_DRAWN 表示未绘制 */
+    int16_t  *drawn_y;
+    int       count;
+    sdui_particles_rect_t drawn;      /* 上一帧精灵的包围盒 */
+    uint32_t  drawn_px;               /* 上一帧精灵方块面积之和 */
+
+    /* ---- 画布与精灵 ---- */
+    uint16_t *buf;
+    int       w, h;
+    uint16_t  color;
+    int       radius;
+    int       dim;         /* 精灵边长 = 2r + 1 */
+    uint8_t   sprite[(2 * SDUI_PARTICLE_R_MAX + 1) * (2 * SDUI_PARTICLE_R_MAX + 1)];
+
+    uint32_t  rng;
+};
+
+/* ---- xorshift32：比 rand() 快且无全局锁 ---- */
+static inline uint32_t rng_next(sdui_particles_t *ps) {
+    uint32_t v = ps->rng;
+    v ^= v << 13;
+    v ^= v >> 17;
+    v ^= v << 5;
+    return ps->rng = v;
+}
+
+/** 圆点精灵：覆盖率 = clamp(r + 0.5 - 距离, 0, 1)，边缘 1px 抗锯齿 */
+static void build_sprite(sdui_particles_t *ps) {
+    int r = ps->radius;
+    for (int j = 0; j < ps->dim; j++) {
+        for (int i = 0; i < ps->dim; i++) {
+            float d   = sqrtf((float)((i - r) * (i - r) + (j - r) * (j - r)));
+            float cov = (float)r + 0.5f - d;
+            cov = cov < 0.0f ? 0.0f : (cov > 1.0f ? 1.0f : cov);
+            ps->sprite[j * ps->dim + i] = (uint8_t)(cov * 255.0f + 0.5f);
+        }
+    }
+}
+
+static void spawn(sdui_particles_t *ps, int i) {
+    ps->x[i]     = ((int32_t)(rng_next(ps) % (2 * SPAWN_JITTER)) - SPAWN_JITTER) * 65536;
+    ps->y[i]     = ((int32_t)(rng_next(ps) % (2 * SPAWN_JITTER)) - SPAWN_JITTER) * 65536;
+    ps->vx[i]    = ((int32_t)(rng_next(ps) % 200) - 100) * (65536 / 80);
+    ps->vy[i]    = ((int32_t)(rng_next(ps) % 200) - 100) * (65536 / 80) - Q16(1.5);
+    ps->alpha[i] = 255;
+}
+
+static inline void rect_add(sdui_particles_rect_t *r, int x1, int y1, int x2, int y2) {
+    if (x1 < r->x1) r->x1 = (int16_t)x1;
+    if (y1 < r->y1) r->y1 = (int16_t)y1;
+    if (x2 > r->x2) r->x2 = (int16_t)x2;
+    if (y2 > r->y2) r->y2 = (int16_t)y2;
+}
+
+/* ======================================================
+ * 公共接口
+ * ====================================================== */
+sdui_particles_t *sdui_particles_create(int count, uint16_t *buf, int w, int h, uint16_t color, int radius) {
+    if (!buf || w <= 0 || h <= 0) return NULL;
+    if (count < 0) count = 0;
+    if (count > SDUI_PARTICLES_MAX) count = SDUI_PARTICLES_MAX;
+    if (radius < 1) radius = 1;
+    if (radius > SDUI_PARTICLE_R_MAX) radius = SDUI_PARTICLE_R_MAX;
+
+    /* 结构体与全部数组一次分配 */
+    size_t n    = (size_t)(count ? count : 1);
+    size_t size = sizeof(sdui_particles_t) + n * (4 * sizeof(int32_t) + 2 * sizeof(int16_t) + sizeof(uint8_t));
+    sdui_particles_t *ps = heap_caps_malloc(size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!ps) return NULL;
+    memset(ps, 0, sizeof(*ps));
+    ps->drawn = (sdui_particles_rect_t){ INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN };
+
+    uint8_t *p = (uint8_t *)(ps + 1);
+    ps->x       = (int32_t *)p; p += n * sizeof(int32_t);
+    ps->y       = (int32_t *)p; p += n * sizeof(int32_t);
+    ps->vx      = (int32_t *)p; p += n * sizeof(int32_t);
+    ps->vy      = (int32_t *)p; p += n * sizeof(int32_t);
+    ps->drawn_x = (int16_t *)p; p += n * sizeof(int16_t);
+    ps->drawn_y = (int16_t *)p; p += n * sizeof(int16_t);
+    ps->alpha   = p;
+
+    ps->count   = count;
+    ps->buf     = buf;
+    ps->w       = w;
+    ps->h       = h;
+    ps->color   = color;
+    ps->radius  = radius;
+    ps->dim     = 2 * radius + 1;
+    ps->rng     = 0x9E3779B9u ^ (uint32_t)(uintptr_t)ps;
+    build_sprite(ps);
+
+    memset(ps->alpha, 0, n);   /* 首帧全部重生 */
+    for (size_t i = 0; i < n; i++) ps->drawn_x[i] = NOT_DRAWN;
+    return ps;
+}
+
+void sdui_particles_destroy(sdui_particles_t *ps) {
+    heap_caps_free(ps);
+}
+
+bool sdui_particles_step(sdui_particles_t *ps, sdui_particles_rect_t *dirty) {
+    sdui_particles_rect_t r = { INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN };
+    const int dim = ps->dim, w = ps->w, h = ps->h;
+
+    /* ---- 1. 清除上一帧画过的区域：精灵重叠严重时整块清包围盒更省写带宽 ---- */
+    const sdui_particles_rect_t *pr = &ps->drawn;
+    if (pr->x1 <= pr->x2) {
+        uint32_t box = (uint32_t)(pr->x2 - pr->x1 + 1) * (uint32_t)(pr->y2 - pr->y1 + 1);
+        if (ps->drawn_px >= box) {
+            for (int y = pr->y1; y <= pr->y2; y++)
+                sdui_px_fill(ps->buf + y * w + pr->x1, 0, (size_t)(pr->x2 - pr->x1 + 1));
+        } else {
+            for (int i = 0; i < ps->count; i++) {
+                int sx = ps->drawn_x[i];
+                if (sx == NOT_DRAWN) continue;
+                int sy = ps->drawn_y[i];
+                int x0 = sx < 0 ? 0 : sx, x1 = sx + dim > w ? w : sx + dim;
+                int y0 = sy < 0 ? 0 : sy, y1 = sy + dim > h ? h : sy + dim;
+                for (int y = y0; y < y1; y++) sdui_px_fill(ps->buf + y * w + x0, 0, (size_t)(x1 - x0));
+            }
+        }
+        r = *pr;
+    }
+    sdui_particles_rect_t cur = { INT16_MAX, INT16_MAX, INT16_MIN, INT16_MIN };
+    uint32_t              cur_px = 0;
+
+    /* ---- 2. 物理更新 + 精灵混合 ---- */
+    const int cx = w / 2 - ps->radius, cy = h / 2 - ps->radius;
+    for (int i = 0; i < ps->count; i++) {
+        ps->drawn_x[i] = NOT_DRAWN;
+        if (ps->alpha[i] == 0) spawn(ps, i);
+        ps->x[i]  += ps->vx[i];
+        ps->y[i]  += ps->vy[i];
+        ps->vy[i] += GRAVITY_Q16;
+        uint8_t a = ps->alpha[i] > FADE_PER_FRAME ? ps->alpha[i] - FADE_PER_FRAME : 0;
+        ps->alpha[i] = a;
+        if (a == 0) continue;
+
+        int sx = cx + (ps->x[i] >> 16);
+        int sy = cy + (ps->y[i] >> 16);
+        int x0 = sx < 0 ? 0 : sx, x1 = sx + dim > w ? w : sx + dim;
+        int y0 = sy < 0 ? 0 : sy, y1 = sy + dim > h ? h : sy + dim;
+        if (x0 >= x1 || y0 >= y1) continue;
+
+        /* 精灵覆盖率 × 粒子 alpha */
+        for (int y = y0; y < y1; y++)
+            sdui_px_blend_mask(ps->buf + y * w + x0, ps->color,
+                               ps->sprite + (y - sy) * dim + (x0 - sx), a, (size_t)(x1 - x0));
+        rect_add(&cur, x0, y0, x1 - 1, y1 - 1);
+        cur_px += (uint32_t)((x1 - x0) * (y1 - y0));
+        ps->drawn_x[i] = (int16_t)sx;
+        ps->drawn_y[i] = (int16_t)sy;
+    }
+
+    ps->drawn    = cur;
+    ps->drawn_px = cur_px;
+    if (cur.x1 <= cur.x2) rect_add(&r, cur.x1, cur.y1, cur.x2, cur.y2);
+    if (dirty) *dirty = r;
+    return r.x1 <= r.x2;
+}
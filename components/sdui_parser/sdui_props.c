@@ -0,0 +1,147 @@
+/**
+ * @file sdui_props.c
+ * @brief SDUI 属性键 / 取值词完美哈希查找（槽位表由 gen_props.py 生成）
+ */
+#include "sdui_props.h"
+#include <string.h>
+
+#define TOK_NAME_(name, str) str,
+
+const char *const sdui_tok_names[SDUI_TOK_NUM] = {
+    "",
+    SDUI_PROP_KEYS(TOK_NAME_)
+    SDUI_PROP_WORDS(TOK_NAME_)
+};
+
+/* ---- 以下由 gen_props.py 生成，勿手改 ---- */
+#define TOK_HASH_MUL  0x9E48478Du
+#define TOK_SLOT_BITS 9
+
+static const uint8_t s_tok_slots[1u << TOK_SLOT_BITS] = {
+    [  1] = SDUI_TOK_SRC_REF,
+    [  5] = SDUI_TOK_MIN_OPA,
+    [  7] = SDUI_TOK_DIRECTION,
+    [ 13] = SDUI_TOK_FORMAT,
+    [ 18] = SDUI_TOK_Y,
+    [ 21] = SDUI_TOK_INDIC_COLOR,
+    [ 24] = SDUI_TOK_MAX_ITEMS,
+    [ 25] = SDUI_TOK_MARQUEE,
+    [ 32] = SDUI_TOK_BORDER_W,
+    [ 34] = SDUI_TOK_WRAP,
+    [ 39] = SDUI_TOK_DURATION,
+    [ 47] = SDUI_TOK_VALUE,
+    [ 49] = SDUI_TOK_COLOR_PULSE,
+    [ 59] = SDUI_TOK_SPACE_AROUND,
+    [ 63] = SDUI_TOK_ON_PRESS,
+    [ 64] = SDUI_TOK_COUNT,
+    [ 72] = SDUI_TOK_SHADOW_W,
+    [ 82] = SDUI_TOK_TOP_RIGHT,
+    [ 85] = SDUI_TOK_TYPE,
+    [100] = SDUI_TOK_TOP_MID,
+    [104] = SDUI_TOK_SPACE_BETWEEN,
+    [105] = SDUI_TOK_SCROLL_TO,
+    [107] = SDUI_TOK_H,
+    [109] = SDUI_TOK_END,
+    [112] = SDUI_TOK_FADE,
+    [124] = SDUI_TOK_REPEAT,
+    [125] = SDUI_TOK_MAX,
+    [126] = SDUI_TOK_ALIGN_ITEMS,
+    [129] = SDUI_TOK_IMG_W,
+    [134] = SDUI_TOK_LEFT_MID,
+    [138] = SDUI_TOK_BUTTON,
+    [142] = SDUI_TOK_RADIUS,
+    [144] = SDUI_TOK_CLASS,
+    [154] = SDUI_TOK_BG_COLOR,
+    [176] = SDUI_TOK_BORDER_COLOR,
+    [179] = SDUI_TOK_CCW,
+    [188] = SDUI_TOK_LIST,
+    [189] = SDUI_TOK_ID,
+    [197] = SDUI_TOK_ALIGN,
+    [198] = SDUI_TOK_GAP,
+    [214] = SDUI_TOK_ON_CHANGE,
+    [215] = SDUI_TOK_CONTENT,
+    [232] = SDUI_TOK_SLIDE_IN,
+    [236] = SDUI_TOK_ANIM,
+    [244] = SDUI_TOK_LEFT,
+    [247] = SDUI_TOK_CANVAS_H,
+    [249] = SDUI_TOK_HIDDEN,
+    [257] = SDUI_TOK_SCROLL,
+    [260] = SDUI_TOK_BAR,
+    [261] = SDUI_TOK_BG_OPA,
+    [264] = SDUI_TOK_PARTICLE_SIZE,
+    [265] = SDUI_TOK_BREATHE,
+    [269] = SDUI_TOK_SHADOW_COLOR,
+    [274] = SDUI_TOK_COLOR_A,
+    [281] = SDUI_TOK_SLIDER,
+    [283] = SDUI_TOK_BOTTOM_RIGHT,
+    [285] = SDUI_TOK_CHILDREN,
+    [287] = SDUI_TOK_FONT_SIZE,
+    [296] = SDUI_TOK_ITEMS,
+    [299] = SDUI_TOK_ON_CLICK,
+    [304] = SDUI_TOK_BOTTOM_LEFT,
+    [307] = SDUI_TOK_PAD,
+    [309] = SDUI_TOK_ROW,
+    [316] = SDUI_TOK_LABEL,
+    [322] = SDUI_TOK_AMPLITUDE,
+    [325] = SDUI_TOK_COLUMN_WRAP,
+    [335] = SDUI_TOK_START,
+    [338] = SDUI_TOK_COLUMN,
+    [340] = SDUI_TOK_TOP,
+    [350] = SDUI_TOK_SHAKE,
+    [356] = SDUI_TOK_CENTER,
+    [359] = SDUI_TOK_COLOR_B,
+    [360] = SDUI_TOK_TEXT_COLOR,
+    [361] = SDUI_TOK_BLINK,
+    [371] = SDUI_TOK_RIGHT_MID,
+    [372] = SDUI_TOK_ROW_CLASS,
+    [377] = SDUI_TOK_TEXT,
+    [379] = SDUI_TOK_TRIM,
+    [384] = SDUI_TOK_PARTICLE,
+    [388] = SDUI_TOK_X,
+    [389] = SDUI_TOK_FLEX,
+    [392] = SDUI_TOK_IMAGE,
+    [393] = SDUI_TOK_TRANSITION,
+    [396] = SDUI_TOK_OPA,
+    [397] = SDUI_TOK_NONE,
+    [403] = SDUI_TOK_SRC,
+    [405] = SDUI_TOK_MAX_OPA,
+    [414] = SDUI_TOK_LABEL_CLASS,
+    [415] = SDUI_TOK_CONTAINER,
+    [418] = SDUI_TOK_W,
+    [426] = SDUI_TOK_RIGHT,
+    [429] = SDUI_TOK_TOP_LEFT,
+    [430] = SDUI_TOK_SPACE_EVENLY,
+    [431] = SDUI_TOK_FROM,
+    [438] = SDUI_TOK_ON_RELEASE,
+    [440] = SDUI_TOK_FOLLOW,
+    [444] = SDUI_TOK_IMG_H,
+    [448] = SDUI_TOK_ROW_WRAP,
+    [454] = SDUI_TOK_APPEND,
+    [457] = SDUI_TOK_COLOR,
+    [458] = SDUI_TOK_JUSTIFY,
+    [463] = SDUI_TOK_FULL,
+    [474] = SDUI_TOK_SCROLLABLE,
+    [485] = SDUI_TOK_MIN,
+    [486] = SDUI_TOK_LONG_MODE,
+    [490] = SDUI_TOK_BOTTOM_MID,
+    [491] = SDUI_TOK_DOT,
+    [498] = SDUI_TOK_CANVAS_W,
+    [503] = SDUI_TOK_RECONCILE,
+    [506] = SDUI_TOK_SPIN,
+};
+/* ---- 生成结束 ---- */
+
+sdui_tok_t sdui_tok_lookup(const char *s) {
+    if (!s) return SDUI_TOK_UNKNOWN;
+    uint32_t    h = 2166136261u;   /* FNV-1a，与 gen_props.py 相同 */
+    const char *p = s;
+    while (*p) { h ^= (uint8_t)*p++; h *= 16777619u; }
+    sdui_tok_t t = (sdui_tok_t)s_tok_slots[(h * TOK_HASH_MUL) >> (32 - TOK_SLOT_BITS)];
+    return (t && !strcmp(sdui_tok_names[t], s)) ? t : SDUI_TOK_UNKNOWN;
+}
+
+bool sdui_tok_selftest(void) {
+    for (int t = 1; t < SDUI_TOK_NUM; t++)
+        if (sdui_tok_lookup(sdui_tok_names[t]) != (sdui_tok_t)t) return false;
+    return true;
+}
@@ -0,0 +1,566 @@
+/**
+ * @file sdui_state.c
+ * @brief SDUI 状态变量与属性绑定实现
+ *
+ * 每个变量挂一条引用链（双向循环链表，哨兵在变量内），链上节点嵌在绑定里，
+ * 解除绑定 O(1) 摘链。state/set 只改变量值并挂入脏链，刷新定时器在下一次
+ * lv_timer_handler 中沿脏变量的引用链收集绑定（去重）后逐个渲染。
+ * 绑定通过 LV_EVENT_DELETE 回调挂在对象上，对象删除时随之释放。
+ *
+ * 速率描述也是变量：state/set 的具名变量，或组件属性上直接写的描述（绑定私有的
+ * 匿名变量）。推进中的变量挂在推进链上，推进定时器按显示刷新周期计算当前值，
+ * 只有格式化后的文本变化时才置脏重绘，到达终点后摘链，链空时定时器暂停。
+ */
+#include "sdui_state.h"
+#include "esp_log.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+#include <inttypes.h>
+
+static const char *TAG = "SDUI_STATE";
+
+#define STATE_RENDER_MAX  256   /* 单个模板渲染结果上限（含结尾 0），超出截断 */
+
+struct state_bind;
+
+/** 引用链节点：变量 → 绑定 */
+typedef struct bind_ref {
+    struct bind_ref   *prev, *next;
+    struct state_bind *bind;
+} bind_ref_t;
+
+typedef enum {
+    RATE_FMT_INT = 0,   /* 整数（向下取整） */
+    RATE_FMT_TIME,      /* 秒数显示为 m:ss / h:mm:ss */
+} rate_fmt_t;
+
+/** 速率描述：值从 base 起每秒推进 rate，到达 until 停止 */
+typedef struct {
+    double  base;
+    double  rate;
+    double  until;   /* 无终点时为 NAN */
+    int64_t t0_us;   /* 描述生效时刻 */
+    uint8_t fmt;     /* rate_fmt_t */
+} state_rate_t;
+
+typedef struct state_var {
+    uint32_t          hash;
+    bool              dirty;
+    bool              ticking;
+    bool              parked;       /* 速率未到终点但无人引用：不推进，被引用时按当前时刻补算 */
+    struct state_var *dirty_next;   /* 脏链 */
+    struct state_var *tick_next;    /* 推进链 */
+    char             *value;        /* PSRAM，未设置时为 NULL */
+    state_rate_t      rate;         /* ticking 时有效 */
+    bind_ref_t        refs;         /* 引用链哨兵 */
+    char              name[SDUI_STATE_NAME_MAX];   /* 绑定私有的匿名变量为空串 */
+} state_var_t;
+
+typedef struct state_bind {
+    lv_obj_t          *obj;
+    struct state_bind *next_dirty;   /* 刷新时的待渲染链 */
+    state_var_t       *own;          /* 属性上直接写的速率描述：私有变量，值即渲染结果 */
+    uint8_t            prop;         /* sdui_bind_prop_t */
+    uint8_t            nrefs;
+    bool               queued;
+    bind_ref_t         refs[SDUI_STATE_BIND_REFS];
+    char               tmpl[];
+} state_bind_t;
+
+static state_var_t **s_vars        = NULL;   /* PSRAM，按需扩容；不含私有变量 */
+static uint16_t      s_var_count   = 0;
+static uint16_t      s_var_cap     = 0;
+static uint32_t      s_bind_count  = 0;
+static state_var_t  *s_dirty       = NULL;
+static state_var_t  *s_ticking     = NULL;
+static lv_timer_t   *s_flush_timer = NULL;
+static lv_timer_t   *s_tick_timer  = NULL;
+
+static void bind_delete_cb(lv_event_t *e);
+
+/* ======================================================
+ * 变量表
+ * ====================================================== */
+static bool name_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+           c == '_' || c == '.' || c == '-';
+}
+
+static uint32_t name_hash(const char *s, size_t len) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) { h ^= (uint8_t)s[i]; h *= 16777619u; }
+    return h;
+}
+
+/**
+ * 从 s 起找下一个变量引用 {name}
+ * @return 引用起点 '{'，name / len 为变量名；没有更多引用时返回 NULL
+ */
+static const char *next_ref(const char *s, const char **name, size_t *len) {
+    for (s = strchr(s, '{'); s; s = strchr(s + 1, '{')) {
+        size_t n = 0;
+        while (name_char(s[1 + n])) n++;
+        if (n > 0 && n < SDUI_STATE_NAME_MAX && s[1 + n] == '}') {
+            *name = s + 1;
+            *len  = n;
+            return s;
+        }
+    }
+    return NULL;
+}
+
+static state_var_t *var_new(void) {
+    state_var_t *v = heap_caps_calloc(1, sizeof(*v), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (v) v->refs.prev = v->refs.next = &v->refs;
+    return v;
+}
+
+static state_var_t *var_find(const char *name, size_t len) {
+    uint32_t h = name_hash(name, len);
+    for (uint16_t i = 0; i < s_var_count; i++) {
+        state_var_t *v = s_vars[i];
+        if (v->hash == h && !strncmp(v->name, name, len) && v->name[len] == '\0') return v;
+    }
+    return NULL;
+}
+
+/** 查找变量，不存在时创建（未设置值）；达到上限或内存不足返回 NULL */
+static state_var_t *var_get(const char *name, size_t len) {
+    state_var_t *v = var_find(name, len);
+    if (v) return v;
+    if (len == 0 || len >= SDUI_STATE_NAME_MAX || s_var_count == SDUI_STATE_VARS_MAX) return NULL;
+
+    if (s_var_count == s_var_cap) {
+        uint16_t cap = s_var_cap ? s_var_cap * 2 : 16;
+        state_var_t **nv = heap_caps_realloc(s_vars, cap * sizeof(*nv), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!nv) return NULL;
+        s_vars    = nv;
+        s_var_cap = cap;
+    }
+    v = var_new();
+    if (!v) return NULL;
+    memcpy(v->name, name, len);
+    v->hash = name_hash(name, len);
+    s_vars[s_var_count++] = v;
+    return v;
+}
+
+/** 写入新值；与当前值相同时返回 false */
+static bool var_store(state_var_t *v, const char *s) {
+    if (v->value && !strcmp(v->value, s)) return false;
+    size_t n = strnlen(s, SDUI_STATE_VALUE_MAX - 1);
+    if (!v->value) {
+        v->value = heap_caps_malloc(SDUI_STATE_VALUE_MAX, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+        if (!v->value) return false;
+    }
+    memcpy(v->value, s, n);
+    v->value[n] = '\0';
+    return true;
+}
+
+static void var_mark_dirty(state_var_t *v) {
+    if (v->dirty) return;
+    v->dirty      = true;
+    v->dirty_next = s_dirty;
+    s_dirty       = v;
+}
+
+static void dirty_remove(state_var_t *v) {
+    if (!v->dirty) return;
+    v->dirty = false;
+    for (state_var_t **pp = &s_dirty; *pp; pp = &(*pp)->dirty_next) {
+        if (*pp == v) { *pp = v->dirty_next; return; }
+    }
+}
+
+static void var_stop_ticking(state_var_t *v) {
+    v->parked = false;
+    if (!v->ticking) return;
+    v->ticking = false;
+    for (state_var_t **pp = &s_ticking; *pp; pp = &(*pp)->tick_next) {
+        if (*pp == v) { *pp = v->tick_next; return; }
+    }
+}
+
+/* ======================================================
+ * 速率描述
+ * ====================================================== */
+
+/** 解析 {"value", "rate" | "duration", "until", "format"}；value 缺失或不是数字时返回 false */
+static bool rate_parse(const cJSON *d, state_rate_t *r) {
+    const cJSON *v   = cJSON_GetObjectItemCaseSensitive(d, "value");
+    const cJSON *rt  = cJSON_GetObjectItemCaseSensitive(d, "rate");
+    const cJSON *un  = cJSON_GetObjectItemCaseSensitive(d, "until");
+    const cJSON *dur = cJSON_GetObjectItemCaseSensitive(d, "duration");
+    const cJSON *fmt = cJSON_GetObjectItemCaseSensitive(d, "format");
+    if (!cJSON_IsNumber(v)) return false;
+
+    r->base  = v->valuedouble;
+    r->until = cJSON_IsNumber(un) ? un->valuedouble : NAN;
+    r->rate  = cJSON_IsNumber(rt) ? rt->valuedouble : 0;
+    /* duration (ms)：在该时长内线性到达 until，换算为速率 */
+    if (!cJSON_IsNumber(rt) && cJSON_IsNumber(dur) && dur->valuedouble > 0 && !isnan(r->until))
+        r->rate = (r->until - r->base) * 1000.0 / dur->valuedouble;
+    r->fmt   = (cJSON_IsString(fmt) && !strcmp(fmt->valuestring, "time")) ? RATE_FMT_TIME : RATE_FMT_INT;
+    r->t0_us = esp_timer_get_time();
+    return true;
+}
+
+/** 按时刻 now 计算值并格式化；到达终点（或速率为 0）时返回 true */
+static bool rate_eval(const state_rate_t *r, int64_t now, char *out, size_t cap) {
+    double x    = r->base + r->rate * (double)(now - r->t0_us) / 1e6;
+    bool   done = r->rate == 0;
+    if (!isnan(r->until) && ((r->rate > 0 && x >= r->until) || (r->rate < 0 && x <= r->until))) {
+        x    = r->until;
+        done = true;
+    }
+    double f = floor(x);
+    if (f > INT32_MAX) f = INT32_MAX;
+    if (f < INT32_MIN) f = INT32_MIN;
+    int32_t n = (int32_t)f;
+    if (r->fmt == RATE_FMT_TIME) {
+        if (n < 0) n = 0;
+        if (n >= 3600) snprintf(out, cap, "%" PRId32 ":%02" PRId32 ":%02" PRId32, n / 3600, n / 60 % 60, n % 60);
+        else           snprintf(out, cap, "%" PRId32 ":%02" PRId32, n / 60, n % 60);
+    } else {
+        snprintf(out, cap, "%" PRId32, n);
+    }
+    return done;
+}
+
+/** 推进一个变量：文本变化时置脏；返回是否已到达终点 */
+static bool var_tick(state_var_t *v, int64_t now) {
+    char buf[24];
+    bool done = rate_eval(&v->rate, now, buf, sizeof(buf));
+    if (var_store(v, buf)) var_mark_dirty(v);
+    return done;
+}
+
+static bool var_unreferenced(const state_var_t *v) {
+    return v->refs.next == &v->refs;
+}
+
+/** 算出 now 时刻的值；未到终点且有引用时挂入推进链，无引用时暂停 */
+static void var_advance(state_var_t *v, int64_t now) {
+    if (var_tick(v, now)) {
+        var_stop_ticking(v);
+        return;
+    }
+    if (var_unreferenced(v)) {
+        var_stop_ticking(v);
+        v->parked = true;
+        return;
+    }
+    v->parked = false;
+    if (!v->ticking) {
+        v->ticking   = true;
+        v->tick_next = s_ticking;
+        s_ticking    = v;
+    }
+    if (s_tick_timer) lv_timer_resume(s_tick_timer);
+}
+
+/** 按描述开始推进变量：立即算出起点值 */
+static void var_set_rate(state_var_t *v, const state_rate_t *r) {
+    v->rate = *r;
+    var_advance(v, r->t0_us);
+}
+
+/* ======================================================
+ * 绑定
+ * ====================================================== */
+static size_t render(const char *tmpl, char *out, size_t cap) {
+    size_t      o = 0;
+    const char *s = tmpl, *name, *ref;
+    size_t      len;
+    while ((ref = next_ref(s, &name, &len)) != NULL) {
+        size_t n = (size_t)(ref - s);
+        if (n > cap - 1 - o) n = cap - 1 - o;
+        memcpy(out + o, s, n);
+        o += n;
+        state_var_t *v = var_find(name, len);
+        if (v && v->value) {
+            n = strlen(v->value);
+            if (n > cap - 1 - o) n = cap - 1 - o;
+            memcpy(out + o, v->value, n);
+            o += n;
+        }
+        s = name + len + 1;
+    }
+    size_t n = strlen(s);
+    if (n > cap - 1 - o) n = cap - 1 - o;
+    memcpy(out + o, s, n);
+    o += n;
+    out[o] = '\0';
+    return o;
+}
+
+/** 把渲染结果写到属性上 */
+static void prop_apply(lv_obj_t *obj, uint8_t prop, const char *s, lv_anim_enable_t anim) {
+    if (prop == SDUI_BIND_TEXT) {
+        lv_label_set_text(obj, s);
+        return;
+    }
+    int32_t v = (int32_t)lround(strtod(s, NULL));
+    if      (lv_obj_has_class(obj, &lv_slider_class)) lv_slider_set_value(obj, v, anim);
+    else if (lv_obj_has_class(obj, &lv_bar_class))    lv_bar_set_value(obj, v, anim);
+}
+
+static void bind_apply(const state_bind_t *b, lv_anim_enable_t anim) {
+    if (b->own) {
+        prop_apply(b->obj, b->prop, b->own->value ? b->own->value : "", anim);
+        return;
+    }
+    char buf[STATE_RENDER_MAX];
+    render(b->tmpl, buf, sizeof(buf));
+    prop_apply(b->obj, b->prop, buf, anim);
+}
+
+static void ref_link(state_bind_t *b, state_var_t *v) {
+    bind_ref_t *r = &b->refs[b->nrefs++];
+    r->bind       = b;
+    r->prev       = v->refs.prev;
+    r->next       = &v->refs;
+    v->refs.prev->next = r;
+    v->refs.prev       = r;
+    if (v->parked) var_advance(v, esp_timer_get_time());
+}
+
+static void bind_free(state_bind_t *b) {
+    for (uint8_t i = 0; i < b->nrefs; i++) {
+        bind_ref_t *r = &b->refs[i];
+        r->prev->next = r->next;
+        r->next->prev = r->prev;
+    }
+    if (b->own) {
+        var_stop_ticking(b->own);
+        dirty_remove(b->own);
+        heap_caps_free(b->own->value);
+        heap_caps_free(b->own);
+    }
+    heap_caps_free(b);
+    s_bind_count--;
+}
+
+static void bind_delete_cb(lv_event_t *e) {
+    bind_free(lv_event_get_user_data(e));
+}
+
+static state_bind_t *bind_find(lv_obj_t *obj, sdui_bind_prop_t prop) {
+    uint32_t n = lv_obj_get_event_count(obj);
+    for (uint32_t i = 0; i < n; i++) {
+        lv_event_dsc_t *dsc = lv_obj_get_event_dsc(obj, i);
+        if (lv_event_dsc_get_cb(dsc) != bind_delete_cb) continue;
+        state_bind_t *b = lv_event_dsc_get_user_data(dsc);
+        if (b->prop == prop) return b;
+    }
+    return NULL;
+}
+
+static void bind_attach(state_bind_t *b, lv_obj_t *obj, sdui_bind_prop_t prop) {
+    b->obj  = obj;
+    b->prop = (uint8_t)prop;
+    s_bind_count++;
+    lv_obj_add_event_cb(obj, bind_delete_cb, LV_EVENT_DELETE, b);
+}
+
+bool sdui_state_is_template(const char *s) {
+    const char *name;
+    size_t      len;
+    return s && next_ref(s, &name, &len) != NULL;
+}
+
+void sdui_state_unbind(lv_obj_t *obj, sdui_bind_prop_t prop) {
+    if (!s_bind_count || !obj) return;
+    state_bind_t *b = bind_find(obj, prop);
+    if (!b) return;
+    lv_obj_remove_event_cb_with_user_data(obj, bind_delete_cb, b);
+    bind_free(b);
+}
+
+void sdui_state_bind(lv_obj_t *obj, sdui_bind_prop_t prop, const char *tmpl) {
+    if (!obj || !tmpl) return;
+    sdui_state_unbind(obj, prop);
+
+    size_t        n = strlen(tmpl) + 1;
+    state_bind_t *b = heap_caps_calloc(1, sizeof(*b) + n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (!b) {
+        char buf[STATE_RENDER_MAX];
+        render(tmpl, buf, sizeof(buf));
+        prop_apply(obj, prop, buf, LV_ANIM_OFF);
+        ESP_LOGW(TAG, "bind: alloc failed, '%s' will not update", tmpl);
+        return;
+    }
+    memcpy(b->tmpl, tmpl, n);
+
+    const char *s = b->tmpl, *name, *ref;
+    size_t      len;
+    while (b->nrefs < SDUI_STATE_BIND_REFS && (ref = next_ref(s, &name, &len)) != NULL) {
+        s = name + len + 1;
+        state_var_t *v = var_get(name, len);
+        if (!v) { ESP_LOGW(TAG, "bind: too many variables, '%.*s' ignored", (int)len, name); continue; }
+        ref_link(b, v);
+    }
+    bind_attach(b, obj, prop);
+    bind_apply(b, LV_ANIM_OFF);
+}
+
+bool sdui_state_bind_rate(lv_obj_t *obj, sdui_bind_prop_t prop, const cJSON *desc) {
+    state_rate_t r;
+    if (!obj || !cJSON_IsObject(desc) || !rate_parse(desc, &r)) {
+        ESP_LOGW(TAG, "rate: descriptor needs a numeric 'value'");
+        return false;
+    }
+    sdui_state_unbind(obj, prop);
+
+    state_bind_t *b = heap_caps_calloc(1, sizeof(*b) + 1, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    state_var_t  *v = b ? var_new() : NULL;
+    if (!v) {
+        char buf[24];
+        rate_eval(&r, r.t0_us, buf, sizeof(buf));
+        prop_apply(obj, prop, buf, LV_ANIM_OFF);
+        ESP_LOGW(TAG, "rate: alloc failed, value will not advance");
+        heap_caps_free(b);
+        return true;
+    }
+    b->own = v;
+    ref_link(b, v);
+    bind_attach(b, obj, prop);
+    var_set_rate(v, &r);
+    dirty_remove(v);   /* 首个值当场写入，不等刷新 */
+    bind_apply(b, LV_ANIM_OFF);
+    return true;
+}
+
+/* ======================================================
+ * 合并刷新与推进
+ * ====================================================== */
+
+/** 收集脏变量引用的绑定（同一绑定只渲染一次）并重新渲染 */
+static uint32_t flush_dirty(lv_anim_enable_t anim) {
+    state_bind_t *list = NULL;
+    while (s_dirty) {
+        state_var_t *v = s_dirty;
+        s_dirty  = v->dirty_next;
+        v->dirty = false;
+        for (bind_ref_t *r = v->refs.next; r != &v->refs; r = r->next) {
+            state_bind_t *b = r->bind;
+            if (b->queued) continue;
+            b->queued     = true;
+            b->next_dirty = list;
+            list          = b;
+        }
+    }
+    uint32_t n = 0;
+    for (state_bind_t *b = list; b; b = b->next_dirty, n++) {
+        b->queued = false;
+        bind_apply(b, anim);
+    }
+    return n;
+}
+
+void sdui_state_flush(void) {
+    if (s_flush_timer) lv_timer_pause(s_flush_timer);
+    int64_t  t0 = esp_timer_get_time();
+    uint32_t n  = flush_dirty(LV_ANIM_ON);
+    ESP_LOGD(TAG, "re-rendered %" PRIu32 " bindings in %" PRId64 " us", n, esp_timer_get_time() - t0);
+}
+
+static void state_flush_cb(lv_timer_t *t) {
+    sdui_state_flush();
+}
+
+/** 按显示刷新周期推进速率变量：值未变的不重绘，推进值不做过渡动画 */
+static void state_tick_cb(lv_timer_t *t) {
+    int64_t now = esp_timer_get_time();
+    for (state_var_t **pp = &s_ticking; *pp;) {
+        state_var_t *v = *pp;
+        if (var_unreferenced(v)) {
+            v->ticking = false;
+            v->parked  = true;
+            *pp        = v->tick_next;
+        } else if (var_tick(v, now)) {
+            v->ticking = false;
+            *pp        = v->tick_next;
+        } else {
+            pp = &v->tick_next;
+        }
+    }
+    if (!s_ticking) lv_timer_pause(t);
+    if (s_dirty) flush_dirty(LV_ANIM_OFF);
+}
+
+void sdui_state_init(void) {
+    if (s_flush_timer) return;
+    s_flush_timer = lv_timer_create(state_flush_cb, 0, NULL);
+    lv_timer_pause(s_flush_timer);
+    s_tick_timer = lv_timer_create(state_tick_cb, LV_DEF_REFR_PERIOD, NULL);
+    lv_timer_pause(s_tick_timer);
+}
+
+/** 应用一个 {"名": 值} 对象，返回改变的变量数 */
+static int state_set_obj(const cJSON *obj) {
+    int    changed = 0;
+    cJSON *item    = NULL;
+    cJSON_ArrayForEach(item, obj) {
+        char         num[24];
+        const char  *s = NULL;
+        state_rate_t r;
+        if      (cJSON_IsString(item)) s = item->valuestring;
+        else if (cJSON_IsBool(item))   s = cJSON_IsTrue(item) ? "true" : "false";
+        else if (cJSON_IsNull(item))   s = "";
+        else if (cJSON_IsNumber(item)) {
+            double d = item->valuedouble;
+            if (d >= INT32_MIN && d <= INT32_MAX && d == (double)(int32_t)d)
+                snprintf(num, sizeof(num), "%" PRId32, (int32_t)d);
+            else
+                snprintf(num, sizeof(num), "%.6g", d);
+            s = num;
+        } else if (!cJSON_IsObject(item) || !rate_parse(item, &r)) {
+            ESP_LOGW(TAG, "state/set: '%s' must be a scalar or a rate descriptor", item->string);
+            continue;
+        }
+        state_var_t *v = var_get(item->string, strlen(item->string));
+        if (!v) { ESP_LOGW(TAG, "state/set: cannot store '%s'", item->string); continue; }
+        if (!s) {
+            var_set_rate(v, &r);   /* 校正：新的起点与速率 */
+            changed++;
+            continue;
+        }
+        var_stop_ticking(v);
+        if (!var_store(v, s)) continue;
+        var_mark_dirty(v);
+        changed++;
+    }
+    return changed;
+}
+
+int sdui_state_set(const char *json_str) {
+    cJSON *root = json_str ? cJSON_Parse(json_str) : NULL;
+    if (!root || !(cJSON_IsObject(root) || cJSON_IsArray(root))) {
+        ESP_LOGW(TAG, "state/set: expected a JSON object");
+        cJSON_Delete(root);
+        return -1;
+    }
+
+    /* 总线通道满时相邻的几条合成数组批次，按序应用，同名变量以最后一个为准 */
+    int changed = 0;
+    if (cJSON_IsArray(root)) {
+        cJSON *obj = NULL;
+        cJSON_ArrayForEach(obj, root) {
+            if (cJSON_IsObject(obj)) changed += state_set_obj(obj);
+            else ESP_LOGW(TAG, "state/set: batch items must be objects");
+        }
+    } else {
+        changed = state_set_obj(root);
+    }
+    cJSON_Delete(root);
+
+    if (s_dirty && s_flush_timer) lv_timer_resume(s_flush_timer);
+    return changed;
+}
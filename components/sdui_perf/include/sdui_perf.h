@@ -0,0 +1,162 @@
+/**
+ * @file sdui_perf.h
+ * @brief SDUI 渲染流水线分段计时
+ *
+ * 一条下行消息从第一个 WebSocket 分片到上屏，沿途各模块在阶段边界打点：
+ *
+ *   RX        首个分片到达（websocket_manager）
+ *   RX_DONE   分片重组完成
+ *   ROUTED    信封拆解完成，进入订阅回调（sdui_bus）
+ *   PARSED    payload 解析为 DOM（sdui_parser，锁外）
+ *   PREPARED  图片解码完成，预处理结束
+ *   LOCKED    取得 LVGL 锁、任务登记 / 更新开始
+ *   BUILT     组件创建 / 对比 / 属性更新完成（分片构建时为最后一片）
+ *   REFR      之后第一次刷新开始
+ *   RENDER    LVGL 布局完成、开始绘制
+ *   FLUSHED   绘制与刷屏完成，画面已到面板
+ *
+ * 记录以本地序号为键，信封中带 "seq" / "ts" 时一并保存并原样回传，
+ * 服务端据此把发送时刻与上屏时刻对应起来。只有到达 BUILT 的消息
+ * （ui/layout、ui/update）会在上屏后发布；其余消息路由结束即回收。
+ *
+ * 打点只有一次时间戳读取加一个临界区，CONFIG_SDUI_PERF 关闭时全部为空操作。
+ */
+#ifndef SDUI_PERF_H
+#define SDUI_PERF_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "sdkconfig.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 打点阶段（按流水线顺序） */
+typedef enum {
+    SDUI_PERF_RX = 0,
+    SDUI_PERF_RX_DONE,
+    SDUI_PERF_ROUTED,
+    SDUI_PERF_PARSED,
+    SDUI_PERF_PREPARED,
+    SDUI_PERF_LOCKED,
+    SDUI_PERF_BUILT,
+    SDUI_PERF_REFR,
+    SDUI_PERF_RENDER,
+    SDUI_PERF_FLUSHED,
+    SDUI_PERF_STAGE_COUNT,
+} sdui_perf_stage_t;
+
+/**
+ * 分段：第 i 段为阶段 i 到阶段 i + 1（缺失的阶段计入下一段），
+ * 最后一项为 RX → FLUSHED 总耗时
+ */
+#define SDUI_PERF_PHASE_COUNT   SDUI_PERF_STAGE_COUNT
+#define SDUI_PERF_PHASE_TOTAL   (SDUI_PERF_PHASE_COUNT - 1)
+
+/** 直方图桶：上界 0.5, 1, 2, … 512 ms，最后一桶为 ≥ 512 ms */
+#define SDUI_PERF_HIST_BUCKETS  12
+#define SDUI_PERF_HIST_WINDOW   64    /* 滚动窗口：最近上屏的记录数 */
+
+/** 最近 SDUI_PERF_HIST_WINDOW 条上屏记录的分段直方图 */
+typedef struct {
+    uint32_t published;   /**< 已上屏并发布的记录总数 */
+    uint32_t lost;        /**< 上屏前被挤出记录表的消息数 */
+    uint16_t window;      /**< 直方图中的记录数 */
+    uint8_t  count[SDUI_PERF_PHASE_COUNT][SDUI_PERF_HIST_BUCKETS];
+} sdui_perf_hist_t;
+
+/** 上屏记录的发布回调：json 为 perf/render 的 payload，在计时模块的后台任务中调用 */
+typedef void (*sdui_perf_sink_t)(const char *json);
+
+#if CONFIG_SDUI_PERF
+
+/**
+ * @brief 挂载显示器刷新事件并创建发布任务（须在显示启动后、LVGL 锁内调用）
+ */
+void sdui_perf_init(void);
+
+/** @brief 设置上屏记录的发布回调（通常转发为上行 perf/render） */
+void sdui_perf_set_sink(sdui_perf_sink_t sink);
+
+/**
+ * @brief 一条下行消息的首个分片到达：新建记录并打 RX
+ *
+ * 调用任务成为接收任务，之后 sdui_perf_routed / sdui_perf_claim 作用于这条记录，
+ * 直到 sdui_perf_end 或 sdui_perf_detach。
+ */
+void sdui_perf_begin(void);
+
+/** @brief 在接收任务当前记录上打点（RX_DONE 等） */
+void sdui_perf_mark_current(sdui_perf_stage_t stage);
+
+/**
+ * @brief 信封拆解完成：记下主题、载荷大小与服务端 seq / ts，打 ROUTED
+ * @param seq 信封中的 "seq"，没有时传负数
+ * @param ts  信封中的 "ts"（服务端发送时刻，原样回传），没有时传 0
+ */
+void sdui_perf_routed(const char *topic, size_t topic_len, size_t bytes, int64_t seq, double ts);
+
+/** @brief 路由结束：当前记录若未被认领则回收 */
+void sdui_perf_end(void);
+
+/**
+ * @brief 把接收任务的当前记录交给另一个任务继续路由（总线异步分发）
+ *
+ * 记录转为排队状态，接收任务之后的 sdui_perf_end 不再回收它。
+ * 消息被丢弃时以 sdui_perf_drop 回收。
+ *
+ * @return 记录键；没有记录时返回 0
+ */
+uint32_t sdui_perf_detach(void);
+
+/**
+ * @brief 在调用任务上接手 sdui_perf_detach 交出的记录
+ *
+ * 调用任务成为这条记录的接收任务，之后的 sdui_perf_routed / sdui_perf_claim /
+ * sdui_perf_end 作用于它；记录已被挤出时本次路由不计时。
+ */
+void sdui_perf_adopt(uint32_t id);
+
+/**
+ * @brief 在接收任务中认领当前记录，使其跟踪到上屏
+ * @return 记录键；不在接收任务中或没有记录时返回 0（之后的打点为空操作）
+ */
+uint32_t sdui_perf_claim(void);
+
+/** @brief 在指定记录上打点；打 BUILT 后记录等待下一次刷新上屏 */
+void sdui_perf_mark(uint32_t id, sdui_perf_stage_t stage);
+
+/** @brief 放弃已认领的记录（布局被取代、更新被推迟等） */
+void sdui_perf_drop(uint32_t id);
+
+/** @brief 读取滚动直方图（无需加锁） */
+void sdui_perf_get_hist(sdui_perf_hist_t *out);
+
+/** @brief 分段名（perf/render 与遥测中的键名） */
+const char *sdui_perf_phase_name(int phase);
+
+#else
+
+static inline void     sdui_perf_init(void) {}
+static inline void     sdui_perf_set_sink(sdui_perf_sink_t sink) { (void)sink; }
+static inline void     sdui_perf_begin(void) {}
+static inline void     sdui_perf_mark_current(sdui_perf_stage_t stage) { (void)stage; }
+static inline void     sdui_perf_routed(const char *topic, size_t topic_len, size_t bytes, int64_t seq, double ts) {
+    (void)topic; (void)topic_len; (void)bytes; (void)seq; (void)ts;
+}
+static inline void     sdui_perf_end(void) {}
+static inline uint32_t sdui_perf_detach(void) { return 0; }
+static inline void     sdui_perf_adopt(uint32_t id) { (void)id; }
+static inline uint32_t sdui_perf_claim(void) { return 0; }
+static inline void     sdui_perf_mark(uint32_t id, sdui_perf_stage_t stage) { (void)id; (void)stage; }
+static inline void     sdui_perf_drop(uint32_t id) { (void)id; }
+
+#endif /* CONFIG_SDUI_PERF */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SDUI_PERF_H */
@@ -0,0 +1,396 @@
+/**
+ * @file sdui_perf.c
+ * @brief SDUI 渲染流水线分段计时实现
+ *
+ * 记录表只有 PERF_SLOTS 条，打点在 WebSocket 事件任务（接收、路由）、总线分发通道
+ * （路由、预处理）与 LVGL 任务（构建、刷新）之间交错，以自旋锁保护；直方图只在 LVGL
+ * 任务中更新。每个路由任务各有一条当前记录，异步分发时记录随消息从接收任务交给通道任务。
+ * 上屏的记录经队列交给低优先级任务序列化并发布，打点方从不等待网络。
+ */
+#include "sdui_perf.h"
+
+#if CONFIG_SDUI_PERF
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/idf_additions.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "esp_log.h"
+#include "lvgl.h"
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+static const char *TAG = "SDUI_PERF";
+
+#define PERF_SLOTS      8     /* 同时在途的消息数（含等待上屏的布局） */
+#define PERF_QUEUE_LEN  4
+#define PERF_TOPIC_MAX  24
+#define PERF_JSON_MAX   512
+#define PERF_CUR_TASKS  4     /* 同时路由消息的任务：WebSocket 接收任务 + 总线分发通道 */
+
+enum { REC_FREE = 0, REC_OPEN, REC_QUEUED, REC_CLAIMED, REC_FRAME, REC_DONE };
+
+typedef struct {
+    uint32_t id;
+    uint8_t  state;
+    uint16_t mask;                          /* 已打点的阶段 */
+    char     topic[PERF_TOPIC_MAX];
+    uint32_t bytes;
+    int64_t  seq;                           /* 服务端 seq，< 0 为无 */
+    double   ts;                            /* 服务端发送时刻，0 为无 */
+    int64_t  t[SDUI_PERF_STAGE_COUNT];      /* esp_timer 时间戳 (μs) */
+} perf_rec_t;
+
+static const char *const s_phase_names[SDUI_PERF_PHASE_COUNT] = {
+    "rx", "route", "parse", "prepare", "lock", "build", "wait", "layout", "render", "total",
+};
+
+static portMUX_TYPE      s_mux      = portMUX_INITIALIZER_UNLOCKED;
+static perf_rec_t        s_recs[PERF_SLOTS];
+static uint32_t          s_next_id  = 1;
+static struct {
+    TaskHandle_t task;
+    uint32_t     id;
+}                        s_cur[PERF_CUR_TASKS];   /* 各路由任务正在路由的记录，id 为 0 的项空闲 */
+static QueueHandle_t     s_queue    = NULL;
+static sdui_perf_sink_t  s_sink     = NULL;
+
+/* 滚动直方图（LVGL 任务内更新） */
+static sdui_perf_hist_t  s_hist;
+static uint8_t           s_win[SDUI_PERF_HIST_WINDOW][SDUI_PERF_PHASE_COUNT];   /* 各记录的桶号，0xFF 为缺失 */
+static uint16_t          s_win_pos;
+static bool              s_rendered;
+
+/* ======================================================
+ * 记录表（调用者持有 s_mux）
+ * ====================================================== */
+static perf_rec_t *rec_find(uint32_t id) {
+    if (!id) return NULL;
+    for (int i = 0; i < PERF_SLOTS; i++) {
+        if (s_recs[i].id == id && s_recs[i].state != REC_FREE) return &s_recs[i];
+    }
+    return NULL;
+}
+
+/** 调用任务的当前记录键，没有时为 0 */
+static uint32_t cur_get(void) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < PERF_CUR_TASKS; i++) {
+        if (s_cur[i].id && s_cur[i].task == self) return s_cur[i].id;
+    }
+    return 0;
+}
+
+/** 设置调用任务的当前记录（0 为清除）；路由任务超过 PERF_CUR_TASKS 时不跟踪 */
+static void cur_set(uint32_t id) {
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    int          slot = -1;
+    for (int i = 0; i < PERF_CUR_TASKS; i++) {
+        if (s_cur[i].id && s_cur[i].task == self) {
+            slot = i;
+            break;
+        }
+        if (!s_cur[i].id && slot < 0) slot = i;
+    }
+    if (slot < 0) return;
+    s_cur[slot].task = self;
+    s_cur[slot].id   = id;
+}
+
+/** 记录是否正被某个任务路由 */
+static bool cur_holds(uint32_t id) {
+    for (int i = 0; i < PERF_CUR_TASKS; i++) {
+        if (s_cur[i].id == id) return true;
+    }
+    return false;
+}
+
+/** 调用任务的当前记录；不在路由中时为 NULL */
+static perf_rec_t *rec_current(void) {
+    return rec_find(cur_get());
+}
+
+static void rec_stamp(perf_rec_t *r, sdui_perf_stage_t stage, int64_t now) {
+    r->t[stage] = now;
+    r->mask    |= 1u << stage;
+    if (stage == SDUI_PERF_BUILT && r->state == REC_CLAIMED) r->state = REC_FRAME;
+}
+
+/* ======================================================
+ * 直方图
+ * ====================================================== */
+static uint8_t hist_bucket(int64_t us) {
+    uint8_t b    = 0;
+    int64_t edge = 500;
+    while (us >= edge && b < SDUI_PERF_HIST_BUCKETS - 1) {
+        edge <<= 1;
+        b++;
+    }
+    return b;
+}
+
+/** 各分段耗时，缺失的阶段并入下一段；不存在的分段为 -1 */
+static void rec_phases(const perf_rec_t *r, int64_t ph[SDUI_PERF_PHASE_COUNT]) {
+    int prev = SDUI_PERF_RX;
+    for (int s = 1; s < SDUI_PERF_STAGE_COUNT; s++) {
+        if (r->mask & (1u << s)) {
+            ph[s - 1] = r->t[s] - r->t[prev];
+            prev      = s;
+        } else {
+            ph[s - 1] = -1;
+        }
+    }
+    ph[SDUI_PERF_PHASE_TOTAL] = r->t[SDUI_PERF_FLUSHED] - r->t[SDUI_PERF_RX];
+}
+
+static void hist_add(const perf_rec_t *r) {
+    int64_t  ph[SDUI_PERF_PHASE_COUNT];
+    uint8_t *slot = s_win[s_win_pos];
+    rec_phases(r, ph);
+
+    bool full = s_hist.window == SDUI_PERF_HIST_WINDOW;
+    for (int p = 0; p < SDUI_PERF_PHASE_COUNT; p++) {
+        if (full && slot[p] != 0xFF) s_hist.count[p][slot[p]]--;
+        slot[p] = ph[p] < 0 ? 0xFF : hist_bucket(ph[p]);
+        if (slot[p] != 0xFF) s_hist.count[p][slot[p]]++;
+    }
+    if (!full) s_hist.window++;
+    s_win_pos = (s_win_pos + 1) % SDUI_PERF_HIST_WINDOW;
+    s_hist.published++;
+}
+
+/* ======================================================
+ * 刷新事件：BUILT 之后第一次真正绘制的刷新即为上屏
+ * ====================================================== */
+static void disp_event_cb(lv_event_t *e) {
+    lv_event_code_t code = lv_event_get_code(e);
+    int64_t         now  = esp_timer_get_time();
+    bool            done = false;
+
+    portENTER_CRITICAL(&s_mux);
+    if (code == LV_EVENT_REFR_START) s_rendered = false;
+    else if (code == LV_EVENT_RENDER_START) s_rendered = true;
+    for (int i = 0; i < PERF_SLOTS; i++) {
+        perf_rec_t *r = &s_recs[i];
+        if (r->state != REC_FRAME) continue;
+        if (code == LV_EVENT_REFR_START) {
+            rec_stamp(r, SDUI_PERF_REFR, now);
+            r->mask &= ~(1u << SDUI_PERF_RENDER);
+        } else if (code == LV_EVENT_RENDER_START) {
+            if (!(r->mask & (1u << SDUI_PERF_RENDER))) rec_stamp(r, SDUI_PERF_RENDER, now);
+        } else if (s_rendered && (r->mask & (1u << SDUI_PERF_RENDER))) {
+            rec_stamp(r, SDUI_PERF_FLUSHED, now);
+            r->state = REC_DONE;   /* 只有本任务推进 DONE → FREE，出锁后处理期间不会被复用 */
+            done     = true;
+        }
+    }
+    portEXIT_CRITICAL(&s_mux);
+    if (!done) return;
+
+    for (int i = 0; i < PERF_SLOTS; i++) {
+        perf_rec_t *r = &s_recs[i];
+        if (r->state != REC_DONE) continue;
+        hist_add(r);
+        if (s_queue) xQueueSend(s_queue, r, 0);   /* 队列满时只丢发布，不丢直方图 */
+        portENTER_CRITICAL(&s_mux);
+        r->state = REC_FREE;
+        portEXIT_CRITICAL(&s_mux);
+    }
+}
+
+/* ======================================================
+ * 发布任务
+ * ====================================================== */
+static void perf_format(const perf_rec_t *r, char *buf, size_t cap) {
+    int64_t ph[SDUI_PERF_PHASE_COUNT];
+    rec_phases(r, ph);
+
+    int n = snprintf(buf, cap, "{\"id\":%" PRIu32 ",\"topic\":\"%s\",\"bytes\":%" PRIu32, r->id, r->topic, r->bytes);
+    if (r->seq >= 0) n += snprintf(buf + n, cap - n, ",\"seq\":%" PRId64, r->seq);
+    if (r->ts != 0)  n += snprintf(buf + n, cap - n, ",\"ts\":%.0f", r->ts);
+    n += snprintf(buf + n, cap - n, ",\"phases_us\":{");
+    bool first = true;
+    for (int p = 0; p < SDUI_PERF_PHASE_TOTAL && n < (int)cap; p++) {
+        if (ph[p] < 0) continue;
+        n += snprintf(buf + n, cap - n, "%s\"%s\":%" PRId64, first ? "" : ",", s_phase_names[p], ph[p]);
+        first = false;
+    }
+    if (n < (int)cap) {
+        snprintf(buf + n, cap - n, "},\"total_us\":%" PRId64 ",\"age_us\":%" PRId64 "}",
+                 ph[SDUI_PERF_PHASE_TOTAL], esp_timer_get_time() - r->t[SDUI_PERF_FLUSHED]);
+    }
+}
+
+static void perf_task(void *arg) {
+    (void)arg;
+    perf_rec_t r;
+    char       buf[PERF_JSON_MAX];
+    while (1) {
+        if (xQueueReceive(s_queue, &r, portMAX_DELAY) != pdTRUE) continue;
+        perf_format(&r, buf, sizeof(buf));
+        ESP_LOGD(TAG, "%s", buf);
+        sdui_perf_sink_t sink = s_sink;
+        if (sink) sink(buf);
+    }
+}
+
+/* ======================================================
+ * 公共接口
+ * ====================================================== */
+void sdui_perf_init(void) {
+    static bool inited = false;
+    if (inited) return;
+    lv_display_t *disp = lv_display_get_default();
+    if (!disp) {
+        ESP_LOGW(TAG, "no display, profiler disabled");
+        return;
+    }
+    inited = true;
+    memset(s_win, 0xFF, sizeof(s_win));
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_RENDER_START, NULL);
+    lv_display_add_event_cb(disp, disp_event_cb, LV_EVENT_REFR_READY, NULL);
+
+    s_queue = xQueueCreate(PERF_QUEUE_LEN, sizeof(perf_rec_t));
+    if (!s_queue ||
+        xTaskCreatePinnedToCoreWithCaps(perf_task, "sdui_perf", 4096, NULL, 2, NULL,
+                                        tskNO_AFFINITY, MALLOC_CAP_SPIRAM) != pdPASS) {
+        ESP_LOGE(TAG, "perf task create failed, records are kept in the histogram only");
+    }
+    ESP_LOGI(TAG, "Render profiler on (%d slots, histogram window %d)", PERF_SLOTS, SDUI_PERF_HIST_WINDOW);
+}
+
+void sdui_perf_set_sink(sdui_perf_sink_t sink) {
+    s_sink = sink;
+}
+
+void sdui_perf_begin(void) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_mux);
+    cur_set(0);   /* 本任务上一条消息未走完（断线）时，其记录可直接复用 */
+    perf_rec_t *r = NULL, *oldest = NULL;
+    for (int i = 0; i < PERF_SLOTS && !r; i++) {
+        perf_rec_t *s = &s_recs[i];
+        if (s->state == REC_FREE || (s->state == REC_OPEN && !cur_holds(s->id))) r = s;
+        else if (s->state != REC_DONE && s->state != REC_OPEN && (!oldest || s->id < oldest->id)) oldest = s;
+    }
+    if (!r && oldest) {
+        r = oldest;   /* 全部在等上屏：挤掉最早的一条 */
+        s_hist.lost++;
+    }
+    if (!r) {
+        portEXIT_CRITICAL(&s_mux);
+        return;
+    }
+    memset(r, 0, sizeof(*r));
+    r->id    = s_next_id++;
+    r->state = REC_OPEN;
+    r->seq   = -1;
+    rec_stamp(r, SDUI_PERF_RX, now);
+    if (!s_next_id) s_next_id = 1;
+    cur_set(r->id);
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void sdui_perf_mark_current(sdui_perf_stage_t stage) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_current();
+    if (r) rec_stamp(r, stage, now);
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void sdui_perf_routed(const char *topic, size_t topic_len, size_t bytes, int64_t seq, double ts) {
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_current();
+    if (r) {
+        size_t n = topic_len < PERF_TOPIC_MAX - 1 ? topic_len : PERF_TOPIC_MAX - 1;
+        for (size_t i = 0; i < n; i++) {
+            char c = topic[i];
+            r->topic[i] = (c == '"' || c == '\\' || (unsigned char)c < 0x20) ? '_' : c;   /* 直接拼进 JSON */
+        }
+        r->topic[n] = '\0';
+        r->bytes    = (uint32_t)bytes;
+        r->seq      = seq;
+        r->ts       = ts;
+        rec_stamp(r, SDUI_PERF_ROUTED, now);
+    }
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void sdui_perf_end(void) {
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_current();
+    if (r && r->state == REC_OPEN) r->state = REC_FREE;
+    cur_set(0);
+    portEXIT_CRITICAL(&s_mux);
+}
+
+uint32_t sdui_perf_detach(void) {
+    uint32_t id = 0;
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_current();
+    if (r && r->state == REC_OPEN) {
+        r->state = REC_QUEUED;
+        id       = r->id;
+    }
+    cur_set(0);
+    portEXIT_CRITICAL(&s_mux);
+    return id;
+}
+
+void sdui_perf_adopt(uint32_t id) {
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_find(id);
+    if (r && r->state == REC_QUEUED) {
+        r->state = REC_OPEN;
+        cur_set(id);
+    } else {
+        cur_set(0);   /* 记录已被挤出：本次路由不计时 */
+    }
+    portEXIT_CRITICAL(&s_mux);
+}
+
+uint32_t sdui_perf_claim(void) {
+    uint32_t id = 0;
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_current();
+    if (r && r->state == REC_OPEN) {
+        r->state = REC_CLAIMED;
+        id       = r->id;
+    }
+    portEXIT_CRITICAL(&s_mux);
+    return id;
+}
+
+void sdui_perf_mark(uint32_t id, sdui_perf_stage_t stage) {
+    if (!id) return;
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_find(id);
+    if (r) rec_stamp(r, stage, now);
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void sdui_perf_drop(uint32_t id) {
+    if (!id) return;
+    portENTER_CRITICAL(&s_mux);
+    perf_rec_t *r = rec_find(id);
+    if (r && !cur_holds(r->id)) r->state = REC_FREE;
+    else if (r)                 r->state = REC_OPEN;   /* 仍在路由中：交给 sdui_perf_end 回收 */
+    portEXIT_CRITICAL(&s_mux);
+}
+
+void sdui_perf_get_hist(sdui_perf_hist_t *out) {
+    if (out) *out = s_hist;
+}
+
+const char *sdui_perf_phase_name(int phase) {
+    return (phase >= 0 && phase < SDUI_PERF_PHASE_COUNT) ? s_phase_names[phase] : "";
+}
+
+#endif /* CONFIG_SDUI_PERF */
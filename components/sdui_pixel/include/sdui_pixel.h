@@ -0,0 +1,97 @@
+/**
+ * @file sdui_pixel.h
+ * @brief SDUI RGB565 像素内核（填充 / 混合 / 字节序交换）
+ *
+ * 两个后端：
+ *   - 参考实现：可移植 C，Linux 主机上同样可编译，作为正确性基准
+ *   - PIE：ESP32-S3 128 位向量指令（每条指令 8 像素），CONFIG_SDUI_PIXEL_PIE 开启
+ * sdui_pixel_init() 逐个内核与参考实现比对，一致才启用 PIE，否则整体回退到 C。
+ *
+ * 混合语义与 LVGL lv_color_16_16_mix 逐位一致：opa (0–255) 量化为
+ * m = (opa + 4) >> 3 (0–32)，每个通道 out = bg + (fg - bg) * m / 32（向下取整）。
+ *
+ * 使用者：
+ *   - sdui_particles：画布清除（fill）与精灵混合（blend_mask）
+ *   - LVGL 软件渲染：经 sdui_pixel_lv.h 接管纯色填充、半透明填充、
+ *     图片 opa 混合与 RGB565 字节序交换（见 sdkconfig.defaults）
+ */
+#ifndef SDUI_PIXEL_H
+#define SDUI_PIXEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 一个后端的全部内核 */
+typedef struct {
+    const char *name;
+    /** dst[i] = color */
+    void (*fill)(uint16_t *dst, uint16_t color, size_t n);
+    /** dst[i] = mix(dst[i], color, opa) */
+    void (*blend)(uint16_t *dst, uint16_t color, uint8_t opa, size_t n);
+    /** dst[i] = mix(dst[i], color, mask[i] * opa / 255)；精灵行通常很短，两个后端均为 C */
+    void (*blend_mask)(uint16_t *dst, uint16_t color, const uint8_t *mask, uint8_t opa, size_t n);
+    /** dst[i] = mix(a[i], b[i], opa)，opa 为 b 的权重；dst 可与 a 相同 */
+    void (*mix)(uint16_t *dst, const uint16_t *a, const uint16_t *b, uint8_t opa, size_t n);
+    /** buf[i] = 高低字节交换（QSPI 面板为大端 RGB565） */
+    void (*swap)(uint16_t *buf, size_t n);
+} sdui_pixel_backend_t;
+
+/**
+ * @brief 选择后端：PIE 已编译且自检通过时启用，否则使用参考实现
+ *
+ * 应在显示启动前调用；未调用时所有内核走参考实现。
+ */
+void sdui_pixel_init(void);
+
+/** @brief 当前后端 */
+const sdui_pixel_backend_t *sdui_pixel_active(void);
+
+/** @brief 参考实现（C） */
+const sdui_pixel_backend_t *sdui_pixel_reference(void);
+
+/**
+ * @brief 以参考实现为基准校验一个后端（随机数据、各种对齐与长度）
+ * @return 全部内核逐像素一致返回 true
+ */
+bool sdui_pixel_selftest(const sdui_pixel_backend_t *be);
+
+/**
+ * @brief 对每个已编译的后端逐内核计时，日志输出每像素周期数
+ *
+ * 在内部 SRAM 的一行全屏宽度缓冲上运行，结果形如
+ * "blend  C 6.02 cyc/px  PIE 1.13 cyc/px"。
+ */
+void sdui_pixel_bench(void);
+
+/* ---- 当前后端的便捷入口 ---- */
+static inline void sdui_px_fill(uint16_t *dst, uint16_t color, size_t n) {
+    sdui_pixel_active()->fill(dst, color, n);
+}
+static inline void sdui_px_blend(uint16_t *dst, uint16_t color, uint8_t opa, size_t n) {
+    sdui_pixel_active()->blend(dst, color, opa, n);
+}
+static inline void sdui_px_blend_mask(uint16_t *dst, uint16_t color, const uint8_t *mask, uint8_t opa, size_t n) {
+    sdui_pixel_active()->blend_mask(dst, color, mask, opa, n);
+}
+static inline void sdui_px_mix(uint16_t *dst, const uint16_t *a, const uint16_t *b, uint8_t opa, size_t n) {
+    sdui_pixel_active()->mix(dst, a, b, opa, n);
+}
+static inline void sdui_px_swap(uint16_t *buf, size_t n) {
+    sdui_pixel_active()->swap(buf, n);
+}
+
+/* ---- LVGL 软件渲染接管（sdui_pixel_lv.h 使用，stride 以字节计） ---- */
+void sdui_px_lv_fill(void *dest, int32_t w, int32_t h, int32_t stride, uint16_t color, uint8_t opa);
+void sdui_px_lv_image_opa(void *dest, int32_t w, int32_t h, int32_t stride,
+                          const void *src, int32_t src_stride, uint8_t opa);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SDUI_PIXEL_H */
@@ -0,0 +1,27 @@
+/**
+ * @file sdui_pixel_lv.h
+ * @brief LVGL 软件渲染的自定义汇编钩子 (LV_USE_DRAW_SW_ASM = CUSTOM)
+ *
+ * 由 LVGL 的 lv_draw_sw 源文件通过 LV_DRAW_SW_ASM_CUSTOM_INCLUDE 引入，
+ * 把 RGB565 目标上的无遮罩纯色填充、半透明填充、RGB565 图片 opa 混合
+ * 以及刷屏前的字节序交换交给 sdui_pixel 当前后端。
+ * 其余组合（带遮罩、其他色彩格式、混合模式）返回 LV_RESULT_INVALID，由 LVGL 自行处理。
+ */
+#pragma once
+
+#include "sdui_pixel.h"
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565(dsc)                                                   \
+    (sdui_px_lv_fill((dsc)->dest_buf, (dsc)->dest_w, (dsc)->dest_h, (dsc)->dest_stride,        \
+                     lv_color_to_u16((dsc)->color), LV_OPA_COVER), LV_RESULT_OK)
+
+#define LV_DRAW_SW_COLOR_BLEND_TO_RGB565_WITH_OPA(dsc)                                          \
+    (sdui_px_lv_fill((dsc)->dest_buf, (dsc)->dest_w, (dsc)->dest_h, (dsc)->dest_stride,        \
+                     lv_color_to_u16((dsc)->color), (dsc)->opa), LV_RESULT_OK)
+
+#define LV_DRAW_SW_RGB565_BLEND_NORMAL_TO_RGB565_WITH_OPA(dsc)                                  \
+    (sdui_px_lv_image_opa((dsc)->dest_buf, (dsc)->dest_w, (dsc)->dest_h, (dsc)->dest_stride,   \
+                          (dsc)->src_buf, (dsc)->src_stride, (dsc)->opa), LV_RESULT_OK)
+
+#define LV_DRAW_SW_RGB565_SWAP(buf, buf_size_px)                                                \
+    (sdui_px_swap((uint16_t *)(buf), (buf_size_px)), LV_RESULT_OK)
@@ -0,0 +1,412 @@
+/**
+ * @file sdui_pixel.c
+ * @brief SDUI RGB565 像素内核：参考实现、后端选择、自检与计时
+ *
+ * 参考实现的混合采用 32 位拆分：G 移到高半字，R/B 留在低半字，
+ * 一次乘法同时完成三个通道。PIE 后端（sdui_pixel_pie.S）每次处理
+ * 8 像素的 128 位块，首尾不足一块或对齐不一致的部分交回参考实现。
+ */
+#include "sdui_pixel.h"
+#include "esp_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ESP_PLATFORM
+#include "sdkconfig.h"
+#include "esp_cpu.h"
+#include "esp_heap_caps.h"
+#else
+#include <time.h>
+#endif
+
+#if defined(CONFIG_SDUI_PIXEL_PIE)
+#define SDUI_PIXEL_HAVE_PIE 1
+#else
+#define SDUI_PIXEL_HAVE_PIE 0
+#endif
+
+static const char *TAG = "SDUI_PIXEL";
+
+/** opa (0–255) → 0..32，与 lv_color_16_16_mix 相同 */
+#define MIX_M(opa)  (((uint32_t)(opa) + 4) >> 3)
+
+static inline uint32_t rgb565_split(uint16_t c) {
+    return ((uint32_t)c | ((uint32_t)c << 16)) & 0x07E0F81Fu;
+}
+
+/** bg + (fg - bg) * m / 32，fg 为拆分形式 */
+static inline uint16_t mix_split(uint16_t bg, uint32_t fg_x, uint32_t m) {
+    uint32_t b = rgb565_split(bg);
+    uint32_t v = ((((fg_x - b) * m) >> 5) + b) & 0x07E0F81Fu;
+    return (uint16_t)(v | (v >> 16));
+}
+
+/* ======================================================
+ * 参考实现
+ * ====================================================== */
+static void ref_fill(uint16_t *dst, uint16_t color, size_t n) {
+    if ((color >> 8) == (color & 0xFF)) {
+        memset(dst, color & 0xFF, n * 2);
+        return;
+    }
+    /* 对齐到 4 字节后按 32 位写 */
+    if (n && ((uintptr_t)dst & 2)) { *dst++ = color; n--; }
+    uint32_t  c2 = (uint32_t)color | ((uint32_t)color << 16);
+    uint32_t *d  = (uint32_t *)dst;
+    for (size_t i = 0; i < n / 2; i++) d[i] = c2;
+    if (n & 1) dst[n - 1] = color;
+}
+
+static void ref_blend(uint16_t *dst, uint16_t color, uint8_t opa, size_t n) {
+    uint32_t m = MIX_M(opa);
+    if (m == 0) return;
+    if (m >= 32) { ref_fill(dst, color, n); return; }
+    uint32_t fg = rgb565_split(color);
+    for (size_t i = 0; i < n; i++) dst[i] = mix_split(dst[i], fg, m);
+}
+
+static void ref_blend_mask(uint16_t *dst, uint16_t color, const uint8_t *mask, uint8_t opa, size_t n) {
+    uint32_t fg = rgb565_split(color);
+    for (size_t i = 0; i < n; i++) {
+        uint32_t o = opa == 255 ? mask[i] : ((uint32_t)mask[i] * opa) >> 8;
+        uint32_t m = MIX_M(o);
+        if (m) dst[i] = mix_split(dst[i], fg, m);
+    }
+}
+
+static void ref_mix(uint16_t *dst, const uint16_t *a, const uint16_t *b, uint8_t opa, size_t n) {
+    uint32_t m = MIX_M(opa);
+    for (size_t i = 0; i < n; i++) dst[i] = mix_split(a[i], rgb565_split(b[i]), m);
+}
+
+static void ref_swap(uint16_t *buf, size_t n) {
+    if (n && ((uintptr_t)buf & 2)) { *buf = (uint16_t)((*buf << 8) | (*buf >> 8)); buf++; n--; }
+    uint32_t *d = (uint32_t *)buf;
+    for (size_t i = 0; i < n / 2; i++) {
+        uint32_t v = d[i];
+        d[i] = ((v << 8) & 0xFF00FF00u) | ((v >> 8) & 0x00FF00FFu);
+    }
+    if (n & 1) buf[n - 1] = (uint16_t)((buf[n - 1] << 8) | (buf[n - 1] >> 8));
+}
+
+static const sdui_pixel_backend_t s_ref = {
+    .name       = "C",
+    .fill       = ref_fill,
+    .blend      = ref_blend,
+    .blend_mask = ref_blend_mask,
+    .mix        = ref_mix,
+    .swap       = ref_swap,
+};
+
+/* ======================================================
+ * PIE 后端（ESP32-S3）
+ * ====================================================== */
+#if SDUI_PIXEL_HAVE_PIE
+
+/** 短于此长度时建立常量表的开销不划算 */
+#define PIE_MIN_PX  32
+
+/** 混合内核的常量表，布局与 sdui_pixel_pie.S 中的偏移一致 */
+typedef struct {
+    uint16_t ones[8];      /*   0 */
+    uint16_t m1f[8];       /*  16 */
+    uint16_t m7e0[8];      /*  32 */
+    uint16_t mf800[8];     /*  48 */
+    uint16_t k64[8];       /*  64 */
+    uint16_t im[8];        /*  80: 32 - m */
+    uint16_t m[8];         /*  96 */
+    uint16_t color[8];     /* 112: blend 的广播颜色 */
+} __attribute__((aligned(16))) pie_mix_k_t;
+
+static const pie_mix_k_t s_mix_k = {
+    .ones  = { 1, 1, 1, 1, 1, 1, 1, 1 },
+    .m1f   = { 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F },
+    .m7e0  = { 0x7E0, 0x7E0, 0x7E0, 0x7E0, 0x7E0, 0x7E0, 0x7E0, 0x7E0 },
+    .mf800 = { 0xF800, 0xF800, 0xF800, 0xF800, 0xF800, 0xF800, 0xF800, 0xF800 },
+    .k64   = { 64, 64, 64, 64, 64, 64, 64, 64 },
+};
+
+static const uint32_t s_swap_k[8] __attribute__((aligned(16))) = {
+    0x00FF00FFu, 0x00FF00FFu, 0x00FF00FFu, 0x00FF00FFu,
+    0xFF00FF00u, 0xFF00FF00u, 0xFF00FF00u, 0xFF00FF00u,
+};
+
+/* sdui_pixel_pie.S；blocks 为 8 像素块数，指针须 16 字节对齐 */
+extern void sdui_px_pie_fill(uint16_t *dst, const uint16_t *color8, size_t blocks);
+extern void sdui_px_pie_mix(uint16_t *dst, const uint16_t *a, const uint16_t *b,
+                            const pie_mix_k_t *k, size_t blocks, int32_t b_step);
+extern void sdui_px_pie_swap(uint16_t *buf, const uint32_t *k, size_t blocks);
+
+/** 到下一个 16 字节边界的像素数（dst 须 2 字节对齐） */
+static inline size_t pie_head(const void *p) {
+    return ((16 - ((uintptr_t)p & 15)) & 15) / 2;
+}
+
+static void pie_k_init(pie_mix_k_t *k, uint32_t m) {
+    memcpy(k, &s_mix_k, offsetof(pie_mix_k_t, im));
+    for (int i = 0; i < 8; i++) {
+        k->im[i] = (uint16_t)(32 - m);
+        k->m[i]  = (uint16_t)m;
+    }
+}
+
+static void pie_fill(uint16_t *dst, uint16_t color, size_t n) {
+    if (n < PIE_MIN_PX || ((uintptr_t)dst & 1)) { ref_fill(dst, color, n); return; }
+    size_t head = pie_head(dst);
+    ref_fill(dst, color, head);
+    dst += head; n -= head;
+
+    uint16_t c8[8] __attribute__((aligned(16)));
+    for (int i = 0; i < 8; i++) c8[i] = color;
+    sdui_px_pie_fill(dst, c8, n / 8);
+    ref_fill(dst + (n & ~(size_t)7), color, n & 7);
+}
+
+static void pie_blend(uint16_t *dst, uint16_t color, uint8_t opa, size_t n) {
+    uint32_t m = MIX_M(opa);
+    if (m == 0) return;
+    if (m >= 32) { pie_fill(dst, color, n); return; }
+    if (n < PIE_MIN_PX || ((uintptr_t)dst & 1)) { ref_blend(dst, color, opa, n); return; }
+
+    size_t head = pie_head(dst);
+    ref_blend(dst, color, opa, head);
+    dst += head; n -= head;
+
+    pie_mix_k_t k;
+    pie_k_init(&k, m);
+    for (int i = 0; i < 8; i++) k.color[i] = color;
+    sdui_px_pie_mix(dst, dst, k.color, &k, n / 8, 0);
+    ref_blend(dst + (n & ~(size_t)7), color, opa, n & 7);
+}
+
+static void pie_mix(uint16_t *dst, const uint16_t *a, const uint16_t *b, uint8_t opa, size_t n) {
+    if (n < PIE_MIN_PX || ((uintptr_t)dst & 1)
+        || (((uintptr_t)dst ^ (uintptr_t)a) & 15) || (((uintptr_t)dst ^ (uintptr_t)b) & 15)) {
+        ref_mix(dst, a, b, opa, n);
+        return;
+    }
+    size_t head = pie_head(dst);
+    ref_mix(dst, a, b, opa, head);
+    dst += head; a += head; b += head; n -= head;
+
+    pie_mix_k_t k;
+    pie_k_init(&k, MIX_M(opa));
+    sdui_px_pie_mix(dst, a, b, &k, n / 8, 16);
+    size_t done = n & ~(size_t)7;
+    ref_mix(dst + done, a + done, b + done, opa, n & 7);
+}
+
+static void pie_swap(uint16_t *buf, size_t n) {
+    if (n < PIE_MIN_PX || ((uintptr_t)buf & 1)) { ref_swap(buf, n); return; }
+    size_t head = pie_head(buf);
+    ref_swap(buf, head);
+    buf += head; n -= head;
+    sdui_px_pie_swap(buf, s_swap_k, n / 8);
+    ref_swap(buf + (n & ~(size_t)7), n & 7);
+}
+
+static const sdui_pixel_backend_t s_pie = {
+    .name       = "PIE",
+    .fill       = pie_fill,
+    .blend      = pie_blend,
+    .blend_mask = ref_blend_mask,   /* 精灵行 ≤ 17px，向量化无收益 */
+    .mix        = pie_mix,
+    .swap       = pie_swap,
+};
+#endif /* SDUI_PIXEL_HAVE_PIE */
+
+static const sdui_pixel_backend_t *s_active = &s_ref;
+
+/* ======================================================
+ * 自检：与参考实现逐像素比对
+ * ====================================================== */
+#define ST_PX   200
+#define ST_PAD  16
+
+static uint32_t st_rng(uint32_t *s) {
+    uint32_t v = *s;
+    v ^= v << 13;
+    v ^= v >> 17;
+    v ^= v << 5;
+    return *s = v;
+}
+
+bool sdui_pixel_selftest(const sdui_pixel_backend_t *be) {
+    static const uint16_t lens[] = { 0, 1, 7, 8, 9, 31, 32, 33, 47, 64, 127, 183 };
+    static const uint8_t  opas[] = { 0, 1, 3, 4, 100, 128, 200, 251, 252, 253, 255 };
+    const size_t cap = ST_PX + ST_PAD;
+
+    uint16_t *mem = malloc(cap * 2 * 4 + 16);
+    uint8_t  *mask = malloc(cap);
+    if (!mem || !mask) { free(mem); free(mask); return false; }
+    uint16_t *base = (uint16_t *)(((uintptr_t)mem + 15) & ~(uintptr_t)15);
+    uint16_t *a = base, *b = base + cap, *d_ref = base + 2 * cap, *d_be = base + 3 * cap;
+
+    uint32_t seed = 0x2545F491u;
+    for (size_t i = 0; i < cap; i++) {
+        a[i]    = (uint16_t)st_rng(&seed);
+        b[i]    = (uint16_t)st_rng(&seed);
+        mask[i] = (uint8_t)st_rng(&seed);
+    }
+
+    /* 每个用例从同一初始内容出发，比对整个缓冲（含越界写） */
+#define ST_CASE(what, init, call)                                                   \
+    do {                                                                            \
+        init(d_ref); init(d_be);                                                    \
+        { uint16_t *d = d_ref; const sdui_pixel_backend_t *k = &s_ref; call; }      \
+        { uint16_t *d = d_be;  const sdui_pixel_backend_t *k = be;     call; }      \
+        if (memcmp(d_ref, d_be, cap * 2)) {                                         \
+            ESP_LOGE(TAG, "%s %s mismatch: n=%u off=%u", be->name, what,            \
+                     (unsigned)n, (unsigned)off);                                   \
+            ok = false;                                                             \
+        }                                                                           \
+    } while (0)
+#define ST_FROM_A(p)  memcpy((p), a, cap * 2)
+#define ST_ZERO(p)    memset((p), 0, cap * 2)
+
+    bool ok = true;
+    for (size_t li = 0; ok && li < sizeof(lens) / sizeof(lens[0]); li++) {
+        size_t n = lens[li];
+        for (size_t off = 0; ok && off < 8; off++) {
+            uint16_t color = (uint16_t)st_rng(&seed);
+            size_t   boff  = (off + (li & 1) * 3) & 7;   /* 一半用例 a/b 对齐不一致 */
+
+            ST_CASE("fill", ST_FROM_A, k->fill(d + off, color, n));
+            ST_CASE("swap", ST_FROM_A, k->swap(d + off, n));
+            for (size_t oi = 0; ok && oi < sizeof(opas); oi++) {
+                uint8_t opa = opas[oi];
+                ST_CASE("blend", ST_FROM_A, k->blend(d + off, color, opa, n));
+                ST_CASE("blend_mask", ST_FROM_A, k->blend_mask(d + off, color, mask, opa, n));
+                ST_CASE("mix", ST_ZERO, k->mix(d + off, a + off, b + boff, opa, n));
+                ST_CASE("mix in-place", ST_FROM_A, k->mix(d + off, d + off, b + off, opa, n));
+            }
+        }
+    }
+#undef ST_CASE
+#undef ST_FROM_A
+#undef ST_ZERO
+    free(mem);
+    free(mask);
+    return ok;
+}
+
+/* ======================================================
+ * 公共接口
+ * ====================================================== */
+const sdui_pixel_backend_t *sdui_pixel_active(void) {
+    return s_active;
+}
+
+const sdui_pixel_backend_t *sdui_pixel_reference(void) {
+    return &s_ref;
+}
+
+void sdui_pixel_init(void) {
+#if SDUI_PIXEL_HAVE_PIE
+    if (sdui_pixel_selftest(&s_pie)) {
+        s_active = &s_pie;
+    } else {
+        ESP_LOGW(TAG, "PIE self-test failed, using C kernels");
+    }
+#endif
+    ESP_LOGI(TAG, "pixel backend: %s", s_active->name);
+}
+
+void sdui_px_lv_fill(void *dest, int32_t w, int32_t h, int32_t stride, uint16_t color, uint8_t opa) {
+    const sdui_pixel_backend_t *be = s_active;
+    uint8_t *row = dest;
+    for (int32_t y = 0; y < h; y++, row += stride) {
+        if (opa == 255) be->fill((uint16_t *)row, color, (size_t)w);
+        else            be->blend((uint16_t *)row, color, opa, (size_t)w);
+    }
+}
+
+void sdui_px_lv_image_opa(void *dest, int32_t w, int32_t h, int32_t stride,
+                          const void *src, int32_t src_stride, uint8_t opa) {
+    const sdui_pixel_backend_t *be = s_active;
+    uint8_t       *row = dest;
+    const uint8_t *s   = src;
+    for (int32_t y = 0; y < h; y++, row += stride, s += src_stride)
+        be->mix((uint16_t *)row, (const uint16_t *)row, (const uint16_t *)s, opa, (size_t)w);
+}
+
+/* ======================================================
+ * 计时
+ * ====================================================== */
+#define BENCH_PX    (466 * 10)     /* 一块 LVGL 绘制缓冲：屏宽 × 10 行 */
+#define BENCH_REPS  20
+
+#ifdef ESP_PLATFORM
+#define BENCH_UNIT  "cyc/px"
+static inline uint32_t bench_now(void) { return esp_cpu_get_cycle_count(); }
+#define BENCH_ALLOC(sz) heap_caps_aligned_alloc(16, (sz), MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT)
+#define BENCH_FREE(p)   heap_caps_free(p)
+#else
+#define BENCH_UNIT  "ns/px"
+static inline uint32_t bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec);
+}
+#define BENCH_ALLOC(sz) aligned_alloc(16, ((sz) + 15) & ~(size_t)15)
+#define BENCH_FREE(p)   free(p)
+#endif
+
+enum { K_FILL, K_BLEND, K_BLEND_MASK, K_MIX, K_SWAP, K_COUNT };
+static const char *const s_kernel_names[K_COUNT] = { "fill", "blend", "blend_mask", "mix", "swap" };
+
+static float bench_kernel(const sdui_pixel_backend_t *be, int k, uint16_t *d, const uint16_t *s, const uint8_t *mask) {
+    uint32_t best = UINT32_MAX;
+    for (int r = 0; r < BENCH_REPS; r++) {
+        uint32_t t0 = bench_now();
+        switch (k) {
+        case K_FILL:       be->fill(d, 0x1234, BENCH_PX); break;
+        case K_BLEND:      be->blend(d, 0xF81F, 128, BENCH_PX); break;
+        case K_BLEND_MASK: be->blend_mask(d, 0xF81F, mask, 200, BENCH_PX); break;
+        case K_MIX:        be->mix(d, d, s, 128, BENCH_PX); break;
+        default:           be->swap(d, BENCH_PX); break;
+        }
+        uint32_t dt = bench_now() - t0;
+        if (dt < best) best = dt;
+    }
+    return (float)best / BENCH_PX;
+}
+
+void sdui_pixel_bench(void) {
+    const sdui_pixel_backend_t *backends[] = {
+        &s_ref,
+#if SDUI_PIXEL_HAVE_PIE
+        &s_pie,
+#endif
+    };
+    const int nb = (int)(sizeof(backends) / sizeof(backends[0]));
+
+    uint16_t *d    = BENCH_ALLOC(BENCH_PX * 2);
+    uint16_t *s    = BENCH_ALLOC(BENCH_PX * 2);
+    uint8_t  *mask = BENCH_ALLOC(BENCH_PX);
+    if (!d || !s || !mask) {
+        ESP_LOGW(TAG, "bench: out of internal memory");
+        BENCH_FREE(d); BENCH_FREE(s); BENCH_FREE(mask);
+        return;
+    }
+    uint32_t seed = 0x9E3779B9u;
+    for (int i = 0; i < BENCH_PX; i++) {
+        d[i]    = (uint16_t)st_rng(&seed);
+        s[i]    = (uint16_t)st_rng(&seed);
+        mask[i] = (uint8_t)st_rng(&seed);
+    }
+
+    ESP_LOGI(TAG, "bench: %d px, best of %d (active: %s)", BENCH_PX, BENCH_REPS, s_active->name);
+    for (int k = 0; k < K_COUNT; k++) {
+        char line[96];
+        int  len = snprintf(line, sizeof(line), "%-10s", s_kernel_names[k]);
+        for (int b = 0; b < nb && len < (int)sizeof(line); b++)
+            len += snprintf(line + len, sizeof(line) - len, "  %-3s %6.2f " BENCH_UNIT,
+                            backends[b]->name, (double)bench_kernel(backends[b], k, d, s, mask));
+        ESP_LOGI(TAG, "%s", line);
+    }
+    BENCH_FREE(d);
+    BENCH_FREE(s);
+    BENCH_FREE(mask);
+}
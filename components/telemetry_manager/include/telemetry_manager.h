@@ -8,6 +8,8 @@ extern "C" {
 #include <stdint.h>
 #include <stddef.h>
 
+struct cJSON;
+
 /**
  * @brief 设备遥测数据结构体
  * 所有字段在每次上报时采集，通过 sdui_bus 上行发送至服务器。
@@ -22,6 +24,13 @@ typedef struct {
     uint64_t uptime_s;             /**< 系统运行时长（秒） */
 } telemetry_data_t;
 
+/**
+ * @brief 附加字段回调：每次上报序列化前调用，向 root 追加其他模块的状态
+ *
+ * 在遥测任务中执行，回调内只能读取线程安全的数据。
+ */
+typedef void (*telemetry_extra_cb_t)(struct cJSON *root);
+
 /**
  * @brief 启动遥测定时上报任务
  *
@@ -33,6 +42,15 @@ typedef struct {
  */
 void telemetry_app_start(uint32_t report_interval_s);
 
+/**
+ * @brief 注册附加字段回调（仅一个，后注册者覆盖）
+ *
+ * 使遥测模块无需依赖上层组件即可上报其统计，例如 SDUI 图片缓存命中率。
+ *
+ * @param cb 回调，NULL 取消
+ */
+void telemetry_set_extra_cb(telemetry_extra_cb_t cb);
+
 /**
  * @brief 获取设备唯一码（MAC 地址字符串）
  *
@@ -38,6 +38,7 @@ static const char *TAG = "TELEMETRY";
 static char s_device_id[18]   = {0};   // 缓存设备 ID，只读取一次
 static uint32_t s_interval_s  = 30;    // 上报间隔（秒）
 static temperature_sensor_handle_t s_temp_sensor = NULL;
+static telemetry_extra_cb_t s_extra_cb = NULL;   // 附加字段回调
 
 /* ---- 内部：初始化温度传感器 ---- */
 static void prv_init_temp_sensor(void)
@@ -127,6 +128,12 @@ void telemetry_collect(telemetry_data_t *data)
     data->uptime_s = (uint64_t)(esp_timer_get_time() / 1000000ULL);
 }
 
+/* ---- 注册附加字段回调 ---- */
+void telemetry_set_extra_cb(telemetry_extra_cb_t cb)
+{
+    s_extra_cb = cb;
+}
+
 /* ---- 获取设备 ID（供外部模块调用） ---- */
 void telemetry_get_device_id(char *buf, size_t len)
 {
@@ -159,6 +166,15 @@ static void telemetry_report_task(void *arg)
             cJSON_AddNumberToObject(root, "free_heap_total",    (double)data.free_heap_total);
             cJSON_AddNumberToObject(root, "uptime_s",           (double)data.uptime_s);
 
+            // 可接收二进制帧的下行主题，服务端据此选择 SBL 编码
+            const char *bin_topics[8];
+            int n_bin = sdui_bus_get_bin_topics(bin_topics, 8);
+            cJSON_AddItemToObject(root, "bin_topics", cJSON_CreateStringArray(bin_topics, n_bin));
+
+            // 其他模块的附加字段
+            telemetry_extra_cb_t extra = s_extra_cb;
+            if (extra) extra(root);
+
             char *json_str = cJSON_PrintUnformatted(root);
             cJSON_Delete(root);
 
@@ -168,7 +184,7 @@ static void telemetry_report_task(void *arg)
                          data.temperature, (unsigned long)data.free_heap_internal);
 
                 // --- 通过 SDUI Bus 上行 ---
-                sdui_bus_publish_up("telemetry/heartbeat", json_str);
+                sdui_bus_publish_up_ex("telemetry/heartbeat", json_str, strlen(json_str), SDUI_BUS_UP_JSON);
                 free(json_str);
             }
         }
@@ -5,9 +5,15 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+#include <stddef.h>
+
 // 定义底层的路由分发函数类型（当前由 sdui_bus 接管）
 typedef void (*websocket_rx_cb_t)(const char *text);
 
+// 二进制帧的路由分发函数类型
+typedef void (*websocket_rx_bin_cb_t)(const uint8_t *data, size_t len);
+
 /**
  * @brief 启动 WebSocket 守护进程
  * @param uri 目标服务器地址 (例如: ws://172.16.11.64:8080)
@@ -15,6 +21,13 @@ typedef void (*websocket_rx_cb_t)(const char *text);
  */
 void websocket_app_start(const char *uri, websocket_rx_cb_t cb);
 
+/**
+ * @brief 设置二进制帧 (opcode 0x02) 的接收回调
+ * @param cb 完整帧拼接完成后的回调 (通常传入 sdui_bus_route_down_bin)，NULL 则丢弃二进制帧
+ * @note 应在 websocket_app_start() 之前调用
+ */
+void websocket_set_bin_rx_cb(websocket_rx_bin_cb_t cb);
+
 /**
  * @brief 停止并销毁 WebSocket 客户端
  */
@@ -27,6 +40,12 @@ void websocket_app_stop(void);
  */
 void websocket_send_json(const char *payload);
 
+/**
+ * @brief 同 websocket_send_json，按长度发送（不要求 '\0' 结尾）
+ * @note 发送是同步的，返回后 data 即可复用
+ */
+void websocket_send_text(const char *data, size_t len);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,17 +2,20 @@
 #include "esp_websocket_client.h"
 #include "esp_log.h"
 #include "esp_heap_caps.h"
+#include "sdui_perf.h"
 #include <string.h>
 
 static const char *TAG = "WS_MANAGER";
 
 static esp_websocket_client_handle_t client = NULL;
 static websocket_rx_cb_t global_rx_cb = NULL;
+static websocket_rx_bin_cb_t global_rx_bin_cb = NULL;
 static bool is_connected = false;
 
 // 大体积载荷拼接缓冲区
 static char *rx_buffer = NULL;
 static int rx_buffer_len = 0;
+static bool rx_is_binary = false;   // 当前拼接中的消息是否为二进制帧
 
 static void websocket_event_handler(void *handler_args, esp_event_base_t base, int32_t event_id, void *event_data)
 {
@@ -36,11 +39,15 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
             break;
 
         case WEBSOCKET_EVENT_DATA:
-            // 仅处理文本帧 (0x01) 或二进制流延续帧 (0x00)
-            if (data->op_code == 0x01 || data->op_code == 0x00) {
+            // 处理文本帧 (0x01)、二进制帧 (0x02) 及延续帧 (0x00)
+            if (data->op_code == 0x01 || data->op_code == 0x02 || data->op_code == 0x00) {
                 
                 // 数据包起始标识
                 if (data->payload_offset == 0) {
+                    if (data->op_code != 0x00) {
+                        rx_is_binary = (data->op_code == 0x02);
+                        sdui_perf_begin();   // 渲染计时起点：首个分片到达
+                    }
                     if (rx_buffer) {
                         heap_caps_free(rx_buffer);
                     }
@@ -62,10 +69,16 @@ static void websocket_event_handler(void *handler_args, esp_event_base_t base, i
                 // 完整帧接收完毕
                 if (rx_buffer_len == data->payload_len) {
                     rx_buffer[rx_buffer_len] = '\0'; // 字符串封尾
-                    
-                    if (global_rx_cb) {
+                    sdui_perf_mark_current(SDUI_PERF_RX_DONE);
+
+                    if (rx_is_binary) {
+                        if (global_rx_bin_cb) {
+                            global_rx_bin_cb((const uint8_t *)rx_buffer, rx_buffer_len);
+                        }
+                    } else if (global_rx_cb) {
                         global_rx_cb(rx_buffer); // 推入 SDUI 总线
                     }
+                    sdui_perf_end();
 
                     // 用完即焚，释放内存池
                     heap_caps_free(rx_buffer);
@@ -98,16 +111,26 @@ void websocket_app_start(const char *uri, websocket_rx_cb_t cb)
     esp_websocket_client_start(client);
 }
 
+void websocket_set_bin_rx_cb(websocket_rx_bin_cb_t cb)
+{
+    global_rx_bin_cb = cb;
+}
+
 void websocket_send_json(const char *payload)
+{
+    if (payload == NULL) return;
+    websocket_send_text(payload, strlen(payload));
+}
+
+void websocket_send_text(const char *data, size_t len)
 {
     // 非阻塞拦截机制：物理断线时直接舍弃上行交互，避免任务死锁或看门狗复位
-    if (!is_connected || client == NULL || payload == NULL) {
+    if (!is_connected || client == NULL || data == NULL) {
         ESP_LOGD(TAG, "Drop TX data: Websocket disconnected");
         return;
     }
-    
-    int len = strlen(payload);
-    esp_websocket_client_send_text(client, payload, len, portMAX_DELAY);
+
+    esp_websocket_client_send_text(client, data, (int)len, portMAX_DELAY);
 }
 
 void websocket_app_stop(void)
@@ -0,0 +1,404 @@
+/**
+ * @file bus_bench.c
+ * @brief 主机总线基准：不同订阅数下 sdui_bus 单条消息的分发开销
+ *
+ * 每个订阅规模 N 登记 N 个形如 "bench/tNNNN/v" 的精确主题，另加设备上常见的两条
+ * 通配订阅（"audio/cmd/#"、"sensor/+/temp"），然后测量：
+ *   hit_ns     sdui_bus_publish_local 命中一个订阅者
+ *   miss_ns    sdui_bus_publish_local 无人订阅的主题
+ *   wild_ns    命中通配订阅（"audio/cmd/record_start"）
+ *   route_ns   sdui_bus_route_down 完整信封（含信封扫描与 payload 拷贝）
+ *   linear_ns  参照：旧实现的定长数组逐个 strcmp，同一命中主题
+ *
+ * 每项为 -n 批（每批 -m 次分发）的单次耗时中位数。
+ *
+ * 第二张表测量大载荷的下行信封（base64 音频块、约 200 KB 的布局），每条消息：
+ *   legacy     参照：旧实现——sdui_json 扫描整个信封并反转义字符串，payload 再拷贝成 '\0' 结尾串
+ *   text       sdui_bus_subscribe 订阅者（原地扫描 + 一次 '\0' 结尾拷贝）
+ *   slice      sdui_bus_subscribe_slice 订阅者（原地扫描，借用原文）
+ * 输出单条耗时 (us) 与拷贝字节数：分发期间经 malloc / calloc / realloc 申请的字节数
+ * （这些路径上的每份 payload 拷贝都落在一次新申请里，--wrap 统计）。
+ *
+ * 第三张表测量上行信封（audio/record 音频块、ui/click），每秒信封数与每条申请字节数：
+ *   legacy     参照：旧实现——cJSON 建对象、cJSON_Parse 嵌入 payload、PrintUnformatted
+ *   validate   sdui_bus_publish_up（校验后原样嵌入）
+ *   raw        sdui_bus_publish_up_ex(SDUI_BUS_UP_JSON)（不校验）
+ * 发送为 host/port 的计数桩，结果只含信封生成。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "cJSON.h"
+#include "sdui_bus.h"
+#include "sdui_json.h"
+#include "websocket_manager.h"
+
+#define BENCH_TOPIC_LEN  32                 /* 旧订阅表的主题宽度，仅用于 linear 参照 */
+#define BENCH_ENV_BYTES  (8u * 1024 * 1024) /* 信封表每批处理的总字节数 */
+
+static volatile uint32_t s_hits;
+static volatile size_t   s_seen;
+
+static void on_msg(const char *payload) {
+    (void)payload;
+    s_hits++;
+}
+
+static void on_slice(const char *payload, size_t len) {
+    (void)payload;
+    s_seen += len;
+    s_hits++;
+}
+
+/* ======================================================
+ * 分配统计（链接期 --wrap 包装 libc 分配函数）
+ * ====================================================== */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+static size_t s_alloc_bytes;
+
+void *__wrap_malloc(size_t size) {
+    s_alloc_bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    s_alloc_bytes += n * size;
+    return __real_calloc(n, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    s_alloc_bytes += size;
+    return __real_realloc(ptr, size);
+}
+
+/* ======================================================
+ * 旧实现参照：定长数组 + strcmp 全表扫描
+ * ====================================================== */
+typedef struct {
+    char          topic[BENCH_TOPIC_LEN];
+    sdui_bus_cb_t cb;
+} linear_sub_t;
+
+static linear_sub_t *s_linear;
+static int           s_linear_n;
+
+static void linear_publish(const char *topic, const char *payload) {
+    for (int i = 0; i < s_linear_n; i++) {
+        if (strcmp(s_linear[i].topic, topic) == 0 && s_linear[i].cb) s_linear[i].cb(payload);
+    }
+}
+
+/* ======================================================
+ * 旧实现参照：sdui_json 扫描信封，payload 拷贝为 '\0' 结尾串后分发
+ * ====================================================== */
+typedef struct {
+    char        topic[64];
+    bool        has_topic;
+    bool        in_payload;
+    const char *pl_begin;
+    const char *pl_end;
+    char       *pl_str;
+} legacy_scan_t;
+
+static bool legacy_cb(void *ctx, const sdui_json_event_t *ev) {
+    legacy_scan_t *es = ctx;
+
+    if (ev->depth == 0) return ev->type == SDUI_JSON_OBJ_BEGIN || ev->type == SDUI_JSON_OBJ_END;
+    if (ev->depth != 1) return true;
+    if (es->in_payload) {
+        if (ev->type == SDUI_JSON_OBJ_END || ev->type == SDUI_JSON_ARR_END) {
+            es->pl_end     = ev->raw + 1;
+            es->in_payload = false;
+        }
+        return true;
+    }
+    if (!ev->key) return true;
+    if (!strcmp(ev->key, "topic") && ev->type == SDUI_JSON_STRING) {
+        snprintf(es->topic, sizeof(es->topic), "%s", ev->str);
+        es->has_topic = true;
+    } else if (!strcmp(ev->key, "payload")) {
+        if (ev->type == SDUI_JSON_OBJ_BEGIN || ev->type == SDUI_JSON_ARR_BEGIN) {
+            es->pl_begin   = ev->raw;
+            es->in_payload = true;
+        } else {
+            const char *src = ev->type == SDUI_JSON_STRING ? ev->str : ev->raw;
+            size_t      n   = ev->type == SDUI_JSON_STRING ? ev->len : ev->raw_len;
+            es->pl_str = malloc(n + 1);
+            if (!es->pl_str) return false;
+            memcpy(es->pl_str, src, n);
+            es->pl_str[n] = '\0';
+        }
+    }
+    return true;
+}
+
+static void legacy_route_down(const char *raw_json) {
+    legacy_scan_t es = {0};
+    if (!sdui_json_parse(raw_json, strlen(raw_json), 1, legacy_cb, &es) || !es.has_topic) {
+        free(es.pl_str);
+        return;
+    }
+    char *payload = es.pl_str;
+    if (!payload && es.pl_begin && es.pl_end) {
+        size_t n = (size_t)(es.pl_end - es.pl_begin);
+        payload  = malloc(n + 1);
+        if (!payload) return;
+        memcpy(payload, es.pl_begin, n);
+        payload[n] = '\0';
+    }
+    sdui_bus_publish_local(es.topic, payload);
+    free(payload);
+}
+
+/* ======================================================
+ * 旧实现参照：cJSON 组装上行信封
+ * ====================================================== */
+static void legacy_publish_up(const char *topic, const char *payload) {
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "topic", topic);
+    cJSON_AddStringToObject(root, "device_id", "AABBCCDDEEFF");
+    cJSON *payload_json = cJSON_Parse(payload);
+    if (payload_json) {
+        cJSON_AddItemToObject(root, "payload", payload_json);
+    } else {
+        cJSON_AddStringToObject(root, "payload", payload ? payload : "");
+    }
+    char *out_str = cJSON_PrintUnformatted(root);
+    if (out_str) {
+        websocket_send_json(out_str);
+        free(out_str);
+    }
+    cJSON_Delete(root);
+}
+
+/* ======================================================
+ * 计时
+ * ====================================================== */
+typedef enum { OP_LOCAL, OP_ROUTE, OP_LINEAR, OP_LEGACY, OP_UP_LEGACY, OP_UP_VALIDATE, OP_UP_RAW } bench_op_t;
+
+static const char *s_up_topic;   /* 上行测量的主题，payload 经 time_op 的 arg 传入 */
+
+static int cmp_f64(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* 返回单次分发耗时中位数 (ns)；命中数与预期不符时返回负值。alloc 非空时输出单次申请字节数 */
+static double time_op(bench_op_t op, const char *arg, uint32_t expect, int batches, int per_batch, size_t *alloc) {
+    double *ns = calloc((size_t)batches, sizeof(double));
+    for (int b = 0; b < batches; b++) {
+        s_hits        = 0;
+        s_alloc_bytes = 0;
+        int64_t t0 = esp_timer_get_time();
+        for (int i = 0; i < per_batch; i++) {
+            switch (op) {
+            case OP_LOCAL:  sdui_bus_publish_local(arg, "1"); break;
+            case OP_ROUTE:  sdui_bus_route_down(arg); break;
+            case OP_LINEAR: linear_publish(arg, "1"); break;
+            case OP_LEGACY: legacy_route_down(arg); break;
+            case OP_UP_LEGACY:   legacy_publish_up(s_up_topic, arg); break;
+            case OP_UP_VALIDATE: sdui_bus_publish_up(s_up_topic, arg); break;
+            case OP_UP_RAW:      sdui_bus_publish_up_ex(s_up_topic, arg, strlen(arg), SDUI_BUS_UP_JSON); break;
+            }
+        }
+        int64_t t1 = esp_timer_get_time();
+        if (s_hits != expect * (uint32_t)per_batch) {
+            free(ns);
+            return -1;
+        }
+        ns[b] = (double)(t1 - t0) * 1000.0 / per_batch;
+        if (alloc) *alloc = s_alloc_bytes / (size_t)per_batch;
+    }
+    qsort(ns, (size_t)batches, sizeof(double), cmp_f64);
+    double med = batches & 1 ? ns[batches / 2] : (ns[batches / 2 - 1] + ns[batches / 2]) / 2;
+    free(ns);
+    return med;
+}
+
+/* ======================================================
+ * 信封语料
+ * ====================================================== */
+static char *make_audio_env(size_t pcm_bytes) {
+    static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n   = (pcm_bytes + 2) / 3 * 4;
+    char  *env = malloc(n + 64);
+    size_t off = (size_t)sprintf(env, "{\"topic\":\"bench/env\",\"payload\":\"");
+    for (size_t i = 0; i < n; i++) env[off++] = b64[(i * 7) & 63];
+    strcpy(env + off, "\"}");
+    return env;
+}
+
+static char *make_layout_env(size_t target) {
+    char  *env = malloc(target + 512);
+    size_t off = (size_t)sprintf(env, "{\"topic\":\"bench/env\",\"payload\":"
+                                      "{\"type\":\"container\",\"flex\":\"column\",\"children\":[");
+    for (int i = 0; off < target; i++) {
+        off += (size_t)sprintf(env + off,
+                               "%s{\"type\":\"label\",\"id\":\"row_%05d\",\"text\":\"第 %d 条 \\\"消息\\\"\","
+                               "\"text_color\":\"#E0E0E0\",\"font_size\":16,\"w\":\"full\",\"pad\":4}",
+                               i ? "," : "", i, i);
+    }
+    strcpy(env + off, "]}}");
+    return env;
+}
+
+/* ======================================================
+ * 入口
+ * ====================================================== */
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-n batches] [-m dispatches] [subscriptions...]\n"
+            "  -n  timed batches per measurement (default 9)\n"
+            "  -m  dispatches per batch (default 100000)\n"
+            "  subscription counts default to 10 100 1000\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    int batches = 9, per_batch = 100000;
+    int sizes[16], nsizes = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            batches = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            per_batch = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && nsizes < (int)(sizeof(sizes) / sizeof(sizes[0]))) {
+            sizes[nsizes++] = atoi(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!nsizes) {
+        sizes[0] = 10, sizes[1] = 100, sizes[2] = 1000;
+        nsizes = 3;
+    }
+    if (batches < 1 || per_batch < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    printf("%8s %9s %9s %9s %9s %9s\n", "subs", "hit_ns", "miss_ns", "wild_ns", "route_ns", "linear_ns");
+
+    int failed = 0;
+    for (int s = 0; s < nsizes; s++) {
+        int n = sizes[s];
+        if (n < 1) continue;
+
+        sdui_bus_init();
+        sdui_bus_subscribe("audio/cmd/#", on_msg);
+        sdui_bus_subscribe("sensor/+/temp", on_msg);
+
+        free(s_linear);
+        s_linear   = calloc((size_t)n, sizeof(*s_linear));
+        s_linear_n = n;
+        for (int i = 0; i < n; i++) {
+            char topic[BENCH_TOPIC_LEN];
+            snprintf(topic, sizeof(topic), "bench/t%04d/v", i);
+            sdui_bus_subscribe(topic, on_msg);
+            memcpy(s_linear[i].topic, topic, sizeof(topic));
+            s_linear[i].cb = on_msg;
+        }
+
+        /* 命中表中间的主题：线性扫描平均要比较一半 */
+        char hit[BENCH_TOPIC_LEN], env[96];
+        snprintf(hit, sizeof(hit), "bench/t%04d/v", n / 2);
+        snprintf(env, sizeof(env), "{\"topic\":\"%s\",\"payload\":{\"v\":1}}", hit);
+
+        double r[5] = {
+            time_op(OP_LOCAL, hit, 1, batches, per_batch, NULL),
+            time_op(OP_LOCAL, "bench/none/v", 0, batches, per_batch, NULL),
+            time_op(OP_LOCAL, "audio/cmd/record_start", 1, batches, per_batch, NULL),
+            time_op(OP_ROUTE, env, 1, batches, per_batch, NULL),
+            time_op(OP_LINEAR, hit, 1, batches, per_batch, NULL),
+        };
+        printf("%8d", n);
+        for (int i = 0; i < 5; i++) {
+            if (r[i] < 0) failed++;
+            printf(" %9.1f", r[i]);
+        }
+        printf("\n");
+    }
+    free(s_linear);
+
+    /* ---- 大载荷信封：旧实现 / text 订阅 / slice 订阅 ---- */
+    static const struct {
+        const char *name;
+        size_t      bytes;    /* 音频为 PCM 字节数（Base64 后约 4/3），布局为目标载荷大小 */
+        bool        layout;
+    } msgs[] = {
+        {"audio_512", 512, false},
+        {"audio_16k", 16 * 1024, false},
+        {"layout_200k", 200 * 1024, true},
+    };
+
+    printf("\n%-12s %8s %10s %9s %10s %9s %10s %9s\n", "envelope", "bytes", "legacy_us", "legacy_B",
+           "text_us", "text_B", "slice_us", "slice_B");
+    for (size_t m = 0; m < sizeof(msgs) / sizeof(msgs[0]); m++) {
+        char  *env  = msgs[m].layout ? make_layout_env(msgs[m].bytes) : make_audio_env(msgs[m].bytes);
+        size_t len  = strlen(env);
+        int    reps = len < BENCH_ENV_BYTES ? (int)(BENCH_ENV_BYTES / len) : 1;
+        double us[3];
+        size_t copied[3];
+
+        sdui_bus_init();
+        sdui_bus_subscribe("bench/env", on_msg);
+        us[0] = time_op(OP_LEGACY, env, 1, batches, reps, &copied[0]);
+        us[1] = time_op(OP_ROUTE, env, 1, batches, reps, &copied[1]);
+        sdui_bus_init();
+        sdui_bus_subscribe_slice("bench/env", on_slice);
+        us[2] = time_op(OP_ROUTE, env, 1, batches, reps, &copied[2]);
+
+        printf("%-12s %8zu", msgs[m].name, len);
+        for (int i = 0; i < 3; i++) {
+            if (us[i] < 0) failed++;
+            printf(" %10.2f %9zu", us[i] / 1000.0, copied[i]);
+        }
+        printf("\n");
+        free(env);
+    }
+    sdui_bus_init();
+
+    /* ---- 上行信封：旧实现 / 校验 / 免校验 ---- */
+    char audio_pl[800];
+    {
+        /* 与 audio_record_task 相同：512 字节单声道 PCM 的 Base64（684 字符） */
+        static const char b64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        int off = snprintf(audio_pl, sizeof(audio_pl), "{\"state\": \"stream\", \"data\": \"");
+        for (int i = 0; i < 684; i++) audio_pl[off++] = b64[(i * 7) & 63];
+        snprintf(audio_pl + off, sizeof(audio_pl) - (size_t)off, "\"}");
+    }
+    static const struct {
+        const char *name;
+        const char *topic;
+    } ups[] = {
+        {"audio/record", "audio/record"},
+        {"ui/click", "ui/click"},
+    };
+    const char *up_payloads[] = {audio_pl, "{\"id\":\"btn_confirm\"}"};
+
+    sdui_bus_set_device_id("AABBCCDDEEFF");
+    printf("\n%-12s %8s %11s %9s %11s %9s %11s %9s\n", "uplink", "bytes", "legacy_eps", "legacy_B",
+           "valid_eps", "valid_B", "raw_eps", "raw_B");
+    for (size_t u = 0; u < sizeof(ups) / sizeof(ups[0]); u++) {
+        static const bench_op_t ops[3] = {OP_UP_LEGACY, OP_UP_VALIDATE, OP_UP_RAW};
+        s_up_topic = ups[u].topic;
+        printf("%-12s %8zu", ups[u].name, strlen(up_payloads[u]));
+        for (int i = 0; i < 3; i++) {
+            size_t copied = 0;
+            double ns     = time_op(ops[i], up_payloads[u], 0, batches, per_batch / 10 + 1, &copied);
+            if (ns < 0) failed++;
+            printf(" %11.0f %9zu", ns > 0 ? 1e9 / ns : 0.0, copied);
+        }
+        printf("\n");
+    }
+
+    if (failed) fprintf(stderr, "%d measurement(s) dispatched to the wrong number of subscribers\n", failed);
+    return failed ? 1 : 0;
+}
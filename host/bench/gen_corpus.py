@@ -0,0 +1,230 @@
+#!/usr/bin/env python3
+"""生成 sdui_bench 的基准语料（确定性输出，同一版本脚本每次生成的文件逐字节相同）
+
+    python3 host/bench/gen_corpus.py build-host/corpus
+
+每个文件是一个信封或信封数组；"setup": true 的信封在每轮计时前回放，不计时。
+布局与样式取自 server.py 的 AI 对话页（SDUI_STYLES / build_ai_layout），
+图片编码与 server.py 的 image_attrs() 一致。
+"""
+import base64
+import json
+import os
+import sys
+
+STYLES = {
+    "bubble":      {"radius": 10, "pad": 10, "text_color": "#ffffff"},
+    "bubble_user": {"bg_color": "#2ecc71"},
+    "bubble_ai":   {"bg_color": "#333333"},
+    "bubble_text": {"font_size": 16},
+    "cell":        {"bg_color": "#222222", "radius": 4, "pad": 2, "text_color": "#dddddd"},
+}
+
+GRID_SIZES = (64, 512, 4096)
+
+
+def env(topic, payload, setup=False):
+    e = {"topic": topic, "payload": payload}
+    if setup:
+        e["setup"] = True
+    return e
+
+
+def styles(setup=True):
+    return env("ui/styles", STYLES, setup)
+
+
+# ---- AI 对话页 ----
+def chat_layout(rounds):
+    items = []
+    for i in range(rounds):
+        items.append({"text": f"Question {i}: how is the weather today?", "class": "bubble_user"})
+        items.append({"text": f"Answer {i}: sunny, 24 degrees, light wind from the south-east.", "class": "bubble_ai"})
+    return {
+        "reconcile": True, "flex": "column", "justify": "start", "align_items": "center", "gap": 10,
+        "children": [
+            {"type": "label", "id": "status_label", "text": "Ready", "font_size": 16, "text_color": "#f1c40f"},
+            {"type": "container", "flex": "row", "justify": "space_between", "w": "90%", "h": 30, "children": [
+                {"type": "label", "id": "stat_rounds", "text": f"Rounds: {rounds}", "font_size": 14, "text_color": "#aaaaaa"},
+                {"type": "label", "id": "stat_tokens", "text": f"Tokens: {rounds * 137}", "font_size": 14, "text_color": "#aaaaaa"},
+            ]},
+            {"type": "list", "id": "scroll_box", "w": "95%", "h": 260, "gap": 10, "bg_color": "#111111",
+             "pad": 10, "radius": 10, "row_class": "bubble", "label_class": "bubble_text",
+             "max_items": 200, "follow": True, "items": items},
+            {"type": "container", "flex": "row", "gap": 20, "w": "full", "justify": "center", "children": [
+                {"type": "button", "id": "btn_new_chat", "text": "New", "w": 100, "h": 50,
+                 "bg_color": "#e74c3c", "radius": 25, "on_click": "server://ui/new_chat"},
+                {"type": "button", "id": "btn_rec", "text": "Hold to Talk", "w": 140, "h": 50,
+                 "bg_color": "#3498db", "radius": 25,
+                 "on_press": "local://audio/cmd/record_start", "on_release": "local://audio/cmd/record_stop",
+                 "anim": {"type": "color_pulse", "color_a": "#3498db", "color_b": "#2980b9",
+                          "duration": 800, "repeat": -1}},
+            ]},
+        ],
+    }
+
+
+# ---- 网格：N 个带 id 的标签，覆盖 64 / 512 / 4096 组件量级 ----
+def grid_layout(n, reconcile=False, tag=""):
+    cells = [{"type": "label", "id": f"c{i}", "class": "cell", "text": f"{tag}{i}"} for i in range(n)]
+    root = {"flex": "column", "children": [
+        {"type": "container", "id": "grid", "flex": "row_wrap", "w": "full", "h": "full",
+         "gap": 2, "pad": 4, "scrollable": True, "children": cells},
+    ]}
+    if reconcile:
+        root["reconcile"] = True
+    return root
+
+
+def grid_update(n):
+    return {"ops": [{"id": f"c{i}", "text": f"#{i}", "text_color": "#ffcc00"} for i in range(n)]}
+
+
+def grid_reconcile(n):
+    """同结构布局，约 1/8 的标签文本变化：只有这些节点应被 patched"""
+    root = grid_layout(n, reconcile=True)
+    for i, cell in enumerate(root["children"][0]["children"]):
+        if i % 8 == 0:
+            cell["text"] = f"*{i}"
+    return root
+
+
+def grid_replace(n):
+    """与 grid_reconcile 相同的变化，但不带 reconcile：全量重建，作为增量模式的对照"""
+    root = grid_reconcile(n)
+    del root["reconcile"]
+    return root
+
+
+def grid_bound(n):
+    """约 1/8 的标签文本绑定状态变量 score，其余为普通文本"""
+    root = grid_layout(n)
+    for i, cell in enumerate(root["children"][0]["children"]):
+        if i % 8 == 0:
+            cell["text"] = "{score} pts"
+    return root
+
+
+def grid_bound_update(n):
+    """与 state/set 等效的 ui/update：逐个改写同一批标签"""
+    return {"ops": [{"id": f"c{i}", "text": "42 pts"} for i in range(0, n, 8)]}
+
+
+# ---- 聊天气泡：样式类与逐节点本地样式的对照 ----
+BUBBLE_CLASSES = ("bubble", "bubble_ai", "bubble_text")
+
+
+def bubble_layout(n, inline=False):
+    """n 个气泡标签；inline 时把三个类的属性展开写在每个节点上"""
+    bubbles = []
+    for i in range(n):
+        node = {"type": "label", "id": f"b{i}", "w": "90%", "text": f"Answer {i}: sunny, 24 degrees."}
+        if inline:
+            for cls in BUBBLE_CLASSES:
+                node.update(STYLES[cls])
+        else:
+            node["class"] = " ".join(BUBBLE_CLASSES)
+        bubbles.append(node)
+    return {"flex": "column", "gap": 10, "children": bubbles}
+
+
+# ---- 深层嵌套 ----
+def nested_layout(depth):
+    node = {"type": "label", "id": "leaf", "text": "leaf"}
+    for i in range(depth):
+        node = {"type": "container", "id": f"n{i}", "w": "full", "h": "full", "pad": 1, "children": [node]}
+    return {"flex": "column", "children": [node]}
+
+
+# ---- 图片：240×240 图标（纯色底 + 色块），raw565 与 rle565 ----
+def rgb565(r, g, b):
+    v = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3)
+    return bytes((v & 0xFF, v >> 8))
+
+
+def icon_pixels(w, h):
+    bg, fg, accent = rgb565(30, 30, 40), rgb565(46, 204, 113), rgb565(241, 196, 15)
+    rows = []
+    for y in range(h):
+        row = bytearray()
+        for x in range(w):
+            if 40 <= x < 200 and 40 <= y < 200 and (x - 120) ** 2 + (y - 120) ** 2 < 80 ** 2:
+                row += fg
+            elif 100 <= x < 140 and 20 <= y < 220:
+                row += accent
+            else:
+                row += bg
+        rows.append(bytes(row))
+    return b"".join(rows)
+
+
+def encode_rle565(px565):
+    """与 server.py rle565_tokens() 相同的编码"""
+    px = [px565[i:i + 2] for i in range(0, len(px565), 2)]
+    out, i, n = bytearray(), 0, len(px)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and px[i + run] == px[i]:
+            run += 1
+        if run >= 2:
+            out += bytes([0x7F + run]) + px[i]
+            i += run
+            continue
+        j = i + 1
+        while j < n and j - i < 128 and not (j + 1 < n and px[j + 1] == px[j]):
+            j += 1
+        out += bytes([j - i - 1]) + b"".join(px[i:j])
+        i = j
+    return bytes(out)
+
+
+def image_layout(fmt, w=240, h=240):
+    px = icon_pixels(w, h)
+    data = encode_rle565(px) if fmt == "rle565" else px
+    node = {"type": "image", "id": "cover", "w": w, "h": h, "img_w": w, "img_h": h,
+            "src": base64.b64encode(data).decode("ascii")}
+    if fmt == "rle565":
+        node["format"] = "rle565"
+    return {"flex": "column", "justify": "center", "align_items": "center", "children": [node]}
+
+
+def corpus():
+    files = {
+        "chat_empty.json":    [styles(), env("ui/layout", chat_layout(0))],
+        "chat_20.json":       [styles(), env("ui/layout", chat_layout(10))],
+        "chat_append.json":   [styles(), env("ui/layout", chat_layout(10), setup=True),
+                               env("ui/update", {"id": "scroll_box", "append": [
+                                   {"text": "Another question about the forecast?", "class": "bubble_user"}]})],
+        "bubbles_20.json":    [styles(), env("ui/layout", bubble_layout(20))],
+        "bubbles_20_inline.json": [styles(), env("ui/layout", bubble_layout(20, inline=True))],
+        "nested_64.json":     [env("ui/layout", nested_layout(64))],
+        "image_raw565.json":  [env("ui/layout", image_layout("raw565"))],
+        "image_rle565.json":  [env("ui/layout", image_layout("rle565"))],
+    }
+    for n in GRID_SIZES:
+        files[f"grid_{n}.json"] = [styles(), env("ui/layout", grid_layout(n))]
+        files[f"update_{n}.json"] = [styles(), env("ui/layout", grid_layout(n), setup=True),
+                                     env("ui/update", grid_update(n))]
+        files[f"reconcile_{n}.json"] = [styles(), env("ui/layout", grid_layout(n, reconcile=True), setup=True),
+                                        env("ui/layout", grid_reconcile(n))]
+        files[f"full_{n}.json"] = [styles(), env("ui/layout", grid_layout(n), setup=True),
+                                   env("ui/layout", grid_replace(n))]
+        files[f"state_{n}.json"] = [styles(), env("ui/layout", grid_bound(n), setup=True),
+                                    env("state/set", {"score": 42})]
+        files[f"state_update_{n}.json"] = [styles(), env("ui/layout", grid_bound(n), setup=True),
+                                           env("ui/update", grid_bound_update(n))]
+    return files
+
+
+def main():
+    out_dir = sys.argv[1] if len(sys.argv) > 1 else "corpus"
+    os.makedirs(out_dir, exist_ok=True)
+    for name, envelopes in sorted(corpus().items()):
+        path = os.path.join(out_dir, name)
+        with open(path, "w", encoding="utf-8") as f:
+            json.dump(envelopes, f, ensure_ascii=False, separators=(",", ":"))
+        print(f"{path}: {os.path.getsize(path)} B")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,176 @@
+/**
+ * @file ids_bench.c
+ * @brief 主机 ID 注册表基准：ui/update 按 id 定位组件的耗时
+ *
+ * 与 gen_corpus.py 的 grid 语料相同的 id（c0 … c{N-1}），N 默认 64 / 512 / 4096，输出：
+ *   put_ns     sdui_ids_put 单次耗时 (ns)，含扩容（每轮从空表登记 N 个）
+ *   hit_ns     sdui_ids_get 命中的单次耗时 (ns)，按打乱的顺序查全部 id
+ *   miss_ns    sdui_ids_get 未命中的单次耗时 (ns)
+ *   scan_ns    原实现的参照：对 {id, obj} 数组线性 strcmp 查找 (ns)，
+ *              原表固定 64 项，这里不设上限以显示线性扫描随 N 的增长
+ *   rev_ns     原实现 action_event_cb 的参照：按对象指针线性反查 id (ns)；
+ *              现在 id 挂在对象的元数据上，反查为一次取址
+ * 每列为 -r 次运行的中位数，每次运行至少 -m 次操作。查找结果累加到校验和，
+ * 防止编译器消除查找；命中结果与期望对象不一致时返回 1。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "sdui_ids.h"
+
+#define ID_LEN    12
+#define RUNS_MAX  15
+
+typedef struct {
+    const char *id;
+    void       *obj;
+} scan_entry_t;
+
+static int cmp_f64(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, (size_t)n, sizeof(double), cmp_f64);
+    return v[n / 2];
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-m ops] [-r runs] [widgets...]\n"
+            "  -m  minimum operations per run (default 200000)\n"
+            "  -r  runs per widget count, median reported (default 5, max %d)\n"
+            "  widget counts default to 64 512 4096\n",
+            argv0, RUNS_MAX);
+}
+
+/* 线性参照：原 sdui_parser_find_by_id */
+static void *scan_find(const scan_entry_t *t, int n, const char *id) {
+    for (int i = 0; i < n; i++)
+        if (!strcmp(t[i].id, id)) return t[i].obj;
+    return NULL;
+}
+
+/* 线性参照：原 action_event_cb 按对象反查 id */
+static const char *scan_rev(const scan_entry_t *t, int n, const void *obj) {
+    for (int i = 0; i < n; i++)
+        if (t[i].obj == obj) return t[i].id;
+    return NULL;
+}
+
+static int bench(int n, int ops, int runs, uintptr_t *sum) {
+    char         *ids   = malloc((size_t)n * ID_LEN);
+    char         *miss  = malloc((size_t)n * ID_LEN);
+    int          *order = malloc((size_t)n * sizeof(int));
+    scan_entry_t *table = malloc((size_t)n * sizeof(scan_entry_t));
+    double        put[RUNS_MAX], hit[RUNS_MAX], mis[RUNS_MAX], scan[RUNS_MAX], rev[RUNS_MAX];
+    int           bad = 0;
+    if (!ids || !miss || !order || !table) return 1;
+
+    uint32_t s = 0x2545F491u;
+    for (int i = 0; i < n; i++) {
+        snprintf(ids + i * ID_LEN, ID_LEN, "c%d", i);
+        snprintf(miss + i * ID_LEN, ID_LEN, "m%d", i);
+        table[i].id  = ids + i * ID_LEN;
+        table[i].obj = &table[i];
+        order[i]     = i;
+    }
+    for (int i = n - 1; i > 0; i--) {   // Fisher-Yates，xorshift
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        int j = (int)(s % (uint32_t)(i + 1)), t = order[i];
+        order[i] = order[j];
+        order[j] = t;
+    }
+
+    int reps = (ops + n - 1) / n;
+    for (int r = 0; r < runs; r++) {
+        int64_t t0 = esp_timer_get_time();
+        for (int k = 0; k < reps; k++) {
+            sdui_ids_clear();
+            for (int i = 0; i < n; i++) sdui_ids_put(table[i].id, table[i].obj);
+        }
+        put[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)reps * n);
+
+        t0 = esp_timer_get_time();
+        for (int k = 0; k < reps; k++) {
+            for (int i = 0; i < n; i++) {
+                void *obj = sdui_ids_get(table[order[i]].id);
+                bad += obj != table[order[i]].obj;
+                *sum += (uintptr_t)obj;
+            }
+        }
+        hit[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)reps * n);
+
+        t0 = esp_timer_get_time();
+        for (int k = 0; k < reps; k++)
+            for (int i = 0; i < n; i++) *sum += (uintptr_t)sdui_ids_get(miss + order[i] * ID_LEN);
+        mis[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)reps * n);
+
+        // 线性扫描是 O(N)，按 N 缩减次数，保持每次运行的总耗时相近
+        int scan_reps = (reps + n - 1) / n;
+        t0 = esp_timer_get_time();
+        for (int k = 0; k < scan_reps; k++)
+            for (int i = 0; i < n; i++) *sum += (uintptr_t)scan_find(table, n, table[order[i]].id);
+        scan[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)scan_reps * n);
+
+        t0 = esp_timer_get_time();
+        for (int k = 0; k < scan_reps; k++)
+            for (int i = 0; i < n; i++) *sum += (uintptr_t)scan_rev(table, n, table[order[i]].obj);
+        rev[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)scan_reps * n);
+    }
+    if (sdui_ids_count() != n) bad++;
+
+    printf("%7d %8.1f %8.1f %8.1f %9.1f %9.1f\n", n, median(put, runs), median(hit, runs), median(mis, runs),
+           median(scan, runs), median(rev, runs));
+    if (bad) fprintf(stderr, "%d: %d lookups returned the wrong widget\n", n, bad);
+    free(ids);
+    free(miss);
+    free(order);
+    free(table);
+    return bad ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    int ops = 200000, runs = 5;
+    int counts[16], ncounts = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            ops = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && ncounts < (int)(sizeof(counts) / sizeof(counts[0]))) {
+            counts[ncounts++] = atoi(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!ncounts) {
+        counts[0] = 64, counts[1] = 512, counts[2] = 4096;
+        ncounts = 3;
+    }
+    if (ops < 1 || runs < 1 || runs > RUNS_MAX) {
+        usage(argv[0]);
+        return 2;
+    }
+    for (int c = 0; c < ncounts; c++) {
+        if (counts[c] < 1) {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    sdui_ids_init();
+    uintptr_t sum    = 0;
+    int       failed = 0;
+    printf("median of %d runs, >= %d ops each\n", runs, ops);
+    printf("%7s %8s %8s %8s %9s %9s\n", "widgets", "put_ns", "hit_ns", "miss_ns", "scan_ns", "rev_ns");
+    for (int c = 0; c < ncounts; c++) failed += bench(counts[c], ops, runs, &sum);
+    printf("checksum %lx\n", (unsigned long)sum);
+    return failed ? 1 : 0;
+}
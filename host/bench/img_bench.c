@@ -0,0 +1,180 @@
+/**
+ * @file img_bench.c
+ * @brief 主机图片基准：rle565 的线路体积与解码速度
+ *
+ * 生成四张 240×240 RGB565 合成样例（图标、纯色封面 + 色块、水平渐变、随机噪声），
+ * 用与 server.py rle565_tokens() 相同的规则编码，输出：
+ *   raw_b64 / rle_b64   raw565 与 rle565 经 Base64 后的线路字节数
+ *   ratio               raw_b64 / rle_b64
+ *   decode_us           sdui_img_rle565_decode 单次耗时 (us)，-n 批的中位数（每批 -m 次）
+ *   mb_s                解码输出速度 (MB/s，1 MB = 10^6 B)
+ * 每张样例解码后与原图逐字节比对，不一致时返回 1。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "sdui_img_codec.h"
+
+#define IMG_W   240
+#define IMG_H   240
+#define IMG_PX  (IMG_W * IMG_H)
+
+static uint16_t s_px[IMG_PX];
+static uint8_t  s_rle[IMG_PX * 2 + IMG_PX / 128 + 16];   // 最坏情况：全字面量，每 128 像素一个操作字节
+static uint8_t  s_out[IMG_PX * 2];
+
+static uint16_t rgb565(int r, int g, int b) {
+    return (uint16_t)(((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3));
+}
+
+/* ======================================================
+ * 样例
+ * ====================================================== */
+// 图标：纯色底 + 圆、矩形与三角形
+static void gen_icon(void) {
+    uint16_t bg = rgb565(32, 36, 48), c1 = rgb565(46, 204, 113), c2 = rgb565(241, 196, 15), c3 = rgb565(231, 76, 60);
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            uint16_t c  = bg;
+            int      dx = x - 120, dy = y - 100;
+            if (dx * dx + dy * dy <= 60 * 60) c = c1;
+            if (x >= 40 && x < 110 && y >= 160 && y < 210) c = c2;
+            if (y >= 150 && y < 220 && x >= 130 + (220 - y) / 2 && x < 210 - (220 - y) / 2) c = c3;
+            s_px[y * IMG_W + x] = c;
+        }
+    }
+}
+
+// 纯色封面 + 色块：大面积底色上排列 4×3 的色块
+static void gen_cover(void) {
+    uint16_t bg = rgb565(20, 20, 20);
+    for (int y = 0; y < IMG_H; y++) {
+        for (int x = 0; x < IMG_W; x++) {
+            uint16_t c  = bg;
+            int      bx = (x - 20) / 52, by = (y - 40) / 60;
+            if (x >= 20 && y >= 40 && bx < 4 && by < 3 && (x - 20) % 52 < 44 && (y - 40) % 60 < 48)
+                c = rgb565(60 * bx + 40, 80 * by + 40, 200 - 40 * bx);
+            s_px[y * IMG_W + x] = c;
+        }
+    }
+}
+
+// 水平渐变：颜色只随 x 变化，R/B 各 32 级
+static void gen_gradient(void) {
+    for (int y = 0; y < IMG_H; y++)
+        for (int x = 0; x < IMG_W; x++) s_px[y * IMG_W + x] = rgb565(x * 255 / (IMG_W - 1), 64, 255 - x * 255 / (IMG_W - 1));
+}
+
+// 随机噪声：照片的近似，几乎没有相邻重复像素
+static void gen_noise(void) {
+    uint32_t s = 0x2545F491u;
+    for (int i = 0; i < IMG_PX; i++) {
+        s ^= s << 13;
+        s ^= s >> 17;
+        s ^= s << 5;
+        s_px[i] = (uint16_t)s;
+    }
+}
+
+/* ======================================================
+ * 编码：与 server.py rle565_tokens() 相同
+ * ====================================================== */
+static size_t encode_rle565(const uint16_t *px, int n, uint8_t *out) {
+    size_t o = 0;
+    int    i = 0;
+    while (i < n) {
+        int run = 1;
+        while (i + run < n && run < 128 && px[i + run] == px[i]) run++;
+        if (run >= 2) {
+            out[o++] = (uint8_t)(0x7F + run);
+            memcpy(out + o, &px[i], 2);
+            o += 2;
+            i += run;
+            continue;
+        }
+        // 字面量：延伸到下一段重复之前
+        int j = i + 1;
+        while (j < n && j - i < 128 && !(j + 1 < n && px[j + 1] == px[j])) j++;
+        out[o++] = (uint8_t)(j - i - 1);
+        memcpy(out + o, &px[i], (size_t)(j - i) * 2);
+        o += (size_t)(j - i) * 2;
+        i = j;
+    }
+    return o;
+}
+
+static size_t b64_len(size_t n) { return (n + 2) / 3 * 4; }
+
+static int cmp_f64(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-n batches] [-m decodes]\n"
+            "  -n  timed batches per sample (default 9)\n"
+            "  -m  decodes per batch (default 200)\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    static const struct {
+        const char *name;
+        void (*gen)(void);
+    } samples[] = {
+        {"icon", gen_icon},
+        {"cover", gen_cover},
+        {"gradient", gen_gradient},
+        {"noise", gen_noise},
+    };
+    int batches = 9, per_batch = 200;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            batches = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            per_batch = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (batches < 1 || per_batch < 1) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    double *us = calloc((size_t)batches, sizeof(double));
+    if (!us) return 1;
+    printf("%dx%d RGB565, median of %d batches x %d decodes\n", IMG_W, IMG_H, batches, per_batch);
+    printf("%-9s %8s %8s %6s %9s %7s\n", "sample", "raw_b64", "rle_b64", "ratio", "decode_us", "mb_s");
+
+    int failed = 0;
+    for (size_t s = 0; s < sizeof(samples) / sizeof(samples[0]); s++) {
+        samples[s].gen();
+        size_t rle = encode_rle565(s_px, IMG_PX, s_rle);
+
+        memset(s_out, 0, sizeof(s_out));
+        if (sdui_img_rle565_decode(s_rle, rle, s_out, sizeof(s_out)) != (int32_t)sizeof(s_out) ||
+            memcmp(s_out, s_px, sizeof(s_out)) != 0) {
+            fprintf(stderr, "%s: decode mismatch\n", samples[s].name);
+            failed++;
+            continue;
+        }
+
+        for (int b = 0; b < batches; b++) {
+            int64_t t0 = esp_timer_get_time();
+            for (int k = 0; k < per_batch; k++) sdui_img_rle565_decode(s_rle, rle, s_out, sizeof(s_out));
+            us[b] = (double)(esp_timer_get_time() - t0) / per_batch;
+        }
+        qsort(us, (size_t)batches, sizeof(double), cmp_f64);
+        double med = us[batches / 2];
+        size_t raw = b64_len(sizeof(s_px)), enc = b64_len(rle);
+        printf("%-9s %8zu %8zu %5.1fx %9.1f %7.0f\n", samples[s].name, raw, enc, (double)raw / (double)enc, med,
+               med > 0 ? sizeof(s_out) / med : 0.0);
+    }
+    free(us);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file particles_bench.c
+ * @brief 主机粒子基准：sdui_particles_step 的单帧耗时与刷新面积
+ *
+ * 与 particle 组件相同的设置：200×200 RGB565 画布（黑底）、半径 3。
+ * 每个粒子数先空跑 64 帧（首帧全部重生，alpha 32 帧后归零，之后进入稳态），
+ * 再计时 -n 帧，输出：
+ *   us_frame   单帧平均耗时 (us)，-r 次运行取中位数
+ *   dirty_px   每帧 dirty 矩形的平均面积（调用方据此做局部失效；原实现每帧失效整张画布）
+ * 画布内容每帧做一次校验和，防止编译器把绘制当作无用计算消除。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "esp_timer.h"
+#include "sdui_particles.h"
+
+#define CANVAS_W   200
+#define CANVAS_H   200
+#define RADIUS     3
+#define COLOR      0xFD20   /* 橙色 */
+#define WARMUP     64
+#define RUNS_MAX   15
+
+static int cmp_f64(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-n frames] [-r runs] [particles...]\n"
+            "  -n  timed frames per run (default 3000)\n"
+            "  -r  runs per particle count, median reported (default 3, max %d)\n"
+            "  particle counts default to 30 128 256 512\n",
+            argv0, RUNS_MAX);
+}
+
+int main(int argc, char **argv) {
+    int frames = 3000, runs = 3;
+    int counts[16], ncounts = 0;
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            frames = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else if (argv[i][0] != '-' && ncounts < (int)(sizeof(counts) / sizeof(counts[0]))) {
+            counts[ncounts++] = atoi(argv[i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (!ncounts) {
+        counts[0] = 30, counts[1] = 128, counts[2] = 256, counts[3] = 512;
+        ncounts = 4;
+    }
+    if (frames < 1 || runs < 1 || runs > RUNS_MAX) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    uint16_t *buf = calloc(CANVAS_W * CANVAS_H, sizeof(uint16_t));
+    if (!buf) return 1;
+
+    printf("canvas %dx%d, radius %d, %d frames, median of %d runs\n", CANVAS_W, CANVAS_H, RADIUS, frames, runs);
+    printf("%9s %9s %9s\n", "particles", "us_frame", "dirty_px");
+
+    uint32_t sum = 0;
+    for (int c = 0; c < ncounts; c++) {
+        double   us[RUNS_MAX];
+        uint64_t dirty_px = 0;
+        for (int r = 0; r < runs; r++) {
+            memset(buf, 0, CANVAS_W * CANVAS_H * sizeof(uint16_t));
+            sdui_particles_t *ps = sdui_particles_create(counts[c], buf, CANVAS_W, CANVAS_H, COLOR, RADIUS);
+            if (!ps) {
+                free(buf);
+                return 1;
+            }
+            sdui_particles_rect_t d;
+            for (int f = 0; f < WARMUP; f++) sdui_particles_step(ps, &d);
+
+            uint64_t px = 0;
+            int64_t  t0 = esp_timer_get_time();
+            for (int f = 0; f < frames; f++) {
+                if (sdui_particles_step(ps, &d)) px += (uint64_t)(d.x2 - d.x1 + 1) * (uint64_t)(d.y2 - d.y1 + 1);
+                sum += buf[(f * 7919) % (CANVAS_W * CANVAS_H)];
+            }
+            us[r] = (double)(esp_timer_get_time() - t0) / frames;
+            if (r == 0) dirty_px = px / (uint64_t)frames;
+            sdui_particles_destroy(ps);
+        }
+        qsort(us, (size_t)runs, sizeof(double), cmp_f64);
+        printf("%9d %9.1f %9llu\n", counts[c], us[runs / 2], (unsigned long long)dirty_px);
+    }
+    fprintf(stderr, "checksum %u\n", (unsigned)sum);
+    free(buf);
+    return 0;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file props_bench.c
+ * @brief 主机属性分派基准：建 500 节点布局时逐节点取属性的耗时
+ *
+ * 只测组件创建之前的取属性部分（LVGL 调用不计），两种节点形态：
+ *   grid     gen_corpus.py 网格的标签 {type, id, class, text}
+ *   inline   bubbles_20_inline 的气泡标签，9 个键（样式逐节点展开）
+ * 每种形态输出：
+ *   legacy_ns  原实现：create_widget / create_label / apply_classes / apply_common_style /
+ *              bind_actions / finish_widget / attach_meta / parse_node 依次调用
+ *              cJSON_GetObjectItem（不区分大小写，逐个成员比较），type / align / long_mode
+ *              取值走 strcmp 链，签名过滤逐键 strcmp
+ *   token_ns   现实现：node_props_scan 遍历一次成员、经 sdui_tok_lookup 填属性表，
+ *              之后按记号查表，取值转记号后 switch
+ *   speedup    legacy_ns / token_ns
+ * 单位为每节点 ns，-r 次运行的中位数，每次运行至少 -m 个节点。
+ * 两种实现取到的属性累加到校验和，结果不一致时返回 1。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "cJSON.h"
+#include "esp_timer.h"
+#include "sdui_props.h"
+
+#define NODES     500
+#define RUNS_MAX  15
+
+typedef struct {
+    cJSON *v[SDUI_TOK_NUM_KEYS];
+} node_props_t;
+
+#define NP(p, key) ((p)->v[SDUI_TOK_##key])
+
+/* 原实现按调用顺序查找的键（label 节点） */
+static const char *const s_legacy_keys[] = {
+    "text", "long_mode",                                                  /* create_label */
+    "class",                                                              /* apply_classes */
+    "w", "h", "align", "bg_color", "bg_opa", "pad", "radius", "gap",      /* apply_common_style */
+    "border_w", "border_color", "text_color", "font_size", "shadow_w",
+    "shadow_color", "opa", "hidden",
+    "on_click", "on_press", "on_release",                                 /* bind_actions */
+    "anim",                                                               /* finish_widget */
+    "id",                                                                 /* attach_meta */
+    "children",                                                           /* parse_node */
+};
+#define LEGACY_KEY_COUNT (sizeof(s_legacy_keys) / sizeof(s_legacy_keys[0]))
+
+/* 与 s_legacy_keys 同序的记号 */
+static const sdui_tok_t s_token_keys[LEGACY_KEY_COUNT] = {
+    SDUI_TOK_TEXT, SDUI_TOK_LONG_MODE,
+    SDUI_TOK_CLASS,
+    SDUI_TOK_W, SDUI_TOK_H, SDUI_TOK_ALIGN, SDUI_TOK_BG_COLOR, SDUI_TOK_BG_OPA, SDUI_TOK_PAD, SDUI_TOK_RADIUS,
+    SDUI_TOK_GAP, SDUI_TOK_BORDER_W, SDUI_TOK_BORDER_COLOR, SDUI_TOK_TEXT_COLOR, SDUI_TOK_FONT_SIZE,
+    SDUI_TOK_SHADOW_W, SDUI_TOK_SHADOW_COLOR, SDUI_TOK_OPA, SDUI_TOK_HIDDEN,
+    SDUI_TOK_ON_CLICK, SDUI_TOK_ON_PRESS, SDUI_TOK_ON_RELEASE,
+    SDUI_TOK_ANIM,
+    SDUI_TOK_ID,
+    SDUI_TOK_CHILDREN,
+};
+
+static int cmp_f64(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double median(double *v, int n) {
+    qsort(v, (size_t)n, sizeof(double), cmp_f64);
+    return v[n / 2];
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-m nodes] [-r runs]\n"
+            "  -m  minimum nodes per run (default 200000)\n"
+            "  -r  runs per shape, median reported (default 5, max %d)\n",
+            argv0, RUNS_MAX);
+}
+
+/* ---- 原实现的取值解析（strcmp 链） ---- */
+static int legacy_widget_type(const char *ts) {
+    static const char *const types[] = {"container", "label", "button", "image", "bar", "slider", "particle", "list"};
+    if (!ts) return 0;
+    for (int i = 0; i < 8; i++)
+        if (!strcmp(ts, types[i])) return i + 1;
+    return 0;
+}
+
+static int legacy_align(const char *s) {
+    static const char *const aligns[] = {"center", "top_mid", "top_left", "top_right", "bottom_mid",
+                                         "bottom_left", "bottom_right", "left_mid", "right_mid"};
+    if (!s) return 0;
+    for (int i = 0; i < 9; i++)
+        if (!strcmp(s, aligns[i])) return i + 1;
+    return 0;
+}
+
+static int legacy_long_mode(const char *s) {
+    if (!strcmp(s, "wrap"))    return 1;
+    if (!strcmp(s, "scroll"))  return 2;
+    if (!strcmp(s, "dot"))     return 3;
+    if (!strcmp(s, "marquee")) return 4;
+    return 0;
+}
+
+static bool legacy_sig_key(const char *key) {
+    return key && strcmp(key, "type") && strcmp(key, "id") && strcmp(key, "children") && strcmp(key, "reconcile");
+}
+
+static uintptr_t legacy_node(cJSON *node) {
+    uintptr_t sum  = 0;
+    cJSON    *type = cJSON_GetObjectItem(node, "type");
+    sum += (uintptr_t)legacy_widget_type(cJSON_IsString(type) ? type->valuestring : NULL);
+    for (size_t k = 0; k < LEGACY_KEY_COUNT; k++) {
+        cJSON *it = cJSON_GetObjectItem(node, s_legacy_keys[k]);
+        sum += (uintptr_t)it;
+        if (!it || !cJSON_IsString(it)) continue;
+        if (k == 1) sum += (uintptr_t)legacy_long_mode(it->valuestring);
+        if (k == 5) {
+            sum += (uintptr_t)legacy_align(it->valuestring);
+            sum += (uintptr_t)cJSON_GetObjectItem(node, "x") + (uintptr_t)cJSON_GetObjectItem(node, "y");
+        }
+    }
+    cJSON *it = NULL;
+    cJSON_ArrayForEach(it, node) sum += legacy_sig_key(it->string);
+    return sum;
+}
+
+/* ---- 现实现 ---- */
+static void node_props_scan(node_props_t *p, const cJSON *node) {
+    memset(p, 0, sizeof(*p));
+    cJSON *it = NULL;
+    cJSON_ArrayForEach(it, node) {
+        sdui_tok_t t = sdui_tok_lookup(it->string);
+        if (sdui_tok_is_key(t) && !p->v[t]) p->v[t] = it;
+    }
+}
+
+static sdui_tok_t value_tok(const cJSON *item) {
+    return cJSON_IsString(item) ? sdui_tok_lookup(item->valuestring) : SDUI_TOK_UNKNOWN;
+}
+
+static int token_widget_type(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_CONTAINER: return 1;
+        case SDUI_TOK_LABEL:     return 2;
+        case SDUI_TOK_BUTTON:    return 3;
+        case SDUI_TOK_IMAGE:     return 4;
+        case SDUI_TOK_BAR:       return 5;
+        case SDUI_TOK_SLIDER:    return 6;
+        case SDUI_TOK_PARTICLE:  return 7;
+        case SDUI_TOK_LIST:      return 8;
+        default:                 return 0;
+    }
+}
+
+static int token_long_mode(sdui_tok_t t) {
+    switch (t) {
+        case SDUI_TOK_WRAP:    return 1;
+        case SDUI_TOK_SCROLL:  return 2;
+        case SDUI_TOK_DOT:     return 3;
+        case SDUI_TOK_MARQUEE: return 4;
+        default:               return 0;
+    }
+}
+
+static int token_align(sdui_tok_t t) {
+    return (t >= SDUI_TOK_CENTER && t <= SDUI_TOK_RIGHT_MID) ? (int)(t - SDUI_TOK_CENTER) + 1 : 0;
+}
+
+static uintptr_t token_node(cJSON *node) {
+    node_props_t p;
+    uintptr_t    sum = 0;
+    node_props_scan(&p, node);
+    sum += (uintptr_t)token_widget_type(value_tok(NP(&p, TYPE)));
+    for (size_t k = 0; k < LEGACY_KEY_COUNT; k++) {
+        cJSON *it = p.v[s_token_keys[k]];
+        sum += (uintptr_t)it;
+        if (!it || !cJSON_IsString(it)) continue;
+        if (k == 1) sum += (uintptr_t)token_long_mode(value_tok(it));
+        if (k == 5) sum += (uintptr_t)token_align(value_tok(it)) + (uintptr_t)NP(&p, X) + (uintptr_t)NP(&p, Y);
+    }
+    cJSON *it = NULL;
+    cJSON_ArrayForEach(it, node) {
+        sdui_tok_t t = sdui_tok_lookup(it->string);
+        sum += t != SDUI_TOK_TYPE && t != SDUI_TOK_ID && t != SDUI_TOK_CHILDREN && t != SDUI_TOK_RECONCILE;
+    }
+    return sum;
+}
+
+/* ---- 语料：与 gen_corpus.py 相同的节点 ---- */
+static cJSON *grid_cell(int i) {
+    char   buf[16];
+    cJSON *n = cJSON_CreateObject();
+    cJSON_AddStringToObject(n, "type", "label");
+    snprintf(buf, sizeof(buf), "c%d", i);
+    cJSON_AddStringToObject(n, "id", buf);
+    cJSON_AddStringToObject(n, "class", "cell");
+    snprintf(buf, sizeof(buf), "%d", i);
+    cJSON_AddStringToObject(n, "text", buf);
+    return n;
+}
+
+static cJSON *inline_bubble(int i) {
+    char   buf[48];
+    cJSON *n = cJSON_CreateObject();
+    cJSON_AddStringToObject(n, "type", "label");
+    snprintf(buf, sizeof(buf), "b%d", i);
+    cJSON_AddStringToObject(n, "id", buf);
+    cJSON_AddStringToObject(n, "w", "90%");
+    snprintf(buf, sizeof(buf), "Answer %d: sunny, 24 degrees.", i);
+    cJSON_AddStringToObject(n, "text", buf);
+    cJSON_AddNumberToObject(n, "radius", 10);
+    cJSON_AddNumberToObject(n, "pad", 10);
+    cJSON_AddStringToObject(n, "text_color", "#ffffff");
+    cJSON_AddStringToObject(n, "bg_color", "#333333");
+    cJSON_AddNumberToObject(n, "font_size", 16);
+    return n;
+}
+
+static int bench(const char *name, cJSON *(*make)(int), int min_nodes, int runs) {
+    cJSON *nodes[NODES];
+    double legacy[RUNS_MAX], token[RUNS_MAX];
+    for (int i = 0; i < NODES; i++) nodes[i] = make(i);
+
+    uintptr_t lsum = 0, tsum = 0;
+    int       reps = (min_nodes + NODES - 1) / NODES;
+    for (int r = 0; r < runs; r++) {
+        int64_t t0 = esp_timer_get_time();
+        for (int k = 0; k < reps; k++)
+            for (int i = 0; i < NODES; i++) lsum += legacy_node(nodes[i]);
+        legacy[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)reps * NODES);
+
+        t0 = esp_timer_get_time();
+        for (int k = 0; k < reps; k++)
+            for (int i = 0; i < NODES; i++) tsum += token_node(nodes[i]);
+        token[r] = (double)(esp_timer_get_time() - t0) * 1000.0 / ((double)reps * NODES);
+    }
+    for (int i = 0; i < NODES; i++) cJSON_Delete(nodes[i]);
+
+    double l = median(legacy, runs), t = median(token, runs);
+    printf("%-7s %6d %10.1f %9.1f %8.2f\n", name, NODES, l, t, t > 0 ? l / t : 0.0);
+    if (lsum != tsum) {
+        fprintf(stderr, "%s: legacy and token lookups disagree\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    int min_nodes = 200000, runs = 5;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            min_nodes = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-r") && i + 1 < argc) {
+            runs = atoi(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+    if (min_nodes < 1 || runs < 1 || runs > RUNS_MAX) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (!sdui_tok_selftest()) {
+        fprintf(stderr, "token table out of sync, re-run gen_props.py\n");
+        return 1;
+    }
+
+    int failed = 0;
+    printf("median of %d runs, >= %d nodes each\n", runs, min_nodes);
+    printf("%-7s %6s %10s %9s %8s\n", "shape", "nodes", "legacy_ns", "token_ns", "speedup");
+    failed += bench("grid", grid_cell, min_nodes, runs);
+    failed += bench("inline", inline_bubble, min_nodes, runs);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,447 @@
+/**
+ * @file sdui_bench.c
+ * @brief 主机布局基准：把 ui/layout / ui/update / state/set 语料经 sdui_bus 回放到无头 LVGL 显示器
+ *
+ * 每个语料文件是一个信封 {"topic", "payload"} 或信封数组。带 "setup": true 的信封
+ * 在每轮计时前回放（不计时），其余信封依次计时：路由 → 分片构建完成 → 一次完整刷新。
+ *
+ * LVGL 时钟为虚拟时钟：构建片之间的定时器空等直接跳过，计时只包含 CPU 工作，
+ * 与设备上的 time_us 之和（不含片间让出的时间）对应。
+ *
+ * 每个文件输出：
+ *   render_us   路由开始到刷新完成（min / median / max）
+ *   build_us    路由开始到构建完成（median）
+ *   refr_us     构建完成后的布局 + 绘制 + 刷屏（median）
+ *   flushed_px  刷屏回调收到的像素总数
+ *   objects     SDUI 根视图下的 LVGL 对象数（含根）
+ *   heap_peak   计时期间相对起点的堆峰值增量；heap_net 为结束时的净增量
+ *
+ * ui/layout 默认经 sdui_parser_stream 流式构建（与 main.c 相同，未设锁回调，一次建完）；
+ * --legacy 时改用 cJSON_ParseWithLength 解析整棵 DOM（sdui_json 之前的做法），
+ * 再经 sdui_parser_prepare_dom 展平并分片构建，作为解析与峰值内存的对照。
+ */
+#include <errno.h>
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "cJSON.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "sdui_bus.h"
+#include "sdui_parser.h"
+#include "host_port.h"
+
+#define BENCH_DISP_W      SDUI_SCREEN_W
+#define BENCH_DISP_H      SDUI_SCREEN_H
+#define BENCH_BUF_LINES   10          /* 与 BSP 的 LVGL_TRANSFER_BUF_LINES 相同 */
+#define BENCH_DRAIN_MAX   100000      /* 等待旧根回收的最大定时器轮数 */
+#define BENCH_TICK_STEP   5           /* 无定时器就绪时虚拟时钟的步进 (ms) */
+
+static const char *TAG = "SDUI_BENCH";
+
+/* ======================================================
+ * 堆统计（链接期 --wrap 包装 libc 分配函数）
+ * ====================================================== */
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_aligned_alloc(size_t alignment, size_t size);
+void  __real_free(void *ptr);
+
+static size_t s_heap_used, s_heap_peak;
+
+static inline void heap_add(void *p) {
+    s_heap_used += malloc_usable_size(p);
+    if (s_heap_used > s_heap_peak) s_heap_peak = s_heap_used;
+}
+
+void *__wrap_malloc(size_t size) {
+    void *p = __real_malloc(size);
+    if (p) heap_add(p);
+    return p;
+}
+
+void *__wrap_calloc(size_t n, size_t size) {
+    void *p = __real_calloc(n, size);
+    if (p) heap_add(p);
+    return p;
+}
+
+void *__wrap_aligned_alloc(size_t alignment, size_t size) {
+    void *p = __real_aligned_alloc(alignment, size);
+    if (p) heap_add(p);
+    return p;
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    size_t old = ptr ? malloc_usable_size(ptr) : 0;
+    void  *p   = __real_realloc(ptr, size);
+    if (p) {
+        s_heap_used -= old;
+        heap_add(p);
+    } else if (!size) {
+        s_heap_used -= old;
+    }
+    return p;
+}
+
+void __wrap_free(void *ptr) {
+    if (ptr) s_heap_used -= malloc_usable_size(ptr);
+    __real_free(ptr);
+}
+
+size_t host_heap_used(void) { return s_heap_used; }
+
+/* ======================================================
+ * 无头显示器与虚拟时钟
+ * ====================================================== */
+static uint32_t s_tick_ms;
+static uint64_t s_flushed_px;
+static uint32_t s_flushes;
+
+static uint32_t tick_cb(void) { return s_tick_ms; }
+
+static void flush_cb(lv_display_t *disp, const lv_area_t *area, uint8_t *px_map) {
+    (void)px_map;
+    s_flushed_px += lv_area_get_size(area);
+    s_flushes++;
+    lv_display_flush_ready(disp);
+}
+
+/** 跑一轮定时器并把虚拟时钟拨到下一个定时器就绪 */
+static void timer_step(void) {
+    uint32_t next = lv_timer_handler();
+    s_tick_ms += (next == LV_NO_TIMER_READY || next == 0) ? BENCH_TICK_STEP : next;
+}
+
+/** 分片构建直到完成 */
+static void pump_build(void) {
+    while (sdui_parser_is_building()) timer_step();
+}
+
+static uint32_t count_objs(lv_obj_t *obj) {
+    uint32_t n = 1, cnt = lv_obj_get_child_count(obj);
+    for (uint32_t i = 0; i < cnt; i++) n += count_objs(lv_obj_get_child(obj, i));
+    return n;
+}
+
+/** 等旧根被回收定时器删完（屏幕对象数连续 3 轮不变） */
+static void drain(void) {
+    lv_obj_t *scr    = lv_screen_active();
+    uint32_t  last   = count_objs(scr);
+    int       stable = 0;
+    for (int i = 0; i < BENCH_DRAIN_MAX && stable < 3; i++) {
+        timer_step();
+        uint32_t n = count_objs(scr);
+        stable     = (n == last) ? stable + 1 : 0;
+        last       = n;
+    }
+}
+
+/* ======================================================
+ * 总线订阅（与 main.c 相同，主机单线程无需加锁）
+ * ====================================================== */
+static bool s_legacy;
+
+static void on_ui_layout(const char *payload, size_t len) {
+    if (!payload) return;
+    if (!s_legacy) {
+        sdui_parser_stream(payload, len);
+        return;
+    }
+    sdui_layout_job_t *job = sdui_parser_prepare_dom(cJSON_ParseWithLength(payload, len));
+    if (job) sdui_parser_submit(job);
+}
+
+static void on_ui_update(const char *payload) {
+    if (payload) sdui_parser_update(payload);
+}
+
+/* 设备上由合并定时器在下一帧重绘；这里立即重绘，计入本条消息 */
+static void on_state_set(const char *payload) {
+    if (!payload) return;
+    sdui_parser_state_set(payload);
+    sdui_parser_state_flush();
+}
+
+static void on_ui_styles(const char *payload) {
+    if (payload) sdui_parser_set_styles(payload);
+}
+
+static void on_ui_image(const char *payload) {
+    if (payload && sdui_parser_image_feed(payload)) sdui_parser_image_commit();
+}
+
+static void on_font_glyphs(const char *payload) {
+    if (payload && sdui_parser_glyph_feed(payload)) sdui_parser_glyph_commit();
+}
+
+/* ======================================================
+ * 语料
+ * ====================================================== */
+typedef struct {
+    char *json;
+    bool  setup;
+} bench_msg_t;
+
+typedef struct {
+    const char  *path;
+    bench_msg_t *msgs;
+    int          count;
+    size_t       bytes;   /* 计时信封的字节数 */
+} bench_file_t;
+
+typedef struct {
+    int64_t  render_us, build_us, refr_us;
+    uint64_t flushed_px;
+    uint32_t flushes, objects, uplinks;
+    int64_t  heap_peak, heap_net;
+    sdui_render_stats_t rs;
+} bench_run_t;
+
+static char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = n >= 0 ? malloc((size_t)n + 1) : NULL;
+    if (buf && fread(buf, 1, (size_t)n, f) != (size_t)n) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (!buf) return NULL;
+    buf[n] = '\0';
+    *len   = (size_t)n;
+    return buf;
+}
+
+static bool load_file(bench_file_t *bf) {
+    size_t len  = 0;
+    char  *text = read_file(bf->path, &len);
+    if (!text) {
+        ESP_LOGE(TAG, "%s: %s", bf->path, strerror(errno));
+        return false;
+    }
+    cJSON *root = cJSON_Parse(text);
+    free(text);
+    if (!root || !(cJSON_IsObject(root) || cJSON_IsArray(root))) {
+        ESP_LOGE(TAG, "%s: not an envelope or envelope array", bf->path);
+        cJSON_Delete(root);
+        return false;
+    }
+
+    int n     = cJSON_IsArray(root) ? cJSON_GetArraySize(root) : 1;
+    bf->msgs  = calloc((size_t)n, sizeof(bench_msg_t));
+    bf->count = 0;
+    for (int i = 0; i < n; i++) {
+        cJSON *env = cJSON_IsArray(root) ? cJSON_GetArrayItem(root, i) : root;
+        if (!cJSON_IsObject(env) || !cJSON_IsString(cJSON_GetObjectItem(env, "topic"))) {
+            ESP_LOGW(TAG, "%s: envelope %d has no topic, skipped", bf->path, i);
+            continue;
+        }
+        bench_msg_t *m = &bf->msgs[bf->count++];
+        m->setup       = cJSON_IsTrue(cJSON_GetObjectItem(env, "setup"));
+        cJSON_DeleteItemFromObject(env, "setup");
+        m->json = cJSON_PrintUnformatted(env);
+        if (!m->setup) bf->bytes += strlen(m->json);
+    }
+    cJSON_Delete(root);
+    return bf->count > 0;
+}
+
+/* ======================================================
+ * 计时
+ * ====================================================== */
+static const char *const RESET_LAYOUT = "{\"topic\":\"ui/layout\",\"payload\":{\"children\":[]}}";
+
+static void route_settle(const char *json) {
+    sdui_bus_route_down(json);
+    pump_build();
+}
+
+static void run_file(const bench_file_t *bf, bench_run_t *out) {
+    /* 每轮从同一状态开始：空界面 + setup 信封，旧根删完、屏幕刷净 */
+    route_settle(RESET_LAYOUT);
+    for (int i = 0; i < bf->count; i++) {
+        if (bf->msgs[i].setup) route_settle(bf->msgs[i].json);
+    }
+    drain();
+    lv_refr_now(NULL);
+
+    memset(out, 0, sizeof(*out));
+    s_flushed_px        = 0;
+    s_flushes           = 0;
+    uint32_t uplinks0   = host_uplink_count();
+    size_t   heap0      = s_heap_used;
+    s_heap_peak         = s_heap_used;
+
+    for (int i = 0; i < bf->count; i++) {
+        if (bf->msgs[i].setup) continue;
+        int64_t t0 = esp_timer_get_time();
+        sdui_bus_route_down(bf->msgs[i].json);
+        pump_build();
+        int64_t t1 = esp_timer_get_time();
+        lv_refr_now(NULL);
+        int64_t t2 = esp_timer_get_time();
+        out->build_us  += t1 - t0;
+        out->refr_us   += t2 - t1;
+        out->render_us += t2 - t0;
+    }
+
+    out->heap_peak  = (int64_t)s_heap_peak - (int64_t)heap0;
+    out->heap_net   = (int64_t)s_heap_used - (int64_t)heap0;
+    out->flushed_px = s_flushed_px;
+    out->flushes    = s_flushes;
+    out->uplinks    = host_uplink_count() - uplinks0;
+    out->objects    = sdui_parser_get_root() ? count_objs(sdui_parser_get_root()) : 0;
+    sdui_parser_get_render_stats(&out->rs);
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int64_t median(int64_t *v, int n) {
+    qsort(v, (size_t)n, sizeof(int64_t), cmp_i64);
+    return n & 1 ? v[n / 2] : (v[n / 2 - 1] + v[n / 2]) / 2;
+}
+
+/* ======================================================
+ * 入口
+ * ====================================================== */
+static void usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [-n iterations] [-w warmup] [--json out.json] [--legacy] [-v] corpus.json...\n"
+            "  -n        timed iterations per file (default 10)\n"
+            "  -w        untimed warmup iterations per file (default 1)\n"
+            "  --legacy  parse ui/layout with cJSON instead of sdui_json\n"
+            "  -v        component INFO logs on stderr\n",
+            argv0);
+}
+
+int main(int argc, char **argv) {
+    int         iters = 10, warmup = 1;
+    const char *json_path = NULL;
+    int         nfiles    = 0;
+    const char **paths    = calloc((size_t)argc, sizeof(char *));
+
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            iters = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "-w") && i + 1 < argc) {
+            warmup = atoi(argv[++i]);
+        } else if (!strcmp(argv[i], "--json") && i + 1 < argc) {
+            json_path = argv[++i];
+        } else if (!strcmp(argv[i], "--legacy")) {
+            s_legacy = true;
+        } else if (!strcmp(argv[i], "-v")) {
+            host_log_level = ESP_LOG_INFO;
+        } else if (argv[i][0] == '-') {
+            usage(argv[0]);
+            return 2;
+        } else {
+            paths[nfiles++] = argv[i];
+        }
+    }
+    if (!nfiles || iters < 1 || warmup < 0) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    lv_init();
+    lv_tick_set_cb(tick_cb);
+    lv_display_t *disp = lv_display_create(BENCH_DISP_W, BENCH_DISP_H);
+    size_t        buf_sz = (size_t)BENCH_DISP_W * BENCH_BUF_LINES * sizeof(uint16_t);
+    lv_display_set_color_format(disp, LV_COLOR_FORMAT_RGB565);
+    lv_display_set_buffers(disp, aligned_alloc(64, buf_sz), NULL, buf_sz, LV_DISPLAY_RENDER_MODE_PARTIAL);
+    lv_display_set_flush_cb(disp, flush_cb);
+
+    sdui_parser_init();
+    sdui_bus_init();
+    sdui_bus_subscribe_slice("ui/layout", on_ui_layout);
+    sdui_bus_subscribe("ui/update", on_ui_update);
+    sdui_bus_subscribe("state/set", on_state_set);
+    sdui_bus_subscribe("ui/styles", on_ui_styles);
+    sdui_bus_subscribe("ui/image", on_ui_image);
+    sdui_bus_subscribe("font/glyphs", on_font_glyphs);
+
+    FILE *jf = NULL;
+    if (json_path) {
+        jf = fopen(json_path, "w");
+        if (!jf) {
+            ESP_LOGE(TAG, "%s: %s", json_path, strerror(errno));
+            return 1;
+        }
+        fprintf(jf, "{\"lvgl\":\"%d.%d.%d\",\"display\":[%d,%d],\"iterations\":%d,\"parser\":\"%s\",\"files\":[",
+                LVGL_VERSION_MAJOR, LVGL_VERSION_MINOR, LVGL_VERSION_PATCH,
+                BENCH_DISP_W, BENCH_DISP_H, iters, s_legacy ? "cjson" : "sdui_json");
+    }
+
+    printf("%-28s %7s %9s %9s %9s %9s %9s %10s %7s %10s %9s\n", "file", "bytes", "render_us", "min", "max",
+           "build_us", "refr_us", "flushed_px", "objects", "heap_peak", "heap_net");
+
+    int64_t *render = calloc((size_t)iters, sizeof(int64_t));
+    int64_t *build  = calloc((size_t)iters, sizeof(int64_t));
+    int64_t *refr   = calloc((size_t)iters, sizeof(int64_t));
+    int      failed = 0, emitted = 0;
+
+    for (int f = 0; f < nfiles; f++) {
+        bench_file_t bf = {.path = paths[f]};
+        if (!load_file(&bf)) {
+            failed++;
+            continue;
+        }
+
+        bench_run_t run;
+        for (int i = 0; i < warmup; i++) run_file(&bf, &run);
+        for (int i = 0; i < iters; i++) {
+            run_file(&bf, &run);
+            render[i] = run.render_us;
+            build[i]  = run.build_us;
+            refr[i]   = run.refr_us;
+        }
+        int64_t r_med = median(render, iters);   /* 排序后 render[0] / render[iters-1] 即最值 */
+        int64_t b_med = median(build, iters);
+        int64_t f_med = median(refr, iters);
+
+        const char *name = strrchr(bf.path, '/') ? strrchr(bf.path, '/') + 1 : bf.path;
+        printf("%-28s %7zu %9lld %9lld %9lld %9lld %9lld %10llu %7u %10lld %9lld\n", name, bf.bytes,
+               (long long)r_med, (long long)render[0], (long long)render[iters - 1], (long long)b_med,
+               (long long)f_med, (unsigned long long)run.flushed_px, (unsigned)run.objects,
+               (long long)run.heap_peak, (long long)run.heap_net);
+
+        if (jf) {
+            fprintf(jf,
+                    "%s{\"file\":\"%s\",\"bytes\":%zu,"
+                    "\"render_us\":{\"min\":%lld,\"median\":%lld,\"max\":%lld},"
+                    "\"build_us\":%lld,\"refr_us\":%lld,\"flushed_px\":%llu,\"flushes\":%u,"
+                    "\"objects\":%u,\"heap_peak\":%lld,\"heap_net\":%lld,\"uplinks\":%u,"
+                    "\"created\":%u,\"patched\":%u,\"deleted\":%u,\"reconciled\":%s}",
+                    emitted ? "," : "", name, bf.bytes, (long long)render[0], (long long)r_med,
+                    (long long)render[iters - 1], (long long)b_med, (long long)f_med,
+                    (unsigned long long)run.flushed_px, (unsigned)run.flushes, (unsigned)run.objects,
+                    (long long)run.heap_peak, (long long)run.heap_net, (unsigned)run.uplinks,
+                    (unsigned)run.rs.created, (unsigned)run.rs.patched, (unsigned)run.rs.deleted,
+                    run.rs.reconciled ? "true" : "false");
+            emitted++;
+        }
+
+        for (int i = 0; i < bf.count; i++) cJSON_free(bf.msgs[i].json);
+        free(bf.msgs);
+    }
+
+    if (jf) {
+        fprintf(jf, "]}\n");
+        fclose(jf);
+    }
+    free(render);
+    free(build);
+    free(refr);
+    free(paths);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file lv_conf.h
+ * @brief 主机构建的 LVGL 配置：与 sdkconfig.defaults 中的 CONFIG_LV_* 保持一致
+ *
+ * 未列出的选项取 LVGL 默认值（lv_conf_internal.h）。差异只有两处：
+ * 没有操作系统（单线程、单绘制单元），以及日志关闭。
+ * 软件渲染同样挂 sdui_pixel_lv.h，主机上走参考实现。
+ */
+#ifndef LV_CONF_H
+#define LV_CONF_H
+
+#define LV_COLOR_DEPTH              16
+
+#define LV_USE_STDLIB_MALLOC        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_STRING        LV_STDLIB_CLIB
+#define LV_USE_STDLIB_SPRINTF       LV_STDLIB_CLIB
+
+#define LV_DEF_REFR_PERIOD          15
+#define LV_OS                       LV_OS_NONE
+#define LV_OBJ_STYLE_CACHE          1
+
+#define LV_USE_DRAW_SW_ASM          LV_DRAW_SW_ASM_CUSTOM
+#define LV_DRAW_SW_ASM_CUSTOM_INCLUDE "sdui_pixel_lv.h"
+
+#define LV_FONT_MONTSERRAT_12       1
+#define LV_FONT_MONTSERRAT_14       1
+#define LV_FONT_MONTSERRAT_16       1
+#define LV_FONT_MONTSERRAT_18       1
+#define LV_FONT_MONTSERRAT_20       1
+#define LV_FONT_MONTSERRAT_22       1
+#define LV_FONT_MONTSERRAT_24       1
+#define LV_FONT_MONTSERRAT_26       1
+#define LV_USE_FONT_COMPRESSED      1
+#define LV_TXT_BREAK_CHARS          " ,.;:-_"
+#define LV_USE_IMGFONT              1
+
+#define LV_USE_LOG                  0
+#define LV_USE_SYSMON               0
+
+#endif /* LV_CONF_H */
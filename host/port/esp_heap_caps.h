@@ -0,0 +1,41 @@
+/**
+ * @file esp_heap_caps.h
+ * @brief 主机构建的 heap_caps_*：能力位被忽略，全部走 libc 堆
+ *
+ * heap_caps_get_free_size 返回 HOST_HEAP_SIZE 减去 host_heap_used()，
+ * 后者默认为 0；sdui_bench 以链接期包装的 malloc 统计实际占用，
+ * 渲染统计中的 heap_bytes 因此与设备含义一致。
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MALLOC_CAP_32BIT     (1 << 1)
+#define MALLOC_CAP_8BIT      (1 << 2)
+#define MALLOC_CAP_DMA       (1 << 3)
+#define MALLOC_CAP_SPIRAM    (1 << 10)
+#define MALLOC_CAP_INTERNAL  (1 << 11)
+#define MALLOC_CAP_DEFAULT   (1 << 12)
+
+#define HOST_HEAP_SIZE       ((size_t)1 << 30)   /* 名义容量，只用于换算余量 */
+
+void  *heap_caps_malloc(size_t size, uint32_t caps);
+void  *heap_caps_calloc(size_t n, size_t size, uint32_t caps);
+void  *heap_caps_realloc(void *ptr, size_t size, uint32_t caps);
+void  *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps);
+void   heap_caps_free(void *ptr);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+size_t heap_caps_get_minimum_free_size(uint32_t caps);
+
+/** 当前堆占用（字节）；弱定义返回 0，由使用者覆盖 */
+size_t host_heap_used(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file esp_port.c
+ * @brief 主机构建的 ESP-IDF / mbedtls 替身，以及 audio_manager、websocket_manager 桩
+ *
+ * FreeRTOS 替身另见 rtos_single.c（基准程序）与 rtos_pthread.c（总线通道测试）。
+ */
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "mbedtls/base64.h"
+#include "audio_manager.h"
+#include "websocket_manager.h"
+#include "host_port.h"
+
+/* ======================================================
+ * 日志与时间
+ * ====================================================== */
+esp_log_level_t host_log_level = ESP_LOG_WARN;
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *fmt, ...) {
+    static const char letters[] = "?EWIDV";
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "%c (%lld) %s: ", letters[level], (long long)(esp_timer_get_time() / 1000), tag);
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+}
+
+int64_t esp_timer_get_time(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/* ======================================================
+ * 堆
+ * ====================================================== */
+__attribute__((weak)) size_t host_heap_used(void) { return 0; }
+
+void *heap_caps_malloc(size_t size, uint32_t caps) { (void)caps; return malloc(size); }
+void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) { (void)caps; return calloc(n, size); }
+void *heap_caps_realloc(void *ptr, size_t size, uint32_t caps) { (void)caps; return realloc(ptr, size); }
+void  heap_caps_free(void *ptr) { free(ptr); }
+
+void *heap_caps_aligned_alloc(size_t alignment, size_t size, uint32_t caps) {
+    (void)caps;
+    return aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+    (void)caps;
+    size_t used = host_heap_used();
+    return used < HOST_HEAP_SIZE ? HOST_HEAP_SIZE - used : 0;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t caps) { return heap_caps_get_free_size(caps); }
+size_t heap_caps_get_minimum_free_size(uint32_t caps)  { return heap_caps_get_free_size(caps); }
+
+/* ======================================================
+ * Base64 解码（RFC 4648，忽略空白）
+ * ====================================================== */
+static int b64_value(unsigned char c) {
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen,
+                          const unsigned char *src, size_t slen) {
+    size_t chars = 0, pad = 0;
+    for (size_t i = 0; i < slen; i++) {
+        unsigned char c = src[i];
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') continue;
+        if (c == '=') {
+            if (++pad > 2) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        } else if (pad || b64_value(c) < 0) {
+            return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+        }
+        chars++;
+    }
+    if (chars % 4) return MBEDTLS_ERR_BASE64_INVALID_CHARACTER;
+
+    size_t need = chars / 4 * 3 - pad;
+    if (!need) {
+        *olen = 0;
+        return 0;
+    }
+    if (!dst || dlen < need) {
+        *olen = need;
+        return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+    }
+
+    uint32_t acc = 0;
+    size_t   n = 0, out = 0;
+    for (size_t i = 0; i < slen; i++) {
+        int v = b64_value(src[i]);
+        if (v < 0) continue;
+        acc = (acc << 6) | (uint32_t)v;
+        if (++n == 4) {
+            dst[out++] = (unsigned char)(acc >> 16);
+            dst[out++] = (unsigned char)(acc >> 8);
+            dst[out++] = (unsigned char)acc;
+            acc = 0;
+            n   = 0;
+        }
+    }
+    if (n == 3) {            /* 一个 '=' */
+        dst[out++] = (unsigned char)(acc >> 10);
+        dst[out++] = (unsigned char)(acc >> 2);
+    } else if (n == 2) {     /* 两个 '=' */
+        dst[out++] = (unsigned char)(acc >> 4);
+    }
+    *olen = out;
+    return 0;
+}
+
+/* ======================================================
+ * 组件桩
+ * ====================================================== */
+static uint32_t s_uplinks;
+
+bool audio_manager_is_recording(void) { return false; }
+
+void websocket_send_json(const char *payload) {
+    (void)payload;
+    s_uplinks++;
+}
+
+void websocket_send_text(const char *data, size_t len) {
+    (void)data;
+    (void)len;
+    s_uplinks++;
+}
+
+uint32_t host_uplink_count(void) { return s_uplinks; }
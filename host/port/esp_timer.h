@@ -0,0 +1,17 @@
+/**
+ * @file esp_timer.h
+ * @brief 主机构建的 esp_timer_get_time：CLOCK_MONOTONIC 微秒
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,21 @@
+/**
+ * @file FreeRTOS.h
+ * @brief 主机构建的 FreeRTOS 最小子集：只提供组件用到的类型与常量
+ *
+ * 基准程序单线程运行（rtos_single.c）；总线通道测试以 pthread 实现任务与信号量
+ * （rtos_pthread.c）。一个 tick 为 1ms。
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef int32_t  BaseType_t;
+typedef uint32_t UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE             0
+#define pdTRUE              1
+#define pdPASS              pdTRUE
+#define portMAX_DELAY       ((TickType_t)0xffffffffu)
+#define pdMS_TO_TICKS(ms)   ((TickType_t)(ms))
+#define tskNO_AFFINITY      ((BaseType_t)0x7fffffff)
@@ -0,0 +1,19 @@
+/**
+ * @file idf_additions.h
+ * @brief 主机构建的 ESP-IDF 任务扩展：栈能力位与绑核被忽略
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+BaseType_t xTaskCreatePinnedToCoreWithCaps(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                           UBaseType_t prio, TaskHandle_t *out, BaseType_t core, uint32_t caps);
+
+#ifdef __cplusplus
+}
+#endif
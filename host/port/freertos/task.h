@@ -0,0 +1,24 @@
+/**
+ * @file task.h
+ * @brief 主机构建的任务接口：单线程构建中当前任务恒为同一个句柄
+ */
+#pragma once
+
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct host_task *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t   xTaskGetTickCount(void);
+void         vTaskDelay(TickType_t ticks);
+BaseType_t   xTaskNotifyGive(TaskHandle_t task);
+uint32_t     ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t wait);
+
+#ifdef __cplusplus
+}
+#endif
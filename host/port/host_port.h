@@ -0,0 +1,19 @@
+/**
+ * @file host_port.h
+ * @brief 主机构建的附加接口（设备上不存在）
+ */
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** 经 websocket_send_json / websocket_send_text 上行的消息数（ui/image_miss 等），桩只计数不发送 */
+uint32_t host_uplink_count(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,25 @@
+/**
+ * @file base64.h
+ * @brief 主机构建的 mbedtls Base64 解码（返回值与 olen 语义同 mbedtls）
+ */
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL   -0x002A
+#define MBEDTLS_ERR_BASE64_INVALID_CHARACTER  -0x002C
+
+/**
+ * dst 为 NULL 或 dlen 不足时返回 MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL，
+ * 并在 *olen 中给出所需字节数；空白与换行被跳过。
+ */
+int mbedtls_base64_decode(unsigned char *dst, size_t dlen, size_t *olen,
+                          const unsigned char *src, size_t slen);
+
+#ifdef __cplusplus
+}
+#endif
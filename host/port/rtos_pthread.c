@@ -0,0 +1,159 @@
+/**
+ * @file rtos_pthread.c
+ * @brief 总线通道测试的 FreeRTOS 替身：任务为 pthread，信号量与任务通知为互斥量 + 条件变量
+ *
+ * 只实现 sdui_bus 分发通道用到的部分。优先级、绑核与栈能力位被忽略，
+ * 调度顺序由操作系统决定，测试须以显式同步而非优先级判断先后。
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <time.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "freertos/idf_additions.h"
+
+struct host_mutex {
+    pthread_mutex_t m;
+    pthread_cond_t  c;
+    bool            binary;   /* 二值信号量：count 为 0 / 1 */
+    int             count;
+};
+
+struct host_task {
+    pthread_t       th;
+    TaskFunction_t  fn;
+    void           *arg;
+    pthread_mutex_t m;
+    pthread_cond_t  c;
+    uint32_t        notify;
+};
+
+static struct host_task        s_main = {.m = PTHREAD_MUTEX_INITIALIZER, .c = PTHREAD_COND_INITIALIZER};
+static __thread struct host_task *t_self;
+
+/** wait 个 tick（毫秒）之后的绝对时刻；portMAX_DELAY 返回 false 表示无限等待 */
+static bool deadline(TickType_t wait, struct timespec *ts) {
+    if (wait == portMAX_DELAY) return false;
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec  += wait / 1000;
+    ts->tv_nsec += (long)(wait % 1000) * 1000000;
+    if (ts->tv_nsec >= 1000000000) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000;
+    }
+    return true;
+}
+
+/* ======================================================
+ * 信号量
+ * ====================================================== */
+static SemaphoreHandle_t sem_new(bool binary, int count) {
+    struct host_mutex *s = calloc(1, sizeof(*s));
+    if (!s) return NULL;
+    pthread_mutex_init(&s->m, NULL);
+    pthread_cond_init(&s->c, NULL);
+    s->binary = binary;
+    s->count  = count;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)  { return sem_new(false, 1); }
+SemaphoreHandle_t xSemaphoreCreateBinary(void) { return sem_new(true, 0); }
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t wait) {
+    struct timespec ts;
+    bool            timed = deadline(wait, &ts);
+    int             err   = 0;
+    pthread_mutex_lock(&s->m);
+    while (!s->count && err != ETIMEDOUT) {
+        err = timed ? pthread_cond_timedwait(&s->c, &s->m, &ts) : pthread_cond_wait(&s->c, &s->m);
+    }
+    BaseType_t ok = s->count ? pdTRUE : pdFALSE;
+    if (ok) s->count--;
+    pthread_mutex_unlock(&s->m);
+    return ok;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+    pthread_mutex_lock(&s->m);
+    BaseType_t ok = !(s->binary && s->count) ? pdTRUE : pdFALSE;
+    if (ok) s->count++;
+    pthread_cond_signal(&s->c);
+    pthread_mutex_unlock(&s->m);
+    return ok;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t s) {
+    pthread_mutex_destroy(&s->m);
+    pthread_cond_destroy(&s->c);
+    free(s);
+}
+
+/* ======================================================
+ * 任务与通知
+ * ====================================================== */
+static void *task_entry(void *arg) {
+    t_self = arg;
+    t_self->fn(t_self->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreatePinnedToCoreWithCaps(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                           UBaseType_t prio, TaskHandle_t *out, BaseType_t core, uint32_t caps) {
+    (void)name; (void)stack; (void)prio; (void)core; (void)caps;
+    struct host_task *t = calloc(1, sizeof(*t));
+    if (!t) return pdFALSE;
+    t->fn  = fn;
+    t->arg = arg;
+    pthread_mutex_init(&t->m, NULL);
+    pthread_cond_init(&t->c, NULL);
+    if (out) *out = t;   /* 与 FreeRTOS 一致：任务开始运行前句柄已写出 */
+    if (pthread_create(&t->th, NULL, task_entry, t) != 0) {
+        if (out) *out = NULL;
+        free(t);
+        return pdFALSE;
+    }
+    pthread_detach(t->th);
+    return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return t_self ? t_self : &s_main;
+}
+
+TickType_t xTaskGetTickCount(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (TickType_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void vTaskDelay(TickType_t ticks) {
+    struct timespec ts = {.tv_sec = ticks / 1000, .tv_nsec = (long)(ticks % 1000) * 1000000};
+    nanosleep(&ts, NULL);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t) {
+    pthread_mutex_lock(&t->m);
+    t->notify++;
+    pthread_cond_signal(&t->c);
+    pthread_mutex_unlock(&t->m);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t wait) {
+    struct host_task *t = xTaskGetCurrentTaskHandle();
+    struct timespec   ts;
+    bool              timed = deadline(wait, &ts);
+    int               err   = 0;
+    pthread_mutex_lock(&t->m);
+    while (!t->notify && err != ETIMEDOUT) {
+        err = timed ? pthread_cond_timedwait(&t->c, &t->m, &ts) : pthread_cond_wait(&t->c, &t->m);
+    }
+    uint32_t n = t->notify;
+    if (n) t->notify = clear_on_exit ? 0 : n - 1;
+    pthread_mutex_unlock(&t->m);
+    return n;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file rtos_single.c
+ * @brief 基准程序的 FreeRTOS 替身：单线程运行
+ *
+ * LVGL、总线回调与分片构建都在主线程里轮流执行，互斥量只需检查加解锁配对。
+ * 分发通道在主机基准中关闭，任务创建、通知与二值信号量不会被调用。
+ */
+#include <stdlib.h>
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+struct host_mutex {
+    int held;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return calloc(1, sizeof(struct host_mutex));
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t wait) {
+    (void)wait;
+    if (!sem || sem->held) {
+        ESP_LOGE("HOST", "mutex %p taken twice on a single thread", (void *)sem);
+        abort();
+    }
+    sem->held = 1;
+    return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem) {
+    if (!sem || !sem->held) return pdFALSE;
+    sem->held = 0;
+    return pdTRUE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem) { free(sem); }
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    static int main_task;
+    return (TaskHandle_t)&main_task;
+}
+
+/* 单线程没有可让出的对象 */
+void vTaskDelay(TickType_t ticks) { (void)ticks; }
@@ -0,0 +1,28 @@
+/**
+ * @file sdkconfig.h
+ * @brief 主机构建的配置：取设备默认值（sdkconfig.defaults / 各组件 Kconfig）
+ *
+ * CONFIG_SDUI_PERF 依赖 FreeRTOS 队列与任务，主机上关闭（打点为空操作），
+ * 分段耗时由 sdui_bench 直接测量。CONFIG_SDUI_BUS_LANES 在基准中关闭，
+ * 总线在调用线程中同步回调订阅者；bus_lanes_test 定义 HOST_BUS_LANES 打开通道，
+ * 任务由 rtos_pthread.c 以线程实现，队列取小深度以便构造溢出。
+ */
+#pragma once
+
+#define CONFIG_SDUI_ANIM_TARGET_FPS   30
+#define CONFIG_LV_DEF_REFR_PERIOD     15
+
+#if HOST_BUS_LANES
+#define CONFIG_SDUI_BUS_LANES          1
+#define CONFIG_SDUI_BUS_LANE_STACK     4096
+#define CONFIG_SDUI_BUS_LANE_BLOCK_MS  200
+#define CONFIG_SDUI_BUS_LANE_RT_DEPTH  2
+#define CONFIG_SDUI_BUS_LANE_RT_PRIO   6
+#define CONFIG_SDUI_BUS_LANE_RT_CORE   1
+#define CONFIG_SDUI_BUS_LANE_UI_DEPTH  3
+#define CONFIG_SDUI_BUS_LANE_UI_PRIO   4
+#define CONFIG_SDUI_BUS_LANE_UI_CORE   -1
+#define CONFIG_SDUI_BUS_LANE_BG_DEPTH  2
+#define CONFIG_SDUI_BUS_LANE_BG_PRIO   2
+#define CONFIG_SDUI_BUS_LANE_BG_CORE   -1
+#endif
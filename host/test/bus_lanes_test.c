@@ -0,0 +1,350 @@
+/**
+ * @file bus_lanes_test.c
+ * @brief 主机测试：sdui_bus 分发通道的顺序、溢出策略、取代与批次合并
+ *
+ * 以 HOST_BUS_LANES 编译 sdui_bus，通道任务由 rtos_pthread.c 以线程实现，
+ * 队列深度见 host/port/sdkconfig.h（realtime 2 / interactive 3 / background 2，阻塞上限 200ms）。
+ * 订阅者在闸门打开前自旋，用来占住通道任务、把队列填满。
+ * 全部通过时打印 "ALL OK" 并返回 0，任一检查失败打印位置并返回 1。
+ */
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "sdui_bus.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+
+#define CHECK(c)                                                         \
+    do {                                                                 \
+        if (!(c)) {                                                      \
+            printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #c);           \
+            printf("log: %s\n", s_log);                                  \
+            exit(1);                                                     \
+        }                                                                \
+    } while (0)
+
+static char            s_log[4096];
+static pthread_mutex_t s_log_mu = PTHREAD_MUTEX_INITIALIZER;
+
+static atomic_int   s_gate_ui, s_gate_rt, s_gate_cmd;   // 非 0 时对应订阅者自旋等待
+static atomic_int   s_entered;              // 已进入的订阅者回调数
+static atomic_int   s_on_main;              // 在主线程（非通道任务）上执行的回调数
+static TaskHandle_t s_main;
+static int64_t      s_t_audio;
+
+static void log_add(const char *tag, const char *p, size_t n) {
+    pthread_mutex_lock(&s_log_mu);
+    size_t at = strlen(s_log);
+    snprintf(s_log + at, sizeof(s_log) - at, "%s:%.*s;", tag, (int)n, p);
+    pthread_mutex_unlock(&s_log_mu);
+}
+
+static bool log_is(const char *expect) {
+    pthread_mutex_lock(&s_log_mu);
+    bool eq = strcmp(s_log, expect) == 0;
+    pthread_mutex_unlock(&s_log_mu);
+    return eq;
+}
+
+static void log_reset(void) {
+    pthread_mutex_lock(&s_log_mu);
+    s_log[0] = '\0';
+    pthread_mutex_unlock(&s_log_mu);
+}
+
+static void enter(atomic_int *gate) {
+    atomic_fetch_add(&s_entered, 1);
+    if (xTaskGetCurrentTaskHandle() == s_main) atomic_fetch_add(&s_on_main, 1);
+    while (gate && atomic_load(gate)) usleep(1000);
+}
+
+/* ======================================================
+ * 订阅者
+ * ====================================================== */
+static void on_audio(const char *p, size_t n) {
+    enter(&s_gate_rt);
+    s_t_audio = esp_timer_get_time();
+    log_add("A", p, n);
+}
+
+static void on_cmd(const char *p) {
+    enter(&s_gate_cmd);
+    log_add("C", p, strlen(p));
+}
+
+static void on_ui(const char *p, size_t n) {
+    enter(&s_gate_ui);
+    log_add("U", p, n);
+}
+
+static void on_text(const char *p) {
+    enter(NULL);
+    log_add("T", p, strlen(p));
+}
+
+static void on_bin(const uint8_t *d, size_t n) {
+    enter(NULL);
+    log_add("B", (const char *)d, n);
+}
+
+static void on_font(const char *p) {
+    enter(NULL);
+    log_add("F", p, strlen(p));
+}
+
+static pthread_t s_echo_thread;
+
+static void on_echo(const char *p) {
+    enter(NULL);
+    CHECK(pthread_equal(pthread_self(), s_echo_thread));
+    log_add("E", p, strlen(p));
+}
+
+// 通道任务内转发下行消息：同通道的再投递须同步回调，否则会等待自己腾位
+static void on_forward(const char *p) {
+    enter(NULL);
+    s_echo_thread = pthread_self();
+    log_add("R", "in", 2);
+    sdui_bus_route_down("{\"topic\":\"ui/echo\",\"payload\":\"fwd\"}");
+    log_add("R", p, strlen(p));
+}
+
+/* ======================================================
+ * 工具
+ * ====================================================== */
+static void down(const char *topic, const char *payload) {
+    char b[512];
+    snprintf(b, sizeof(b), "{\"topic\":\"%s\",\"payload\":%s}", topic, payload);
+    sdui_bus_route_down(b);
+    memset(b, 'X', sizeof(b));   // WebSocket 在回调返回后即释放缓冲，通道须已拷贝
+}
+
+// 等待日志变为 expect，再确认 20ms 内没有多余的回调
+static void wait_log(const char *expect) {
+    for (int i = 0; i < 2000 && !log_is(expect); i++) usleep(1000);
+    usleep(20000);
+    CHECK(log_is(expect));
+}
+
+// 等待第 n 个回调进入（被闸门挡住的订阅者已出队）
+static void wait_entered(int n) {
+    for (int i = 0; i < 2000 && atomic_load(&s_entered) < n; i++) usleep(1000);
+    CHECK(atomic_load(&s_entered) >= n);
+}
+
+static sdui_bus_lane_stats_t stats(sdui_bus_lane_t lane) {
+    sdui_bus_lane_stats_t st;
+    CHECK(sdui_bus_get_lane_stats(lane, &st));
+    return st;
+}
+
+static void *post_styles(void *arg) {
+    down("ui/styles", arg);
+    return NULL;
+}
+
+int main(void) {
+    s_main = xTaskGetCurrentTaskHandle();
+    sdui_bus_lane_stats_t st;
+
+    // 0. 通道启动前：同步回调
+    sdui_bus_subscribe_slice("audio/play", on_audio);
+    CHECK(!sdui_bus_get_lane_stats(SDUI_BUS_LANE_REALTIME, &st));
+    down("audio/play", "\"s0\"");
+    CHECK(log_is("A:s0;") && atomic_load(&s_on_main) == 1);
+
+    sdui_bus_init();   // 清空订阅并启动通道
+    sdui_bus_subscribe_slice("audio/play", on_audio);
+    sdui_bus_subscribe("audio/cmd/#", on_cmd);
+    sdui_bus_subscribe_slice("ui/layout", on_ui);
+    sdui_bus_subscribe_bin("ui/layout", on_bin);
+    sdui_bus_subscribe("ui/update", on_text);
+    sdui_bus_subscribe_slice("ui/update", on_ui);
+    sdui_bus_subscribe("ui/styles", on_text);
+    sdui_bus_subscribe("state/set", on_text);
+    sdui_bus_subscribe("ui/forward", on_forward);
+    sdui_bus_subscribe("ui/echo", on_echo);
+    sdui_bus_subscribe("font/glyph", on_font);
+    atomic_store(&s_on_main, 0);
+    log_reset();
+
+    // 1. 慢布局不阻塞音频
+    int n = atomic_load(&s_entered);
+    atomic_store(&s_gate_ui, 1);
+    down("ui/layout", "{\"id\":1}");
+    wait_entered(n + 1);
+    int64_t t0 = esp_timer_get_time();
+    down("audio/play", "\"a1\"");
+    wait_log("A:a1;");
+    CHECK(s_t_audio - t0 < 100000);
+    atomic_store(&s_gate_ui, 0);
+    wait_log("A:a1;U:{\"id\":1};");
+
+    // 2. 通道内保持到达顺序：转义字符串、text 借用、二进制帧
+    log_reset();
+    down("ui/update", "\"u\\\"1\"");
+    uint8_t fr[64] = {'S', 'B', 1, 9};
+    memcpy(fr + 4, "ui/layout", 9);
+    memcpy(fr + 13, "BIN", 3);
+    sdui_bus_route_down_bin(fr, 16);
+    memset(fr, 0, sizeof(fr));
+    down("ui/update", "{\"k\":2}");
+    wait_log("T:u\"1;U:u\"1;B:BIN;T:{\"k\":2};U:{\"k\":2};");
+
+    // 3. audio/play（DROP）：队列满时丢最早的一块，投递方不等待
+    log_reset();
+    n = atomic_load(&s_entered);
+    atomic_store(&s_gate_rt, 1);
+    down("audio/play", "\"p1\"");
+    wait_entered(n + 1);
+    t0 = esp_timer_get_time();
+    down("audio/play", "\"p2\"");
+    down("audio/play", "\"p3\"");
+    down("audio/play", "\"p4\"");
+    down("audio/play", "\"p5\"");
+    CHECK(esp_timer_get_time() - t0 < 50000);
+    st = stats(SDUI_BUS_LANE_REALTIME);
+    CHECK(st.capacity == 2 && st.depth == 2 && st.depth_max == 2 && st.dropped == 2 && st.blocked == 0);
+    atomic_store(&s_gate_rt, 0);
+    wait_log("A:p1;A:p4;A:p5;");
+
+    // 4. ui/layout（COALESCE）：只取代排队中的旧布局，其余消息保持顺序
+    log_reset();
+    n = atomic_load(&s_entered);
+    atomic_store(&s_gate_ui, 1);
+    down("ui/layout", "1");
+    wait_entered(n + 1);
+    down("ui/layout", "2");
+    down("ui/update", "\"x\"");
+    down("ui/update", "\"y\"");
+    down("ui/layout", "3");
+    st = stats(SDUI_BUS_LANE_INTERACTIVE);
+    CHECK(st.coalesced == 1 && st.dropped == 0 && st.blocked == 0 && st.depth == 3);
+    atomic_store(&s_gate_ui, 0);
+    wait_log("U:1;T:x;U:x;T:y;U:y;U:3;");
+
+    // 5. BLOCK（ui/styles）：队列满时投递方等待通道腾位，消息不丢且顺序不变
+    log_reset();
+    n = atomic_load(&s_entered);
+    atomic_store(&s_gate_ui, 1);
+    down("ui/layout", "\"a\"");
+    wait_entered(n + 1);
+    down("ui/styles", "1");
+    down("ui/styles", "2");
+    down("ui/styles", "3");
+    pthread_t th;
+    CHECK(pthread_create(&th, NULL, post_styles, "4") == 0);
+    for (int i = 0; i < 1000 && stats(SDUI_BUS_LANE_INTERACTIVE).blocked == 0; i++) usleep(1000);
+    usleep(30000);
+    st = stats(SDUI_BUS_LANE_INTERACTIVE);
+    CHECK(st.blocked == 1 && st.depth == 3 && st.dropped == 0);
+    atomic_store(&s_gate_ui, 0);
+    pthread_join(th, NULL);
+    wait_log("U:a;T:1;T:2;T:3;T:4;");
+    st = stats(SDUI_BUS_LANE_INTERACTIVE);
+    CHECK(st.dropped == 0 && st.block_us_max >= 30000);
+
+    // 6. BLOCK 超时：等满 CONFIG_SDUI_BUS_LANE_BLOCK_MS 后丢弃并计入 dropped
+    log_reset();
+    n = atomic_load(&s_entered);
+    atomic_store(&s_gate_ui, 1);
+    down("ui/layout", "\"b\"");
+    wait_entered(n + 1);
+    down("ui/styles", "5");
+    down("ui/styles", "6");
+    down("ui/styles", "7");
+    t0 = esp_timer_get_time();
+    down("ui/styles", "8");
+    int64_t blocked_us = esp_timer_get_time() - t0;
+    CHECK(blocked_us >= 190000 && blocked_us < 1000000);
+    st = stats(SDUI_BUS_LANE_INTERACTIVE);
+    CHECK(st.blocked == 2 && st.dropped == 1 && st.depth == 3);
+    atomic_store(&s_gate_ui, 0);
+    wait_log("U:b;T:5;T:6;T:7;");
+
+    // 7. MERGE（ui/update、state/set）：队列满时相邻两条同主题消息合成数组批次，投递方不等待、消息不丢。
+    //    队尾不是同主题时合并队列中相邻的一对；字符串等非对象 / 数组 payload 不参与合并
+    log_reset();
+    n = atomic_load(&s_entered);
+    sdui_bus_lane_stats_t st0 = stats(SDUI_BUS_LANE_INTERACTIVE);
+    atomic_store(&s_gate_ui, 1);
+    down("ui/layout", "\"m\"");
+    wait_entered(n + 1);
+    down("ui/update", "{\"id\":1}");
+    down("state/set", "{\"a\":1}");
+    down("state/set", " {\"b\":2} ");
+    t0 = esp_timer_get_time();
+    down("ui/update", "[{\"id\":2}]");
+    down("ui/update", "{\"ops\":[{\"id\":3}]}");
+    down("ui/update", "[]");
+    CHECK(esp_timer_get_time() - t0 < 50000);
+    st = stats(SDUI_BUS_LANE_INTERACTIVE);
+    CHECK(st.coalesced == st0.coalesced + 3 && st.blocked == st0.blocked && st.dropped == st0.dropped &&
+          st.depth == 3);
+    atomic_store(&s_gate_ui, 0);
+    wait_log("U:m;T:{\"id\":1};U:{\"id\":1};T:[{\"a\":1},{\"b\":2}];"
+             "T:[{\"id\":2},{\"ops\":[{\"id\":3}]}];U:[{\"id\":2},{\"ops\":[{\"id\":3}]}];");
+
+    // 8. DROP 新消息遇到全是 BLOCK 消息的满队列：丢弃新消息本身，不挤掉命令
+    log_reset();
+    n = atomic_load(&s_entered);
+    atomic_store(&s_gate_cmd, 1);
+    down("audio/cmd/stop", "\"c0\"");
+    wait_entered(n + 1);
+    down("audio/cmd/stop", "\"c1\"");
+    down("audio/cmd/stop", "\"c2\"");
+    uint32_t dropped = stats(SDUI_BUS_LANE_REALTIME).dropped;
+    t0 = esp_timer_get_time();
+    down("audio/play", "\"late\"");
+    CHECK(esp_timer_get_time() - t0 < 50000);
+    st = stats(SDUI_BUS_LANE_REALTIME);
+    CHECK(st.dropped == dropped + 1 && st.blocked == 0 && st.depth == 2);
+    atomic_store(&s_gate_cmd, 0);
+    wait_log("C:c0;C:c1;C:c2;");
+
+    // 9. font/# 写 SPIFFS，走后台通道
+    log_reset();
+    uint32_t bg = stats(SDUI_BUS_LANE_BACKGROUND).delivered;
+    uint32_t ui = stats(SDUI_BUS_LANE_INTERACTIVE).delivered;
+    down("font/glyph", "\"g\"");
+    wait_log("F:g;");
+    CHECK(stats(SDUI_BUS_LANE_BACKGROUND).delivered == bg + 1);
+    CHECK(stats(SDUI_BUS_LANE_INTERACTIVE).delivered == ui);
+
+    // 10. 自定义规则优先于缺省规则；非法规则被忽略
+    sdui_bus_set_lane("audio/cmd/#", SDUI_BUS_LANE_BACKGROUND, SDUI_BUS_OVERFLOW_BLOCK);
+    sdui_bus_set_lane("bad/#/x", SDUI_BUS_LANE_BACKGROUND, SDUI_BUS_OVERFLOW_BLOCK);
+    sdui_bus_set_lane("audio/play", SDUI_BUS_LANE_BACKGROUND, (sdui_bus_overflow_t)7);
+    log_reset();
+    n  = atomic_load(&s_entered);
+    uint32_t rt = stats(SDUI_BUS_LANE_REALTIME).delivered;
+    bg = stats(SDUI_BUS_LANE_BACKGROUND).delivered;
+    atomic_store(&s_gate_rt, 1);
+    down("audio/play", "\"z\"");
+    wait_entered(n + 1);
+    CHECK(stats(SDUI_BUS_LANE_REALTIME).delivered == rt + 1);   // 仍在 realtime：非法规则未生效
+    down("audio/cmd/stop", "\"s\"");
+    wait_log("C:s;");                                            // realtime 被占住时命令照常出队
+    CHECK(stats(SDUI_BUS_LANE_BACKGROUND).delivered == bg + 1);
+    atomic_store(&s_gate_rt, 0);
+    wait_log("C:s;A:z;");
+
+    // 11. 通道任务内再投递本通道：同步回调，不排队
+    log_reset();
+    down("ui/forward", "\"out\"");
+    wait_log("R:in;E:fwd;R:out;");
+
+    for (int l = 0; l < SDUI_BUS_LANE_COUNT; l++) {
+        st = stats(l);
+        printf("%-11s enq %u del %u drop %u coal %u blocked %u (max %u us) depth_max %u wait max %u us\n",
+               sdui_bus_lane_name(l), st.enqueued, st.delivered, st.dropped, st.coalesced, st.blocked,
+               st.block_us_max, st.depth_max, st.wait_us_max);
+        CHECK(st.depth == 0);
+    }
+    CHECK(atomic_load(&s_on_main) == 0);
+    printf("ALL OK\n");
+    return 0;
+}
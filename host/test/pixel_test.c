@@ -0,0 +1,186 @@
+/**
+ * @file pixel_test.c
+ * @brief 主机测试：sdui_pixel 参考实现与 LVGL lv_color_16_16_mix 逐位一致
+ *
+ *   - sdui_pixel_selftest(sdui_pixel_reference()) 通过；故意改错一个内核的后端必须被自检拒绝
+ *   - mix：每个 opa (0–255) × 全部 65536 种前景色 × 一组背景色，与 lv_color_16_16_mix 比对
+ *   - blend：每个 opa × 全部 65536 种背景色 × 一组前景色
+ *   - blend_mask：全部 mask 值 × 一组 opa，mask 与 opa 按 (mask * opa) >> 8 合成（opa 255 时取 mask）
+ *   - swap / fill 与逐像素写法比对，sdui_px_lv_fill / sdui_px_lv_image_opa 按 stride 只改写有效宽度
+ * 全部通过时打印 "ALL OK" 并返回 0。
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "lvgl.h"
+#include "sdui_pixel.h"
+
+#define CHECK(c)                                                         \
+    do {                                                                 \
+        if (!(c)) {                                                      \
+            printf("FAIL %s:%d %s\n", __FILE__, __LINE__, #c);           \
+            exit(1);                                                     \
+        }                                                                \
+    } while (0)
+
+#define NPX 65536
+
+// 边界色（黑、白、三原色及其补色）与几种常见 UI 色
+static const uint16_t s_colors[] = {
+    0x0000, 0xFFFF, 0xF800, 0x07E0, 0x001F, 0x07FF, 0xF81F, 0xFFE0,
+    0x0821, 0x7BEF, 0x8410, 0xF7DE, 0x1234, 0xA5A5, 0x5A5A, 0xFEDC,
+};
+#define NCOLORS (sizeof(s_colors) / sizeof(s_colors[0]))
+
+static uint16_t s_all[NPX];   // 0..65535
+static uint16_t s_dst[NPX];
+static uint16_t s_tmp[NPX];
+
+static int report(const char *what, uint16_t fg, uint16_t bg, unsigned opa, uint16_t got) {
+    printf("%s fg %04X bg %04X opa %u: got %04X, LVGL %04X\n", what, fg, bg, opa, got,
+           lv_color_16_16_mix(fg, bg, (uint8_t)opa));
+    return 1;
+}
+
+/* ======================================================
+ * 自检
+ * ====================================================== */
+static void bad_blend(uint16_t *dst, uint16_t color, uint8_t opa, size_t n) {
+    sdui_pixel_reference()->blend(dst, color, opa, n);
+    if (n > 5 && opa == 128) dst[5] ^= 1;   // 只在一处差一位
+}
+
+static void test_selftest(void) {
+    const sdui_pixel_backend_t *ref = sdui_pixel_reference();
+    CHECK(sdui_pixel_selftest(ref));
+
+    sdui_pixel_backend_t bad = *ref;
+    bad.name  = "bad";
+    bad.blend = bad_blend;
+    CHECK(!sdui_pixel_selftest(&bad));   // 预期打印一条 mismatch 错误日志
+}
+
+/* ======================================================
+ * 与 lv_color_16_16_mix 比对
+ * ====================================================== */
+static void test_mix(void) {
+    const sdui_pixel_backend_t *ref = sdui_pixel_reference();
+    int bad = 0;
+    for (size_t c = 0; c < NCOLORS; c++) {
+        uint16_t bg = s_colors[c];
+        for (size_t i = 0; i < NPX; i++) s_tmp[i] = bg;
+        for (unsigned opa = 0; opa <= 255; opa++) {
+            ref->mix(s_dst, s_tmp, s_all, (uint8_t)opa, NPX);   // b (= 前景) 的权重为 opa
+            for (size_t i = 0; i < NPX && bad < 8; i++) {
+                if (s_dst[i] != lv_color_16_16_mix(s_all[i], bg, (uint8_t)opa))
+                    bad += report("mix", s_all[i], bg, opa, s_dst[i]);
+            }
+        }
+    }
+    CHECK(bad == 0);
+}
+
+static void test_blend(void) {
+    const sdui_pixel_backend_t *ref = sdui_pixel_reference();
+    int bad = 0;
+    for (size_t c = 0; c < NCOLORS; c++) {
+        uint16_t fg = s_colors[c];
+        for (unsigned opa = 0; opa <= 255; opa++) {
+            memcpy(s_dst, s_all, sizeof(s_dst));
+            ref->blend(s_dst, fg, (uint8_t)opa, NPX);
+            for (size_t i = 0; i < NPX && bad < 8; i++) {
+                if (s_dst[i] != lv_color_16_16_mix(fg, s_all[i], (uint8_t)opa))
+                    bad += report("blend", fg, s_all[i], opa, s_dst[i]);
+            }
+        }
+    }
+    CHECK(bad == 0);
+}
+
+static void test_blend_mask(void) {
+    static const uint8_t opas[] = { 0, 1, 64, 127, 128, 200, 253, 254, 255 };
+    const sdui_pixel_backend_t *ref = sdui_pixel_reference();
+    uint8_t mask[256];
+    for (int i = 0; i < 256; i++) mask[i] = (uint8_t)i;
+
+    int bad = 0;
+    for (size_t c = 0; c < NCOLORS; c++) {
+        uint16_t fg = s_colors[c];
+        for (size_t b = 0; b < NCOLORS; b++) {
+            uint16_t bg = s_colors[b];
+            for (size_t oi = 0; oi < sizeof(opas); oi++) {
+                uint8_t opa = opas[oi];
+                for (int i = 0; i < 256; i++) s_dst[i] = bg;
+                ref->blend_mask(s_dst, fg, mask, opa, 256);
+                for (int i = 0; i < 256 && bad < 8; i++) {
+                    unsigned o = opa == 255 ? mask[i] : (mask[i] * opa) >> 8;
+                    if (s_dst[i] != lv_color_16_16_mix(fg, bg, (uint8_t)o))
+                        bad += report("blend_mask", fg, bg, o, s_dst[i]);
+                }
+            }
+        }
+    }
+    CHECK(bad == 0);
+}
+
+/* ======================================================
+ * fill / swap / LVGL 接管入口
+ * ====================================================== */
+static void test_fill_swap(void) {
+    const sdui_pixel_backend_t *ref = sdui_pixel_reference();
+    // 从奇数像素起写，覆盖首尾不满 32 位的部分
+    for (size_t off = 0; off < 2; off++) {
+        for (size_t c = 0; c < NCOLORS; c++) {
+            memcpy(s_dst, s_all, sizeof(s_dst));
+            ref->fill(s_dst + off, s_colors[c], 1001);
+            for (size_t i = 0; i < 1100; i++)
+                CHECK(s_dst[i] == (i >= off && i < off + 1001 ? s_colors[c] : s_all[i]));
+        }
+        memcpy(s_dst, s_all, sizeof(s_dst));
+        ref->swap(s_dst + off, 1001);
+        for (size_t i = 0; i < 1100; i++) {
+            uint16_t v = s_all[i];
+            CHECK(s_dst[i] == (i >= off && i < off + 1001 ? (uint16_t)((v << 8) | (v >> 8)) : v));
+        }
+    }
+}
+
+static void test_lv_hooks(void) {
+    enum { W = 37, H = 5, STRIDE = 48 * 2 };   // stride 以字节计，每行尾部 11 像素不得改写
+    uint16_t fg = 0xF81F;
+    for (unsigned opa = 0; opa <= 255; opa += 51) {
+        memcpy(s_dst, s_all, sizeof(s_dst));
+        sdui_px_lv_fill(s_dst, W, H, STRIDE, fg, (uint8_t)opa);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < STRIDE / 2; x++) {
+                size_t i = (size_t)y * STRIDE / 2 + x;
+                CHECK(s_dst[i] == (x < W ? lv_color_16_16_mix(fg, s_all[i], (uint8_t)opa) : s_all[i]));
+            }
+        }
+
+        memcpy(s_dst, s_all, sizeof(s_dst));
+        const uint16_t *src = s_all + 30000;   // 另一段内容作为图片，行距与目标相同
+        sdui_px_lv_image_opa(s_dst, W, H, STRIDE, src, STRIDE, (uint8_t)opa);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < STRIDE / 2; x++) {
+                size_t i = (size_t)y * STRIDE / 2 + x;
+                CHECK(s_dst[i] == (x < W ? lv_color_16_16_mix(src[i], s_all[i], (uint8_t)opa) : s_all[i]));
+            }
+        }
+    }
+}
+
+int main(void) {
+    for (size_t i = 0; i < NPX; i++) s_all[i] = (uint16_t)i;
+    sdui_pixel_init();   // 主机上没有 PIE，当前后端即参考实现
+    CHECK(sdui_pixel_active() == sdui_pixel_reference());
+
+    test_selftest();
+    test_mix();
+    test_blend();
+    test_blend_mask();
+    test_fill_swap();
+    test_lv_hooks();
+    printf("ALL OK\n");
+    return 0;
+}
@@ -11,7 +11,10 @@
 #include "audio_manager.h"
 #include "sdui_bus.h"
 #include "sdui_parser.h"
+#include "sdui_pixel.h"
+#include "sdui_perf.h"
 #include "telemetry_manager.h"
+#include "cJSON.h"
 
 static const char *TAG = "SDUI_APP";
 
@@ -19,13 +22,59 @@ static const char *TAG = "SDUI_APP";
 #define SCREEN_SLEEP_TIMEOUT_MS 30000 
 static bool is_screen_sleeping = false;
 
+/* ---- 流式构建的加锁回调：解析在锁外进行，只在创建组件时分段持锁 ---- */
+static void ui_lock(void)
+{
+    bsp_display_lock(-1);
+}
+
+static void wake_screen(void)
+{
+    bsp_display_lock(-1);
+    lv_disp_trig_activity(NULL);
+    bsp_display_unlock();
+}
+
 /* ---- SDUI 总线回调：处理 ui/layout 主题（全量布局渲染） ---- */
-static void on_ui_layout(const char *payload)
+static void on_ui_layout(const char *payload, size_t len)
+{
+    if (!payload) return;
+    wake_screen();
+    sdui_parser_stream(payload, len);   // 直接解析下行原文，边读边建，不保留整棵 DOM
+}
+
+/* ---- SDUI 总线回调：处理 ui/layout 二进制帧（SBL 编码的全量布局） ---- */
+static void on_ui_layout_bin(const uint8_t *data, size_t len)
+{
+    if (!data) return;
+    wake_screen();
+    sdui_parser_stream_bin(data, len);
+}
+
+/* ---- SDUI 总线回调：处理 ui/styles 主题（共享样式类定义） ---- */
+static void on_ui_styles(const char *payload)
 {
     if (!payload) return;
     bsp_display_lock(-1);
-    lv_disp_trig_activity(NULL);
-    sdui_parser_render(payload);
+    sdui_parser_set_styles(payload);
+    bsp_display_unlock();
+}
+
+/* ---- SDUI 总线回调：处理 ui/image 主题（分片图片上传，解码在锁外） ---- */
+static void on_ui_image(const char *payload)
+{
+    if (!payload || !sdui_parser_image_feed(payload)) return;   // 未收齐时不加锁
+    bsp_display_lock(-1);
+    sdui_parser_image_commit();
+    bsp_display_unlock();
+}
+
+/* ---- SDUI 总线回调：处理 font/glyphs 主题（按需下发的字形，登记在锁外） ---- */
+static void on_font_glyphs(const char *payload)
+{
+    if (!payload || !sdui_parser_glyph_feed(payload)) return;
+    bsp_display_lock(-1);
+    sdui_parser_glyph_commit();
     bsp_display_unlock();
 }
 
@@ -39,6 +88,101 @@ static void on_ui_update(const char *payload)
     bsp_display_unlock();
 }
 
+/* ---- SDUI 总线回调：处理 state/set 主题（状态变量，只重绘绑定的组件） ---- */
+static void on_state_set(const char *payload)
+{
+    if (!payload) return;
+    bsp_display_lock(-1);
+    lv_disp_trig_activity(NULL);
+    sdui_parser_state_set(payload);
+    bsp_display_unlock();
+}
+
+/* ---- 上屏计时记录：由计时模块的后台任务调用，转发到服务端 ---- */
+static void on_perf_record(const char *json)
+{
+    sdui_bus_publish_up("perf/render", json);
+}
+
+/* ---- 遥测附加字段：图片 / 字形缓存命中率与淘汰数、动画调度、总线通道排队与渲染耗时直方图 ---- */
+static void telemetry_add_sdui_stats(cJSON *root)
+{
+    sdui_image_cache_stats_t st;
+    sdui_parser_get_image_cache_stats(&st);
+    cJSON *c = cJSON_AddObjectToObject(root, "img_cache");
+    if (!c) return;
+    uint32_t lookups = st.hits + st.misses;
+    cJSON_AddNumberToObject(c, "hits",      st.hits);
+    cJSON_AddNumberToObject(c, "misses",    st.misses);
+    cJSON_AddNumberToObject(c, "hit_rate",  lookups ? (double)st.hits / lookups : 0);
+    cJSON_AddNumberToObject(c, "evictions", st.evictions);
+    cJSON_AddNumberToObject(c, "entries",   st.entries);
+    cJSON_AddNumberToObject(c, "bytes",     st.bytes);
+    cJSON_AddNumberToObject(c, "budget",    st.budget);
+
+    sdui_glyph_cache_stats_t gs;
+    sdui_parser_get_glyph_cache_stats(&gs);
+    cJSON *g = cJSON_AddObjectToObject(root, "glyph_cache");
+    if (!g) return;
+    cJSON_AddNumberToObject(g, "hits",      gs.hits);
+    cJSON_AddNumberToObject(g, "misses",    gs.misses);
+    cJSON_AddNumberToObject(g, "requests",  gs.requests);
+    cJSON_AddNumberToObject(g, "evictions", gs.evictions);
+    cJSON_AddNumberToObject(g, "glyphs",    gs.glyphs);
+    cJSON_AddNumberToObject(g, "bytes",     gs.bytes);
+    cJSON_AddNumberToObject(g, "budget",    gs.budget);
+
+    sdui_anim_stats_t as;
+    sdui_parser_get_anim_stats(&as);
+    cJSON *an = cJSON_AddObjectToObject(root, "anim");
+    if (!an) return;
+    cJSON_AddNumberToObject(an, "active",       as.active);
+    cJSON_AddNumberToObject(an, "paused",       as.paused);
+    cJSON_AddNumberToObject(an, "level",        as.level);
+    cJSON_AddNumberToObject(an, "fps",          as.fps);
+    cJSON_AddNumberToObject(an, "target_fps",   as.target_fps);
+    cJSON_AddNumberToObject(an, "frame_us",     as.frame_us);
+    cJSON_AddNumberToObject(an, "frame_max_us", as.frame_max_us);
+    cJSON_AddNumberToObject(an, "dropped",      as.dropped);
+    cJSON_AddNumberToObject(an, "skipped",      as.skipped);
+
+#if CONFIG_SDUI_BUS_LANES
+    cJSON *bl = cJSON_AddObjectToObject(root, "bus_lanes");
+    for (int i = 0; bl && i < SDUI_BUS_LANE_COUNT; i++) {
+        sdui_bus_lane_stats_t ls;
+        if (!sdui_bus_get_lane_stats(i, &ls)) continue;
+        cJSON *l = cJSON_AddObjectToObject(bl, sdui_bus_lane_name(i));
+        if (!l) break;
+        cJSON_AddNumberToObject(l, "depth",        ls.depth);
+        cJSON_AddNumberToObject(l, "depth_max",    ls.depth_max);
+        cJSON_AddNumberToObject(l, "capacity",     ls.capacity);
+        cJSON_AddNumberToObject(l, "enqueued",     ls.enqueued);
+        cJSON_AddNumberToObject(l, "dropped",      ls.dropped);
+        cJSON_AddNumberToObject(l, "coalesced",    ls.coalesced);
+        cJSON_AddNumberToObject(l, "blocked",      ls.blocked);
+        cJSON_AddNumberToObject(l, "block_max_us", ls.block_us_max);
+        cJSON_AddNumberToObject(l, "wait_us",      ls.delivered ? (double)(ls.wait_us_sum / ls.delivered) : 0);
+        cJSON_AddNumberToObject(l, "wait_max_us",  ls.wait_us_max);
+    }
+#endif
+
+#if CONFIG_SDUI_PERF
+    sdui_perf_hist_t ph;
+    sdui_perf_get_hist(&ph);
+    cJSON *p = cJSON_AddObjectToObject(root, "render_perf");
+    if (!p) return;
+    cJSON_AddNumberToObject(p, "published", ph.published);
+    cJSON_AddNumberToObject(p, "lost",      ph.lost);
+    cJSON_AddNumberToObject(p, "window",    ph.window);
+    cJSON *hist = cJSON_AddObjectToObject(p, "hist");
+    for (int i = 0; hist && i < SDUI_PERF_PHASE_COUNT; i++) {
+        int counts[SDUI_PERF_HIST_BUCKETS];
+        for (int b = 0; b < SDUI_PERF_HIST_BUCKETS; b++) counts[b] = ph.count[i][b];
+        cJSON_AddItemToObject(hist, sdui_perf_phase_name(i), cJSON_CreateIntArray(counts, SDUI_PERF_HIST_BUCKETS));
+    }
+#endif
+}
+
 /* ---- SDUI 总线回调：处理 audio/cmd/record_start（本地事件路由） ---- */
 static void on_audio_record_start(const char *payload)
 {
@@ -148,14 +292,29 @@ void app_main(void)
     // 1. 硬件初始化：显示优先（SPI DMA 需要内部 SRAM，必须最先分配）
     bsp_display_start();
 
+    // 像素内核：PIE 自检通过才启用（切换前 LVGL 走的 C 实现结果逐位相同）
+    sdui_pixel_init();
+#if CONFIG_SDUI_PIXEL_BENCH
+    sdui_pixel_bench();
+#endif
+
     // 2. 初始化 SDUI 解析引擎
     bsp_display_lock(-1);
     sdui_parser_init();
+    sdui_parser_set_lock(ui_lock, bsp_display_unlock);
+    sdui_perf_init();
     
     // 挂载息屏定时器 (每 500ms 检查一次)
     lv_timer_create(screen_sleep_timer_cb, 500, NULL);
     bsp_display_unlock();
 
+#if CONFIG_SDUI_GLYPH_PERSIST
+    // 预载上次保存的常用字形（锁外读文件）
+    if (bsp_spiffs_mount() == ESP_OK) {
+        sdui_parser_glyph_persist(CONFIG_BSP_SPIFFS_MOUNT_POINT "/glyphs.bin");
+    }
+#endif
+
     // 检查是否已配网
     bool is_provisioned = wifi_manager_is_provisioned();
 
@@ -190,8 +349,13 @@ void app_main(void)
     audio_app_start();
 
     //    -- 下行 UI 主题 --
-    sdui_bus_subscribe("ui/layout", on_ui_layout);   // 全量布局渲染
+    sdui_bus_subscribe_slice("ui/layout", on_ui_layout); // 全量布局渲染（零拷贝切片）
+    sdui_bus_subscribe_bin("ui/layout", on_ui_layout_bin); // 全量布局渲染 (SBL 二进制帧)
     sdui_bus_subscribe("ui/update", on_ui_update);   // 增量属性更新
+    sdui_bus_subscribe("state/set", on_state_set);   // 状态变量（绑定组件局部重绘）
+    sdui_bus_subscribe("ui/styles", on_ui_styles);   // 共享样式类
+    sdui_bus_subscribe("ui/image", on_ui_image);     // 分片图片上传
+    sdui_bus_subscribe("font/glyphs", on_font_glyphs); // 按需下发的字形
 
     //    -- 本地硬件事件主题 (由 Action URI local:// 触发) --
     sdui_bus_subscribe("audio/cmd/record_start", on_audio_record_start);                
@@ -210,10 +374,13 @@ void app_main(void)
     ESP_LOGI(TAG, "Connecting to WebSocket: %s", ws_url);
 
     // 6. 启动外围子系统
+    sdui_perf_set_sink(on_perf_record);   // ui/layout、ui/update 上屏后上行 perf/render
+    websocket_set_bin_rx_cb(sdui_bus_route_down_bin);
     websocket_app_start(ws_url, sdui_bus_route_down); 
     imu_app_start();
 
     // 7. 启动遥测上报模块（每 30 秒上报一次设备状态）
     // 必须在 websocket_app_start() 之后调用，确保上行链路就绪
+    telemetry_set_extra_cb(telemetry_add_sdui_stats);
     telemetry_app_start(30);
 }
\ No newline at end of file
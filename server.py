@@ -3,9 +3,12 @@ import websockets
 import json
 import logging
 import base64
+import hashlib
 import wave
 import io
 import os
+import re
+import struct
 import time
 from concurrent.futures import ThreadPoolExecutor
 
@@ -14,6 +17,12 @@ from openai import AsyncOpenAI
 from faster_whisper import WhisperModel
 import edge_tts
 
+# 可选：字形光栅化 (font/glyph_miss)，缺失时设备上的汉字保持占位框
+try:
+    from PIL import Image, ImageDraw, ImageFont
+except ImportError:
+    Image = ImageDraw = ImageFont = None
+
 # ============================================================
 #  SDUI Gateway Server — DeepSeek AI 语音对话终端
 # ============================================================
@@ -61,56 +70,43 @@ def get_or_create_device(device_id, websocket, remote):
 # ============================================================
 #  UI 布局构建器 (SDUI 引擎)
 # ============================================================
-def build_chat_bubble(text, is_user=False):
-    """构建单条聊天气泡 UI"""
-    bg_color = "#2ecc71" if is_user else "#333333" # 用户绿色，AI深灰
-    text_color = "#ffffff"
-    # SDUI 中的 long_mode 设为 scroll 可以让长文本在气泡内滚动，避免撑爆容器
-    return {
-        "type": "container",
-        "w": "full",
-        "h": "content",
-        "bg_color": bg_color,
-        "radius": 10,
-        "pad": 10,
-        "flex": "column",
-        "justify": "center",
-        "children": [
-            {
-                "type": "label",
-                "text": text,
-                "font_size": 16,
-                "text_color": text_color,
-                "w": "full",
-                "long_mode": "scroll"
-            }
-        ]
-    }
+# 共享样式类 (ui/styles)：设备端每类只建一个 lv_style_t，气泡通过 "class" 引用，
+# 不再为每个气泡对象各自生成一份本地样式
+SDUI_STYLES = {
+    "bubble":      {"radius": 10, "pad": 10, "text_color": "#ffffff"},  # 文字颜色由行继承给标签
+    "bubble_user": {"bg_color": "#2ecc71"},  # 用户绿色
+    "bubble_ai":   {"bg_color": "#333333"},  # AI深灰
+    "bubble_text": {"font_size": 16},
+    "chat_hint":   {"bg_opa": 0, "text_color": "#888888"},  # 空对话提示语
+}
+
+CHAT_HINT = {"text": "请按住底部按钮开始对话...", "class": "chat_hint"}
+
+def chat_item(msg):
+    """单条聊天记录 → list 条目（行样式 bubble + 角色样式，文本自动换行，见 SDUI_STYLES）"""
+    return {"text": msg["content"], "class": "bubble_user" if msg["role"] == "user" else "bubble_ai"}
+
+async def send_chat_message(ws, device_state, msg):
+    """追加一条聊天记录：只下发 append，不重发整页布局；第一条消息同时替换掉提示语"""
+    display_msgs = [m for m in device_state["messages"] if m["role"] != "system"]
+    if len(display_msgs) == 1:
+        await send_update(ws, "scroll_box", items=[chat_item(msg)])
+    else:
+        await send_update(ws, "scroll_box", append=[chat_item(msg)])
 
 def build_ai_layout(device_state):
     """构建沉浸式 AI 对话终端布局"""
-    stats = device_state["stats"]
     messages = device_state["messages"]
     
     # 抽取需要展示的对话记录 (过滤掉 system prompt)
     display_msgs = [m for m in messages if m["role"] != "system"]
     
-    # 渲染历史对话气泡
-    bubble_children = []
-    if not display_msgs:
-        bubble_children.append({
-            "type": "label",
-            "text": "请按住底部按钮开始对话...",
-            "font_size": 16,
-            "text_color": "#888888",
-            "align": "center"
-        })
-    else:
-        for msg in display_msgs:
-            bubble_children.append(build_chat_bubble(msg["content"], is_user=(msg["role"]=="user")))
+    # 历史对话：虚拟化列表，设备端只为可见的几行创建对象
+    chat_items = [chat_item(m) for m in display_msgs] or [CHAT_HINT]
 
-    # 构建完整 JSON 树
+    # 构建完整 JSON 树（reconcile: 设备端按 id/位置 复用已有组件，仅修改差异，避免整屏重建）
     return {
+        "reconcile": True,
         "flex": "column",
         "justify": "start",
         "align_items": "center",
@@ -132,23 +128,26 @@ def build_ai_layout(device_state):
                 "w": "90%",
                 "h": 30,
                 "children": [
-                    {"type": "label", "text": f"💬 轮数: {stats['rounds']}", "font_size": 14, "text_color": "#aaaaaa"},
-                    {"type": "label", "text": f"🪙 Tokens: {stats['total_tokens']}", "font_size": 14, "text_color": "#aaaaaa"}
+                    # 文本绑定状态变量：统计变化时只发 state/set，设备只重绘这两个标签
+                    {"type": "label", "id": "stat_rounds", "text": "💬 轮数: {rounds}", "font_size": 14, "text_color": "#aaaaaa"},
+                    {"type": "label", "id": "stat_tokens", "text": "🪙 Tokens: {tokens}", "font_size": 14, "text_color": "#aaaaaa"}
                 ]
             },
             # 3. 对话历史滚动区
             {
-                "type": "container",
+                "type": "list",
                 "id": "scroll_box",
-                "scrollable": True,
-                "w": "95%", 
+                "w": "95%",
                 "h": 260, # 给底部留出空间
-                "flex": "column", 
                 "gap": 10,
-                "bg_color": "#111111", 
-                "pad": 10, 
+                "bg_color": "#111111",
+                "pad": 10,
                 "radius": 10,
-                "children": bubble_children
+                "row_class": "bubble",
+                "label_class": "bubble_text",
+                "max_items": 200,
+                "follow": True,
+                "items": chat_items
             },
             # 4. 底部交互控制区
             {
@@ -184,20 +183,336 @@ def build_ai_layout(device_state):
         ]
     }
 
+# ============================================================
+#  SBL 二进制布局编码 (与 components/sdui_json/sdui_json_bin.c 保持一致)
+# ============================================================
+SDUI_BIN_VERSION = 1
+SDUI_BUS_BIN_MAGIC = b"SB"
+SDUI_BUS_BIN_VERSION = 1
+
+# 内置键表：顺序必须与设备端 s_keys 一致，只能在末尾追加
+SDUI_BIN_KEYS = [
+    "type", "id", "children", "text", "w", "h", "align", "x", "y",
+    "bg_color", "bg_opa", "pad", "radius", "gap", "border_w", "border_color",
+    "text_color", "font_size", "shadow_w", "shadow_color", "opa", "hidden",
+    "flex", "justify", "align_items", "scrollable", "long_mode",
+    "value", "min", "max", "indic_color",
+    "on_click", "on_press", "on_release", "on_change",
+    "anim", "duration", "repeat", "color_a", "color_b", "min_opa", "max_opa",
+    "direction", "from", "amplitude",
+    "src", "img_w", "img_h",
+    "count", "color", "particle_size", "canvas_w", "canvas_h",
+    "reconcile", "class", "transition", "format", "src_ref",
+    "items", "row_class", "label_class", "max_items", "follow",
+]
+_SDUI_BIN_KEY_INDEX = {k: i for i, k in enumerate(SDUI_BIN_KEYS)}
+_HEX_COLOR_RE = re.compile(r"^#[0-9a-fA-F]{6}$")
+
+def _varint(n: int) -> bytes:
+    out = bytearray()
+    while True:
+        b = n & 0x7F
+        n >>= 7
+        if n:
+            out.append(b | 0x80)
+        else:
+            out.append(b)
+            return bytes(out)
+
+def encode_sbl(value) -> bytes:
+    """将布局 JSON 树编码为 SBL：varint 键标签 + 字符串驻留表 + 3 字节颜色"""
+    strings, index = [], {}
+    body = bytearray()
+
+    def intern(s: str) -> int:
+        if s not in index:
+            index[s] = len(strings)
+            strings.append(s.encode("utf-8"))
+        return index[s]
+
+    def enc(v, key=None):
+        if v is None:
+            body.append(0x00)
+        elif isinstance(v, bool):
+            body.append(0x02 if v else 0x01)
+        elif isinstance(v, int) or (isinstance(v, float) and v.is_integer() and abs(v) < 2**53):
+            n = int(v)
+            if -2**63 <= n < 2**63:
+                body.append(0x03)
+                body.extend(_varint((n << 1) ^ (n >> 63)))
+            else:
+                body.append(0x04)
+                body.extend(struct.pack("<d", float(n)))
+        elif isinstance(v, float):
+            body.append(0x04)
+            body.extend(struct.pack("<d", v))
+        elif isinstance(v, str):
+            if key and (key.endswith("color") or key.startswith("color_")) and _HEX_COLOR_RE.match(v):
+                body.append(0x06)
+                body.extend(bytes.fromhex(v[1:]))
+            else:
+                body.append(0x05)
+                body.extend(_varint(intern(v)))
+        elif isinstance(v, dict):
+            body.append(0x07)
+            body.extend(_varint(len(v)))
+            for k, item in v.items():
+                tag = _SDUI_BIN_KEY_INDEX.get(k)
+                body.extend(_varint(tag if tag is not None else len(SDUI_BIN_KEYS) + intern(k)))
+                enc(item, k)
+        elif isinstance(v, (list, tuple)):
+            body.append(0x08)
+            body.extend(_varint(len(v)))
+            for item in v:
+                enc(item)
+        else:
+            raise TypeError(f"SBL: unsupported type {type(v).__name__}")
+
+    enc(value)
+    table = bytearray(_varint(len(strings)))
+    for sb in strings:
+        table.extend(_varint(len(sb)))
+        table.extend(sb)
+    return bytes([SDUI_BIN_VERSION]) + bytes(table) + bytes(body)
+
 # ============================================================
 #  辅助发送函数
 # ============================================================
+# 会改动画面的主题在信封中带 seq / ts，设备上屏后以 perf/render 原样回传
+PERF_TOPICS = ("ui/layout", "ui/update")
+PERF_PENDING_MAX = 64
+
+def perf_stamp(ws, topic: str, binary: bool = False):
+    """登记一次发送；二进制帧头没有 seq，按发送顺序与回传记录对应"""
+    if not hasattr(ws, "perf_sent"):
+        ws.perf_seq, ws.perf_sent, ws.perf_bin = 0, {}, []
+    ts = int(time.time() * 1000)
+    if binary:
+        ws.perf_bin = ws.perf_bin[-(PERF_PENDING_MAX - 1):] + [(topic, time.monotonic())]
+        return None, ts
+    ws.perf_seq += 1
+    ws.perf_sent[ws.perf_seq] = (topic, time.monotonic())
+    if len(ws.perf_sent) > PERF_PENDING_MAX:
+        ws.perf_sent.pop(next(iter(ws.perf_sent)))
+    return ws.perf_seq, ts
+
+def log_render_perf(ws, device_id: str, rec: dict):
+    """perf/render：设备内各阶段耗时 + 发送到记录回传的往返时间"""
+    sent = None
+    if "seq" in rec:
+        sent = getattr(ws, "perf_sent", {}).pop(rec["seq"], None)
+    elif getattr(ws, "perf_bin", None):
+        sent = ws.perf_bin.pop(0)
+    phases = " ".join(f"{k}={v / 1000:.1f}" for k, v in rec.get("phases_us", {}).items())
+    line = (f"[{device_id}] perf {rec.get('topic')} #{rec.get('seq', rec.get('id'))} {rec.get('bytes', 0)} B: "
+            f"设备内 {rec.get('total_us', 0) / 1000:.1f} ms ({phases})")
+    if sent:
+        # 往返时间扣除上屏后排队发布的时间，剩下为 下行 + 设备内 + 上行
+        rtt_ms = (time.monotonic() - sent[1]) * 1000 - rec.get("age_us", 0) / 1000
+        line += f"，发送→上屏→回传 {rtt_ms:.1f} ms"
+    logging.info(line)
+
 async def send_topic(ws, topic: str, payload):
-    msg = json.dumps({"topic": topic, "payload": payload}, ensure_ascii=False)
+    env = {"topic": topic}
+    if topic in PERF_TOPICS:
+        env["seq"], env["ts"] = perf_stamp(ws, topic)
+    env["payload"] = payload
+    msg = json.dumps(env, ensure_ascii=False)
     await ws.send(msg)
 
+async def send_topic_bin(ws, topic: str, data: bytes):
+    """二进制帧: 'S' 'B' | 版本 | topic 长度 | topic | payload"""
+    t = topic.encode("utf-8")
+    await ws.send(SDUI_BUS_BIN_MAGIC + bytes([SDUI_BUS_BIN_VERSION, len(t)]) + t + data)
+
 async def send_layout(ws, layout: dict):
-    await send_topic(ws, "ui/layout", layout)
+    # 设备在心跳 bin_topics 中声明支持时改用 SBL 二进制帧
+    if "ui/layout" in getattr(ws, "bin_topics", ()):
+        data = encode_sbl(layout)
+        json_len = len(json.dumps(layout, ensure_ascii=False).encode("utf-8"))
+        logging.info(f"ui/layout → SBL {len(data)} B (JSON {json_len} B, {len(data) * 100 // max(json_len, 1)}%)")
+        perf_stamp(ws, "ui/layout", binary=True)
+        await send_topic_bin(ws, "ui/layout", data)
+    else:
+        await send_topic(ws, "ui/layout", layout)
 
 async def send_update(ws, widget_id: str, **props):
     update = {"id": widget_id, **props}
     await send_topic(ws, "ui/update", update)
 
+async def send_updates(ws, *updates: dict):
+    """批量更新：多个 {"id": ..., ...} 合并为一条 ui/update，设备端一次解析、一次加锁"""
+    if len(updates) == 1:
+        await send_topic(ws, "ui/update", updates[0])
+    elif updates:
+        await send_topic(ws, "ui/update", list(updates))
+
+async def send_state(ws, **variables):
+    """state/set：更新设备端状态变量，引用它们的组件（"{name}" 模板）在下一帧重绘"""
+    await send_topic(ws, "state/set", variables)
+
+async def send_stats(ws, device_state):
+    stats = device_state["stats"]
+    await send_state(ws, rounds=stats["rounds"], tokens=stats["total_tokens"])
+
+def rle565_tokens(rgb565: bytes):
+    """rle565 编码 (与 sdui_img_codec.h 一致)，逐个产出 (token 字节, 像素数)"""
+    px = [rgb565[i:i + 2] for i in range(0, len(rgb565), 2)]
+    i, n = 0, len(px)
+    while i < n:
+        run = 1
+        while i + run < n and run < 128 and px[i + run] == px[i]:
+            run += 1
+        if run >= 2:
+            yield bytes([0x7F + run]) + px[i], run
+            i += run
+            continue
+        # 字面量：延伸到下一段重复之前
+        j = i + 1
+        while j < n and j - i < 128 and not (j + 1 < n and px[j + 1] == px[j]):
+            j += 1
+        yield bytes([j - i - 1]) + b"".join(px[i:j]), j - i
+        i = j
+
+def encode_rle565(rgb565: bytes) -> bytes:
+    return b"".join(t for t, _ in rle565_tokens(rgb565))
+
+def image_attrs(rgb565: bytes, w: int, h: int) -> dict:
+    """内联 image 节点属性：rle565 更小时自动压缩"""
+    rle = encode_rle565(rgb565)
+    if len(rle) < len(rgb565):
+        return {"src": base64.b64encode(rle).decode("ascii"), "format": "rle565", "img_w": w, "img_h": h}
+    return {"src": base64.b64encode(rgb565).decode("ascii"), "img_w": w, "img_h": h}
+
+# 内容寻址图片：ref → (rgb565, w, h)，设备上报 ui/image_miss 时据此补发
+IMAGE_STORE: dict = {}
+
+def image_ref(rgb565: bytes, w: int, h: int) -> str:
+    """图片内容哈希 (16 位 hex)，同时登记到 IMAGE_STORE"""
+    ref = hashlib.blake2b(struct.pack("<HH", w, h) + rgb565, digest_size=8).hexdigest()
+    IMAGE_STORE[ref] = (rgb565, w, h)
+    return ref
+
+def image_ref_attrs(ws, rgb565: bytes, w: int, h: int) -> dict:
+    """image 节点属性：本连接已发过的图片只发 src_ref (设备缓存命中)，首次随附像素。
+    设备缓存淘汰后会上报 ui/image_miss，由 sdui_handler 补发"""
+    ref = image_ref(rgb565, w, h)
+    refs = getattr(ws, "img_refs", None)
+    if refs is None:
+        refs = ws.img_refs = set()
+    if ref in refs:
+        return {"src_ref": ref, "img_w": w, "img_h": h}
+    refs.add(ref)
+    return {"src_ref": ref, **image_attrs(rgb565, w, h)}
+
+async def send_image(ws, widget_id: str, rgb565: bytes, w: int, h: int, chunk: int = 6144, compress: bool = True,
+                     ref: str = None):
+    """分片上传 RGB565 位图到 image 组件 (ui/image)：设备端逐片解码进最终缓冲。
+    compress 时以 rle565 发送，分片在 token 边界切分，offset 仍为解码后位图中的偏移；
+    带 ref 时设备收齐后同时登记到图片缓存"""
+    assert len(rgb565) == w * h * 2
+    total = len(rgb565)
+    head = {"w": w, "h": h}
+    if ref:
+        head["ref"] = ref
+    if compress and len(encode_rle565(rgb565)) < total:
+        head["format"] = "rle565"
+        pieces, cur, cur_len, cur_off, off = [], [], 0, 0, 0
+        for tok, npx in rle565_tokens(rgb565):
+            if cur and cur_len + len(tok) > chunk:
+                pieces.append((cur_off, b"".join(cur)))
+                cur, cur_len, cur_off = [], 0, off
+            cur.append(tok)
+            cur_len += len(tok)
+            off += npx * 2
+        if cur:
+            pieces.append((cur_off, b"".join(cur)))
+    else:
+        chunk -= chunk % 3  # 每片 Base64 可独立解码
+        pieces = [(o, rgb565[o:o + chunk]) for o in range(0, total, chunk)]
+    for off, data in pieces:
+        msg = {"id": widget_id, "offset": off, "total": total,
+               "data": base64.b64encode(data).decode("ascii")}
+        if off == 0:
+            msg.update(head)
+        await send_topic(ws, "ui/image", msg)
+
+async def bench_updates(ws, widget_id: str = "status_label"):
+    """ui/update 批量基准：依次发送含 1 / 10 / 100 个更新的消息，耗时见设备日志 Batch update"""
+    for n in (1, 10, 100):
+        ops = [{"id": widget_id, "text": f"bench {n} #{i}"} for i in range(n)]
+        await send_topic(ws, "ui/update", ops)
+        logging.info(f"ui/update bench: sent {n} ops ({len(json.dumps(ops))} B)")
+        await asyncio.sleep(1)
+
+# ============================================================
+#  按需字形 (设备上行 font/glyph_miss → 下行 font/glyphs)
+# ============================================================
+# 以 os.pathsep 分隔的字体文件列表，逐个尝试，第一个能画出该码点的胜出
+# (如 CJK 字体在前、单色 emoji 字体在后)
+GLYPH_FONT_PATHS = [p for p in os.getenv(
+    "SDUI_GLYPH_FONTS", "/usr/share/fonts/opentype/noto/NotoSansCJK-Regular.ttc").split(os.pathsep) if p]
+GLYPH_BOX_MAX = 64   # 与 sdui_glyph.h SDUI_GLYPH_BOX_MAX 一致
+GLYPH_BATCH = 48     # 每条 font/glyphs 的字形数，控制单帧大小
+
+_glyph_fonts: dict = {}   # size → [(ImageFont, .notdef 掩码)]
+_glyph_cache: dict = {}   # (size, cp) → 字形 dict
+
+def _glyph_fonts_for(size: int) -> list:
+    fonts = _glyph_fonts.get(size)
+    if fonts is None:
+        fonts = []
+        if ImageFont:
+            for path in GLYPH_FONT_PATHS:
+                try:
+                    font = ImageFont.truetype(path, size)
+                except OSError:
+                    logging.warning(f"glyph font not found: {path}")
+                    continue
+                fonts.append((font, bytes(font.getmask("\U0010FFFF"))))
+        _glyph_fonts[size] = fonts
+    return fonts
+
+def pack_a4(gray: bytes, w: int, h: int) -> bytes:
+    """8 bit 灰度 → 4 bpp，逐行 (w + 1) // 2 字节，高半字节在左"""
+    out = bytearray()
+    for y in range(h):
+        row = gray[y * w:(y + 1) * w]
+        for x in range(0, w, 2):
+            lo = row[x + 1] >> 4 if x + 1 < w else 0
+            out.append((row[x] >> 4) << 4 | lo)
+    return bytes(out)
+
+def render_glyph(size: int, cp: int) -> dict:
+    """光栅化一个码点为 font/glyphs 中的字形 (格式见 sdui_parser_glyph_feed)。
+    x / y 为位图左下角相对原点与基线的偏移 (y 向上)；没有字体能画时回送空字形，设备不再请求"""
+    key = (size, cp)
+    glyph = _glyph_cache.get(key)
+    if glyph:
+        return glyph
+    ch = chr(cp)
+    glyph = {"cp": cp, "adv": size // 2, "w": 0, "h": 0}
+    for font, notdef in _glyph_fonts_for(size):
+        if bytes(font.getmask(ch)) == notdef:
+            continue
+        left, top, right, bottom = font.getbbox(ch, anchor="ls")
+        w = min(right - left, GLYPH_BOX_MAX)
+        h = min(bottom - top, GLYPH_BOX_MAX)
+        glyph = {"cp": cp, "adv": round(font.getlength(ch)), "w": max(w, 0), "h": max(h, 0)}
+        if w > 0 and h > 0:
+            img = Image.new("L", (w, h), 0)
+            ImageDraw.Draw(img).text((-left, -top), ch, font=font, fill=255, anchor="ls")
+            glyph.update(x=left, y=-bottom, bmp=base64.b64encode(pack_a4(img.tobytes(), w, h)).decode("ascii"))
+        break
+    _glyph_cache[key] = glyph
+    return glyph
+
+async def send_glyphs(ws, size: int, cps: list):
+    """应答 font/glyph_miss：按 GLYPH_BATCH 分批回送字形"""
+    glyphs = [render_glyph(size, cp) for cp in cps if isinstance(cp, int) and 0x80 <= cp <= 0x10FFFF]
+    for i in range(0, len(glyphs), GLYPH_BATCH):
+        await send_topic(ws, "font/glyphs", {"size": size, "glyphs": glyphs[i:i + GLYPH_BATCH]})
+
 # ============================================================
 #  AI 业务流水线 (STT -> LLM -> TTS)
 # ============================================================
@@ -253,9 +568,10 @@ async def process_chat_round(ws, device_id, device_state):
 
         logging.info(f"[{device_id}] 用户: {user_text}")
         
-        # 存入上下文并刷新 UI (展示用户提问气泡)
-        device_state["messages"].append({"role": "user", "content": user_text})
-        await send_layout(ws, build_ai_layout(device_state))
+        # 存入上下文并追加用户提问气泡
+        user_msg = {"role": "user", "content": user_text}
+        device_state["messages"].append(user_msg)
+        await send_chat_message(ws, device_state, user_msg)
         
         # 2. DeepSeek 大模型请求
         await send_update(ws, "status_label", text="🧠 DeepSeek 思考中...")
@@ -277,11 +593,13 @@ async def process_chat_round(ws, device_id, device_state):
         
         logging.info(f"[{device_id}] AI: {ai_text} (消耗 {used_tokens} tokens)")
         
-        # 记录状态并刷新 UI (展示 AI 回复气泡和状态更新)
-        device_state["messages"].append({"role": "assistant", "content": ai_text})
+        # 记录状态，追加 AI 回复气泡并更新统计
+        ai_msg = {"role": "assistant", "content": ai_text}
+        device_state["messages"].append(ai_msg)
         device_state["stats"]["rounds"] += 1
         device_state["stats"]["total_tokens"] += used_tokens
-        await send_layout(ws, build_ai_layout(device_state))
+        await send_chat_message(ws, device_state, ai_msg)
+        await send_stats(ws, device_state)
         
         # 3. Edge-TTS 合成并下发流
         await send_update(ws, "status_label", text="🔊 正在播放...")
@@ -351,11 +669,17 @@ async def sdui_handler(websocket):
                 
                 device_state["telemetry"] = payload
                 device_state["last_seen"] = time.strftime("%H:%M:%S")
+                if isinstance(payload, dict):
+                    websocket.bin_topics = set(payload.get("bin_topics", []))
                 
                 # 首次收到心跳，下发完整 AI 交互界面
                 if not hasattr(websocket, 'initialized'):
                     websocket.initialized = True
+                    await send_topic(websocket, "ui/styles", SDUI_STYLES)
+                    await send_stats(websocket, device_state)
                     await send_layout(websocket, build_ai_layout(device_state))
+                    if os.environ.get("SDUI_BENCH_UPDATES"):
+                        asyncio.create_task(bench_updates(websocket))
                 continue
 
             if not connection_device_id or connection_device_id == "UNKNOWN":
@@ -366,9 +690,10 @@ async def sdui_handler(websocket):
                 state = payload.get("state")
                 if state == "start":
                     device_state["audio_buffer"].clear()
-                    await send_update(websocket, "status_label", text="👂 录音中...")
-                    # 也可以给界面的某个元素加点动画
-                    await send_update(websocket, "scroll_box", anim={"type": "breathe", "min_opa": 180, "max_opa": 255, "duration": 1000})
+                    # 状态文字与动画合并为一条批量更新
+                    await send_updates(websocket,
+                        {"id": "status_label", "text": "👂 录音中..."},
+                        {"id": "scroll_box", "anim": {"type": "breathe", "min_opa": 180, "max_opa": 255, "duration": 1000}})
 
                 elif state == "stream":
                     b64_data = payload.get("data", "")
@@ -381,12 +706,32 @@ async def sdui_handler(websocket):
                     asyncio.create_task(process_chat_round(websocket, connection_device_id, device_state))
 
             # ==== 3. UI 交互路由 ====
+            elif topic == "ui/image_miss":
+                # 设备图片缓存未命中 (已淘汰或重连后)：按 ref 补发到对应组件
+                ref = payload.get("ref")
+                item = IMAGE_STORE.get(ref)
+                if item and payload.get("id"):
+                    await send_image(websocket, payload["id"], *item, ref=ref)
+                else:
+                    logging.warning(f"[{connection_device_id}] ui/image_miss: unknown ref {ref}")
+
+            elif topic == "font/glyph_miss":
+                # 设备字形缓存未命中：一帧内缺的码点合并为一条请求
+                size = payload.get("size")
+                if isinstance(size, int) and 0 < size <= 255:
+                    await send_glyphs(websocket, size, payload.get("cps", []))
+
+            elif topic == "perf/render":
+                if isinstance(payload, dict):
+                    log_render_perf(websocket, connection_device_id, payload)
+
             elif topic == "ui/new_chat":
                 logging.info(f"[{connection_device_id}] 用户请求开启新对话")
                 # 清理上下文
                 device_state["messages"].clear()
                 device_state["stats"] = {"rounds": 0, "total_tokens": 0}
                 # 全量下发刷新屏幕
+                await send_stats(websocket, device_state)
                 await send_layout(websocket, build_ai_layout(device_state))
 
     except websockets.exceptions.ConnectionClosed: